@@ -341,19 +341,23 @@ namespace btk
     // Point conversion
     for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
     {
+      // The values of the clone are shared with the input until they are scaled.
       btk::Point::Pointer p = (*it)->Clone();
+      double s = 1.0;
       if (p->GetType() < 6)
-        p->GetValues() *= scales[p->GetType()];
+        s = scales[p->GetType()];
       else if (p->GetType() == 6) // Reaction: Force, Moment and Position
       {
         std::string suffix = p->GetLabel().substr(2, p->GetLabel().length()-2);
         if (suffix.compare(".F") == 0)
-          p->GetValues() *= scales[Force];
+          s = scales[Force];
         else if (suffix.compare(".M") == 0)
-          p->GetValues() *= scales[Moment];
+          s = scales[Moment];
         else
-          p->GetValues() *= scales[Length];
+          s = scales[Length];
       }
+      if (s != 1.0)
+        p->GetValues() *= s;
       output->AppendPoint(p);
     }
     
@@ -563,7 +567,8 @@ namespace btk
       }
       else
         btkErrorMacro("Unknown analog channel's unit: '"+ (*it)->GetUnit() + "'. Impossible to scale its data.");
-      ac->GetValues() *= s;
+      if (s != 1.0)
+        ac->GetValues() *= s;
       ac->SetScale(ac->GetScale() * s);
       output->AppendAnalog(ac);
       ++idxChannel;
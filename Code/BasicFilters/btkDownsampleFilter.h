@@ -87,6 +87,7 @@ namespace btk
    * To downsample data, you need to set the up/down sample ratio using the method SetUpDownRatio().
    * The given value is an integer corresponding to the ratio used to extract only the value of interest.
    * For example, if you have 200 frames and a ratio of 10, then 20 frames will be extracted (one frame each 10 frames).
+   * No anti-aliasing filter is applied. Use the class ResampleFilter to lowpass filter the data before the decimation or to resample them by a rational ratio.
    *
    * Note: This class require specialization for each kind of class. At this moment, only the specialization of the following classes are implemented:
    *         - btk::Wrench
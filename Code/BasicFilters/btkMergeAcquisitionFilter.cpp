@@ -38,8 +38,39 @@
 
 #include "btkConvert.h"
 
+#include <set>
+
 namespace btk
 {
+  // Sorted index of the labels of a collection of points or analog channels.
+  // Only the first item is kept when several items have the same label (as returned by Acquisition::FindPoint() and Acquisition::FindAnalog()).
+  template <typename T>
+  static void IndexLabels_p(const T* collection, std::map<std::string, typename T::ItemPointer>* index)
+  {
+    index->clear();
+    for (typename T::ConstIterator it = collection->Begin() ; it != collection->End() ; ++it)
+      index->insert(std::make_pair((*it)->GetLabel(), *it));
+  };
+  
+  // Key used to detect the events already present in the output: same label, frame, context and subject.
+  struct MergedEventKey_p
+  {
+    MergedEventKey_p(Event::Pointer e) : label(e->GetLabel()), frame(e->GetFrame()), context(e->GetContext()), subject(e->GetSubject()) {};
+    bool operator<(const MergedEventKey_p& rhs) const
+    {
+      if (this->frame != rhs.frame) return this->frame < rhs.frame;
+      int c = this->label.compare(rhs.label);
+      if (c != 0) return c < 0;
+      c = this->context.compare(rhs.context);
+      if (c != 0) return c < 0;
+      return this->subject.compare(rhs.subject) < 0;
+    };
+    std::string label;
+    int frame;
+    std::string context;
+    std::string subject;
+  };
+  
   /**
    * @class MergeAcquisitionFilter btkMergeAcquisitionFilter.h
    * @brief Merges or concatenates two or more btk::Acquisition objects into a single new one.
@@ -401,9 +432,11 @@ namespace btk
         // are exactly the same.
         if (mergeData)
         {
+          std::map<std::string, Point::Pointer> points;
+          IndexLabels_p(output->GetPoints().get(), &points);
           for (Acquisition::PointIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
           {
-            if (output->FindPoint((*it)->GetLabel()) == output->EndPoint())
+            if (points.find((*it)->GetLabel()) == points.end())
             {
               mergeData = false;
               break;
@@ -412,9 +445,11 @@ namespace btk
         }
         if (mergeData)
         {
+          std::map<std::string, Analog::Pointer> analogs;
+          IndexLabels_p(output->GetAnalogs().get(), &analogs);
           for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
           {
-            if (output->FindAnalog((*it)->GetLabel()) == output->EndAnalog())
+            if (analogs.find((*it)->GetLabel()) == analogs.end())
             {
               mergeData = false;
               break;
@@ -427,25 +462,28 @@ namespace btk
           this->ConcatData(output, input);
         
         // Event
+        // The output's events are indexed once: the events already present are found by their key 
+        // and a new event takes the ID of the last output's event with the same label.
+        std::set<MergedEventKey_p> eventKeys;
+        std::map<std::string, int> eventIds;
+        for (Acquisition::EventIterator itOut = output->BeginEvent() ; itOut != output->EndEvent() ; ++itOut)
+        {
+          eventKeys.insert(MergedEventKey_p(*itOut));
+          eventIds[(*itOut)->GetLabel()] = (*itOut)->GetId();
+        }
         for (Acquisition::EventIterator itIn = input->BeginEvent() ; itIn != input->EndEvent() ; ++itIn)
         {
           // Compute the event's time if necessary (for example, if the acquisition comes from an XLS file).
           if (((*itIn)->GetTime() + 1.0)  <= std::numeric_limits<double>::epsilon())
             (*itIn)->SetTime(static_cast<double>((*itIn)->GetFrame() - 1) / output->GetPointFrequency());
-          Acquisition::EventIterator itOut;
-          for (itOut = output->BeginEvent() ; itOut != output->EndEvent() ; ++itOut)
-          {
-            if ((*itIn)->GetLabel().compare((*itOut)->GetLabel()) == 0)
-            {
-              if (((*itIn)->GetFrame() == (*itOut)->GetFrame())
-                  && ((*itIn)->GetContext().compare((*itOut)->GetContext()) == 0)
-                  && ((*itIn)->GetSubject().compare((*itOut)->GetSubject()) == 0))
-                break;
-              (*itIn)->SetId((*itOut)->GetId());
-            }
-          }
-          if (itOut == output->EndEvent())
-            output->AppendEvent(*itIn);
+          if (!eventKeys.insert(MergedEventKey_p(*itIn)).second)
+            continue;
+          std::map<std::string, int>::const_iterator itId = eventIds.find((*itIn)->GetLabel());
+          if (itId != eventIds.end())
+            (*itIn)->SetId(itId->second);
+          else
+            eventIds[(*itIn)->GetLabel()] = (*itIn)->GetId();
+          output->AppendEvent(*itIn);
         }
         
         // Metadata
@@ -522,16 +560,20 @@ namespace btk
     else
       startFrame = output->GetFirstFrame() - 1;
     
+    std::map<std::string, Point::Pointer> points;
+    IndexLabels_p(output->GetPoints().get(), &points);
     for (Acquisition::PointIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
     {
-      Point::Pointer p = *(output->FindPoint((*it)->GetLabel()));
+      Point::Pointer p = points[(*it)->GetLabel()];
       p->GetValues().block(startFrame, 0, oldInputNumFrames, 3) = (*it)->GetValues().block(startFrame, 0, oldInputNumFrames, 3);
       p->GetResiduals().block(startFrame, 0, oldInputNumFrames, 1) = (*it)->GetResiduals().block(startFrame, 0, oldInputNumFrames, 1);
     }
     // Analog
+    std::map<std::string, Analog::Pointer> analogs;
+    IndexLabels_p(output->GetAnalogs().get(), &analogs);
     for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
     {
-      Analog::Pointer ac = *(output->FindAnalog((*it)->GetLabel()));
+      Analog::Pointer ac = analogs[(*it)->GetLabel()];
       ac->GetValues().block(startFrame * input->GetNumberAnalogSamplePerFrame(), 0, oldInputNumFrames * input->GetNumberAnalogSamplePerFrame(), 1) = (*it)->GetValues().block(startFrame * input->GetNumberAnalogSamplePerFrame(), 0, oldInputNumFrames * input->GetNumberAnalogSamplePerFrame(), 1);
     }
   };
@@ -539,6 +581,8 @@ namespace btk
   void MergeAcquisitionFilter::ConcatData(Acquisition::Pointer output, Acquisition::Pointer input) const
   {
     // Point
+    std::map<std::string, Point::Pointer> points;
+    IndexLabels_p(output->GetPoints().get(), &points);
     for (Acquisition::PointIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
     {
       std::string suffix = "";
@@ -546,7 +590,7 @@ namespace btk
       while (1)
       {
         (*it)->SetLabel((*it)->GetLabel() + suffix);
-        if (output->FindPoint((*it)->GetLabel()) == output->EndPoint())
+        if (points.insert(std::make_pair((*it)->GetLabel(), *it)).second)
         {
           output->AppendPoint(*it);
           break;
@@ -556,6 +600,8 @@ namespace btk
       }
     }
     // Analog
+    std::map<std::string, Analog::Pointer> analogs;
+    IndexLabels_p(output->GetAnalogs().get(), &analogs);
     for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
     {
       std::string suffix = "";
@@ -563,7 +609,7 @@ namespace btk
       while (1)
       {
         (*it)->SetLabel((*it)->GetLabel() + suffix);
-        if (output->FindAnalog((*it)->GetLabel()) == output->EndAnalog())
+        if (analogs.insert(std::make_pair((*it)->GetLabel(), *it)).second)
         {
           output->AppendAnalog(*it);
           break;
@@ -0,0 +1,426 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkResampleFilter.h"
+#include "btkThread_p.h"
+
+#include <btkEigen/SignalProcessing/Resample.h>
+
+// Minimum number of input samples given to each thread.
+static const int _btk_resample_thread_minimum_size = 65536;
+
+namespace btk
+{
+  struct ResampleChannel_p
+  {
+    const double* input;
+    double* output;
+  };
+  
+  struct ResampleChannelRange_p
+  {
+    const btkEigen::PolyphaseResampler* resampler;
+    const ResampleChannel_p* channels;
+    int channelNumber;
+    int sampleNumber;
+  };
+  
+  /**
+   * Resamples the channels of the range given in @a data (pointer to a ResampleChannelRange_p object).
+   */
+  static void ResampleRange_p(void* data)
+  {
+    const ResampleChannelRange_p* range = static_cast<const ResampleChannelRange_p*>(data);
+    for (int i = 0 ; i < range->channelNumber ; ++i)
+      range->resampler->Process(range->channels[i].input, range->sampleNumber, range->channels[i].output);
+  };
+  
+  /**
+   * Resamples all the @a channels (each one has @a sampleNumber input samples) with the same resampler.
+   * The channels are distributed in contiguous ranges between at most @a numberOfThreads threads.
+   */
+  static void ResampleChannels_p(const btkEigen::PolyphaseResampler& resampler, const std::vector<ResampleChannel_p>& channels, int sampleNumber, int numberOfThreads)
+  {
+    const int channelNumber = static_cast<int>(channels.size());
+    if ((channelNumber == 0) || (sampleNumber == 0))
+      return;
+    int num = (numberOfThreads < 1) ? thread_p::GetNumberOfProcessors() : numberOfThreads;
+    const int maxThreads = static_cast<int>(static_cast<long long>(channelNumber) * sampleNumber / _btk_resample_thread_minimum_size);
+    num = std::max(1, std::min(std::min(num, maxThreads), channelNumber));
+    std::vector<ResampleChannelRange_p> ranges(num);
+    for (int i = 0 ; i < num ; ++i)
+    {
+      const int first = channelNumber * i / num;
+      ranges[i].resampler = &resampler;
+      ranges[i].channels = &(channels[first]);
+      ranges[i].channelNumber = channelNumber * (i + 1) / num - first;
+      ranges[i].sampleNumber = sampleNumber;
+    }
+    if (num == 1)
+    {
+      ResampleRange_p(&(ranges[0]));
+      return;
+    }
+    // The last range is resampled in the calling thread.
+    thread_p* threads = new thread_p[num - 1];
+    for (int i = 0 ; i < num - 1 ; ++i)
+      threads[i].Start(&ResampleRange_p, &(ranges[i]));
+    ResampleRange_p(&(ranges[num - 1]));
+    for (int i = 0 ; i < num - 1 ; ++i)
+      threads[i].Join();
+    delete[] threads;
+  };
+  
+  /**
+   * Sets the number of frames of @a output, copies the information of @a input and appends its channel to @a channels.
+   */
+  static void PrepareResampledAnalog_p(const btkEigen::PolyphaseResampler& resampler, Analog::ConstPointer input, Analog::Pointer output, std::vector<ResampleChannel_p>* channels)
+  {
+    output->SetLabel(input->GetLabel());
+    output->SetDescription(input->GetDescription());
+    output->SetUnit(input->GetUnit());
+    output->SetGain(input->GetGain());
+    output->SetOffset(input->GetOffset());
+    output->SetScale(input->GetScale());
+    output->SetFrameNumber(resampler.GetOutputLength(input->GetFrameNumber()));
+    if (output->GetFrameNumber() == 0)
+      return;
+    ResampleChannel_p channel = {input->GetValues().data(), output->GetValues().data()};
+    channels->push_back(channel);
+  };
+  
+  /**
+   * Sets the number of frames of @a output, copies the information of @a input (as well as the residual of the closest input frame) and appends its three channels to @a channels.
+   * The output frames computed with at least one occluded input frame are set as occluded (residual equals to -1). 
+   * Their values must be set to zero after the resampling (see ClearOccludedFrames_p()).
+   */
+  static void PrepareResampledPoint_p(const btkEigen::PolyphaseResampler& resampler, Point::ConstPointer input, Point::Pointer output, std::vector<ResampleChannel_p>* channels)
+  {
+    output->SetLabel(input->GetLabel());
+    output->SetDescription(input->GetDescription());
+    output->SetType(input->GetType());
+    const int n = input->GetFrameNumber();
+    const int m = resampler.GetOutputLength(n);
+    output->SetFrameNumber(m);
+    if (m == 0)
+      return;
+    const Point::Residuals& residualsIn = input->GetResiduals();
+    Point::Residuals& residualsOut = output->GetResiduals();
+    // Number of occluded input frames before each frame
+    std::vector<int> occluded(n + 1, 0);
+    for (int i = 0 ; i < n ; ++i)
+      occluded[i+1] = occluded[i] + ((residualsIn.coeff(i) < 0.0) ? 1 : 0);
+    int first = 0, last = 0;
+    for (int k = 0 ; k < m ; ++k)
+    {
+      resampler.GetInputRange(k, n, &first, &last);
+      if (occluded[last+1] != occluded[first])
+      {
+        residualsOut.coeffRef(k) = -1.0;
+        continue;
+      }
+      const long long j = (2LL * k * resampler.GetDown() + resampler.GetUp()) / (2LL * resampler.GetUp());
+      residualsOut.coeffRef(k) = residualsIn.coeff(static_cast<int>(std::min(j, static_cast<long long>(n - 1))));
+    }
+    const double* valuesIn = input->GetValues().data();
+    double* valuesOut = output->GetValues().data();
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      ResampleChannel_p channel = {valuesIn + i * n, valuesOut + i * m};
+      channels->push_back(channel);
+    }
+  };
+  
+  /**
+   * Sets to zero the values of the occluded frames of the resampled point @a output.
+   */
+  static void ClearOccludedFrames_p(Point::Pointer output)
+  {
+    if (output->GetFrameNumber() == 0)
+      return;
+    const Point::Residuals& residuals = static_cast<Point::ConstPointer>(output)->GetResiduals();
+    Point::Values& values = output->GetValues();
+    for (int k = 0 ; k < residuals.rows() ; ++k)
+    {
+      if (residuals.coeff(k) < 0.0)
+        values.row(k).setZero();
+    }
+  };
+  
+  /**
+   * Sets to zero the values of the occluded frames of the three points of the resampled wrench @a output.
+   */
+  static void ClearOccludedFrames_p(Wrench::Pointer output)
+  {
+    ClearOccludedFrames_p(output->GetPosition());
+    ClearOccludedFrames_p(output->GetForce());
+    ClearOccludedFrames_p(output->GetMoment());
+  };
+  
+  /**
+   * Prepares the resampling of the three points of the wrench @a input.
+   */
+  static void PrepareResampledWrench_p(const btkEigen::PolyphaseResampler& resampler, Wrench::Pointer input, Wrench::Pointer output, std::vector<ResampleChannel_p>* channels)
+  {
+    PrepareResampledPoint_p(resampler, input->GetPosition(), output->GetPosition(), channels);
+    PrepareResampledPoint_p(resampler, input->GetForce(), output->GetForce(), channels);
+    PrepareResampledPoint_p(resampler, input->GetMoment(), output->GetMoment(), channels);
+  };
+  
+  /**
+   * Returns the number of frames of the analog channel @a input.
+   */
+  static int GetFrameNumber_p(const Analog::Pointer& input)
+  {
+    return input->GetFrameNumber();
+  };
+  
+  /**
+   * Returns the number of frames of the point @a input.
+   */
+  static int GetFrameNumber_p(const Point::Pointer& input)
+  {
+    return input->GetFrameNumber();
+  };
+  
+  /**
+   * Returns the number of frames of the wrench @a input (the one of its position).
+   */
+  static int GetFrameNumber_p(const Wrench::Pointer& input)
+  {
+    return input->GetPosition()->GetFrameNumber();
+  };
+  
+  /**
+   * Sets in @a frameNumber the number of frames of the items of the collection @a input (-1 if it is empty).
+   * Returns false if the items have not the same number of frames.
+   */
+  template <class T>
+  static bool GetCollectionFrameNumber_p(typename T::ConstPointer input, int* frameNumber)
+  {
+    *frameNumber = -1;
+    for (typename T::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      const int n = GetFrameNumber_p(*it);
+      if (*frameNumber == -1)
+        *frameNumber = n;
+      else if (*frameNumber != n)
+        return false;
+    }
+    return true;
+  };
+  
+  /**
+   * Specialized version to resample an analog channel.
+   */
+  template <>
+  void ResampleData<Analog>(int up, int down, int numberOfThreads, Analog::Pointer input, Analog::Pointer output)
+  {
+    btkEigen::PolyphaseResampler resampler(up, down);
+    std::vector<ResampleChannel_p> channels;
+    PrepareResampledAnalog_p(resampler, input, output, &channels);
+    ResampleChannels_p(resampler, channels, input->GetFrameNumber(), numberOfThreads);
+  };
+  
+  /**
+   * Specialized version to resample a collection of analog channels. 
+   * All the channels must have the same number of frames. Otherwise, the output is cleared.
+   */
+  template <>
+  void ResampleData<AnalogCollection>(int up, int down, int numberOfThreads, AnalogCollection::Pointer input, AnalogCollection::Pointer output)
+  {
+    int n = -1;
+    if (!GetCollectionFrameNumber_p<AnalogCollection>(input, &n))
+    {
+      btkErrorMacro("The analog channels must have the same number of frames.");
+      output->Clear();
+      return;
+    }
+    btkEigen::PolyphaseResampler resampler(up, down);
+    std::vector<ResampleChannel_p> channels;
+    output->SetItemNumber(input->GetItemNumber());
+    AnalogCollection::ConstIterator itIn = input->Begin();
+    AnalogCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      if (!(*itOut))
+        *itOut = Analog::New();
+      PrepareResampledAnalog_p(resampler, *itIn, *itOut, &channels);
+      ++itIn;
+      ++itOut;
+    }
+    ResampleChannels_p(resampler, channels, n, numberOfThreads);
+  };
+  
+  /**
+   * Specialized version to resample a point.
+   */
+  template <>
+  void ResampleData<Point>(int up, int down, int numberOfThreads, Point::Pointer input, Point::Pointer output)
+  {
+    btkEigen::PolyphaseResampler resampler(up, down);
+    std::vector<ResampleChannel_p> channels;
+    PrepareResampledPoint_p(resampler, input, output, &channels);
+    ResampleChannels_p(resampler, channels, input->GetFrameNumber(), numberOfThreads);
+    ClearOccludedFrames_p(output);
+  };
+  
+  /**
+   * Specialized version to resample a collection of points.
+   * All the points must have the same number of frames. Otherwise, the output is cleared.
+   */
+  template <>
+  void ResampleData<PointCollection>(int up, int down, int numberOfThreads, PointCollection::Pointer input, PointCollection::Pointer output)
+  {
+    int n = -1;
+    if (!GetCollectionFrameNumber_p<PointCollection>(input, &n))
+    {
+      btkErrorMacro("The points must have the same number of frames.");
+      output->Clear();
+      return;
+    }
+    btkEigen::PolyphaseResampler resampler(up, down);
+    std::vector<ResampleChannel_p> channels;
+    output->SetItemNumber(input->GetItemNumber());
+    PointCollection::ConstIterator itIn = input->Begin();
+    PointCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      if (!(*itOut))
+        *itOut = Point::New();
+      PrepareResampledPoint_p(resampler, *itIn, *itOut, &channels);
+      ++itIn;
+      ++itOut;
+    }
+    ResampleChannels_p(resampler, channels, n, numberOfThreads);
+    for (PointCollection::Iterator it = output->Begin() ; it != output->End() ; ++it)
+      ClearOccludedFrames_p(*it);
+  };
+  
+  /**
+   * Specialized version to resample a wrench.
+   */
+  template <>
+  void ResampleData<Wrench>(int up, int down, int numberOfThreads, Wrench::Pointer input, Wrench::Pointer output)
+  {
+    btkEigen::PolyphaseResampler resampler(up, down);
+    std::vector<ResampleChannel_p> channels;
+    PrepareResampledWrench_p(resampler, input, output, &channels);
+    ResampleChannels_p(resampler, channels, input->GetPosition()->GetFrameNumber(), numberOfThreads);
+    ClearOccludedFrames_p(output);
+  };
+  
+  /**
+   * Specialized version to resample a collection of wrenches.
+   * All the wrenches must have the same number of frames. Otherwise, the output is cleared.
+   */
+  template <>
+  void ResampleData<WrenchCollection>(int up, int down, int numberOfThreads, WrenchCollection::Pointer input, WrenchCollection::Pointer output)
+  {
+    int n = -1;
+    if (!GetCollectionFrameNumber_p<WrenchCollection>(input, &n))
+    {
+      btkErrorMacro("The wrenches must have the same number of frames.");
+      output->Clear();
+      return;
+    }
+    btkEigen::PolyphaseResampler resampler(up, down);
+    std::vector<ResampleChannel_p> channels;
+    output->SetItemNumber(input->GetItemNumber());
+    WrenchCollection::ConstIterator itIn = input->Begin();
+    WrenchCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      if (!(*itOut))
+        *itOut = Wrench::New((*itIn)->GetPosition()->GetLabel());
+      PrepareResampledWrench_p(resampler, *itIn, *itOut, &channels);
+      ++itIn;
+      ++itOut;
+    }
+    ResampleChannels_p(resampler, channels, n, numberOfThreads);
+    for (WrenchCollection::Iterator it = output->Begin() ; it != output->End() ; ++it)
+      ClearOccludedFrames_p(*it);
+  };
+  
+  /**
+   * Specialized version to resample the analog channels of an acquisition.
+   * The points, the events and the metadata are copied. The number of analog samples per point frame is multiplied by the ratio
+   * and the parameter ANALOG:RATE is updated if it exists.
+   */
+  template <>
+  void ResampleData<Acquisition>(int up, int down, int numberOfThreads, Acquisition::Pointer input, Acquisition::Pointer output)
+  {
+    btkEigen::PolyphaseResampler resampler(up, down);
+    int numberAnalogSamplePerFrame = input->GetNumberAnalogSamplePerFrame();
+    if ((numberAnalogSamplePerFrame * resampler.GetUp()) % resampler.GetDown() != 0)
+    {
+      btkErrorMacro("The number of analog samples per frame must stay an integer after the resampling. The analog channels are not resampled.");
+      resampler = btkEigen::PolyphaseResampler(1, 1);
+    }
+    else
+      numberAnalogSamplePerFrame = numberAnalogSamplePerFrame * resampler.GetUp() / resampler.GetDown();
+    
+    output->Reset();
+    output->Init(0, input->GetPointFrameNumber(), 0, numberAnalogSamplePerFrame);
+    output->SetPointUnits(input->GetPointUnits());
+    // The values of the cloned points are shared with the input.
+    for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+      output->AppendPoint((*it)->Clone());
+    std::vector<ResampleChannel_p> channels;
+    for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+    {
+      Analog::Pointer ac = Analog::New();
+      output->AppendAnalog(ac);
+      PrepareResampledAnalog_p(resampler, *it, ac, &channels);
+    }
+    ResampleChannels_p(resampler, channels, input->GetAnalogFrameNumber(), numberOfThreads);
+    
+    output->SetMetaData(input->GetMetaData()->Clone());
+    MetaData::Iterator itAnalog = output->GetMetaData()->FindChild("ANALOG");
+    if (itAnalog != output->GetMetaData()->End())
+    {
+      MetaData::Iterator itRate = (*itAnalog)->FindChild("RATE");
+      if (itRate != (*itAnalog)->End())
+        (*itRate)->GetInfo()->SetValues(static_cast<float>(input->GetPointFrequency() * static_cast<double>(numberAnalogSamplePerFrame)));
+    }
+    
+    output->SetFirstFrame(input->GetFirstFrame());
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointFrequency(input->GetPointFrequency());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->Resize(input->GetPointNumber(), input->GetPointFrameNumber(), input->GetAnalogNumber(), numberAnalogSamplePerFrame);
+    output->SetEvents(input->GetEvents()->Clone());
+  };
+};
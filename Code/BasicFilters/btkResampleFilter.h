@@ -0,0 +1,277 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkResampleFilter_h
+#define __btkResampleFilter_h
+
+#include "btkProcessObject.h"
+#include "btkAcquisition.h"
+#include "btkWrenchCollection.h"
+#include "btkLogger.h"
+
+namespace btk
+{
+  template <class T>
+  class ResampleFilter : public ProcessObject
+  {
+  public:
+    typedef btkSharedPtr<ResampleFilter> Pointer;
+    typedef btkSharedPtr<const ResampleFilter> ConstPointer;
+       
+    typedef typename T::Pointer ItemPointer;
+    typedef typename T::ConstPointer ItemConstPointer;    
+    
+    static Pointer New() {return Pointer(new ResampleFilter());};
+    
+    virtual ~ResampleFilter() {};
+    
+    ItemPointer GetInput() {return this->GetInput(0);};
+    void SetInput(ItemPointer input) {this->SetNthInput(0, input);};
+    ItemPointer GetOutput() {return this->GetOutput(0);};
+    
+    int GetUpRatio() const {return this->m_Up;};
+    int GetDownRatio() const {return this->m_Down;};
+    void SetUpDownRatio(int up, int down);
+    int GetNumberOfThreads() const {return this->m_NumberOfThreads;};
+    void SetNumberOfThreads(int num);
+    
+  protected:
+    ResampleFilter();
+    
+    ItemPointer GetInput(int idx) {return static_pointer_cast<T>(this->GetNthInput(idx));};
+    ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
+    virtual DataObject::Pointer MakeOutput(int idx);
+    virtual void GenerateData();
+    
+  private:
+    ResampleFilter(const ResampleFilter& ); // Not implemented.
+    ResampleFilter& operator=(const ResampleFilter& ); // Not implemented.
+    
+    int m_Up;
+    int m_Down;
+    int m_NumberOfThreads;
+  };
+  
+  /**
+   * @class ResampleFilter btkResampleFilter.h
+   * @brief Resample the data stored in the given input by a rational factor using an anti-aliasing polyphase filter.
+   * @tparam T Must be a class inheriting of btk::DataObject
+   *
+   * The number of samples is multiplied by the ratio set with the method SetUpDownRatio(). 
+   * For example, to bring analog data sampled at 1000 Hz to 120 Hz, the ratio must be set to 3/25 (or 120/1000).
+   * Compared to the class DownsampleFilter, the data are lowpass filtered before to be decimated (no aliasing) and the ratio does not need to be an integer.
+   * The FIR filter is designed as in the function resample_poly of SciPy (see btkEigen::PolyphaseResampler).
+   *
+   * The filter is designed once for each update and shared by all the channels of the input. 
+   * The channels can be resampled in parallel by setting a number of threads greater than 1 (see SetNumberOfThreads()).
+   *
+   * This class is specialized for the following classes:
+   *  - btk::Analog and btk::AnalogCollection;
+   *  - btk::Point and btk::PointCollection (the residuals are not filtered: the residual of the closest input frame is used);
+   *  - btk::Wrench and btk::WrenchCollection;
+   *  - btk::Acquisition: only the analog channels are resampled and the number of analog samples per point frame is updated (as well as the parameter ANALOG:RATE if it exists).
+   *    The new number of samples per frame must be an integer, otherwise the input is only copied and an error is reported.
+   *
+   * @note The occluded frames of the points are not interpolated before the resampling. 
+   * The output frames computed with at least one occluded input frame are then set as occluded (residual equals to -1 and values set to 0).
+   * The gaps are then enlarged by the length of the filter.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::Pointer
+   * Smart pointer associated with a ResampleFilter object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ConstPointer
+   * Smart pointer associated with a const ResampleFilter object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ItemPointer
+   * Smart pointer associated with a T object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ItemConstPointer
+   * Smart const pointer associated with a T object.
+   */
+  
+  /**
+   * @fn template <class T> static Pointer ResampleFilter<T>::New();
+   * Creates a smart pointer associated with a ResampleFilter<T> object.
+   */
+  
+  /**
+   * @fn template <class T> virtual ResampleFilter<T>::~ResampleFilter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn template <class T> void ResampleFilter<T>::SetInput(ItemPointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn template <class T> int ResampleFilter<T>::GetUpRatio() const
+   * Gets the upsampling factor of the ratio.
+   */
+  
+  /**
+   * @fn template <class T> int ResampleFilter<T>::GetDownRatio() const
+   * Gets the downsampling factor of the ratio.
+   */
+  
+  /**
+   * Sets the ratio @a up / @a down used to resample the data. Both values must be greater than 0.
+   */
+  template <class T>
+  void ResampleFilter<T>::SetUpDownRatio(int up, int down)
+  {
+    if ((up <= 0) || (down <= 0))
+    {
+      btkErrorMacro("The factors of the ratio must be greater than 0.");
+      return;
+    }
+    if ((this->m_Up == up) && (this->m_Down == down))
+      return;
+    this->m_Up = up;
+    this->m_Down = down;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> int ResampleFilter<T>::GetNumberOfThreads() const
+   * Returns the number of threads used to resample the channels.
+   */
+  
+  /**
+   * Sets the number of threads used to resample the channels. 
+   * A value lower than 1 uses one thread per processor. By default, only one thread is used.
+   */
+  template <class T>
+  void ResampleFilter<T>::SetNumberOfThreads(int num)
+  {
+    if (this->m_NumberOfThreads == num)
+      return;
+    this->m_NumberOfThreads = num;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  template <class T>
+  ResampleFilter<T>::ResampleFilter()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Up = 1;
+    this->m_Down = 1;
+    this->m_NumberOfThreads = 1;
+  };
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a T:Pointer object and return it as a DataObject::Pointer.
+   */
+  template <class T>
+  DataObject::Pointer ResampleFilter<T>::MakeOutput(int /* idx */)
+  {
+    return T::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  template <class T>
+  void ResampleFilter<T>::GenerateData()
+  {
+    ItemPointer input = this->GetInput();
+    if (!input)
+    {
+      btkErrorMacro("No input.");
+      return;
+    }
+    ResampleData(this->m_Up, this->m_Down, this->m_NumberOfThreads, input, this->GetOutput());
+    this->GetOutput()->Modified();
+  };
+  
+  /**
+   * Generic method to resample data. Does nothing.
+   */
+  template <class T>
+  inline void ResampleData(int up, int down, int numberOfThreads, btkSharedPtr<T> input, btkSharedPtr<T> output)
+  {
+    btkNotUsed(up);
+    btkNotUsed(down);
+    btkNotUsed(numberOfThreads);
+    btkNotUsed(input);
+    btkNotUsed(output);
+    btkErrorMacro("Generic method. Please specialize it.");
+  };
+  
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<Analog>(int up, int down, int numberOfThreads, Analog::Pointer input, Analog::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<AnalogCollection>(int up, int down, int numberOfThreads, AnalogCollection::Pointer input, AnalogCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<Point>(int up, int down, int numberOfThreads, Point::Pointer input, Point::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<PointCollection>(int up, int down, int numberOfThreads, PointCollection::Pointer input, PointCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<Wrench>(int up, int down, int numberOfThreads, Wrench::Pointer input, Wrench::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<WrenchCollection>(int up, int down, int numberOfThreads, WrenchCollection::Pointer input, WrenchCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<Acquisition>(int up, int down, int numberOfThreads, Acquisition::Pointer input, Acquisition::Pointer output);
+};
+
+#endif // __btkResampleFilter_h
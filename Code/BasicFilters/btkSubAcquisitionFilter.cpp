@@ -39,6 +39,40 @@
 
 namespace btk
 {
+  // Copies the frames [first, first + frameNumber[ of a point the first time its values are accessed.
+  class SubPointLoader_p : public MeasureDataLoader<Point>
+  {
+  public:
+    SubPointLoader_p(Point::Data::ConstPointer source, int first, int frameNumber) : MeasureDataLoader<Point>(), mp_Source(source), m_First(first), m_FrameNumber(frameNumber) {};
+    virtual int GetFrameNumber() const {return this->m_FrameNumber;};
+    virtual void Load(MeasureData<Point>* data)
+    {
+      Point::Data* pointData = static_cast<Point::Data*>(data);
+      pointData->GetValues() = this->mp_Source->GetValues().block(this->m_First, 0, this->m_FrameNumber, 3);
+      pointData->GetResiduals() = this->mp_Source->GetResiduals().segment(this->m_First, this->m_FrameNumber);
+    };
+  private:
+    Point::Data::ConstPointer mp_Source;
+    int m_First;
+    int m_FrameNumber;
+  };
+  
+  // Copies the samples [first, first + frameNumber[ of an analog channel the first time its values are accessed.
+  class SubAnalogLoader_p : public MeasureDataLoader<Analog>
+  {
+  public:
+    SubAnalogLoader_p(Analog::Data::ConstPointer source, int first, int frameNumber) : MeasureDataLoader<Analog>(), mp_Source(source), m_First(first), m_FrameNumber(frameNumber) {};
+    virtual int GetFrameNumber() const {return this->m_FrameNumber;};
+    virtual void Load(MeasureData<Analog>* data)
+    {
+      data->GetValues() = this->mp_Source->GetValues().segment(this->m_First, this->m_FrameNumber);
+    };
+  private:
+    Analog::Data::ConstPointer mp_Source;
+    int m_First;
+    int m_FrameNumber;
+  };
+  
   /**
    * @class SubAcquisitionFilter btkSubAcquisitionFilter.h
    * @brief Extract a subpart of the acquisition.
@@ -49,6 +83,8 @@ namespace btk
    * To extract a subpart of the acquisition, you have to use the method SetFramesIndex() and give the indices to extract. The index
    * starts from 0 and correspond to the first frame of the acquisition. By default, all the frames are extracted.
    *
+   * With the lazy extraction (see SetLazyExtraction()), the frames of each point and analog channel are copied only when its values are accessed.
+   *
    * Finally, the rest of the acquisition is every time extracted. Thus, the metadata are only shallow copied, and the first frame,
    * acquisition's frequencies, etc. remain the same.
    *
@@ -166,13 +202,35 @@ namespace btk
     this->Modified();
   };
   
+  /**
+   * @fn bool SubAcquisitionFilter::GetLazyExtraction() const
+   * Returns true if the frames of the points and analog channels are extracted only when their values are accessed.
+   */
+  
+  /**
+   * Sets the extraction of the frames as lazy. In this case, the output's points and analog channels are views 
+   * on the input's values (a row block given by the first frame and the number of frames) and their frames are copied the
+   * first time their values are accessed. The views keep the input's values as they were when the filter was updated 
+   * (they are shared with the input until one of them is modified, see MeasureData). 
+   * It is useful to cut an acquisition in many parts (gait cycles, etc.) when only some of them or some of their channels are used.
+   *
+   * The frames' index, the first frame and the events are adapted as with the default extraction.
+   */
+  void SubAcquisitionFilter::SetLazyExtraction(bool enabled)
+  {
+    if (enabled == this->m_LazyExtraction)
+      return;
+    this->m_LazyExtraction = enabled;
+    this->Modified();
+  };
+  
   /**
    * Constructor.
    * By default, the points, the analog channels and the events are extracted all along the acquisition.
    * The metadata are also added in the result.
    */
   SubAcquisitionFilter::SubAcquisitionFilter()
-  : ProcessObject(), m_ExtractionOption(), m_Ids()
+  : ProcessObject(), m_ExtractionOption(), m_Ids(), m_LazyExtraction(false)
   {
     this->mp_FramesIndex[0] = -1;
     this->mp_FramesIndex[1] = -1;
@@ -302,9 +360,21 @@ namespace btk
         point->SetLabel((*it)->GetLabel());
         point->SetDescription((*it)->GetDescription());
         point->SetType((*it)->GetType());
-        point->SetFrameNumber(numFrames);
-        point->SetValues((*it)->GetValues().block(bounds[0],0,numFrames,3));
-        point->SetResiduals((*it)->GetResiduals().block(bounds[0],0,numFrames,1));
+        if (this->m_LazyExtraction && (*it)->GetData())
+        {
+          // The input is loaded before to be cloned: the values are then extracted only once from a lazy input (and not by each window) and shared with the clone.
+          Point::Data::ConstPointer source = (*it)->GetData();
+          source->GetValues();
+          Point::Data::Pointer data = Point::Data::New(0);
+          data->SetLoader(Point::Data::Loader::Pointer(new SubPointLoader_p(source->Clone(), bounds[0], numFrames)));
+          point->SetData(data);
+        }
+        else
+        {
+          point->SetFrameNumber(numFrames);
+          point->SetValues((*it)->GetValues().block(bounds[0],0,numFrames,3));
+          point->SetResiduals((*it)->GetResiduals().block(bounds[0],0,numFrames,1));
+        }
         points->InsertItem(point);
       }
       out->SetPoints(points);
@@ -350,8 +420,20 @@ namespace btk
         analog->SetGain((*it)->GetGain());
         analog->SetOffset((*it)->GetOffset());
         analog->SetScale((*it)->GetScale());
-        analog->SetFrameNumber(numFrames);
-        analog->SetValues((*it)->GetValues().block(bounds[0]*in->GetNumberAnalogSamplePerFrame(),0,numFrames,1));
+        if (this->m_LazyExtraction && (*it)->GetData())
+        {
+          // Same as for the points: the input is loaded only once.
+          Analog::Data::ConstPointer source = (*it)->GetData();
+          source->GetValues();
+          Analog::Data::Pointer data = Analog::Data::New(0);
+          data->SetLoader(Analog::Data::Loader::Pointer(new SubAnalogLoader_p(source->Clone(), bounds[0]*in->GetNumberAnalogSamplePerFrame(), numFrames)));
+          analog->SetData(data);
+        }
+        else
+        {
+          analog->SetFrameNumber(numFrames);
+          analog->SetValues((*it)->GetValues().block(bounds[0]*in->GetNumberAnalogSamplePerFrame(),0,numFrames,1));
+        }
         analogs->InsertItem(analog);
       }
       out->SetAnalogs(analogs);
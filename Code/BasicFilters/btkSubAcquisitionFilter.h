@@ -64,6 +64,8 @@ namespace btk
     BTK_BASICFILTERS_EXPORT void SetExtractionOption(ExtractionOption option);
     ExtractionOption GetExtractionOption(std::list<int>& ids) const {ids = this->m_Ids; return this->m_ExtractionOption;};
     BTK_BASICFILTERS_EXPORT void SetExtractionOption(ExtractionOption option, const std::list<int>& ids);
+    bool GetLazyExtraction() const {return this->m_LazyExtraction;};
+    BTK_BASICFILTERS_EXPORT void SetLazyExtraction(bool enabled);
 
   protected:
     BTK_BASICFILTERS_EXPORT SubAcquisitionFilter();
@@ -84,6 +86,7 @@ namespace btk
     ExtractionOption m_ExtractionOption;
     int mp_FramesIndex[2];
     std::list<int> m_Ids;
+    bool m_LazyExtraction;
   };
 };
 
@@ -53,6 +53,14 @@ namespace btk
    *  - The region of interest where to detect the events (see SetRegionOfInterest()).
    *
    * The algorithm works as following: Based on the region of interest, the maximum is searched. If the maximum is higher than the threshold set, then the frame of the value on the left side of this maximum lower than the threshold is used to create a heel strike event. On the other hand, the value on the right side of the maximum lower than the threshold is used to create a toe-off event.
+   * Thus, at most one stance is detected for each force platform (mode SingleStance, by default).
+   *
+   * For the acquisitions containing several stances on the same platform (e.g. an instrumented treadmill), the mode MultipleStances 
+   * (see SetDetectionMode()) detects every stance in one pass over the vertical force, read in place. A stance starts when the force 
+   * exceeds the threshold plus the hysteresis value (see SetHysteresisValue()) and ends when the force is lower than the threshold. 
+   * As for the single stance mode, the heel strike is set to the last frame lower than the threshold before the stance and 
+   * the toe-off to the first frame lower than the threshold after it. The stances shorter than a minimum duration 
+   * (see SetMinimumStanceDuration()) are discarded. The same algorithm can be used on successive chunks of frames with the class StanceTracker.
    *
    * @note: The design of this class is not perfect as it cannot be used in a pipeline without 
    * to update the part before to know some acquisition's information (first frame, sample frequency, subject's name).
@@ -112,6 +120,69 @@ namespace btk
    * Returns the threshold used to detect gait events.
    */
   
+  /**
+   * @enum VerticalGroundReactionForceGaitEventDetector::DetectionMode
+   * Number of stances detected for each force platform.
+   */
+  /**
+   * @var VerticalGroundReactionForceGaitEventDetector::DetectionMode VerticalGroundReactionForceGaitEventDetector::SingleStance
+   * Detect only the stance containing the maximum of the vertical force.
+   */
+  /**
+   * @var VerticalGroundReactionForceGaitEventDetector::DetectionMode VerticalGroundReactionForceGaitEventDetector::MultipleStances
+   * Detect all the stances.
+   */
+  
+  /**
+   * Sets the number of stances detected for each force platform.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::SetDetectionMode(DetectionMode mode)
+  {
+    if (this->m_DetectionMode == mode)
+      return;
+    this->m_DetectionMode = mode;
+    this->Modified();
+  };
+  
+  /**
+   * @fn DetectionMode VerticalGroundReactionForceGaitEventDetector::GetDetectionMode() const
+   * Returns the number of stances detected for each force platform.
+   */
+  
+  /**
+   * Sets the value added to the threshold to detect the beginning of a stance (only used by the mode MultipleStances).
+   * It avoids the detection of several stances when the force oscillates around the threshold.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::SetHysteresisValue(double hysteresis)
+  {
+    if (this->m_Hysteresis == hysteresis)
+      return;
+    this->m_Hysteresis = hysteresis;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double VerticalGroundReactionForceGaitEventDetector::GetHysteresisValue() const
+   * Returns the value added to the threshold to detect the beginning of a stance.
+   */
+  
+  /**
+   * Sets the minimum number of frames between a heel strike and a toe-off (only used by the mode MultipleStances).
+   * The shorter stances are discarded.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::SetMinimumStanceDuration(int frames)
+  {
+    if (this->m_MinimumStanceDuration == frames)
+      return;
+    this->m_MinimumStanceDuration = frames;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int VerticalGroundReactionForceGaitEventDetector::GetMinimumStanceDuration() const
+   * Returns the minimum number of frames between a heel strike and a toe-off.
+   */
+  
   /**
    * Sets the mapping between the given wrenches and the side of the detected events. If no mapping is given, then all the detected events will be set as "General" events.
    */
@@ -179,6 +250,9 @@ namespace btk
     this->SetInputNumber(1);
     this->SetOutputNumber(1);
     this->m_Threshold = 10; // newtons
+    this->m_DetectionMode = SingleStance;
+    this->m_Hysteresis = 0.0; // newtons
+    this->m_MinimumStanceDuration = 0; // frames
     this->mp_ROI[0] = -1; this->mp_ROI[1] = -1;
     this->m_FirstFrame = 1;
     this->m_FrameRate = 0.0; // Hz
@@ -269,14 +343,40 @@ namespace btk
       if (this->m_FrameRate >= 0.0)
         t = 1.0 / this->m_FrameRate;
       int r = 0, c = 0, num = ub-lb;
-      Eigen::Matrix<double,Eigen::Dynamic,1> fz = (*it)->GetForce()->GetValues().col(2).block(lb,0,num+1,1);
+      // The values are read in place (the const method GetValues() never copies them)
+      Point::ConstPointer force = (*it)->GetForce();
+      const Point::Values& values = force->GetValues();
+      if (this->m_DetectionMode == MultipleStances)
+      {
+        StanceTracker tracker(this->m_Threshold, this->m_Hysteresis, this->m_MinimumStanceDuration);
+        std::vector<int> footStrikes, footOffs;
+        tracker.Process(values.col(2).data() + lb, num+1, &footStrikes, &footOffs);
+        // Chronological order. A foot strike is always before the foot off of the same stance.
+        size_t i = 0, j = 0;
+        while ((i < footStrikes.size()) || (j < footOffs.size()))
+        {
+          if ((j == footOffs.size()) || ((i < footStrikes.size()) && (footStrikes[i] < footOffs[j])))
+          {
+            int frame = footStrikes[i++]+lb+this->m_FirstFrame;
+            output->InsertItem(btk::Event::New("Foot Strike", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the heel strikes the ground", 1));
+          }
+          else
+          {
+            int frame = footOffs[j++]+lb+this->m_FirstFrame;
+            output->InsertItem(btk::Event::New("Foot Off", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the toe leaves the ground", 2));
+          }
+        }
+        ++inc;
+        continue;
+      }
+      Eigen::Map<const Eigen::VectorXd> fz(values.col(2).data() + lb, num+1);
       if (fz.maxCoeff(&r, &c) > this->m_Threshold)
       {
         int incr = r;
         // Heel Strike
         while (incr >= 0)
         {
-          if (fz.coeffRef(incr) < this->m_Threshold)
+          if (fz.coeff(incr) < this->m_Threshold)
           {
             int frame = incr+lb+this->m_FirstFrame; // No need to remove 1 as 'incr' starts from 0
             output->InsertItem(btk::Event::New("Foot Strike", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the heel strikes the ground", 1));
@@ -288,7 +388,7 @@ namespace btk
         incr = r;
         while (incr <= num)
         {
-          if (fz.coeffRef(incr) < this->m_Threshold)
+          if (fz.coeff(incr) < this->m_Threshold)
           {
             int frame = incr+lb+this->m_FirstFrame;
             output->InsertItem(btk::Event::New("Foot Off", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the toe leaves the ground", 2));
@@ -300,4 +400,97 @@ namespace btk
       ++inc;
     }
   };
-}
\ No newline at end of file
+  
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * @class VerticalGroundReactionForceGaitEventDetector::StanceTracker btkVerticalGroundReactionForceGaitEventDetector.h
+   * @brief Incremental detection of the stances in a vertical ground reaction force.
+   *
+   * The values of the force can be given by successive chunks of frames to the method Process() (e.g. during a streaming).
+   * The state of the detection is kept between two calls, so the result is the same than processing all the frames at once.
+   * The detection follows the rules of the mode VerticalGroundReactionForceGaitEventDetector::MultipleStances.
+   * A heel strike is given as soon as the stance lasted the minimum duration and a toe-off at the end of the stance.
+   * The detected frames are zero-based indices counted from the first frame given after the construction or the last call to Reset().
+   */
+  
+  /**
+   * Constructor. Sets the threshold, the hysteresis value (both in newtons) and the minimum stance duration (in frames).
+   */
+  VerticalGroundReactionForceGaitEventDetector::StanceTracker::StanceTracker(double threshold, double hysteresis, int minimumStanceDuration)
+  {
+    this->m_Threshold = threshold;
+    this->m_Hysteresis = hysteresis;
+    this->m_MinimumStanceDuration = minimumStanceDuration;
+    this->Reset();
+  };
+  
+  /**
+   * Restarts the detection. The next given frame will have the index 0.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::StanceTracker::Reset()
+  {
+    this->m_Index = 0;
+    this->m_LastUnloaded = -1;
+    this->m_InStance = false;
+    this->m_Confirmed = false;
+  };
+  
+  /**
+   * Processes the next @a num values of the vertical force @a fz and appends the detected heel strikes and toe-offs to @a footStrikes and @a footOffs.
+   * A heel strike is not detected if no frame lower than the threshold was given before the stance.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::StanceTracker::Process(const double* fz, int num, std::vector<int>* footStrikes, std::vector<int>* footOffs)
+  {
+    const double low = this->m_Threshold, high = this->m_Threshold + this->m_Hysteresis;
+    int i = 0;
+    while (i < num)
+    {
+      if (!this->m_InStance)
+      {
+        // Search the beginning of the next stance
+        for ( ; i < num ; ++i)
+        {
+          if (fz[i] > high)
+            break;
+          else if (fz[i] < low)
+            this->m_LastUnloaded = this->m_Index + i;
+        }
+        if (i == num)
+          break;
+        this->m_InStance = true;
+        this->m_Confirmed = false;
+      }
+      // Search the end of the stance
+      for ( ; i < num ; ++i)
+      {
+        if (!this->m_Confirmed && (this->m_Index + i - this->m_LastUnloaded >= this->m_MinimumStanceDuration))
+        {
+          this->m_Confirmed = true;
+          if (this->m_LastUnloaded >= 0)
+            footStrikes->push_back(this->m_LastUnloaded);
+        }
+        if (fz[i] < low)
+          break;
+      }
+      if (i == num)
+        break;
+      if (this->m_Confirmed)
+        footOffs->push_back(this->m_Index + i);
+      this->m_LastUnloaded = this->m_Index + i;
+      this->m_InStance = false;
+      ++i;
+    }
+    this->m_Index += num;
+  };
+  
+  /**
+   * @fn int VerticalGroundReactionForceGaitEventDetector::StanceTracker::GetProcessedFrameNumber() const
+   * Returns the number of frames processed since the construction or the last call to Reset().
+   */
+  
+  /**
+   * @fn bool VerticalGroundReactionForceGaitEventDetector::StanceTracker::IsInStance() const
+   * Returns true if the last processed frame belongs to a stance.
+   */
+};
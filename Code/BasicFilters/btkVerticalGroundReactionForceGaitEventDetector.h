@@ -50,6 +50,26 @@ namespace btk
   public:
     typedef btkSharedPtr<VerticalGroundReactionForceGaitEventDetector> Pointer;
     typedef btkSharedPtr<const VerticalGroundReactionForceGaitEventDetector> ConstPointer;
+    
+    typedef enum {SingleStance = 0, MultipleStances} DetectionMode;
+    
+    class StanceTracker
+    {
+    public:
+      BTK_BASICFILTERS_EXPORT StanceTracker(double threshold = 10.0, double hysteresis = 0.0, int minimumStanceDuration = 0);
+      BTK_BASICFILTERS_EXPORT void Reset();
+      BTK_BASICFILTERS_EXPORT void Process(const double* fz, int num, std::vector<int>* footStrikes, std::vector<int>* footOffs);
+      int GetProcessedFrameNumber() const {return this->m_Index;};
+      bool IsInStance() const {return this->m_InStance;};
+    private:
+      double m_Threshold;
+      double m_Hysteresis;
+      int m_MinimumStanceDuration;
+      int m_Index;
+      int m_LastUnloaded;
+      bool m_InStance;
+      bool m_Confirmed;
+    };
 
     static Pointer New() {return Pointer(new VerticalGroundReactionForceGaitEventDetector());};
     
@@ -68,6 +88,15 @@ namespace btk
     BTK_BASICFILTERS_EXPORT void SetThresholdValue(int threshold);
     int GetThresholdValue() const {return this->m_Threshold;};
     
+    BTK_BASICFILTERS_EXPORT void SetDetectionMode(DetectionMode mode);
+    DetectionMode GetDetectionMode() const {return this->m_DetectionMode;};
+    
+    BTK_BASICFILTERS_EXPORT void SetHysteresisValue(double hysteresis);
+    double GetHysteresisValue() const {return this->m_Hysteresis;};
+    
+    BTK_BASICFILTERS_EXPORT void SetMinimumStanceDuration(int frames);
+    int GetMinimumStanceDuration() const {return this->m_MinimumStanceDuration;};
+    
     BTK_BASICFILTERS_EXPORT void SetForceplateContextMapping(const std::vector<std::string>& mapping);
     const std::vector<std::string>& GetForceplateContextMapping() const {return this->m_ContextMapping;};
     
@@ -90,6 +119,9 @@ namespace btk
     VerticalGroundReactionForceGaitEventDetector& operator=(const VerticalGroundReactionForceGaitEventDetector& ); // Not implemented.
     
     int m_Threshold;
+    DetectionMode m_DetectionMode;
+    double m_Hysteresis;
+    int m_MinimumStanceDuration;
     std::vector<std::string> m_ContextMapping;
     int mp_ROI[2];
     int m_FirstFrame;
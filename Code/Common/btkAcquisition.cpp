@@ -34,9 +34,12 @@
  */
 
 #include "btkAcquisition.h"
+#include "btkAcquisition_p.h"
 #include "btkException.h"
 #include "btkConvert.h"
 
+#include <algorithm>
+
 namespace btk
 {
   /**
@@ -63,6 +66,15 @@ namespace btk
    *
    * The member used for the maximum interpolation gap is only for information and is not used in the acquisition. It could be used later in a filter to fill gap.
    *
+   * By default, each point stores its values and its residuals in its own matrices. With the storage mode ContiguousPointStorage (see SetPointStorage()),
+   * the values of all the points are stored in one matrix (frames x 3N) and the residuals in another one (frames x N). These matrices are accessible with the methods
+   * GetPointValuesBlock() and GetPointResidualsBlock() and can be used to process all the points together (frame extraction, gap detection, rigid body fitting, ...).
+   * In this mode, the values of a point are copied from the block only when they are accessed individually (Point::GetValues(), Point::GetResiduals(), ...).
+   * The point is then stored separately until the next access to the blocks, which copies back only the points stored separately and modified since their copy.
+   * If only the columns of the point were modified in the blocks (with a reference kept from a previous access), these columns are kept.
+   * If both were modified, the individual modifications are kept and a warning is sent.
+   * To process the points without any copy, use directly their columns in the blocks. 
+   *
    * @ingroup BTKCommon
    */
   
@@ -91,6 +103,29 @@ namespace btk
    * 16 bits ADC.
    */
 
+  /**
+   * @enum Acquisition::PointStorage
+   * Enums used to specify how the values of the points are stored.
+   */
+  /**
+   * @var Acquisition::PointStorage Acquisition::SeparatePointStorage
+   * Each point has its own matrices (default).
+   */
+  /**
+   * @var Acquisition::PointStorage Acquisition::ContiguousPointStorage
+   * All the points share the same matrices (see GetPointValuesBlock() and GetPointResidualsBlock()).
+   */
+  
+  /**
+   * @typedef Acquisition::PointValuesBlock
+   * Matrix storing the values of all the points (frames x 3N). The columns [3i, 3i+3[ correspond to the point #i.
+   */
+  
+  /**
+   * @typedef Acquisition::PointResidualsBlock
+   * Matrix storing the residuals of all the points (frames x N). The column i corresponds to the point #i.
+   */
+
   /**
    * @typedef Acquisition::Pointer
    * Smart pointer associated with an Acquisition object.
@@ -319,14 +354,7 @@ namespace btk
    */
   Acquisition::EventIterator Acquisition::FindEvent(const std::string& label)
   {
-    EventIterator it = this->BeginEvent();
-    while (it != this->EndEvent())
-    {
-      if ((*it)->GetLabel().compare(label) == 0)
-        break;
-      ++it;
-    }
-    return it;
+    return this->m_Events->FindItem(label);
   };
   
   /**
@@ -336,14 +364,7 @@ namespace btk
    */
   Acquisition::EventConstIterator Acquisition::FindEvent(const std::string& label) const
   {
-    EventConstIterator it = this->BeginEvent();
-    while (it != this->EndEvent())
-    {
-      if ((*it)->GetLabel().compare(label) == 0)
-        break;
-      ++it;
-    }
-    return it;
+    return this->m_Events->FindItem(label);
   };
   
   /**
@@ -540,14 +561,7 @@ namespace btk
    */
   Acquisition::PointIterator Acquisition::FindPoint(const std::string& label)
   {
-    PointIterator it = this->BeginPoint();
-    while (it != this->EndPoint())
-    {
-      if ((*it)->GetLabel().compare(label) == 0)
-        break;
-      ++it;
-    }
-    return it;
+    return this->m_Points->FindItem(label);
   };
   
   /**
@@ -557,14 +571,7 @@ namespace btk
    */
   Acquisition::PointConstIterator Acquisition::FindPoint(const std::string& label) const
   {
-    PointConstIterator it = this->BeginPoint();
-    while (it != this->EndPoint())
-    {
-      if ((*it)->GetLabel().compare(label) == 0)
-        break;
-      ++it;
-    }
-    return it;
+    return this->m_Points->FindItem(label);
   };
 
   /**
@@ -773,14 +780,7 @@ namespace btk
    */
   Acquisition::AnalogIterator Acquisition::FindAnalog(const std::string& label)
   {
-    AnalogIterator it = this->BeginAnalog();
-    while (it != this->EndAnalog())
-    {
-      if ((*it)->GetLabel().compare(label) == 0)
-        break;
-      ++it;
-    }
-    return it;
+    return this->m_Analogs->FindItem(label);
   };
   
   /**
@@ -790,14 +790,7 @@ namespace btk
    */
   Acquisition::AnalogConstIterator Acquisition::FindAnalog(const std::string& label) const
   {
-    AnalogConstIterator it = this->BeginAnalog();
-    while (it != this->EndAnalog())
-    {
-      if ((*it)->GetLabel().compare(label) == 0)
-        break;
-      ++it;
-    }
-    return it;
+    return this->m_Analogs->FindItem(label);
   };
   
   /**
@@ -875,6 +868,15 @@ namespace btk
       (*itAnalog)->SetLabel("uname*" + ToString(inc++));
     this->Modified();
   };
+  
+  /**
+   * Initialize the acquisition as the method Init() and set the storage mode of the points with @a storage.
+   */
+  void Acquisition::Init(int pointNumber, int frameNumber, int analogNumber, int analogSampleNumberPerPointFrame, PointStorage storage)
+  {
+    this->SetPointStorage(storage);
+    this->Init(pointNumber, frameNumber, analogNumber, analogSampleNumberPerPointFrame);
+  };
 
   /**
    * Resize the acquisition with @a pointNumber which have @a frameNumber
@@ -898,6 +900,16 @@ namespace btk
     this->Modified();
   };
   
+  /**
+   * Resize the acquisition as the method Resize() and set the storage mode of the points with @a storage.
+   * The points already stored are moved in the new storage.
+   */
+  void Acquisition::Resize(int pointNumber, int frameNumber, int analogNumber, int analogSampleNumberPerPointFrame, PointStorage storage)
+  {
+    this->SetPointStorage(storage);
+    this->Resize(pointNumber, frameNumber, analogNumber, analogSampleNumberPerPointFrame);
+  };
+  
   /**
    * Resize the number of points.
    * Using this method will set the object as modified even if the given number of points is the same than in the acquisition.
@@ -915,10 +927,13 @@ namespace btk
     const int numPoints = this->GetPointNumber();
     for (int inc = numPoints ; inc < pointNumber ; ++inc)
     {
-      Point::Pointer pt = Point::New(this->m_PointFrameNumber);
+      // With the contiguous storage, the values of the new points are directly allocated in the block.
+      Point::Pointer pt = Point::New((this->m_PointStorage == ContiguousPointStorage) ? 0 : this->m_PointFrameNumber);
       pt->SetParent(this);
       this->m_Points->InsertItem(pt);
     }
+    if (this->m_PointStorage == ContiguousPointStorage)
+      this->PackPoints();
     // Set the object as modified
     this->Modified();
   };
@@ -1014,6 +1029,8 @@ namespace btk
       }
     }
     this->m_PointFrameNumber = frameNumber;
+    if (this->m_PointStorage == ContiguousPointStorage)
+      this->PackPoints();
     this->Modified();
   };
 
@@ -1036,6 +1053,7 @@ namespace btk
     this->m_Events->SetItemNumber(0);
     this->m_Points->SetItemNumber(0);
     this->m_Analogs->SetItemNumber(0);
+    this->mp_PointBlock.reset();
     this->m_FirstFrame = 1;
     this->m_PointFrequency = 0.0;
     this->m_PointFrameNumber = 0;
@@ -1241,6 +1259,87 @@ namespace btk
     this->Modified();
   };
   
+  /**
+   * @fn PointStorage Acquisition::GetPointStorage() const
+   * Returns the storage mode of the points.
+   */
+   
+  /**
+   * Sets the storage mode of the points.
+   *
+   * With the mode ContiguousPointStorage, the points are moved in the blocks returned by GetPointValuesBlock() and GetPointResidualsBlock().
+   * With the mode SeparatePointStorage, each point gets back its own matrices.
+   */
+  void Acquisition::SetPointStorage(PointStorage storage)
+  {
+    if (this->m_PointStorage == storage)
+      return;
+    this->m_PointStorage = storage;
+    if (this->m_PointStorage == ContiguousPointStorage)
+      this->PackPoints();
+    else if (this->mp_PointBlock)
+    {
+      // Only the points still stored in the block are copied. The others (lazy loading, etc.) are not loaded.
+      for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
+      {
+        Point::Data::Pointer data = (*it)->GetData();
+        if (!data)
+          continue;
+        const PointBlockLoader_p* loader = dynamic_cast<const PointBlockLoader_p*>(data->GetLoader().get());
+        if (loader && (loader->GetBlock() == this->mp_PointBlock.get()))
+          data->GetValues();
+      }
+      this->mp_PointBlock.reset();
+    }
+    this->Modified();
+  };
+  
+  /**
+   * Returns the matrix containing the values of all the points (frames x 3N). The columns [3i, 3i+3[ correspond to the point #i.
+   *
+   * The points stored separately since the last call (modified individually, appended, etc.) are copied back in the block. 
+   * A point only read individually is not copied back: the modifications done in the block with a reference obtained before are kept.
+   * Then, the references obtained previously with the methods Point::GetValues() and Point::GetResiduals() are invalidated.
+   * The block must not be resized. Use the methods Resize(), ResizePointNumber() or ResizeFrameNumber() instead.
+   *
+   * An exception is thrown if the storage mode is not ContiguousPointStorage (see SetPointStorage()).
+   */
+  Acquisition::PointValuesBlock& Acquisition::GetPointValuesBlock()
+  {
+    if (this->m_PointStorage != ContiguousPointStorage)
+      throw(LogicError("Acquisition::GetPointValuesBlock: the points are not stored contiguously"));
+    this->PackPoints();
+    return this->mp_PointBlock->values;
+  };
+  
+  /**
+   * Returns the matrix containing the residuals of all the points (frames x N). The column i corresponds to the point #i.
+   *
+   * See the method GetPointValuesBlock() for the details.
+   */
+  Acquisition::PointResidualsBlock& Acquisition::GetPointResidualsBlock()
+  {
+    if (this->m_PointStorage != ContiguousPointStorage)
+      throw(LogicError("Acquisition::GetPointResidualsBlock: the points are not stored contiguously"));
+    this->PackPoints();
+    return this->mp_PointBlock->residuals;
+  };
+
+  /**
+   * @fn MemoryArena::Pointer Acquisition::GetMemoryArena() const
+   * Returns the memory arena used to allocate the content of this acquisition (or a null pointer if there is none).
+   */
+  
+  /**
+   * @fn void Acquisition::SetMemoryArena(MemoryArena::Pointer arena)
+   * Sets the memory arena used to allocate the content of this acquisition.
+   *
+   * The acquisition only keeps a reference on the arena. The objects are allocated inside only when 
+   * it is the current one (see MemoryArena::Scope). For example, the class AcquisitionFileReader
+   * sets the arena used during the reading of a file.
+   * The arena is not copied by the method Clone().
+   */
+
   /**
    * @fn Pointer Acquisition::Clone() const
    * Returns a deep copy of this object.
@@ -1270,6 +1369,7 @@ namespace btk
     this->m_Units[Point::Scalar] = "mm";
     // this->m_Units[Point::Reaction] = "";
     this->m_MaxInterpolationGap = 10;
+    this->m_PointStorage = SeparatePointStorage;
   };
   
   /**
@@ -1280,6 +1380,12 @@ namespace btk
   void Acquisition::SetPointFrameNumber(int frameNumber)
   {
     this->m_PointFrameNumber = frameNumber;
+    // The block is resized without copying each point separately.
+    if (this->m_PointStorage == ContiguousPointStorage)
+    {
+      this->PackPoints();
+      return;
+    }
     PointIterator it = this->BeginPoint();
     while (it != this->EndPoint())
     {
@@ -1324,5 +1430,141 @@ namespace btk
     this->m_AnalogSampleNumberPerPointFrame = toCopy.m_AnalogSampleNumberPerPointFrame;
     this->m_AnalogResolution = toCopy.m_AnalogResolution;
     this->m_MaxInterpolationGap = toCopy.m_MaxInterpolationGap;
+    this->m_PointStorage = toCopy.m_PointStorage;
+    // The cloned points share the block of the copied acquisition until they are packed in a new one.
+    if (this->m_PointStorage == ContiguousPointStorage)
+      this->PackPoints();
+  };
+  
+  /**
+   * Moves the points in a block having the current number of points and frames.
+   * Nothing is done if all the points are already in such block and this one is not shared with another acquisition.
+   * If only some points were stored separately, they are copied back in the current block, without copying the others.
+   */
+  void Acquisition::PackPoints()
+  {
+    const int pointNumber = this->GetPointNumber();
+    const int frameNumber = this->m_PointFrameNumber;
+    // The block is owned by the acquisition and one loader per point. A loader is owned only by the data of its point.
+    bool packed = this->mp_PointBlock
+                  && (this->mp_PointBlock->values.rows() == frameNumber)
+                  && (this->mp_PointBlock->values.cols() == 3 * pointNumber)
+                  && (this->mp_PointBlock.use_count() == pointNumber + 1);
+    for (int i = 0 ; packed && (i < pointNumber) ; ++i)
+    {
+      Point::Data::Pointer data = this->m_Points->GetItem(i)->GetData();
+      Point::Data::Loader::Pointer loader = data ? data->GetLoader() : Point::Data::Loader::Pointer();
+      const PointBlockLoader_p* blockLoader = dynamic_cast<const PointBlockLoader_p*>(loader.get());
+      packed = blockLoader && (blockLoader->GetBlock() == this->mp_PointBlock.get()) && (blockLoader->GetIndex() == i) && (loader.use_count() == 2);
+    }
+    if (packed)
+      return;
+    // The current block is updated in place if the points still stored in it did not move and if it is not shared with
+    // another acquisition. Only the points stored separately since the last packing (individual access, ...) are then copied.
+    PointBlock_p::Pointer block;
+    std::vector<bool> inBlock(pointNumber, false);
+    if (this->mp_PointBlock && (this->mp_PointBlock->values.rows() == frameNumber) && (this->mp_PointBlock->values.cols() == 3 * pointNumber))
+    {
+      bool reusable = true;
+      int inBlockNumber = 0;
+      for (int i = 0 ; reusable && (i < pointNumber) ; ++i)
+      {
+        Point::Data::Pointer data = this->m_Points->GetItem(i)->GetData();
+        Point::Data::Loader::Pointer loader = data ? data->GetLoader() : Point::Data::Loader::Pointer();
+        const PointBlockLoader_p* blockLoader = dynamic_cast<const PointBlockLoader_p*>(loader.get());
+        if (blockLoader && (blockLoader->GetBlock() == this->mp_PointBlock.get()))
+        {
+          reusable = (blockLoader->GetIndex() == i) && (loader.use_count() == 2);
+          inBlock[i] = true;
+          ++inBlockNumber;
+        }
+      }
+      if (reusable && (this->mp_PointBlock.use_count() == inBlockNumber + 1))
+        block = this->mp_PointBlock;
+      else
+        inBlock.assign(pointNumber, false);
+    }
+    if (!block)
+      block = PointBlock_p::Pointer(new PointBlock_p(frameNumber, pointNumber));
+    std::vector<Point::Data::Pointer> data(pointNumber);
+    for (int i = 0 ; i < pointNumber ; ++i)
+    {
+      if (inBlock[i]) // Already at its place.
+        continue;
+      Point::Pointer point = this->m_Points->GetItem(i);
+      data[i] = point->GetData();
+      if (block == this->mp_PointBlock) // Reused block: the column can contain old values.
+      {
+        if (block->copied[i] && data[i] && !data[i]->IsLazy())
+        {
+          // The point was copied out of this block by an individual access. The checksums tell which copy was modified since.
+          Point::Data::ConstPointer constData = data[i];
+          const bool pointModified = (PointBlockChecksum_p(constData->GetValues(), constData->GetResiduals()) != block->checksums[i]);
+          const bool blockModified = (PointBlockChecksum_p(block->values.block(0, 3 * i, frameNumber, 3), block->residuals.col(i)) != block->checksums[i]);
+          if (!pointModified) // The columns in the block are kept (possibly modified with the references given by GetPointValuesBlock() and GetPointResidualsBlock()).
+          {
+            block->copied[i] = false;
+            continue;
+          }
+          else if (blockModified)
+          {
+            btkWarningMacro("The point #" + ToString(i) + " was modified individually and in the block of points. Only its individual modifications are kept.");
+          }
+        }
+        block->copied[i] = false;
+        block->values.block(0, 3 * i, frameNumber, 3).setZero();
+        block->residuals.block(0, i, frameNumber, 1).setZero();
+      }
+      if (!data[i])
+      {
+        data[i] = Point::Data::New(0);
+        point->SetData(data[i]);
+        continue;
+      }
+      const PointBlockLoader_p* blockLoader = dynamic_cast<const PointBlockLoader_p*>(data[i]->GetLoader().get());
+      if (blockLoader) // Still in a block: no need to copy the point separately.
+        blockLoader->CopyTo(block.get(), i);
+      else
+      {
+        // Const access: the values shared with a clone are not copied.
+        Point::Data::ConstPointer constData = data[i];
+        const Point::Values& values = constData->GetValues();
+        const Point::Residuals& residuals = constData->GetResiduals();
+        const int rows = std::min(frameNumber, static_cast<int>(values.rows()));
+        block->values.block(0, 3 * i, rows, 3) = values.topRows(rows);
+        block->residuals.block(0, i, rows, 1) = residuals.head(rows);
+      }
+    }
+    for (int i = 0 ; i < pointNumber ; ++i)
+    {
+      if (!inBlock[i])
+        data[i]->SetLoader(Point::Data::Loader::Pointer(new PointBlockLoader_p(block, i)));
+    }
+    this->mp_PointBlock = block;
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * Copies the columns of the point from its block.
+   */
+  void PointBlockLoader_p::Load(MeasureData<Point>* data)
+  {
+    Point::Data* pointData = static_cast<Point::Data*>(data);
+    pointData->GetValues() = this->mp_Block->values.block(0, 3 * this->m_Index, this->mp_Block->values.rows(), 3);
+    pointData->GetResiduals() = this->mp_Block->residuals.col(this->m_Index);
+    // Used by the next packing to know if the point or its columns were modified (see Acquisition::PackPoints()).
+    this->mp_Block->copied[this->m_Index] = true;
+    this->mp_Block->checksums[this->m_Index] = PointBlockChecksum_p(this->mp_Block->values.block(0, 3 * this->m_Index, this->mp_Block->values.rows(), 3), this->mp_Block->residuals.col(this->m_Index));
+  };
+  
+  /**
+   * Copies the columns of the point in the column @a index of another @a block (only the common frames).
+   */
+  void PointBlockLoader_p::CopyTo(PointBlock_p* block, int index) const
+  {
+    const int rows = static_cast<int>(std::min(block->values.rows(), this->mp_Block->values.rows()));
+    block->values.block(0, 3 * index, rows, 3) = this->mp_Block->values.block(0, 3 * this->m_Index, rows, 3);
+    block->residuals.block(0, index, rows, 1) = this->mp_Block->residuals.block(0, this->m_Index, rows, 1);
   };
 }
@@ -41,15 +41,22 @@
 #include "btkEventCollection.h"
 #include "btkPointCollection.h"
 #include "btkAnalogCollection.h"
+#include "btkMemoryArena.h"
 
 #include <list>
 
 namespace btk
 {
+  class PointBlock_p;
+  
   class Acquisition : public DataObject
   {
   public:
     typedef enum {Bit8 = 8, Bit10 = 10, Bit12 = 12, Bit14 = 14, Bit16 = 16}  AnalogResolution;
+    typedef enum {SeparatePointStorage = 0, ContiguousPointStorage} PointStorage;
+    
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> PointValuesBlock;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> PointResidualsBlock;
 
     typedef btkSharedPtr<Acquisition> Pointer;
     typedef btkSharedPtr<const Acquisition> ConstPointer;
@@ -150,7 +157,9 @@ namespace btk
         
     // Others
     BTK_COMMON_EXPORT void Init(int pointNumber, int frameNumber, int analogNumber = 0, int analogSampleNumberPerPointFrame = 1);
+    BTK_COMMON_EXPORT void Init(int pointNumber, int frameNumber, int analogNumber, int analogSampleNumberPerPointFrame, PointStorage storage);
     BTK_COMMON_EXPORT void Resize(int pointNumber, int frameNumber, int analogNumber = 0, int analogSampleNumberPerPointFrame = 1);
+    BTK_COMMON_EXPORT void Resize(int pointNumber, int frameNumber, int analogNumber, int analogSampleNumberPerPointFrame, PointStorage storage);
     BTK_COMMON_EXPORT void ResizePointNumber(int pointNumber);
     BTK_COMMON_EXPORT void ResizeAnalogNumber(int analogNumber);
     BTK_COMMON_EXPORT void ResizeFrameNumber(int frameNumber);
@@ -176,6 +185,12 @@ namespace btk
     BTK_COMMON_EXPORT void SetAnalogResolution(AnalogResolution r);
     int GetMaxInterpolationGap() const {return this->m_MaxInterpolationGap;};
     BTK_COMMON_EXPORT void SetMaxInterpolationGap(int gap);
+    PointStorage GetPointStorage() const {return this->m_PointStorage;};
+    BTK_COMMON_EXPORT void SetPointStorage(PointStorage storage);
+    BTK_COMMON_EXPORT PointValuesBlock& GetPointValuesBlock();
+    BTK_COMMON_EXPORT PointResidualsBlock& GetPointResidualsBlock();
+    MemoryArena::Pointer GetMemoryArena() const {return this->mp_MemoryArena;};
+    void SetMemoryArena(MemoryArena::Pointer arena) {this->mp_MemoryArena = arena;};
     
     Pointer Clone() const {return Pointer(new Acquisition(*this));};
     
@@ -189,6 +204,8 @@ namespace btk
     BTK_COMMON_EXPORT Acquisition(const Acquisition& toCopy);
     Acquisition& operator=(const Acquisition& ); // Not implemented.
     
+    void PackPoints();
+    
     MetaData::Pointer mp_MetaData;
     EventCollection::Pointer m_Events;
     PointCollection::Pointer m_Points;
@@ -200,6 +217,9 @@ namespace btk
     AnalogResolution m_AnalogResolution;
     std::vector<std::string> m_Units;
     int m_MaxInterpolationGap;
+    PointStorage m_PointStorage;
+    btkSharedPtr<PointBlock_p> mp_PointBlock;
+    MemoryArena::Pointer mp_MemoryArena;
   };
 };
 
@@ -0,0 +1,98 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkAcquisition_p_h
+#define __btkAcquisition_p_h
+
+#include "btkPoint.h"
+
+#include <cstring>
+#include <vector>
+
+namespace btk
+{
+  // Values and residuals of all the points of an acquisition (see Acquisition::ContiguousPointStorage).
+  // The matrices are stored by column: the point #i uses the columns [3i, 3i+3[ of the values and the column i of the residuals.
+  class PointBlock_p
+  {
+  public:
+    typedef btkSharedPtr<PointBlock_p> Pointer;
+    PointBlock_p(int frameNumber, int pointNumber)
+    : values(Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::Zero(frameNumber, 3 * pointNumber)),
+      residuals(Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::Zero(frameNumber, pointNumber)),
+      copied(pointNumber, false), checksums(pointNumber, 0)
+    {};
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> values;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> residuals;
+    std::vector<bool> copied; // True if the point was copied out of the block by an individual access (see PointBlockLoader_p::Load()).
+    std::vector<size_t> checksums; // Checksum of the columns of the point when it was copied (see PointBlockChecksum_p()).
+  };
+  
+  // Checksum of the values and residuals of a point. Used to know if a point copied out of a block or its columns in the block were modified since the copy.
+  template <typename V, typename R>
+  inline size_t PointBlockChecksum_p(const V& values, const R& residuals)
+  {
+    size_t checksum = static_cast<size_t>(values.rows());
+    for (int j = 0 ; j < 4 ; ++j)
+    {
+      for (int i = 0 ; i < static_cast<int>(values.rows()) ; ++i)
+      {
+        const double d = (j < 3) ? values.coeff(i,j) : residuals.coeff(i);
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, &d, sizeof(double));
+        for (size_t k = 0 ; k < sizeof(double) ; ++k)
+          checksum = (checksum ^ bytes[k]) * 16777619u; // FNV-1a
+      }
+    }
+    return checksum;
+  };
+  
+  // Copies the columns of a point stored in a block the first time its values are accessed individually.
+  class PointBlockLoader_p : public MeasureDataLoader<Point>
+  {
+  public:
+    PointBlockLoader_p(PointBlock_p::Pointer block, int index) : MeasureDataLoader<Point>(), mp_Block(block), m_Index(index) {};
+    virtual int GetFrameNumber() const {return static_cast<int>(this->mp_Block->values.rows());};
+    virtual void Load(MeasureData<Point>* data);
+    const PointBlock_p* GetBlock() const {return this->mp_Block.get();};
+    int GetIndex() const {return this->m_Index;};
+    void CopyTo(PointBlock_p* block, int index) const;
+  private:
+    PointBlock_p::Pointer mp_Block;
+    int m_Index;
+  };
+};
+
+#endif // __btkAcquisition_p_h
@@ -132,15 +132,19 @@ namespace btk
   
   inline void MeasureTraits<Analog>::Data::Resize(int frameNumber)
   {
-    if (frameNumber > this->m_Values.rows())
+    this->Load();
+    if (frameNumber > this->mp_Values->rows())
     {
-      Values v = Values::Zero(frameNumber,Values::ColsAtCompileTime);
-      if (this->m_Values.data() != 0)
-        v.block(0,0,this->m_Values.rows(),Values::ColsAtCompileTime) = this->m_Values;
-      this->m_Values = v;
+      MeasureBuffer_p<Values> v(new Values(Values::Zero(frameNumber,Values::ColsAtCompileTime)));
+      if (this->mp_Values->data() != 0)
+        v->block(0,0,this->mp_Values->rows(),Values::ColsAtCompileTime) = *(this->mp_Values);
+      this->mp_Values = v;
     }
     else
-      this->m_Values.conservativeResize(frameNumber);
+    {
+      DetachShared_p(this->mp_Values);
+      this->mp_Values->conservativeResize(frameNumber);
+    }
   };
 };
 
@@ -40,7 +40,10 @@
 #include "btkException.h"
 #include "btkLogger.h"
 
-#include <list>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace btk
 {
@@ -55,8 +58,8 @@ namespace btk
     typedef typename T::Pointer ItemPointer;
     typedef typename T::ConstPointer ItemConstPointer;    
     
-    typedef typename std::list<ItemPointer>::iterator Iterator;
-    typedef typename std::list<ItemPointer>::const_iterator ConstIterator;
+    typedef typename std::vector<ItemPointer>::iterator Iterator;
+    typedef typename std::vector<ItemPointer>::const_iterator ConstIterator;
     
     static Pointer New() {return Pointer(new Collection());};
     
@@ -79,6 +82,9 @@ namespace btk
     ItemConstPointer GetBackItem() const {return this->m_Items.back();};
 
     int GetIndexOf(ItemPointer elt) const;
+    int GetIndexOf(const std::string& label) const;
+    Iterator FindItem(const std::string& label);
+    ConstIterator FindItem(const std::string& label) const;
     ItemPointer GetItem(int idx);
     ItemConstPointer GetItem(int idx) const;
     bool InsertItem(Iterator loc, ItemPointer elt);
@@ -94,19 +100,36 @@ namespace btk
     
   protected:
     Collection()
-    : DataObject(), m_Items()
-    {};
+    : DataObject(), m_Items(), m_LabelIndex()
+    {
+      this->m_LabelIndexedItems = 0;
+      this->m_LabelIndexTimestamp = 0;
+    };
     
   private:
     Collection(const Collection& ); // Not implemented.
     Collection& operator=(const Collection& ); // Not implemented.
     
-    std::list<ItemPointer> m_Items;
+    void ResetLabelIndex() {this->m_LabelIndexedItems = 0;};
+    void UpdateLabelIndex() const;
+    
+    std::vector<ItemPointer> m_Items;
+    mutable std::map<std::string, int> m_LabelIndex;
+    mutable int m_LabelIndexedItems;
+    mutable unsigned long m_LabelIndexTimestamp;
   };
   
   /**
    * @class Collection btkCollection.h
    * @brief List of objects.
+   *
+   * The items are stored contiguously and the access by index is done in constant time.
+   * As for a std::vector, an insertion or a removal invalidates the iterators located after the modified position (all of them if the storage is reallocated).
+   * Then, use the iterator returned by the methods RemoveItem() and InsertItem() when the collection is modified during an iteration.
+   *
+   * For the labeled items (btk::Point, btk::Analog, btk::Event, ...), the method FindItem() uses an index associating each label with
+   * the position of the first item having it. This index is built the first time it is used and then updated with the appended items.
+   * It is rebuilt after the other modifications of the collection or after the modification of the label of an indexed item (see DataObjectLabeled::GetLabelTimestamp()).
    *  
    * @ingroup BTKCommon
    */
@@ -205,6 +228,8 @@ namespace btk
   {
     if (num == this->GetItemNumber())
       return;
+    if (num < this->GetItemNumber())
+      this->ResetLabelIndex();
     this->m_Items.resize(num);
     this->Modified();
   };
@@ -245,17 +270,62 @@ namespace btk
     return -1;
   };
   
+  /**
+   * Return the index of the first item with the label @a label or -1 if not found.
+   * The search uses the label index of the collection (see the detailed description of this class).
+   * @warning The item type must have the methods GetLabel() and GetLabelTimestamp().
+   */
+  template <class T>
+  int Collection<T>::GetIndexOf(const std::string& label) const
+  {
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      this->UpdateLabelIndex();
+      std::map<std::string, int>::const_iterator it = this->m_LabelIndex.find(label);
+      if (it == this->m_LabelIndex.end())
+        return -1;
+      // An item replaced by the use of an iterator cannot be detected before.
+      const ItemPointer& item = this->m_Items[it->second];
+      if (item && (item->GetLabel().compare(label) == 0))
+        return it->second;
+      this->m_LabelIndexedItems = 0;
+    }
+    return -1;
+  };
+  
+  /**
+   * Finds the first item with the label @a label and returns the iterator associated with it.
+   * If no item has @a label as label, an iterator pointing to the end of the collection is returned.
+   * @warning The item type must have a method GetLabel().
+   */
+  template <class T>
+  typename Collection<T>::Iterator Collection<T>::FindItem(const std::string& label)
+  {
+    const int idx = this->GetIndexOf(label);
+    return (idx == -1) ? this->End() : this->Begin() + idx;
+  };
+  
+  /**
+   * Finds the first item with the label @a label and returns the const iterator associated with it.
+   * If no item has @a label as label, a const iterator pointing to the end of the collection is returned.
+   * @warning The item type must have a method GetLabel().
+   */
+  template <class T>
+  typename Collection<T>::ConstIterator Collection<T>::FindItem(const std::string& label) const
+  {
+    const int idx = this->GetIndexOf(label);
+    return (idx == -1) ? this->End() : this->Begin() + idx;
+  };
+  
   /**
    * Returns a smart pointer of the object located at the index @a idx.
    */
   template <class T>
   typename T::Pointer Collection<T>::GetItem(int idx)
   {
-    if (idx >= this->GetItemNumber())
+    if ((idx < 0) || (idx >= this->GetItemNumber()))
       throw(OutOfRangeException("Collection<T>::GetItem(int)"));
-    Iterator it = this->Begin();
-    std::advance(it, idx);
-    return *it;
+    return this->m_Items[idx];
   };
   
   /**
@@ -264,11 +334,9 @@ namespace btk
   template <class T>
   typename T::ConstPointer Collection<T>::GetItem(int idx) const
   {
-    if (idx >= this->GetItemNumber())
+    if ((idx < 0) || (idx >= this->GetItemNumber()))
       throw(OutOfRangeException("Collection<T>::GetItem(int) const"));
-    ConstIterator it = this->Begin();
-    std::advance(it, idx);
-    return *it;
+    return this->m_Items[idx];
   };
   
   /**
@@ -283,6 +351,9 @@ namespace btk
       btkErrorMacro("Impossible to insert an empty entry");
       return false;
     }
+    // The label index is still valid for the appended items.
+    if (loc != this->End())
+      this->ResetLabelIndex();
     this->m_Items.insert(loc, elt);
     this->Modified();
     return true;
@@ -295,14 +366,13 @@ namespace btk
   template <class T>
   bool Collection<T>::InsertItem(int idx, ItemPointer elt)
   {
-    Iterator it = this->Begin();
-    if (idx > static_cast<int>(this->m_Items.size()))
+    Iterator it = this->End();
+    if ((idx < 0) || (idx > static_cast<int>(this->m_Items.size())))
     {
       btkWarningMacro("Out of range, the entry is appended");
-      it = this->End();
     }
     else
-      std::advance(it, idx);
+      it = this->Begin() + idx;
     return this->InsertItem(it, elt);
   };
   
@@ -325,14 +395,13 @@ namespace btk
       btkErrorMacro("Impossible to set an empty entry");
       return false;
     }
-    if (idx >= static_cast<int>(this->m_Items.size()))
+    if ((idx < 0) || (idx >= static_cast<int>(this->m_Items.size())))
     {
       btkErrorMacro("Out of range");
       return false;
     }
-    Iterator it = this->Begin();
-    std::advance(it, idx);
-    *it = elt;
+    this->m_Items[idx] = elt;
+    this->ResetLabelIndex();
     this->Modified();
     return true;
   };
@@ -341,13 +410,14 @@ namespace btk
    * Removes the item at the location @a loc.
    */
   template <class T>
-  typename std::list<typename T::Pointer>::iterator Collection<T>::RemoveItem(Iterator loc)
+  typename Collection<T>::Iterator Collection<T>::RemoveItem(Iterator loc)
   {
     if (loc == this->End())
     {
       btkWarningMacro("Out of range");
       return loc;
     }
+    this->ResetLabelIndex();
     Iterator it = this->m_Items.erase(loc);
     this->Modified();
     return it;
@@ -359,14 +429,13 @@ namespace btk
   template <class T>
   void Collection<T>::RemoveItem(int idx)
   {
-    if (idx >= static_cast<int>(this->m_Items.size()))
+    if ((idx < 0) || (idx >= static_cast<int>(this->m_Items.size())))
     {
       btkWarningMacro("Out of range");
       return;
     }
-    Iterator it = this->Begin();
-    std::advance(it, idx);
-    this->m_Items.erase(it);
+    this->ResetLabelIndex();
+    this->m_Items.erase(this->Begin() + idx);
     this->Modified();
   };
   
@@ -382,6 +451,7 @@ namespace btk
       return ItemPointer();
     }
     ItemPointer p = *loc;
+    this->ResetLabelIndex();
     this->m_Items.erase(loc);
     this->Modified();
     return p;
@@ -393,15 +463,14 @@ namespace btk
   template <class T>
   typename T::Pointer Collection<T>::TakeItem(int idx)
   {
-    if (idx >= static_cast<int>(this->m_Items.size()))
+    if ((idx < 0) || (idx >= static_cast<int>(this->m_Items.size())))
     {
       btkErrorMacro("Out of range");
       return ItemPointer();
     }
-    Iterator it = this->Begin();
-    std::advance(it, idx);
-    ItemPointer p = *it;
-    this->m_Items.erase(it);
+    ItemPointer p = this->m_Items[idx];
+    this->ResetLabelIndex();
+    this->m_Items.erase(this->Begin() + idx);
     this->Modified();
     return p;
   };
@@ -414,6 +483,7 @@ namespace btk
   {
     if (!this->m_Items.empty())
     {
+      this->ResetLabelIndex();
       this->m_Items.clear();
       this->Modified();
     }
@@ -426,10 +496,42 @@ namespace btk
   typename btkSharedPtr< Collection<T> > Collection<T>::Clone() const
   {
     Pointer p = Pointer(new Collection());
+    p->m_Items.reserve(this->m_Items.size());
     for (ConstIterator it = this->Begin() ; it != this->End() ; ++it)
       p->m_Items.push_back((*it)->Clone());
     return p;
   };
+  
+  /**
+   * Indexes the labels of the items appended since the last update.
+   * All the items are indexed if the collection was modified otherwise or if the label of an indexed item was modified.
+   * As the timestamps are increasing, a label modified after the indexing has a timestamp greater than the ones of the indexed labels.
+   */
+  template <class T>
+  void Collection<T>::UpdateLabelIndex() const
+  {
+    for (int i = 0 ; i < this->m_LabelIndexedItems ; ++i)
+    {
+      if (this->m_Items[i] && (this->m_Items[i]->GetLabelTimestamp() > this->m_LabelIndexTimestamp))
+        this->m_LabelIndexedItems = 0; // Ends the loop
+    }
+    if (this->m_LabelIndexedItems == 0)
+    {
+      this->m_LabelIndex.clear();
+      this->m_LabelIndexTimestamp = 0;
+    }
+    const int num = static_cast<int>(this->m_Items.size());
+    for (int i = this->m_LabelIndexedItems ; i < num ; ++i)
+    {
+      // The first item with a label is kept (same behaviour than a linear search).
+      if (this->m_Items[i])
+      {
+        this->m_LabelIndex.insert(std::make_pair(this->m_Items[i]->GetLabel(), i));
+        this->m_LabelIndexTimestamp = std::max(this->m_LabelIndexTimestamp, this->m_Items[i]->GetLabelTimestamp());
+      }
+    }
+    this->m_LabelIndexedItems = num;
+  };
 };
 
 #endif // __btkCollection_h
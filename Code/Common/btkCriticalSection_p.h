@@ -69,6 +69,7 @@ namespace btk
     BTK_COMMON_EXPORT void Unlock();
 
   protected:
+    friend class wait_condition_p;
     btk_critical_section_t m_CS;
   };
 };
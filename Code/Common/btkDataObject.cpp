@@ -186,6 +186,10 @@ namespace btk
    * @var DataObjectLabeled::m_Description
    * Description associated with the object.
    */
+  /**
+   * @var DataObjectLabeled::m_LabelTimestamp
+   * Timestamp of the last modification of the label.
+   */
   
   /**
    * @typedef DataObjectLabeled::Pointer
@@ -221,8 +225,16 @@ namespace btk
       return;
     this->m_Label = label;
     this->Modified();
+    this->m_LabelTimestamp = this->GetTimestamp();
   };
   
+  /**
+   * @fn unsigned long DataObjectLabeled::GetLabelTimestamp() const
+   * Returns the timestamp of the last modification of the label by the method SetLabel() (0 if the label was never modified).
+   *
+   * This value is used by the class Collection to know if its label index is still valid.
+   */
+  
   /**
    * @fn const std::string& DataObjectLabeled::GetDescription() const
    * Returns the description.
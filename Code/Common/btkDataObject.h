@@ -101,17 +101,20 @@ namespace btk
     const std::string& GetDescription() const {return this->m_Description;};
     BTK_COMMON_EXPORT virtual void SetDescription(const std::string& description);
     
+    unsigned long GetLabelTimestamp() const {return this->m_LabelTimestamp;};
+    
   protected:
     DataObjectLabeled(const std::string& label = "", const std::string& description = "")
-    : DataObject(), m_Label(label), m_Description(description)
+    : DataObject(), m_Label(label), m_Description(description), m_LabelTimestamp(0)
     {};
     DataObjectLabeled(const DataObjectLabeled& toCopy)
-    : DataObject(toCopy), m_Label(toCopy.m_Label), m_Description(toCopy.m_Description)
+    : DataObject(toCopy), m_Label(toCopy.m_Label), m_Description(toCopy.m_Description), m_LabelTimestamp(toCopy.m_LabelTimestamp)
     {};
     virtual ~DataObjectLabeled() {};
     
     std::string m_Label;
     std::string m_Description;
+    unsigned long m_LabelTimestamp;
   };
 };
 
@@ -34,13 +34,16 @@
  */
 
 #include "btkLogger.h"
+#include "btkThread_p.h"
 
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 #ifdef NDEBUG
-  static btk::Logger::VerboseMode _btk_logger_verbose_mode = btk::Logger::Normal;
+  static volatile btk::Logger::VerboseMode _btk_logger_verbose_mode = btk::Logger::Normal;
 #else
-  static btk::Logger::VerboseMode _btk_logger_verbose_mode = btk::Logger::Detailed;
+  static volatile btk::Logger::VerboseMode _btk_logger_verbose_mode = btk::Logger::Detailed;
 #endif
 static std::string _btk_logger_prefix = "BTK";
 static std::string _btk_logger_debug_affix = "DEBUG";
@@ -49,9 +52,155 @@ static std::string _btk_logger_error_affix = "ERROR";
 static btk::Logger::Stream::Pointer _btk_logger_debug_stream = btk::Logger::Stream::New(&(std::cout));
 static btk::Logger::Stream::Pointer _btk_logger_warning_stream = btk::Logger::Stream::New(&(std::cerr));
 static btk::Logger::Stream::Pointer _btk_logger_error_stream = btk::Logger::Stream::New(&(std::cerr));
+static btk::critical_section_p _btk_logger_lock; // Protects the settings above and the synchronous writing.
+static BTK_THREAD_LOCAL const std::string* _btk_logger_thread_tag = 0;
 
 namespace btk
 {
+  // Message formatted by a thread and written later by the asynchronous sink.
+  struct LoggerEntry_p
+  {
+    Logger::Stream::Pointer stream;
+    std::string text;
+  };
+  
+  // Ring buffer of formatted messages written on their stream by a dedicated thread.
+  // The producers wait when the buffer is full, so no message is lost and the order is kept.
+  class LoggerAsyncSink_p
+  {
+  public:
+    LoggerAsyncSink_p()
+    : m_Entries(1024)
+    {
+      this->m_Head = 0;
+      this->m_Size = 0;
+      this->m_Running = false;
+      this->m_Stopping = false;
+      this->m_Writing = false;
+    };
+    
+    ~LoggerAsyncSink_p()
+    {
+      this->Stop();
+    };
+    
+    bool IsRunning()
+    {
+      this->m_Lock.Lock();
+      bool running = this->m_Running;
+      this->m_Lock.Unlock();
+      return running;
+    };
+    
+    void Start()
+    {
+      this->m_Lock.Lock();
+      if (this->m_Running)
+      {
+        this->m_Lock.Unlock();
+        return;
+      }
+      this->m_Running = true;
+      this->m_Lock.Unlock();
+      if (!this->m_Thread.TryStart(&LoggerAsyncSink_p::Run_p, this))
+      {
+        this->m_Lock.Lock();
+        this->m_Running = false;
+        this->m_Lock.Unlock();
+      }
+    };
+    
+    // Write all the remaining messages before to stop the thread.
+    void Stop()
+    {
+      this->m_Lock.Lock();
+      if (!this->m_Running || this->m_Stopping)
+      {
+        this->m_Lock.Unlock();
+        return;
+      }
+      this->m_Stopping = true;
+      this->m_Condition.WakeAll();
+      this->m_Lock.Unlock();
+      this->m_Thread.Join();
+      this->m_Lock.Lock();
+      this->m_Running = false;
+      this->m_Stopping = false;
+      this->m_Condition.WakeAll();
+      this->m_Lock.Unlock();
+    };
+    
+    // Returns false if the sink is not running. The message must then be written synchronously.
+    bool Push(Logger::Stream::Pointer stream, const std::string& text)
+    {
+      this->m_Lock.Lock();
+      while (this->m_Running && (this->m_Stopping || (this->m_Size == this->m_Entries.size())))
+        this->m_Condition.Wait(&(this->m_Lock));
+      if (!this->m_Running)
+      {
+        this->m_Lock.Unlock();
+        return false;
+      }
+      LoggerEntry_p& entry = this->m_Entries[(this->m_Head + this->m_Size) % this->m_Entries.size()];
+      entry.stream = stream;
+      entry.text = text;
+      ++(this->m_Size);
+      this->m_Condition.WakeAll();
+      this->m_Lock.Unlock();
+      return true;
+    };
+    
+    void Flush()
+    {
+      this->m_Lock.Lock();
+      while (this->m_Running && ((this->m_Size != 0) || this->m_Writing))
+        this->m_Condition.Wait(&(this->m_Lock));
+      this->m_Lock.Unlock();
+    };
+    
+  private:
+    static void Run_p(void* data)
+    {
+      LoggerAsyncSink_p* sink = static_cast<LoggerAsyncSink_p*>(data);
+      LoggerEntry_p entry;
+      sink->m_Lock.Lock();
+      while (1)
+      {
+        while ((sink->m_Size == 0) && !sink->m_Stopping)
+          sink->m_Condition.Wait(&(sink->m_Lock));
+        if (sink->m_Size == 0)
+          break;
+        LoggerEntry_p& front = sink->m_Entries[sink->m_Head];
+        entry.stream.swap(front.stream);
+        entry.text.swap(front.text);
+        sink->m_Head = (sink->m_Head + 1) % sink->m_Entries.size();
+        --(sink->m_Size);
+        sink->m_Writing = true;
+        sink->m_Condition.WakeAll();
+        sink->m_Lock.Unlock();
+        entry.stream->GetOutput() << entry.text << std::endl;
+        entry.stream.reset();
+        sink->m_Lock.Lock();
+        sink->m_Writing = false;
+        sink->m_Condition.WakeAll();
+      }
+      sink->m_Lock.Unlock();
+    };
+    
+    std::vector<LoggerEntry_p> m_Entries;
+    size_t m_Head;
+    size_t m_Size;
+    bool m_Running;
+    bool m_Stopping;
+    bool m_Writing;
+    critical_section_p m_Lock;
+    wait_condition_p m_Condition;
+    thread_p m_Thread;
+  };
+  
+  // Declared after the streams to be destroyed (and then to write the remaining messages) before them.
+  static LoggerAsyncSink_p _btk_logger_async_sink;
+  
   /**
    * @class Logger btkLogger.h
    * @brief Log mechanism to display debug message, warnings and errors
@@ -85,6 +234,18 @@ namespace btk
    *
    * It is possible to select other output streams than std::cout and std::cerr using the method SetDebugStream(), SetWarningStream(), and SetErrorStream().
    *
+   * The logger can be used by several threads at the same time: each message is written at once on its stream. 
+   * To distinguish the messages sent by concurrent threads (for example when several files are read in parallel), 
+   * a tag can be associated with the calling thread using a Logger::ThreadTag object. In the Normal and Detailed mode, 
+   * the tag is written between square brackets after the affix. The classes AcquisitionFileReader and AcquisitionFileWriter
+   * use the name of the processed file as tag.
+   * The macros btkDebugMacro, btkWarningMacro and btkErrorMacro do not build their message when the logger is quiet.
+   *
+   * By default, the messages are written synchronously by the calling thread. With the method SetAsynchronous(), 
+   * the messages are only formatted by the calling thread and stored in a ring buffer written by a dedicated thread.
+   * The method Flush() waits until all the stored messages are written.
+   * @note The prefix and affixes returned by reference should not be modified while other threads are logging.
+   *
    * An example to use this logger is:
    * @code{.cpp}
    * #include <btkLogger.h>
@@ -131,7 +292,7 @@ namespace btk
 #ifdef NDEBUG
     btkNotUsed(msg);
 #else
-    Logger::PrintMessage(_btk_logger_debug_stream.get(), _btk_logger_debug_affix, msg);
+    Logger::PrintMessage(_btk_logger_debug_stream, _btk_logger_debug_affix, msg);
 #endif
   };
      
@@ -141,7 +302,7 @@ namespace btk
    */
   void Logger::Warning(const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_warning_stream.get(), _btk_logger_warning_affix, msg);
+    Logger::PrintMessage(_btk_logger_warning_stream, _btk_logger_warning_affix, msg);
   };
     
   /**
@@ -150,7 +311,7 @@ namespace btk
    */
   void Logger::Error(const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_error_stream.get(), _btk_logger_error_affix, msg);
+    Logger::PrintMessage(_btk_logger_error_stream, _btk_logger_error_affix, msg);
   }
   
   /**
@@ -161,7 +322,7 @@ namespace btk
 #ifdef NDEBUG
     btkNotUsed(filename); btkNotUsed(line); btkNotUsed(msg);
 #else
-    Logger::PrintMessage(_btk_logger_debug_stream.get(), _btk_logger_debug_affix, filename, line, msg);
+    Logger::PrintMessage(_btk_logger_debug_stream, _btk_logger_debug_affix, filename, line, msg);
 #endif
   };
   
@@ -170,7 +331,7 @@ namespace btk
    */
   void Logger::Warning(const std::string& filename, int line, const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_warning_stream.get(), _btk_logger_warning_affix, filename, line, msg);
+    Logger::PrintMessage(_btk_logger_warning_stream, _btk_logger_warning_affix, filename, line, msg);
   };
   
   /**
@@ -178,7 +339,7 @@ namespace btk
    */
   void Logger::Error(const std::string& filename, int line, const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_error_stream.get(), _btk_logger_error_affix, filename, line, msg);
+    Logger::PrintMessage(_btk_logger_error_stream, _btk_logger_error_affix, filename, line, msg);
   };
   
   /**
@@ -194,7 +355,9 @@ namespace btk
    */  
   void Logger::SetVerboseMode(Logger::VerboseMode mode)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_verbose_mode = mode;
+    _btk_logger_lock.Unlock();
   };
       
   /**
@@ -210,7 +373,9 @@ namespace btk
    */
   void Logger::SetPrefix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_prefix = str;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -218,7 +383,10 @@ namespace btk
    */
   Logger::Stream::Pointer Logger::GetDebugStream()
   {
-    return _btk_logger_debug_stream;
+    _btk_logger_lock.Lock();
+    Logger::Stream::Pointer stream = _btk_logger_debug_stream;
+    _btk_logger_lock.Unlock();
+    return stream;
   };
     
   /**
@@ -226,7 +394,10 @@ namespace btk
    */
   Logger::Stream::Pointer Logger::GetWarningStream()
   {
-    return _btk_logger_warning_stream;
+    _btk_logger_lock.Lock();
+    Logger::Stream::Pointer stream = _btk_logger_warning_stream;
+    _btk_logger_lock.Unlock();
+    return stream;
   };
     
   /**
@@ -234,7 +405,10 @@ namespace btk
    */
   Logger::Stream::Pointer Logger::GetErrorStream()
   {
-    return _btk_logger_error_stream;
+    _btk_logger_lock.Lock();
+    Logger::Stream::Pointer stream = _btk_logger_error_stream;
+    _btk_logger_lock.Unlock();
+    return stream;
   };
     
   /**
@@ -266,7 +440,9 @@ namespace btk
    */
   void Logger::SetDebugStream(Logger::Stream::Pointer stream)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_debug_stream = stream;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -274,7 +450,9 @@ namespace btk
    */
   void Logger::SetWarningStream(Logger::Stream::Pointer stream)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_warning_stream = stream;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -282,7 +460,9 @@ namespace btk
    */
   void Logger::SetErrorStream(Logger::Stream::Pointer stream)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_error_stream = stream;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -314,7 +494,9 @@ namespace btk
    */
   void Logger::SetDebugAffix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_debug_affix = str;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -322,7 +504,9 @@ namespace btk
    */
   void Logger::SetWarningAffix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_warning_affix = str;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -330,38 +514,103 @@ namespace btk
    */
   void Logger::SetErrorAffix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_error_affix = str;
+    _btk_logger_lock.Unlock();
+  };
+  
+  /**
+   * Returns the tag associated with the calling thread or an empty string if there is none.
+   */
+  std::string Logger::GetThreadTag()
+  {
+    return (_btk_logger_thread_tag != 0) ? *_btk_logger_thread_tag : std::string();
+  };
+  
+  /**
+   * Returns true if the messages are written by a dedicated thread.
+   */
+  bool Logger::GetAsynchronous()
+  {
+    return _btk_logger_async_sink.IsRunning();
+  };
+  
+  /**
+   * Enables or disables the writing of the messages by a dedicated thread (disabled by default).
+   * When disabled, the remaining messages are written before this method returns.
+   * If the thread cannot be created, the messages are still written synchronously.
+   */
+  void Logger::SetAsynchronous(bool enabled)
+  {
+    if (enabled)
+      _btk_logger_async_sink.Start();
+    else
+      _btk_logger_async_sink.Stop();
+  };
+  
+  /**
+   * Waits until all the messages sent to the asynchronous sink are written.
+   * Nothing is done if the messages are written synchronously.
+   */
+  void Logger::Flush()
+  {
+    _btk_logger_async_sink.Flush();
   };
   
   /**
    * Overload method to print message without information on the file and the line number where the log was written.
    */
-  void Logger::PrintMessage(Stream* level, const std::string& affix, const std::string& msg)
+  void Logger::PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& msg)
   {
     Logger::PrintMessage(level, affix, "", 0, msg);
   };
   
  /**
   * Print message on the given stream with the selected verbose mode and other parameters.
+  * The message is formatted first and then written at once, directly or by the asynchronous sink.
   */
-  void Logger::PrintMessage(Stream* level, const std::string& affix, const std::string& filename, int line, const std::string& msg)
+  void Logger::PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& filename, int line, const std::string& msg)
   {
     if (_btk_logger_verbose_mode == Logger::Quiet)
       return;
-    if (_btk_logger_verbose_mode > Logger::MessageOnly)
+    std::ostringstream oss;
+    _btk_logger_lock.Lock();
+    Logger::VerboseMode mode = _btk_logger_verbose_mode;
+    if (mode == Logger::Quiet)
+    {
+      _btk_logger_lock.Unlock();
+      return;
+    }
+    if (mode > Logger::MessageOnly)
     {
-      level->GetOutput() << (_btk_logger_prefix.empty() ? "" : "[" + _btk_logger_prefix + " ")
-                     << (affix.empty() ? "" : affix)
-                     << (_btk_logger_prefix.empty() && affix.empty() ? "" : "] ");
+      oss << (_btk_logger_prefix.empty() ? "" : "[" + _btk_logger_prefix + " ")
+          << (affix.empty() ? "" : affix)
+          << (_btk_logger_prefix.empty() && affix.empty() ? "" : "] ");
+      if (_btk_logger_thread_tag != 0)
+        oss << "[" << *_btk_logger_thread_tag << "] ";
     }
-    if ((_btk_logger_verbose_mode == Logger::Detailed) && (!filename.empty()))
+    if ((mode == Logger::Detailed) && (!filename.empty()))
     {
-      level->GetOutput() << filename;
+      oss << filename;
       if (line > 0)
-        level->GetOutput() << " (" << line << ")";
-      level->GetOutput() << ": ";
+        oss << " (" << line << ")";
+      oss << ": ";
+    }
+    oss << msg;
+    Stream::Pointer stream = level;
+    if (!_btk_logger_async_sink.IsRunning())
+    {
+      stream->GetOutput() << oss.str() << std::endl;
+      _btk_logger_lock.Unlock();
+      return;
+    }
+    _btk_logger_lock.Unlock();
+    if (!_btk_logger_async_sink.Push(stream, oss.str()))
+    {
+      _btk_logger_lock.Lock();
+      stream->GetOutput() << oss.str() << std::endl;
+      _btk_logger_lock.Unlock();
     }
-    level->GetOutput() << msg << std::endl;
   };
   
   // ----------------------------------------------------------------------- //
@@ -404,4 +653,30 @@ namespace btk
       delete this->mp_Output;
   };
   
-};
\ No newline at end of file
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * @class Logger::ThreadTag btkLogger.h
+   * @brief Associates a tag with the messages sent by the calling thread during its life.
+   *
+   * The previous tag (if any) is restored in the destructor.
+   */
+  
+  /**
+   * Sets @a tag as the tag of the calling thread.
+   */
+  Logger::ThreadTag::ThreadTag(const std::string& tag)
+  : m_Tag(tag)
+  {
+    this->mp_Previous = _btk_logger_thread_tag;
+    _btk_logger_thread_tag = &(this->m_Tag);
+  };
+  
+  /**
+   * Restores the previous tag.
+   */
+  Logger::ThreadTag::~ThreadTag()
+  {
+    _btk_logger_thread_tag = this->mp_Previous;
+  };
+};
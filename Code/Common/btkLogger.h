@@ -44,11 +44,14 @@
 
 /**
  * Internal macro used to print log on the given stream @c s.
+ * Nothing is built when the logger is quiet.
  */
 #define _btkLogMacro(s, p, l, ...) \
   /* Keep the scope of _argc, _argv only inside the "loop" */ \
   do \
   { \
+    if (btk::Logger::GetVerboseMode() == btk::Logger::Quiet) \
+      break; \
     std::string _argv[] = { __VA_ARGS__ }; \
     int _argc = (sizeof _argv) / (sizeof _argv[0]); \
     if (_argc == 1) \
@@ -120,6 +123,18 @@ namespace btk
       bool m_Owned;
     };
     
+    class ThreadTag
+    {
+    public:
+      BTK_COMMON_EXPORT explicit ThreadTag(const std::string& tag);
+      BTK_COMMON_EXPORT ~ThreadTag();
+    private:
+      ThreadTag(const ThreadTag& ); // Not implemented.
+      ThreadTag& operator=(const ThreadTag& ); // Not implemented.
+      std::string m_Tag;
+      const std::string* mp_Previous;
+    };
+    
     BTK_COMMON_EXPORT static void Debug(const std::string& msg);
     BTK_COMMON_EXPORT static void Debug(const std::string& filename, int line, const std::string& msg);
 
@@ -152,9 +167,15 @@ namespace btk
     BTK_COMMON_EXPORT static void SetWarningAffix(const std::string& str);
     BTK_COMMON_EXPORT static void SetErrorAffix(const std::string& str);
     
+    BTK_COMMON_EXPORT static std::string GetThreadTag();
+    
+    BTK_COMMON_EXPORT static bool GetAsynchronous();
+    BTK_COMMON_EXPORT static void SetAsynchronous(bool enabled);
+    BTK_COMMON_EXPORT static void Flush();
+    
   private:
-    static void PrintMessage(Stream* level, const std::string& affix, const std::string& msg);
-    static void PrintMessage(Stream* level, const std::string& affix, const std::string& filename, int line, const std::string& msg);
+    static void PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& msg);
+    static void PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& filename, int line, const std::string& msg);
   };
 };
 
@@ -47,24 +47,111 @@ namespace btk
   template <typename Derived>
   struct MeasureTraits;
   
+  template <typename Derived>
+  class MeasureData;
+  
+  /**
+   * Buffer shared by the copies of a data object until one of them is modified (copy-on-write).
+   * The data objects sharing the buffer are counted separately from the other references to the buffer (see MeasureData::GetValuesPointer()).
+   * These references keep the buffer alive without forcing a copy at each modification.
+   * A buffer given by a mutable reference (see GetMutableReference()) is never shared: its copies receive their own buffer.
+   */
+  template <typename U>
+  class MeasureBuffer_p
+  {
+  public:
+    explicit MeasureBuffer_p(U* buffer) : mp_Buffer(buffer), mp_Owners(new char(0)), m_Referenced(false) {};
+    MeasureBuffer_p(const MeasureBuffer_p& toCopy);
+    MeasureBuffer_p& operator=(const MeasureBuffer_p& other);
+    
+    U* operator->() const {return this->mp_Buffer.get();};
+    U& operator*() const {return *(this->mp_Buffer);};
+    const btkSharedPtr<U>& GetPointer() const {return this->mp_Buffer;};
+    
+    bool IsShared() const {return this->mp_Owners.use_count() > 1;};
+    void Detach() {if (this->IsShared()) *this = MeasureBuffer_p(new U(*(this->mp_Buffer)));};
+    
+    U& GetMutableReference() {this->Detach(); this->m_Referenced = true; return *(this->mp_Buffer);};
+    void ReleaseReference() {this->m_Referenced = false;};
+    
+  private:
+    btkSharedPtr<U> mp_Buffer;
+    btkSharedPtr<char> mp_Owners;
+    bool m_Referenced;
+  };
+  
+  template <typename Derived>
+  class MeasureDataLoader
+  {
+  public:
+    typedef btkSharedPtr<MeasureDataLoader> Pointer;
+    
+    virtual ~MeasureDataLoader() {};
+    
+    /**
+     * Returns the number of frames which will be set by the loader.
+     */
+    virtual int GetFrameNumber() const = 0;
+    /**
+     * Fills the given @a data. The matrices of @a data are empty and must be resized by the loader.
+     */
+    virtual void Load(MeasureData<Derived>* data) = 0;
+    
+  protected:
+    MeasureDataLoader() {};
+    
+  private:
+    MeasureDataLoader(const MeasureDataLoader& ); // Not implemented.
+    MeasureDataLoader& operator=(const MeasureDataLoader& ); // Not implemented.
+  };
+  
   template <typename Derived>
   class MeasureData : public DataObject
   {
   public:
     typedef typename MeasureTraits<Derived>::Values Values; ///< Measures' values along the time.
+    typedef MeasureDataLoader<Derived> Loader; ///< Object filling the values the first time they are accessed.
     
     /**
      * Returns values of the measure. The exact output type depend of the Derived class
+     * If the values are shared with a clone, they are copied before (see IsShared()).
+     * The clones created while the returned reference can be used receive their own copy of the values.
      */
-    Values& GetValues() {return this->m_Values;};
+    Values& GetValues() {this->Load(); return this->mp_Values.GetMutableReference();};
     /**
      * Returns values of the measure. The exact output type depend of the Derived class
      */
-    const Values& GetValues() const {return this->m_Values;};
+    const Values& GetValues() const {this->Load(); return *(this->mp_Values);};
     /**
      * Sets values for the measure. The exact input type depend of the Derived class
+     * The values are assigned in place if they are not shared with a clone and if their number of frames is the same.
      */
     void SetValues(const Values& v);
+    /**
+     * Returns the values with a pointer keeping them alive, even after the destruction of this data object (e.g. for a view in a wrapped language).
+     * If the values are shared with a clone, they are copied before (like with the non-const method GetValues()).
+     */
+    btkSharedPtr<Values> GetValuesPointer() {this->Load(); DetachShared_p(this->mp_Values); return this->mp_Values.GetPointer();};
+    
+    /**
+     * Returns the number of frames, without loading the values.
+     */
+    int GetFrameNumber() const {return this->mp_Loader ? this->mp_Loader->GetFrameNumber() : static_cast<int>(this->mp_Values->rows());};
+    
+    /**
+     * Returns true if the values are shared with another data object (i.e. a clone not yet modified).
+     */
+    bool IsShared() const {return this->mp_Values.IsShared();};
+    
+    /**
+     * Returns true if the values are not yet loaded.
+     */
+    bool IsLazy() const {return this->mp_Loader.get() != 0;};
+    /**
+     * Returns the loader which will fill the values (null if the values are already loaded).
+     */
+    typename Loader::Pointer GetLoader() const {return this->mp_Loader;};
+    void SetLoader(typename Loader::Pointer loader);
     
   protected:
     /**
@@ -81,7 +168,22 @@ namespace btk
      */
     MeasureData& operator=(const MeasureData& ); // Not implemented.
     
-    typename MeasureData<Derived>::Values m_Values; ///< Values of the measure.
+    void Load() const;
+    /**
+     * Releases the mutable references given to the loader. Inherited classes with other buffers must release them too.
+     */
+    virtual void ReleaseLoaderReferences_p() {this->mp_Values.ReleaseReference();};
+    
+    /**
+     * Replaces the shared object @a ptr by its own copy if it is shared with another data object (copy-on-write).
+     */
+    template <typename U>
+    static void DetachShared_p(MeasureBuffer_p<U>& ptr) {ptr.Detach();};
+    
+    MeasureBuffer_p<typename MeasureData<Derived>::Values> mp_Values; ///< Values of the measure (shared between the clones until one of them is modified).
+    
+  private:
+    mutable typename Loader::Pointer mp_Loader;
   };
   
   template <class Derived>
@@ -174,7 +276,8 @@ namespace btk
    const typename Measure<Derived>::Values& Measure<Derived>::GetValues() const
    {
      assert(this->mp_Data != Measure<Derived>::Data::Null);
-     return this->mp_Data->GetValues();
+     // Const access: the values shared with a clone are not copied.
+     return static_cast<const typename Measure<Derived>::Data*>(this->mp_Data.get())->GetValues();
    };
   
   template <class Derived>
@@ -191,7 +294,7 @@ namespace btk
   {
     if (!this->mp_Data)
       return 0;
-    return static_cast<int>(this->mp_Data->GetValues().rows());
+    return this->mp_Data->GetFrameNumber();
   };
  
   template <class Derived>
@@ -266,24 +369,105 @@ namespace btk
    * Currently this class store a matrix defined by the given number of frames. The template @a Derived used by this class gives the number of columns (components) of the measure.
    *
    * To add a new type of data (for example for 2D pressure mat or insole), you have to inherit from this class and add the method Resize(int frameNumber). You can also add other informations in inherited classes, like btk::Point::Data which contains reconstruction residuals.
+   *
+   * The values can be loaded on demand (see MeasureData::SetLoader()). In this case, the matrices stay empty until the first access to them.
+   * Inherited classes must call the method Load() before to access directly to their members.
+   *
+   * The copies (and then the clones) share their values until one of them is modified (copy-on-write). 
+   * The non-const method GetValues() gives its own copy of the values to the data object used. The const method never copies them.
+   * As the reference returned by the non-const method GetValues() can be kept to modify the values, the clones created after receive their own copy of the values 
+   * (like before the copy-on-write). Only the values never modified by such reference (or only filled by a loader) are shared.
+   * Inherited classes must call the method DetachShared_p() before to modify directly their members.
+   *
+   * The method GetValuesPointer() gives a pointer owning the values. Such pointer does not prevent the modifications in place of the values 
+   * and a clone created while such pointer exists receives immediately its own copy of the values. The pointer is not updated when the values 
+   * are replaced (SetValues() with another number of frames, SetLoader(), Resize() in the inherited classes). It keeps then the old values alive but they are not used anymore by this object.
    */
   
   template <class Derived>
   MeasureData<Derived>::MeasureData(int frameNumber)
-  : DataObject(), m_Values(MeasureData::Values::Zero(frameNumber,Derived::Values::ColsAtCompileTime))
+  : DataObject(), mp_Values(new Values(MeasureData::Values::Zero(frameNumber,Derived::Values::ColsAtCompileTime))), mp_Loader()
   {};
   
  template <class Derived>
   MeasureData<Derived>::MeasureData(const MeasureData& toCopy)
-  : DataObject(toCopy), m_Values(toCopy.m_Values)
+  : DataObject(toCopy), mp_Values(toCopy.mp_Values), mp_Loader(toCopy.mp_Loader)
   {};
   
   template <class Derived>
   void MeasureData<Derived>::SetValues(const typename MeasureData::Values& v)
   {
-    this->m_Values = v;
+    this->Load();
+    if (!this->mp_Values.IsShared() && (this->mp_Values->rows() == v.rows()))
+      *(this->mp_Values) = v;
+    else
+      this->mp_Values = MeasureBuffer_p<Values>(new Values(v));
     this->Modified();
   };
+  
+  /**
+   * Sets the object used to fill the values the first time they are accessed (lazy loading).
+   * The current values are released and the number of frames is given by the loader until the values are loaded.
+   * The values are loaded only one time. The loader is shared with the clones of this object.
+   * @warning The loading is not thread safe. Concurrent first accesses to the same data must be synchronized by the caller.
+   */
+  template <class Derived>
+  void MeasureData<Derived>::SetLoader(typename Loader::Pointer loader)
+  {
+    this->mp_Loader = loader;
+    if (this->mp_Loader)
+      this->mp_Values = MeasureBuffer_p<Values>(new Values(0, static_cast<int>(Values::ColsAtCompileTime)));
+    this->Modified();
+  };
+  
+  /**
+   * Loads the values if a loader is set. The loader is released after.
+   */
+  template <class Derived>
+  void MeasureData<Derived>::Load() const
+  {
+    if (!this->mp_Loader)
+      return;
+    typename Loader::Pointer loader = this->mp_Loader;
+    this->mp_Loader.reset();
+    MeasureData<Derived>* data = const_cast<MeasureData<Derived>*>(this);
+    loader->Load(data);
+    // The loader does not keep the references to the values.
+    data->ReleaseLoaderReferences_p();
+  };
+  
+  /**
+   * Copy constructor. The buffer is shared with the copy, except if it is referenced out of the data objects or if a mutable reference was given. 
+   * In this case, the copy receives its own buffer, otherwise a reference kept to modify the original data could modify the copy after a copy-on-write.
+   */
+  template <typename U>
+  MeasureBuffer_p<U>::MeasureBuffer_p(const MeasureBuffer_p& toCopy)
+  : mp_Buffer(toCopy.mp_Buffer), mp_Owners(toCopy.mp_Owners), m_Referenced(false)
+  {
+    if (toCopy.m_Referenced || (this->mp_Buffer.use_count() > this->mp_Owners.use_count()))
+      *this = MeasureBuffer_p(new U(*(toCopy.mp_Buffer)));
+  };
+  
+  /**
+   * Assignment operator. The buffer of @a other is shared as is (used to replace the buffer of a data object).
+   */
+  template <typename U>
+  MeasureBuffer_p<U>& MeasureBuffer_p<U>::operator=(const MeasureBuffer_p& other)
+  {
+    this->mp_Buffer = other.mp_Buffer;
+    this->mp_Owners = other.mp_Owners;
+    this->m_Referenced = other.m_Referenced;
+    return *this;
+  };
+  
+  /**
+   * @class MeasureDataLoader btkMeasure.h
+   * @brief Interface to fill the values of a MeasureData object the first time they are accessed.
+   *
+   * A file reader can use this class to extract only the measures used later (see AcquisitionFileIO::SetLazyLoading()).
+   *
+   * @tparam Derived Class representing a kind of measurement (Point, Analog, etc.)
+   */
 };
 
 #endif // __btkMeasure_h
@@ -0,0 +1,290 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkMemoryArena.h"
+#include "btkThread_p.h"
+
+#include <new>
+
+#if defined(WIN32) || defined(_WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#endif
+
+namespace btk
+{
+  // Header stored in front of each object allocated by MemoryArena::AllocateObject.
+  // Its size (16 bytes) keeps the alignment given by the operator new.
+  union MemoryArenaHeader_p
+  {
+    MemoryArena* arena;
+    double align[2];
+  };
+  
+  static BTK_THREAD_LOCAL MemoryArena* _btk_current_memory_arena = 0;
+  static volatile long _btk_heap_allocation_number = 0;
+  
+  static long MemoryArenaAtomicAdd_p(volatile long* value, long inc)
+  {
+#if defined(WIN32) || defined(_WIN32)
+    return InterlockedExchangeAdd(value, inc) + inc;
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    return __sync_add_and_fetch(value, inc);
+#else
+    static critical_section_p _critical_section;
+    _critical_section.Lock();
+    long result = (*value += inc);
+    _critical_section.Unlock();
+    return result;
+#endif
+  };
+  
+  /**
+   * @class MemoryArena btkMemoryArena.h
+   * @brief Bump allocator used to create at once the objects of an acquisition.
+   *
+   * When a memory arena is current (see MemoryArena::Scope), every object inheriting from the class Object
+   * (points, analog channels, events, metadata, ...) as well as every MetaDataInfo object created by its 
+   * factory method is allocated in large memory blocks owned by the arena instead of the free store.
+   * The destructor of these objects is still called individually, but their memory is released 
+   * all at once when the arena and all the objects allocated inside are destroyed. An object can 
+   * then safely outlive the acquisition which created the arena.
+   *
+   * The class AcquisitionFileReader uses an arena when its method AcquisitionFileReader::SetMemoryArenaEnabled() is set to true.
+   * The arena is then stored in the output acquisition (see Acquisition::GetMemoryArena()).
+   *
+   * Some counters are given to measure the number of allocations: GetAllocationNumber() gives the number of
+   * objects allocated in the arena, GetBlockNumber() the number of allocations done in the free store by the arena
+   * and the static method GetHeapAllocationNumber() the number of objects allocated in the free store without arena.
+   *
+   * @warning An arena is not thread-safe for the allocation and must be current in only one thread at a time.
+   * The destruction of the objects can be done in any thread.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @class MemoryArena::Scope btkMemoryArena.h
+   * @brief Sets a memory arena as the current one for the calling thread during its life.
+   *
+   * The previous current arena (if any) is restored in the destructor.
+   */
+  
+  /**
+   * Sets @a arena as the current arena for the calling thread. A null pointer disables the use of any arena.
+   */
+  MemoryArena::Scope::Scope(MemoryArena::Pointer arena)
+  {
+    this->mp_Previous = _btk_current_memory_arena;
+    _btk_current_memory_arena = arena.get();
+  };
+  
+  /**
+   * Restores the previous current arena.
+   */
+  MemoryArena::Scope::~Scope()
+  {
+    _btk_current_memory_arena = this->mp_Previous;
+  };
+  
+  /**
+   * @typedef MemoryArena::Pointer
+   * Smart pointer associated with a MemoryArena object.
+   */
+  
+  /**
+   * @typedef MemoryArena::ConstPointer
+   * Smart pointer associated with a const MemoryArena object.
+   */
+  
+  /**
+   * @typedef MemoryArena::NullPointer
+   * Special null pointer associated with a MemoryArena object.
+   */
+  
+  /**
+   * @fn static Pointer MemoryArena::New(size_t blockSize = 65536)
+   * Creates a smart pointer associated with a MemoryArena object. The memory is reserved by blocks of @a blockSize bytes.
+   */
+  
+  /**
+   * @fn static NullPointer MemoryArena::Null()
+   * Static function to return a special null pointer type.
+   */
+  
+  /**
+   * @fn size_t MemoryArena::GetBlockSize() const
+   * Returns the default size (in bytes) of the blocks reserved by the arena.
+   */
+  
+  /**
+   * @fn size_t MemoryArena::GetBlockNumber() const
+   * Returns the number of blocks reserved in the free store.
+   */
+  
+  /**
+   * @fn size_t MemoryArena::GetReservedBytes() const
+   * Returns the number of bytes reserved in the free store.
+   */
+  
+  /**
+   * @fn size_t MemoryArena::GetAllocatedBytes() const
+   * Returns the number of bytes given by the method Allocate().
+   */
+  
+  /**
+   * @fn size_t MemoryArena::GetAllocationNumber() const
+   * Returns the number of calls to the method Allocate().
+   */
+  
+  /**
+   * Returns a memory chunk of @a size bytes aligned on 16 bytes.
+   * The memory is released only when the arena is destroyed.
+   */
+  void* MemoryArena::Allocate(size_t size)
+  {
+    size = (size + 15) & ~static_cast<size_t>(15);
+    if (size > this->m_Available)
+    {
+      size_t num = (size > this->m_BlockSize) ? size : this->m_BlockSize;
+      this->mp_Current = static_cast<char*>(::operator new(num));
+      this->m_Blocks.push_back(this->mp_Current);
+      this->m_Available = num;
+      this->m_ReservedBytes += num;
+    }
+    void* ptr = this->mp_Current;
+    this->mp_Current += size;
+    this->m_Available -= size;
+    this->m_AllocatedBytes += size;
+    ++this->m_AllocationNumber;
+    return ptr;
+  };
+  
+  /**
+   * Returns the current arena for the calling thread or a null pointer if there is none.
+   */
+  MemoryArena* MemoryArena::GetCurrent()
+  {
+    return _btk_current_memory_arena;
+  };
+  
+  /**
+   * Allocates the memory for an object of @a size bytes in the current arena or in the free store if there is no current arena.
+   * This method is used by the operator new of the arena's aware classes.
+   */
+  void* MemoryArena::AllocateObject(size_t size)
+  {
+    MemoryArena* arena = _btk_current_memory_arena;
+    MemoryArenaHeader_p* header = 0;
+    if (arena != 0)
+    {
+      header = static_cast<MemoryArenaHeader_p*>(arena->Allocate(sizeof(MemoryArenaHeader_p) + size));
+      arena->Retain();
+    }
+    else
+    {
+      header = static_cast<MemoryArenaHeader_p*>(::operator new(sizeof(MemoryArenaHeader_p) + size));
+      MemoryArenaAtomicAdd_p(&_btk_heap_allocation_number, 1);
+    }
+    header->arena = arena;
+    return header + 1;
+  };
+  
+  /**
+   * Releases the memory of an object allocated with AllocateObject().
+   * If the object was allocated in an arena, the memory is effectively released when the arena and all its objects are destroyed.
+   */
+  void MemoryArena::DeallocateObject(void* ptr)
+  {
+    if (ptr == 0)
+      return;
+    MemoryArenaHeader_p* header = static_cast<MemoryArenaHeader_p*>(ptr) - 1;
+    if (header->arena != 0)
+      MemoryArena::Release(header->arena);
+    else
+      ::operator delete(header);
+  };
+  
+  /**
+   * Returns the number of objects allocated in the free store by the method AllocateObject() since the start of the program.
+   */
+  unsigned long MemoryArena::GetHeapAllocationNumber()
+  {
+    return static_cast<unsigned long>(MemoryArenaAtomicAdd_p(&_btk_heap_allocation_number, 0));
+  };
+  
+  /**
+   * Constructor.
+   */
+  MemoryArena::MemoryArena(size_t blockSize)
+  : m_BlockSize(blockSize), m_Blocks()
+  {
+    this->mp_Current = 0;
+    this->m_Available = 0;
+    this->m_ReservedBytes = 0;
+    this->m_AllocatedBytes = 0;
+    this->m_AllocationNumber = 0;
+    this->m_References = 1;
+  };
+  
+  /**
+   * Destructor. Releases all the reserved blocks.
+   */
+  MemoryArena::~MemoryArena()
+  {
+    for (size_t i = 0 ; i < this->m_Blocks.size() ; ++i)
+      ::operator delete(this->m_Blocks[i]);
+  };
+  
+  /**
+   * Adds a reference to the arena (one per allocated object).
+   */
+  void MemoryArena::Retain()
+  {
+    MemoryArenaAtomicAdd_p(&(this->m_References), 1);
+  };
+  
+  /**
+   * Removes a reference to the arena and destroys it when there is no more reference.
+   * The smart pointer returned by the method New() counts for one reference.
+   */
+  void MemoryArena::Release(MemoryArena* arena)
+  {
+    if (MemoryArenaAtomicAdd_p(&(arena->m_References), -1) == 0)
+      delete arena;
+  };
+};
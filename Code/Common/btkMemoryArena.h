@@ -0,0 +1,100 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkMemoryArena_h
+#define __btkMemoryArena_h
+
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace btk
+{
+  class MemoryArena
+  {
+  public:
+    typedef btkSharedPtr<MemoryArena> Pointer;
+    typedef btkSharedPtr<const MemoryArena> ConstPointer;
+    typedef btkNullPtr<MemoryArena> NullPointer;
+    
+    class Scope
+    {
+    public:
+      BTK_COMMON_EXPORT explicit Scope(MemoryArena::Pointer arena);
+      BTK_COMMON_EXPORT ~Scope();
+    private:
+      Scope(const Scope& ); // Not implemented.
+      Scope& operator=(const Scope& ); // Not implemented.
+      MemoryArena* mp_Previous;
+    };
+    
+    static Pointer New(size_t blockSize = 65536) {return Pointer(new MemoryArena(blockSize), &MemoryArena::Release);};
+    static NullPointer Null() {return NullPointer();};
+    
+    size_t GetBlockSize() const {return this->m_BlockSize;};
+    size_t GetBlockNumber() const {return this->m_Blocks.size();};
+    size_t GetReservedBytes() const {return this->m_ReservedBytes;};
+    size_t GetAllocatedBytes() const {return this->m_AllocatedBytes;};
+    size_t GetAllocationNumber() const {return this->m_AllocationNumber;};
+    BTK_COMMON_EXPORT void* Allocate(size_t size);
+    
+    BTK_COMMON_EXPORT static MemoryArena* GetCurrent();
+    BTK_COMMON_EXPORT static void* AllocateObject(size_t size);
+    BTK_COMMON_EXPORT static void DeallocateObject(void* ptr);
+    BTK_COMMON_EXPORT static unsigned long GetHeapAllocationNumber();
+    
+  private:
+    BTK_COMMON_EXPORT MemoryArena(size_t blockSize);
+    BTK_COMMON_EXPORT ~MemoryArena();
+    MemoryArena(const MemoryArena& ); // Not implemented.
+    MemoryArena& operator=(const MemoryArena& ); // Not implemented.
+    
+    void Retain();
+    BTK_COMMON_EXPORT static void Release(MemoryArena* arena);
+    
+    size_t m_BlockSize;
+    std::vector<char*> m_Blocks;
+    char* mp_Current;
+    size_t m_Available;
+    size_t m_ReservedBytes;
+    size_t m_AllocatedBytes;
+    size_t m_AllocationNumber;
+    volatile long m_References;
+  };
+};
+
+#endif // __btkMemoryArena_h
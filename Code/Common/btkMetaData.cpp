@@ -228,7 +228,7 @@ namespace btk
           {
             if (noPossibleEmptyValue)
             {
-              if (info->GetValues().size() != 0)
+              if (info->GetValueNumber() != 0)
                 return info;
             }
             else
@@ -35,11 +35,23 @@
 
 #include "btkMetaDataInfo.h"
 #include "btkMetaDataInfo_p.h"
+#include "btkMemoryArena.h"
+#include "btkCriticalSection_p.h"
 
 #include <math.h>
 
 namespace btk
 {
+  // Serializes the generation of the pointers returned by the const method MetaDataInfo::GetValues().
+  static critical_section_p& MetaDataInfoValuesLock_p()
+  {
+    static critical_section_p cs;
+    return cs;
+  };
+  
+  // Forces the initialization of the lock when the library is loaded (i.e. before the creation of any thread).
+  static critical_section_p& _btk_metadata_info_values_lock_init = MetaDataInfoValuesLock_p();
+  
   /**
    * @class MetaDataInfo btkMetaDataInfo.h
    * @brief Container class to store data of a MetaData object.
@@ -52,6 +64,11 @@ namespace btk
    * - btk::MetaDataInfo::Integer: Signed integer type stored only on 16 bit. Possible values between -32767 and 32768;
    * - btk::MetaDataInfo::Real: Float type. Precision limited to 1e-5.
    *
+   * The values are stored in one contiguous buffer typed after the format. The strings are stored with
+   * a fixed width (the first dimension), padded with white spaces, as in the parameter section of a C3D file.
+   * The methods GetByteView(), GetIntegerView(), GetRealView() and GetCharView() give access to this
+   * buffer without copying it.
+   *
    * @ingroup BTKCommon
    */
   
@@ -76,6 +93,11 @@ namespace btk
    * Enum value which represents the floats.
    */
   
+  /**
+   * @class MetaDataInfo::View btkMetaDataInfo.h
+   * @brief Read-only view (pointer and size) on contiguous values stored in a MetaDataInfo object.
+   */
+  
   /**
    * @typedef MetaDataInfo::Pointer
    * Smart pointer associated with a MetaDataInfo object.
@@ -164,9 +186,24 @@ namespace btk
    */
 
   MetaDataInfo::~MetaDataInfo()
+  {}
+  
+  /**
+   * Allocates the memory of the object in the current memory arena (if any) or in the free store.
+   * @sa MemoryArena
+   */
+  void* MetaDataInfo::operator new(size_t size)
+  {
+    return MemoryArena::AllocateObject(size);
+  };
+  
+  /**
+   * Releases the memory of an object allocated with the operator new of this class.
+   */
+  void MetaDataInfo::operator delete(void* ptr)
   {
-    Clear_p(this->m_Format, this->m_Values);
-  }
+    MemoryArena::DeallocateObject(ptr);
+  };
 
   /**
    * @fn Format MetaDataInfo::GetFormat() const
@@ -206,17 +243,51 @@ namespace btk
     if (this->m_Format == format)
       return;
     
-    std::vector<void*> oldValues = this->m_Values;
-    
-    this->m_Values = Convertify_p(this->m_Format, format, this->m_Values);
-    Clear_p(this->m_Format, oldValues);
-    
-    if (this->m_Format == Char)
+    if ((this->m_Format == Char) && !this->m_Dims.empty())
       this->m_Dims.erase(this->m_Dims.begin());
-    else if ((format == Char) && (this->m_Values.size() != 0))
-      this->m_Dims.insert(this->m_Dims.begin(), static_cast<uint8_t>(static_cast<std::string*>(this->m_Values[0])->length()));
-    
-    this->m_Format = format;
+    switch (format)
+    {
+      case Char:
+      {
+        std::vector<std::string> values;
+        Extract_p(this, values);
+        int width = 0;
+        for (size_t i = 0 ; i < values.size() ; ++i)
+          width = std::max(width, static_cast<int>(values[i].length()));
+        this->ClearValues(Char);
+        if (!values.empty())
+          this->m_Dims.insert(this->m_Dims.begin(), static_cast<uint8_t>(width));
+        this->AssignStrings(values);
+        break;
+      }
+      case Byte:
+      {
+        std::vector<int8_t> values;
+        Extract_p(this, values);
+        this->ClearValues(Byte);
+        this->m_Bytes.swap(values);
+        this->m_ValueNumber = static_cast<int>(this->m_Bytes.size());
+        break;
+      }
+      case Integer:
+      {
+        std::vector<int16_t> values;
+        Extract_p(this, values);
+        this->ClearValues(Integer);
+        this->m_Integers.swap(values);
+        this->m_ValueNumber = static_cast<int>(this->m_Integers.size());
+        break;
+      }
+      case Real:
+      {
+        std::vector<float> values;
+        Extract_p(this, values);
+        this->ClearValues(Real);
+        this->m_Reals.swap(values);
+        this->m_ValueNumber = static_cast<int>(this->m_Reals.size());
+        break;
+      }
+    }
   };
 
   /**
@@ -236,67 +307,51 @@ namespace btk
    */
   void MetaDataInfo::SetDimension(int idx, uint8_t val)
   {
-    if (idx >= static_cast<int>(this->m_Dims.size()))
+    if ((idx < 0) || (idx >= static_cast<int>(this->m_Dims.size())))
     {
       btkErrorMacro("Out of range");
       return;
     }
     if (this->m_Dims[idx] == val)
       return;
-    int oldProd = this->GetDimensionsProduct();
     uint8_t oldValue = this->m_Dims[idx];
     this->m_Dims[idx] = val;
-    int prod = this->GetDimensionsProduct();
+    int repeat = this->GetDimensionsProduct(idx + 1);
     if (this->m_Format == Char)
     {
       if (idx == 0)
+        this->ResizeCharWidth(val);
+      else
       {
-        std::vector<void*>::iterator it = this->m_Values.begin();
-        while (it != this->m_Values.end())
-        {
-          (static_cast<std::string*>(*it))->resize(val, ' ');
-          ++it;
-        }
+        int inner = this->m_CharWidth;
+        for (int i = 1 ; i < idx ; ++i)
+          inner *= this->m_Dims[i];
+        Reshape_p(this->m_Chars, inner, oldValue, val, repeat, ' ');
+        this->m_ValueNumber = this->GetDimensionsProduct(1);
       }
     }
-    if ( (this->m_Format != Char) || (idx != 0) )
+    else
     {
-      int diffNb = val - oldValue;
-      int repeat = this->GetDimensionsProduct(idx + 1);
-      if (diffNb < 0)
-      {
-        int inc = 1;
-        int step = prod / repeat;
-        if (this->m_Format == Char)
-          step = step / this->m_Dims[0];
-        int elts = step / val;
-        diffNb = diffNb * (-1);
-        while(inc <= repeat)
-        {
-          std::vector<void*>::iterator itStart = this->m_Values.begin();
-          std::vector<void*>::iterator itEnd = this->m_Values.begin();
-          std::advance(itStart, step * inc);
-          std::advance(itEnd, step * inc + diffNb * elts);
-          Erase_p(this->m_Format, this->m_Values, itStart, itEnd);
-          ++inc;
-        }   
-      }
-      else
+      int inner = 1;
+      for (int i = 0 ; i < idx ; ++i)
+        inner *= this->m_Dims[i];
+      switch (this->m_Format)
       {
-        int inc = repeat;
-        int step = oldProd / repeat;
-        if (this->m_Format == Char)
-          step = step / this->m_Dims[0];
-        int elts = step / oldValue;
-        while(inc > 0)
-        {
-          std::vector<void*>::iterator it = this->m_Values.begin();
-          std::advance(it, step * inc);
-          Insert_p(this->m_Format, this->m_Values, it, diffNb * elts);
-          --inc;
-        }
+        case Byte:
+          Reshape_p(this->m_Bytes, inner, oldValue, val, repeat, static_cast<int8_t>(0));
+          break;
+        case Integer:
+          Reshape_p(this->m_Integers, inner, oldValue, val, repeat, static_cast<int16_t>(0));
+          break;
+        case Real:
+          Reshape_p(this->m_Reals, inner, oldValue, val, repeat, 0.0f);
+          break;
+        default: // Impossible
+          break;
       }
+      this->m_ValueNumber = this->GetDimensionsProduct();
     }
+    this->m_ValuesModified = true;
   };
 
   /**
@@ -327,18 +382,20 @@ namespace btk
       return;
     this->m_Dims = dims;
     if (dims.empty())
-      Resize_p(this->m_Format, this->m_Values, 1);
+    {
+      this->ResizeValues(1);
+      if ((this->m_Format == Char) && (this->m_CharWidth == 0))
+        this->ResizeCharWidth(1);
+    }
     else
     {
       if (this->m_Format == Char)
       {
-        int prod = this->GetDimensionsProduct(1);
-        Resize_p(this->m_Values, prod, std::string(this->m_Dims[0], ' '));
-        for (int i = 0 ; i < prod ; ++i)
-          static_cast<std::string*>(this->m_Values[i])->resize(this->m_Dims[0], ' ');
+        this->ResizeCharWidth(this->m_Dims[0]);
+        this->ResizeValues(this->GetDimensionsProduct(1));
       }
       else
-        Resize_p(this->m_Format, this->m_Values, this->GetDimensionsProduct());
+        this->ResizeValues(this->GetDimensionsProduct());
     }
   };
 
@@ -357,9 +414,9 @@ namespace btk
       int inc = 0;
       if (this->m_Format == Char)
         inc = 1;
-      Resize_p(this->m_Format, this->m_Values, this->GetDimensionsProduct(inc));
+      this->ResizeValues(this->GetDimensionsProduct(inc));
       if (this->m_Format == Char && nb == 0)
-        static_cast<std::string*>(this->m_Values[0])->resize(1, ' ');
+        this->ResizeCharWidth(1);
     }
     else
       this->m_Dims.resize(nb, 1);
@@ -368,16 +425,17 @@ namespace btk
 
   /**
    * Returns the value for the given @a idx or 0 if @a idx is out of range.
+   * The value must be only read (see GetValues()).
    */
   void* MetaDataInfo::GetValue(int idx) const
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if ((idx < 0) || (idx >= this->m_ValueNumber))
     {
       btkErrorMacro("Out of range");
       return 0;
     }
     else
-      return this->m_Values[idx];
+      return this->GetValues()[idx];
   };
 
   /**
@@ -387,14 +445,16 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, int8_t val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if ((idx < 0) || (idx >= this->m_ValueNumber))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    if (this->m_Format == Char)
+      this->SetNumberAsString(idx, btk::ToString(val));
+    else
+      Assign_p(this->m_Format, this->m_Bytes, this->m_Integers, this->m_Reals, idx, val);
+    this->m_ValuesModified = true;
   };
 
   /**
@@ -404,14 +464,16 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, int16_t val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if ((idx < 0) || (idx >= this->m_ValueNumber))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    if (this->m_Format == Char)
+      this->SetNumberAsString(idx, btk::ToString(val));
+    else
+      Assign_p(this->m_Format, this->m_Bytes, this->m_Integers, this->m_Reals, idx, val);
+    this->m_ValuesModified = true;
   };
 
   /**
@@ -421,14 +483,16 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, float val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if ((idx < 0) || (idx >= this->m_ValueNumber))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    if (this->m_Format == Char)
+      this->SetNumberAsString(idx, btk::ToString(val));
+    else
+      Assign_p(this->m_Format, this->m_Bytes, this->m_Integers, this->m_Reals, idx, val);
+    this->m_ValuesModified = true;
   };
 
   /**
@@ -439,23 +503,16 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, const std::string& val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if ((idx < 0) || (idx >= this->m_ValueNumber))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    
-    Delete_p(this->m_Format, this->m_Values[idx]);    
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
-
     if (this->m_Format == Char)
-    {
-      int len = static_cast<int>(val.length());
-      if (len > this->m_Dims[0])
-        this->m_Dims[0] = len;
-      for (int i = 0 ; i < this->GetDimensionsProduct(1) ; ++i)
-        static_cast<std::string*>(this->m_Values[i])->resize(this->m_Dims[0], ' ');
-    }
+      this->SetString(idx, val);
+    else
+      Assign_p(this->m_Format, this->m_Bytes, this->m_Integers, this->m_Reals, idx, val);
+    this->m_ValuesModified = true;
   };
   
   /**
@@ -465,13 +522,16 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, int val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if ((idx < 0) || (idx >= this->m_ValueNumber))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    if (this->m_Format == Char)
+      this->SetNumberAsString(idx, btk::ToString(val));
+    else
+      Assign_p(this->m_Format, this->m_Bytes, this->m_Integers, this->m_Reals, idx, val);
+    this->m_ValuesModified = true;
   };
   
   /**
@@ -481,13 +541,16 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, double val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if ((idx < 0) || (idx >= this->m_ValueNumber))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    if (this->m_Format == Char)
+      this->SetNumberAsString(idx, btk::ToString(val));
+    else
+      Assign_p(this->m_Format, this->m_Bytes, this->m_Integers, this->m_Reals, idx, val);
+    this->m_ValuesModified = true;
   };
   
   /**
@@ -496,9 +559,100 @@ namespace btk
    */
   
   /**
-   * @fn const std::vector<std::string>& MetaDataInfo::GetValues() const
-   * Returns the values as a vector of strings.
+   * @fn int MetaDataInfo::GetValueNumber() const
+   * Returns the number of stored values (the number of strings for the Char format).
    */
+  
+  /**
+   * Returns the values as a vector of pointers to the stored elements.
+   *
+   * The pointers are generated on demand from the contiguous storage and are invalidated
+   * by any modification of the values, the format or the dimensions. For the Char format,
+   * each pointer targets a std::string. Prefer the views (GetByteView(), GetIntegerView(),
+   * GetRealView(), GetCharView()) to access the values without any intermediate copy.
+   *
+   * This method can be called concurrently as the generation of the pointers is serialized.
+   *
+   * @warning The values must be only read. For the Char format, the strings are copies of the 
+   * stored characters and a modification through a pointer is lost. Use the methods SetValue()
+   * and SetValues() to modify the values.
+   */
+  const std::vector<void*>& MetaDataInfo::GetValues() const
+  {
+    MetaDataInfoValuesLock_p().Lock();
+    if (this->m_ValuesModified)
+    {
+      this->m_Values.resize(this->m_ValueNumber);
+      this->m_Strings.clear();
+      switch (this->m_Format)
+      {
+        case Byte:
+          for (int i = 0 ; i < this->m_ValueNumber ; ++i)
+            this->m_Values[i] = const_cast<int8_t*>(&(this->m_Bytes[i]));
+          break;
+        case Integer:
+          for (int i = 0 ; i < this->m_ValueNumber ; ++i)
+            this->m_Values[i] = const_cast<int16_t*>(&(this->m_Integers[i]));
+          break;
+        case Real:
+          for (int i = 0 ; i < this->m_ValueNumber ; ++i)
+            this->m_Values[i] = const_cast<float*>(&(this->m_Reals[i]));
+          break;
+        case Char:
+          this->m_Strings.resize(this->m_ValueNumber);
+          Stringify_p(this->GetCharView(), this->m_CharWidth, this->m_Strings);
+          for (int i = 0 ; i < this->m_ValueNumber ; ++i)
+            this->m_Values[i] = &(this->m_Strings[i]);
+          break;
+      }
+      this->m_ValuesModified = false;
+    }
+    MetaDataInfoValuesLock_p().Unlock();
+    return this->m_Values;
+  };
+  
+  /**
+   * @fn int MetaDataInfo::GetCharWidth() const
+   * Returns the number of characters used by each string (i.e. the first dimension for the Char format).
+   * The strings are stored contiguously, padded with white spaces, as in the parameter section of a C3D file.
+   */
+  
+  /**
+   * @fn MetaDataInfo::View<int8_t> MetaDataInfo::GetByteView() const
+   * Returns a view on the stored values without copying them. The view is empty if the format is not Byte.
+   * @warning The view is invalidated by any modification of the values, the format or the dimensions.
+   */
+  
+  /**
+   * @fn MetaDataInfo::View<int16_t> MetaDataInfo::GetIntegerView() const
+   * Returns a view on the stored values without copying them. The view is empty if the format is not Integer.
+   * @warning The view is invalidated by any modification of the values, the format or the dimensions.
+   */
+  
+  /**
+   * @fn MetaDataInfo::View<float> MetaDataInfo::GetRealView() const
+   * Returns a view on the stored values without copying them. The view is empty if the format is not Real.
+   * @warning The view is invalidated by any modification of the values, the format or the dimensions.
+   */
+  
+  /**
+   * @fn MetaDataInfo::View<char> MetaDataInfo::GetCharView() const
+   * Returns a view on all the characters of the stored strings (GetValueNumber() x GetCharWidth() characters, without null terminator).
+   * The view is empty if the format is not Char.
+   * @warning The view is invalidated by any modification of the values, the format or the dimensions.
+   */
+  
+  /**
+   * Returns a view on the characters of the string at the index @a idx (GetCharWidth() characters, without null terminator).
+   * The view is empty if the format is not Char or if @a idx is out of range.
+   * @warning The view is invalidated by any modification of the values, the format or the dimensions.
+   */
+  MetaDataInfo::View<char> MetaDataInfo::GetCharView(int idx) const
+  {
+    if ((this->m_Format != Char) || (idx < 0) || (idx >= this->m_ValueNumber) || (this->m_CharWidth == 0))
+      return View<char>();
+    return View<char>(&(this->m_Chars[idx * this->m_CharWidth]), this->m_CharWidth);
+  };
 
   /**
    * @fn void MetaDataInfo::SetValues(int8_t val)
@@ -546,12 +700,11 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<std::string>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->ClearValues(Char);
      this->FillDimensions(val);
-     this->m_Format = Char;
      std::vector<std::string> values = val;
      this->FillSource(values);
-     Voidify_p(values, this->m_Values);
+     this->AssignStrings(values);
    };
 
    /**
@@ -563,10 +716,11 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<int8_t>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->ClearValues(Byte);
      this->m_Dims = dims;
-     this->m_Format = Byte;
-     Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+     this->m_Bytes = val;
+     this->m_ValueNumber = this->GetDimensionsProduct();
+     this->m_Bytes.resize(this->m_ValueNumber, 0);
    };
 
    /**
@@ -578,11 +732,11 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<int16_t>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->ClearValues(Integer);
      this->m_Dims = dims;
-     this->m_Format = Integer;
-     Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
-
+     this->m_Integers = val;
+     this->m_ValueNumber = this->GetDimensionsProduct();
+     this->m_Integers.resize(this->m_ValueNumber, 0);
    };
    
    /**
@@ -594,10 +748,11 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<float>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->ClearValues(Real);
      this->m_Dims = dims;
-     this->m_Format = Real;
-     Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+     this->m_Reals = val;
+     this->m_ValueNumber = this->GetDimensionsProduct();
+     this->m_Reals.resize(this->m_ValueNumber, 0);
    };
    
    /**
@@ -611,12 +766,11 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<std::string>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->ClearValues(Char);
      this->m_Dims = dims;
-     this->m_Format = Char;
      std::vector<std::string> values = val;
      this->FillSource(values);
-     Voidify_p(values, this->m_Values);
+     this->AssignStrings(values);
    };
 
   /**
@@ -629,7 +783,7 @@ namespace btk
    */
   const std::string MetaDataInfo::ToString(int idx) const
   {
-    return Devoidify_p<std::string>(this->m_Format, this->m_Values, idx, String);
+    return Extract_p<std::string>(this, idx);
   };
 
   /**
@@ -637,7 +791,7 @@ namespace btk
    */
   int8_t MetaDataInfo::ToInt8(int idx) const
   {
-    return Devoidify_p<int8_t>(this->m_Format, this->m_Values, idx, Int8);
+    return Extract_p<int8_t>(this, idx);
   };
 
   /**
@@ -645,7 +799,7 @@ namespace btk
    */
   uint8_t MetaDataInfo::ToUInt8(int idx) const
   {
-    return Devoidify_p<uint8_t>(this->m_Format, this->m_Values, idx, UInt8);
+    return Extract_p<uint8_t>(this, idx);
   };
 
   /**
@@ -653,7 +807,7 @@ namespace btk
    */
   int16_t MetaDataInfo::ToInt16(int idx) const
   {
-    return Devoidify_p<int16_t>(this->m_Format, this->m_Values, idx, Int16);
+    return Extract_p<int16_t>(this, idx);
   };
 
   /**
@@ -661,7 +815,7 @@ namespace btk
    */
   uint16_t MetaDataInfo::ToUInt16(int idx) const
   {
-    return Devoidify_p<uint16_t>(this->m_Format, this->m_Values, idx, UInt16);
+    return Extract_p<uint16_t>(this, idx);
   };
 
   /**
@@ -669,7 +823,7 @@ namespace btk
    */
   int MetaDataInfo::ToInt(int idx) const
   {
-    return Devoidify_p<int>(this->m_Format, this->m_Values, idx, Int);
+    return Extract_p<int>(this, idx);
   };
 
   /**
@@ -677,7 +831,7 @@ namespace btk
    */
   unsigned int MetaDataInfo::ToUInt(int idx) const
   {
-    return Devoidify_p<unsigned int>(this->m_Format, this->m_Values, idx, UInt);
+    return Extract_p<unsigned int>(this, idx);
   };
 
   /**
@@ -685,7 +839,7 @@ namespace btk
    */
   float MetaDataInfo::ToFloat(int idx) const
   {
-    return Devoidify_p<float>(this->m_Format, this->m_Values, idx, Float);
+    return Extract_p<float>(this, idx);
   };
 
   /**
@@ -693,7 +847,7 @@ namespace btk
    */
   double MetaDataInfo::ToDouble(int idx) const
   {
-    return Devoidify_p<double>(this->m_Format, this->m_Values, idx, Double);
+    return Extract_p<double>(this, idx);
   };
 
   /**
@@ -701,7 +855,7 @@ namespace btk
    */
   const std::vector<std::string> MetaDataInfo::ToString() const
   {
-    return Devoidify_p<std::string>(this->m_Format, this->m_Values, String);
+    return Extract_p<std::string>(this);
   };
   
   /**
@@ -709,7 +863,7 @@ namespace btk
    */
   void MetaDataInfo::ToString(std::vector<std::string>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, String);
+    Extract_p(this, val);
   };
 
   /**
@@ -717,7 +871,7 @@ namespace btk
    */
   const std::vector<int8_t> MetaDataInfo::ToInt8() const
   {
-    return Devoidify_p<int8_t>(this->m_Format, this->m_Values, Int8);
+    return Extract_p<int8_t>(this);
   };
 
  /**
@@ -725,7 +879,7 @@ namespace btk
    */
    void MetaDataInfo::ToInt8(std::vector<int8_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Int8);
+    Extract_p(this, val);
   };
 
   /**
@@ -733,7 +887,7 @@ namespace btk
    */
   const std::vector<uint8_t> MetaDataInfo::ToUInt8() const
   {
-    return Devoidify_p<uint8_t>(this->m_Format, this->m_Values, UInt8);
+    return Extract_p<uint8_t>(this);
   };
 
   /**
@@ -741,7 +895,7 @@ namespace btk
    */
   void MetaDataInfo::ToUInt8(std::vector<uint8_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, UInt8);
+    Extract_p(this, val);
   };
 
   /**
@@ -749,7 +903,7 @@ namespace btk
    */
   const std::vector<int16_t> MetaDataInfo::ToInt16() const
   {
-    return Devoidify_p<int16_t>(this->m_Format, this->m_Values, Int16);
+    return Extract_p<int16_t>(this);
   };
 
   /**
@@ -757,7 +911,7 @@ namespace btk
    */
   void MetaDataInfo::ToInt16(std::vector<int16_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Int16);
+    Extract_p(this, val);
   };
 
   /**
@@ -765,7 +919,7 @@ namespace btk
    */
   const std::vector<uint16_t> MetaDataInfo::ToUInt16() const
   {
-    return Devoidify_p<uint16_t>(this->m_Format, this->m_Values, UInt16);
+    return Extract_p<uint16_t>(this);
   };
 
   /**
@@ -773,7 +927,7 @@ namespace btk
    */
   void MetaDataInfo::ToUInt16(std::vector<uint16_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, UInt16);
+    Extract_p(this, val);
   };
 
   /**
@@ -781,7 +935,7 @@ namespace btk
    */
   const std::vector<int> MetaDataInfo::ToInt() const
   {
-    return Devoidify_p<int>(this->m_Format, this->m_Values, Int);
+    return Extract_p<int>(this);
   };
 
   /**
@@ -789,7 +943,7 @@ namespace btk
    */
   void MetaDataInfo::ToInt(std::vector<int>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Int);
+    Extract_p(this, val);
   };
 
   /**
@@ -797,7 +951,7 @@ namespace btk
    */
   const std::vector<unsigned int> MetaDataInfo::ToUInt() const
   {
-    return Devoidify_p<unsigned int>(this->m_Format, this->m_Values, UInt);
+    return Extract_p<unsigned int>(this);
   };
 
   /**
@@ -805,7 +959,7 @@ namespace btk
    */
   void MetaDataInfo::ToUInt(std::vector<unsigned int>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, UInt);
+    Extract_p(this, val);
   };
 
   /**
@@ -813,7 +967,7 @@ namespace btk
    */
   const std::vector<float> MetaDataInfo::ToFloat() const 
   {
-    return Devoidify_p<float>(this->m_Format, this->m_Values, Float);
+    return Extract_p<float>(this);
   };
 
   /**
@@ -821,7 +975,7 @@ namespace btk
    */
   void MetaDataInfo::ToFloat(std::vector<float>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Float);
+    Extract_p(this, val);
   };
 
   /**
@@ -829,7 +983,7 @@ namespace btk
    */
   const std::vector<double> MetaDataInfo::ToDouble() const 
   {
-    return Devoidify_p<double>(this->m_Format, this->m_Values, Double);
+    return Extract_p<double>(this);
   };
 
   /**
@@ -837,7 +991,7 @@ namespace btk
    */
   void MetaDataInfo::ToDouble(std::vector<double>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Double);
+    Extract_p(this, val);
   };
 
   
@@ -850,20 +1004,22 @@ namespace btk
       return false;
     if (rLHS.m_Dims != rRHS.m_Dims) 
       return false;
+    if (rLHS.m_ValueNumber != rRHS.m_ValueNumber)
+      return false;
     bool equal = false;
     switch (rLHS.m_Format)
     {
     case MetaDataInfo::Char:
-      equal = OperatorEqual_p<std::string>(rLHS.m_Values, rRHS.m_Values);
+      equal = (rLHS.m_CharWidth == rRHS.m_CharWidth) && (rLHS.m_Chars == rRHS.m_Chars);
       break;
     case MetaDataInfo::Byte:
-      equal = OperatorEqual_p<char>(rLHS.m_Values, rRHS.m_Values);
+      equal = (rLHS.m_Bytes == rRHS.m_Bytes);
       break;
     case MetaDataInfo::Integer:
-      equal = OperatorEqual_p<int16_t>(rLHS.m_Values, rRHS.m_Values);
+      equal = (rLHS.m_Integers == rRHS.m_Integers);
       break;
     case MetaDataInfo::Real:
-      equal = OperatorEqual_p<float>(rLHS.m_Values, rRHS.m_Values);
+      equal = OperatorEqual_p(rLHS.m_Reals, rRHS.m_Reals);
       break;
     }
     return equal;
@@ -879,10 +1035,9 @@ namespace btk
    * The dimension's value is equal to the size of @a val.
    */
   MetaDataInfo::MetaDataInfo(const std::string& val)
-  : m_Dims(std::vector<uint8_t>(1,static_cast<uint8_t>(val.length())))
+  : m_Dims(std::vector<uint8_t>(1,static_cast<uint8_t>(val.length()))), m_Format(Char), m_ValueNumber(0), m_CharWidth(0), m_ValuesModified(true)
   {
-    this->m_Format = Char;
-    Voidify_p(std::vector<std::string>(1, val), this->m_Values);
+    this->AssignStrings(std::vector<std::string>(1, val));
   };
 
   /**
@@ -890,12 +1045,12 @@ namespace btk
    * @warning The number of values must be lower than 256 and the maximum length for the strings is equal to 255.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<std::string>& val)
+  : m_Dims(), m_Format(Char), m_ValueNumber(0), m_CharWidth(0), m_ValuesModified(true)
   {
     std::vector<std::string> values = val;
     this->FillDimensions(values);
     this->FillSource(values);
-    this->m_Format = Char;
-    Voidify_p(values, this->m_Values);
+    this->AssignStrings(values);
   };
 
   /**
@@ -905,10 +1060,10 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<int8_t>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), m_Format(Byte), m_ValueNumber(0), m_CharWidth(0), m_Bytes(val), m_ValuesModified(true)
   {
-    this->m_Format = Byte;
-    Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+    this->m_ValueNumber = this->GetDimensionsProduct();
+    this->m_Bytes.resize(this->m_ValueNumber, 0);
   };
   
   /**
@@ -918,10 +1073,10 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<int16_t>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), m_Format(Integer), m_ValueNumber(0), m_CharWidth(0), m_Integers(val), m_ValuesModified(true)
   {
-    this->m_Format = Integer;
-    Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+    this->m_ValueNumber = this->GetDimensionsProduct();
+    this->m_Integers.resize(this->m_ValueNumber, 0);
   };
 
   /**
@@ -931,10 +1086,10 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<float>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), m_Format(Real), m_ValueNumber(0), m_CharWidth(0), m_Reals(val), m_ValuesModified(true)
   {
-    this->m_Format = Real;
-    Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+    this->m_ValueNumber = this->GetDimensionsProduct();
+    this->m_Reals.resize(this->m_ValueNumber, 0);
   };
 
   /**
@@ -946,23 +1101,21 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<std::string>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), m_Format(Char), m_ValueNumber(0), m_CharWidth(0), m_ValuesModified(true)
   {
-    this->m_Format = Char;
     std::vector<std::string> values = val;  
     this->FillSource(values);
-    Voidify_p(values, this->m_Values);
+    this->AssignStrings(values);
   };
    
   /**
    * Copy constructor
    */
   MetaDataInfo::MetaDataInfo(const MetaDataInfo& toCopy)
-  : m_Dims(toCopy.m_Dims)
-  {
-    this->m_Format = toCopy.m_Format;
-    Copy_p(this->m_Format, toCopy.m_Values, this->m_Values);
-  };
+  : m_Dims(toCopy.m_Dims), m_Format(toCopy.m_Format), m_ValueNumber(toCopy.m_ValueNumber), m_CharWidth(toCopy.m_CharWidth),
+    m_Bytes(toCopy.m_Bytes), m_Integers(toCopy.m_Integers), m_Reals(toCopy.m_Reals), m_Chars(toCopy.m_Chars),
+    m_Values(), m_Strings(), m_ValuesModified(true)
+  {};
 
   /*
    * Fills the the member MetaDataInfo::m_Dims for a vector of string
@@ -1001,4 +1154,107 @@ namespace btk
         val[i].resize(this->m_Dims[0], ' ');
     }
   };
+
+  /**
+   * Removes all the values and sets the format to @a format.
+   */
+  void MetaDataInfo::ClearValues(Format format)
+  {
+    this->m_Format = format;
+    this->m_ValueNumber = 0;
+    this->m_CharWidth = 0;
+    this->m_Bytes.clear();
+    this->m_Integers.clear();
+    this->m_Reals.clear();
+    this->m_Chars.clear();
+    this->m_ValuesModified = true;
+  };
+  
+  /**
+   * Resizes the number of values to @a num. The values added are "0" or a string with white spaces.
+   */
+  void MetaDataInfo::ResizeValues(int num)
+  {
+    switch (this->m_Format)
+    {
+      case Byte:
+        this->m_Bytes.resize(num, 0);
+        break;
+      case Integer:
+        this->m_Integers.resize(num, 0);
+        break;
+      case Real:
+        this->m_Reals.resize(num, 0.0f);
+        break;
+      case Char:
+        this->m_Chars.resize(num * this->m_CharWidth, ' ');
+        break;
+    }
+    this->m_ValueNumber = num;
+    this->m_ValuesModified = true;
+  };
+  
+  /**
+   * Stores the strings @a val (already adapted by FillSource) as fixed-width strings.
+   * The width corresponds to the first dimension or to the length of the string if there is no dimension.
+   */
+  void MetaDataInfo::AssignStrings(const std::vector<std::string>& val)
+  {
+    if (!this->m_Dims.empty())
+      this->m_CharWidth = this->m_Dims[0];
+    else
+      this->m_CharWidth = val.empty() ? 0 : static_cast<int>(val[0].length());
+    this->m_ValueNumber = static_cast<int>(val.size());
+    this->m_Chars.resize(this->m_ValueNumber * this->m_CharWidth);
+    if (this->m_CharWidth != 0)
+    {
+      for (int i = 0 ; i < this->m_ValueNumber ; ++i)
+        Charify_p(val[i], this->m_CharWidth, &(this->m_Chars[i * this->m_CharWidth]));
+    }
+    this->m_ValuesModified = true;
+  };
+  
+  /**
+   * Sets the number of characters of each string to @a width. The strings are truncated or padded with white spaces.
+   */
+  void MetaDataInfo::ResizeCharWidth(int width)
+  {
+    if (width == this->m_CharWidth)
+      return;
+    Reshape_p(this->m_Chars, 1, this->m_CharWidth, width, this->m_ValueNumber, ' ');
+    this->m_CharWidth = width;
+    this->m_ValuesModified = true;
+  };
+  
+  /**
+   * Sets the string @a val at the index @a idx. The width of the strings (and the first dimension) is enlarged if necessary.
+   */
+  void MetaDataInfo::SetString(int idx, const std::string& val)
+  {
+    int len = static_cast<int>(val.length());
+    if (len > this->m_CharWidth)
+    {
+      if (!this->m_Dims.empty())
+        this->m_Dims[0] = static_cast<uint8_t>(len);
+      this->ResizeCharWidth(len);
+    }
+    if (this->m_CharWidth != 0)
+      Charify_p(val, this->m_CharWidth, &(this->m_Chars[idx * this->m_CharWidth]));
+    this->m_ValuesModified = true;
+  };
+  
+  /**
+   * Sets the number @a val converted as a string at the index @a idx.
+   * If there is only one string, then its width fits exactly the converted number.
+   */
+  void MetaDataInfo::SetNumberAsString(int idx, const std::string& val)
+  {
+    if (this->m_ValueNumber == 1)
+    {
+      if (!this->m_Dims.empty())
+        this->m_Dims[0] = static_cast<uint8_t>(val.length());
+      this->ResizeCharWidth(static_cast<int>(val.length()));
+    }
+    this->SetString(idx, val);
+  };
 };
@@ -41,6 +41,7 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 
 #ifdef _MSC_VER
   #include "Utilities/stdint.h"
@@ -58,6 +59,23 @@ namespace btk
     typedef btkSharedPtr<const MetaDataInfo> ConstPointer;
     
     typedef btkNullPtr<MetaDataInfo> NullPointer;
+    
+    template <typename T>
+    class View
+    {
+    public:
+      View() : mp_Data(0), m_Size(0) {};
+      View(const T* data, int size) : mp_Data(data), m_Size(size) {};
+      const T* GetData() const {return this->mp_Data;};
+      int GetSize() const {return this->m_Size;};
+      bool IsEmpty() const {return (this->m_Size == 0);};
+      const T* Begin() const {return this->mp_Data;};
+      const T* End() const {return this->mp_Data + this->m_Size;};
+      const T& operator[](int idx) const {return this->mp_Data[idx];};
+    private:
+      const T* mp_Data;
+      int m_Size;
+    };
 
     static Pointer New(int8_t val) {return Pointer(new MetaDataInfo(std::vector<uint8_t>(0), std::vector<int8_t>(1, val)));};
     static Pointer New(int16_t val) {return Pointer(new MetaDataInfo(std::vector<uint8_t>(0), std::vector<int16_t>(1, val)));};
@@ -76,6 +94,9 @@ namespace btk
 
     BTK_COMMON_EXPORT ~MetaDataInfo();
     
+    BTK_COMMON_EXPORT static void* operator new(size_t size);
+    BTK_COMMON_EXPORT static void operator delete(void* ptr);
+    
     Format GetFormat() const {return this->m_Format;};
     BTK_COMMON_EXPORT std::string GetFormatAsString() const;
     BTK_COMMON_EXPORT void SetFormat(Format format);
@@ -92,8 +113,15 @@ namespace btk
     BTK_COMMON_EXPORT void SetValue(int idx, const std::string& val);
     BTK_COMMON_EXPORT void SetValue(int idx, int val);
     BTK_COMMON_EXPORT void SetValue(int idx, double val);
-    bool HasValues() const {return !this->m_Values.empty();};
-    const std::vector<void*>& GetValues() const {return this->m_Values;};
+    bool HasValues() const {return (this->m_ValueNumber != 0);};
+    int GetValueNumber() const {return this->m_ValueNumber;};
+    BTK_COMMON_EXPORT const std::vector<void*>& GetValues() const;
+    int GetCharWidth() const {return this->m_CharWidth;};
+    View<int8_t> GetByteView() const {return (this->m_Format == Byte) ? View<int8_t>(this->m_Bytes.empty() ? 0 : &(this->m_Bytes[0]), this->m_ValueNumber) : View<int8_t>();};
+    View<int16_t> GetIntegerView() const {return (this->m_Format == Integer) ? View<int16_t>(this->m_Integers.empty() ? 0 : &(this->m_Integers[0]), this->m_ValueNumber) : View<int16_t>();};
+    View<float> GetRealView() const {return (this->m_Format == Real) ? View<float>(this->m_Reals.empty() ? 0 : &(this->m_Reals[0]), this->m_ValueNumber) : View<float>();};
+    View<char> GetCharView() const {return (this->m_Format == Char) ? View<char>(this->m_Chars.empty() ? 0 : &(this->m_Chars[0]), static_cast<int>(this->m_Chars.size())) : View<char>();};
+    BTK_COMMON_EXPORT View<char> GetCharView(int idx) const;
     void SetValues(int8_t val) {this->SetValues(std::vector<uint8_t>(0), std::vector<int8_t>(1, val));};
     void SetValues(int16_t val) {this->SetValues(std::vector<uint8_t>(0), std::vector<int16_t>(1, val));};
     void SetValues(float val) {this->SetValues(std::vector<uint8_t>(0), std::vector<float>(1, val));};
@@ -156,10 +184,24 @@ namespace btk
 
     void FillDimensions(const std::vector<std::string>& val);
     void FillSource(std::vector<std::string>& val) const;
+    void ClearValues(Format format);
+    void ResizeValues(int num);
+    void AssignStrings(const std::vector<std::string>& val);
+    void ResizeCharWidth(int width);
+    void SetString(int idx, const std::string& val);
+    void SetNumberAsString(int idx, const std::string& val);
 
     std::vector<uint8_t> m_Dims;
     Format m_Format;
-    std::vector<void*> m_Values;
+    int m_ValueNumber;
+    int m_CharWidth;
+    std::vector<int8_t> m_Bytes;
+    std::vector<int16_t> m_Integers;
+    std::vector<float> m_Reals;
+    std::vector<char> m_Chars;
+    mutable std::vector<void*> m_Values;
+    mutable std::vector<std::string> m_Strings;
+    mutable bool m_ValuesModified;
   };
 };
 
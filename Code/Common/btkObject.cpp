@@ -34,6 +34,7 @@
  */
 
 #include "btkObject.h"
+#include "btkMemoryArena.h"
 #include "btkCriticalSection_p.h"
 
 // OSAtomic.h optimizations only used in 10.5 and later
@@ -116,6 +117,23 @@ namespace btk
 #endif
   };
   
+  /**
+   * Allocates the memory of the object in the current memory arena (if any) or in the free store.
+   * @sa MemoryArena
+   */
+  void* Object::operator new(size_t size)
+  {
+    return MemoryArena::AllocateObject(size);
+  };
+  
+  /**
+   * Releases the memory of an object allocated with the operator new of this class.
+   */
+  void Object::operator delete(void* ptr)
+  {
+    MemoryArena::DeallocateObject(ptr);
+  };
+  
   /**
    * @fn Object::Object()
    * Constructor.
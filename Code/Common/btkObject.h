@@ -38,6 +38,8 @@
 
 #include "btkSharedPtr.h"
 
+#include <cstddef>
+
 namespace btk
 {
   class Object
@@ -49,6 +51,9 @@ namespace btk
     unsigned long int GetTimestamp() const {return this->m_Timestamp;};
     BTK_COMMON_EXPORT virtual void Modified();
     
+    BTK_COMMON_EXPORT static void* operator new(size_t size);
+    BTK_COMMON_EXPORT static void operator delete(void* ptr);
+    
   protected:
     Object()
     {
@@ -184,7 +184,8 @@ namespace btk
   const Point::Residuals& Point::GetResiduals() const
   {
     assert(this->mp_Data != Point::Data::Null);
-    return this->mp_Data->GetResiduals();
+    // Const access: the residuals shared with a clone are not copied.
+    return static_cast<const Data*>(this->mp_Data.get())->GetResiduals();
   };
 
   /**
@@ -304,16 +305,23 @@ namespace btk
   /**
    * @fn MeasureTraits<Point>::Data::Residuals& MeasureTraits<Point>::Data::GetResiduals()
    * Returns the residuals for to this data.
+   * If the residuals are shared with a clone, they are copied before. The clones created after receive their own copy of the residuals (see MeasureData::GetValues()).
    */
   
   /**
    * @fn const MeasureTraits<Point>::Data::Residuals& MeasureTraits<Point>::Data::GetResiduals() const
    * Returns the residuals for to this data.
    */
-  
+
+  /**
+   * @fn btkSharedPtr<MeasureTraits<Point>::Data::Residuals> MeasureTraits<Point>::Data::GetResidualsPointer()
+   * Returns the residuals with a pointer keeping them alive (see MeasureData::GetValuesPointer()).
+   */
+
   /**
    * @fn void MeasureTraits<Point>::Data::SetResiduals(const MeasureTraits<Point>::Data::Residuals& r)
    * Sets the residuals for to this data.
+   * The residuals are assigned in place if they are not shared with a clone and if their number of frames is the same.
    */
  
   /**
@@ -67,18 +67,22 @@ namespace btk
       
       void Resize(int frameNumber);
       
-      Residuals& GetResiduals() {return this->m_Residuals;};
-      const Residuals& GetResiduals() const {return this->m_Residuals;};
-      void SetResiduals(const Residuals& r) {this->m_Residuals = r; this->Modified();};
+      Residuals& GetResiduals() {this->Load(); return this->mp_Residuals.GetMutableReference();};
+      const Residuals& GetResiduals() const {this->Load(); return *(this->mp_Residuals);};
+      btkSharedPtr<Residuals> GetResidualsPointer() {this->Load(); DetachShared_p(this->mp_Residuals); return this->mp_Residuals.GetPointer();};
+      void SetResiduals(const Residuals& r);
       
       Pointer Clone() const {return Pointer(new Data(*this));}
       
+    protected:
+      virtual void ReleaseLoaderReferences_p() {MeasureData<Point>::ReleaseLoaderReferences_p(); this->mp_Residuals.ReleaseReference();};
+      
     private:
-      Data(int frameNumber) : MeasureData<Point>(frameNumber), m_Residuals(Residuals::Zero(frameNumber,MeasureTraits<Point>::Residuals::ColsAtCompileTime)) {};
-      Data(const Data& toCopy) : MeasureData<Point>(toCopy), m_Residuals(toCopy.m_Residuals) {};
+      Data(int frameNumber) : MeasureData<Point>(frameNumber), mp_Residuals(new Residuals(Residuals::Zero(frameNumber,MeasureTraits<Point>::Residuals::ColsAtCompileTime))) {};
+      Data(const Data& toCopy) : MeasureData<Point>(toCopy), mp_Residuals(toCopy.mp_Residuals) {};
       Data& operator=(const Data& ); // Not implemented.
       
-      Residuals m_Residuals;
+      MeasureBuffer_p<Residuals> mp_Residuals;
     };
   };
 
@@ -133,28 +137,45 @@ namespace btk
   
   // ----------------------------------------------------------------------- //
   
+  inline void MeasureTraits<Point>::Data::SetResiduals(const Residuals& r)
+  {
+    this->Load();
+    if (!this->mp_Residuals.IsShared() && (this->mp_Residuals->rows() == r.rows()))
+      *(this->mp_Residuals) = r;
+    else
+      this->mp_Residuals = MeasureBuffer_p<Residuals>(new Residuals(r));
+    this->Modified();
+  };
+  
   inline void MeasureTraits<Point>::Data::Resize(int frameNumber)
   {
+    this->Load();
     // Values
-    if (frameNumber > this->m_Values.rows())
+    if (frameNumber > this->mp_Values->rows())
     {
-      Values v = Values::Zero(frameNumber,Values::ColsAtCompileTime);
-      if (this->m_Values.data() != 0)
-        v.block(0,0,this->m_Values.rows(),Values::ColsAtCompileTime) = this->m_Values;
-      this->m_Values = v;
+      MeasureBuffer_p<Values> v(new Values(Values::Zero(frameNumber,Values::ColsAtCompileTime)));
+      if (this->mp_Values->data() != 0)
+        v->block(0,0,this->mp_Values->rows(),Values::ColsAtCompileTime) = *(this->mp_Values);
+      this->mp_Values = v;
     }
     else
-      this->m_Values.conservativeResize(frameNumber,Values::ColsAtCompileTime);
+    {
+      DetachShared_p(this->mp_Values);
+      this->mp_Values->conservativeResize(frameNumber,Values::ColsAtCompileTime);
+    }
     // Residuals
-    if (frameNumber > this->m_Residuals.rows())
+    if (frameNumber > this->mp_Residuals->rows())
     {
-      Residuals r = Residuals::Zero(frameNumber, Residuals::ColsAtCompileTime);
-      if (this->m_Residuals.data() != 0)
-        r.block(0,0,this->m_Residuals.rows(),Residuals::ColsAtCompileTime) = this->m_Residuals;
-      this->m_Residuals = r;
+      MeasureBuffer_p<Residuals> r(new Residuals(Residuals::Zero(frameNumber, Residuals::ColsAtCompileTime)));
+      if (this->mp_Residuals->data() != 0)
+        r->block(0,0,this->mp_Residuals->rows(),Residuals::ColsAtCompileTime) = *(this->mp_Residuals);
+      this->mp_Residuals = r;
     }
     else
-      this->m_Residuals.conservativeResize(frameNumber);
+    {
+      DetachShared_p(this->mp_Residuals);
+      this->mp_Residuals->conservativeResize(frameNumber);
+    }
   };
 };
 
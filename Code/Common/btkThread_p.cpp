@@ -0,0 +1,213 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkThread_p.h"
+#include "btkMacro.h"
+
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+  #include <unistd.h> // sysconf
+#endif
+
+namespace btk
+{
+  struct thread_p_args
+  {
+    thread_p::Function func;
+    void* data;
+  };
+  
+  static void thread_p_exec(thread_p_args* args)
+  {
+    args->func(args->data);
+    delete args;
+  };
+  
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+  static void* thread_p_run(void* arg)
+  {
+    thread_p_exec(static_cast<thread_p_args*>(arg));
+    return 0;
+  };
+#elif defined(HAVE_WIN32_THREADS)
+  static DWORD WINAPI thread_p_run(LPVOID arg)
+  {
+    thread_p_exec(static_cast<thread_p_args*>(arg));
+    return 0;
+  };
+#endif
+  
+  /**
+   * @class thread_p btkThread_p.h
+   * @brief Minimal wrapper over the native threads (pthreads or Win32 threads) used internally to parallelize some algorithms.
+   *
+   * If the threads are not supported or if a thread cannot be created, the function is executed directly in the calling thread.
+   */
+  
+  /**
+   * Constructor.
+   */
+  thread_p::thread_p()
+  : m_Thread()
+  {
+    this->m_Running = false;
+  };
+  
+  /**
+   * Destructor. Wait the end of the thread if it is still running.
+   */
+  thread_p::~thread_p()
+  {
+    this->Join();
+  };
+  
+  /**
+   * Execute the function @a func with the argument @a data in a new thread.
+   */
+  void thread_p::Start(Function func, void* data)
+  {
+    if (!this->TryStart(func, data))
+      func(data);
+  };
+  
+  /**
+   * Execute the function @a func with the argument @a data in a new thread.
+   * Contrary to the method Start(), the function is not executed if the thread cannot be created and false is returned.
+   */
+  bool thread_p::TryStart(Function func, void* data)
+  {
+    this->Join();
+    thread_p_args* args = new thread_p_args;
+    args->func = func;
+    args->data = data;
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    this->m_Running = (pthread_create(&(this->m_Thread), NULL, &thread_p_run, args) == 0);
+#elif defined(HAVE_WIN32_THREADS)
+    this->m_Thread = CreateThread(NULL, 0, &thread_p_run, args, 0, NULL);
+    this->m_Running = (this->m_Thread != NULL);
+#endif
+    if (!this->m_Running)
+      delete args;
+    return this->m_Running;
+  };
+  
+  /**
+   * Wait the end of the thread.
+   */
+  void thread_p::Join()
+  {
+    if (!this->m_Running)
+      return;
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    pthread_join(this->m_Thread, NULL);
+#elif defined(HAVE_WIN32_THREADS)
+    WaitForSingleObject(this->m_Thread, INFINITE);
+    CloseHandle(this->m_Thread);
+#endif
+    this->m_Running = false;
+  };
+  
+  /**
+   * Returns the number of processors available on the computer (at least 1).
+   */
+  int thread_p::GetNumberOfProcessors()
+  {
+    int num = 1;
+#if defined(HAVE_WIN32_THREADS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    num = static_cast<int>(info.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+    num = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    return (num > 0) ? num : 1;
+  };
+  
+  /**
+   * @class wait_condition_p btkThread_p.h
+   * @brief Minimal wrapper over the native condition variables used with the class critical_section_p.
+   *
+   * Without thread support, the methods do nothing.
+   */
+  
+  /**
+   * Constructor.
+   */
+  wait_condition_p::wait_condition_p()
+  : m_Condition()
+  {
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    pthread_cond_init(&(this->m_Condition), NULL);
+#elif defined(HAVE_WIN32_THREADS)
+    InitializeConditionVariable(&(this->m_Condition));
+#endif
+  };
+  
+  /**
+   * Destructor.
+   */
+  wait_condition_p::~wait_condition_p()
+  {
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    pthread_cond_destroy(&(this->m_Condition));
+#endif
+  };
+  
+  /**
+   * Release the locked critical section @a cs, wait to be woken up and lock again @a cs.
+   * As spurious wake ups are possible, the awaited state must be tested again by the caller.
+   */
+  void wait_condition_p::Wait(critical_section_p* cs)
+  {
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    pthread_cond_wait(&(this->m_Condition), &(cs->m_CS));
+#elif defined(HAVE_WIN32_THREADS)
+    SleepConditionVariableCS(&(this->m_Condition), &(cs->m_CS), INFINITE);
+#else
+    btkNotUsed(cs);
+#endif
+  };
+  
+  /**
+   * Wake up all the threads waiting on this condition.
+   */
+  void wait_condition_p::WakeAll()
+  {
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    pthread_cond_broadcast(&(this->m_Condition));
+#elif defined(HAVE_WIN32_THREADS)
+    WakeAllConditionVariable(&(this->m_Condition));
+#endif
+  };
+};
@@ -145,6 +145,17 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the three first words of the buffer are 0x0000 0000 0080.
+   */
+  AcquisitionFileIO::ProbeResult ANBFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    static const char key[6] = {0x00, 0x00, 0x00, 0x00, 0x00, static_cast<char>(0x80)};
+    if ((size < 6) || (memcmp(buffer, key, 6) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Checks if the suffix of @a filename is ANB.
    */
@@ -64,6 +64,7 @@ namespace btk
     // ~ANBFileIO(); // Implicit.
     
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
+    BTK_IO_EXPORT virtual ProbeResult CanReadBuffer(const char* buffer, size_t size, const std::string& extension, size_t fileSize);
     BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
@@ -36,6 +36,7 @@
 #include "btkANCFileIO.h"
 #include "btkMetaDataUtils.h"
 #include "btkMotionAnalysisFileIOUtils_p.h"
+#include "btkASCIIFileUtils_p.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
 
@@ -43,11 +44,203 @@
 #include <algorithm>
 #include <cctype>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <sstream>
+#include <cmath>
 
 namespace btk
 {
+  // Extracts the next line of the header or throws an exception if the end of the file is reached.
+  inline void ANCFileIONextLine_p(ASCIITokenizer_p* tokenizer, std::string* line)
+  {
+    if (!tokenizer->NextLine(line))
+      throw(ANCFileIOException("Unexpected end of file."));
+  };
+  
+  // Destination of the values extracted from the rows of an ANC file.
+  struct ANCFileIOAnalogData_p
+  {
+    size_t frameNumber;
+    std::vector<double*> values;
+    std::vector<double> scales;
+  };
+  
+  // Rows of the data section parsed by one thread. The index of each row is given by its time.
+  struct ANCFileIOChunk_p
+  {
+    const char* begin;
+    const char* end;
+    const ANCFileIOAnalogData_p* data;
+    double firstTime; // Time of the first row of the data section
+    double rate;
+    long beginIndex; // Expected index of the first row (-1 if the chunk has no row)
+    long endIndex; // Index of the first row of the next chunk (the rows stored by each chunk are in disjoint ranges)
+    long firstIndex; // Index of the first row parsed (-1 if the chunk has no row)
+    long lastIndex; // Index of the last row parsed
+    bool valid; // False if a row cannot be parsed or if the rows are not consecutive
+  };
+  
+  // Extracts the time of the row and converts it in index. The time is rounded in the file: the index is the nearest integer.
+  inline bool ANCFileIOExtractRowIndex_p(ASCIITokenizer_p* row, double firstTime, double rate, long* index)
+  {
+    const char* b = 0;
+    const char* e = 0;
+    double time = 0.0;
+    if (!row->NextToken(&b, &e) || !ParseASCIIField_p(b, e, &time))
+      return false;
+    const double d = (time - firstTime) * rate;
+    *index = static_cast<long>(std::floor(d + 0.5));
+    return ((d >= -0.25) && (std::fabs(d - *index) <= 0.25));
+  };
+  
+  // Extracts the next line containing data (the blank lines are skipped).
+  inline bool ANCFileIONextRow_p(ASCIITokenizer_p* tokenizer, const char** first, const char** last)
+  {
+    do
+    {
+      if (!tokenizer->NextLine(first, last))
+        return false;
+    }
+    while (IsASCIIBlankRange_p(*first, *last));
+    return true;
+  };
+  
+  void ANCFileIOExtractChunk_p(void* chunk)
+  {
+    ANCFileIOChunk_p* c = static_cast<ANCFileIOChunk_p*>(chunk);
+    c->firstIndex = -1;
+    c->lastIndex = -1;
+    c->valid = false;
+    ASCIITokenizer_p tokenizer(c->begin, c->end);
+    const char* first = 0;
+    const char* last = 0;
+    long index = 0;
+    double val = 0.0;
+    const size_t numberOfChannels = c->data->values.size();
+    while (ANCFileIONextRow_p(&tokenizer, &first, &last))
+    {
+      ASCIITokenizer_p row(first, last);
+      if (!ANCFileIOExtractRowIndex_p(&row, c->firstTime, c->rate, &index)
+          || (index != ((c->lastIndex == -1) ? c->beginIndex : c->lastIndex + 1))
+          || (index >= c->endIndex))
+        return;
+      if (c->firstIndex == -1)
+        c->firstIndex = index;
+      c->lastIndex = index;
+      const bool store = (static_cast<size_t>(index) < c->data->frameNumber);
+      for (size_t j = 0 ; j < numberOfChannels ; ++j)
+      {
+        if (!row.NextNumber(&val))
+          return;
+        if (store)
+          c->data->values[j][index] = val * c->data->scales[j];
+      }
+      row.SkipBlanks();
+      if (!row.AtEnd())
+        return;
+    }
+    c->valid = true;
+  };
+  
+  /*
+   * Parses the data section [begin, end) with several threads. Each thread parses a range of complete rows and uses the time 
+   * of each row to know where to store its values. The index of the first row of each range is extracted before: a thread stops
+   * at the first row which is not in its own range of indices, so two threads never store the same row. The ranges are then 
+   * validated: the rows must be consecutive from the first row to the last expected frame and each row must contain one value 
+   * by channel. Returns false otherwise and the data section must be parsed sequentially (the values already extracted are 
+   * overwritten).
+   */
+  bool ANCFileIOExtractValues_p(const char* begin, const char* end, const ANCFileIOAnalogData_p* data, double rate, int numberOfThreads)
+  {
+    if (rate <= 0.0)
+      return false;
+    ASCIITokenizer_p tokenizer(begin, end);
+    const char* first = 0;
+    const char* last = 0;
+    double firstTime = 0.0;
+    if (!tokenizer.NextToken(&first, &last) || !ParseASCIIField_p(first, last, &firstTime))
+      return false;
+    while ((first > begin) && (*(first-1) != '\n'))
+      --first;
+    std::vector<const char*> bounds;
+    SplitASCIILines_p(first, end, numberOfThreads, &bounds);
+    std::vector<ANCFileIOChunk_p> chunks(numberOfThreads);
+    int previous = -1; // Last chunk with rows
+    for (int i = 0 ; i < numberOfThreads ; ++i)
+    {
+      chunks[i].begin = bounds[i];
+      chunks[i].end = bounds[i+1];
+      chunks[i].data = data;
+      chunks[i].firstTime = firstTime;
+      chunks[i].rate = rate;
+      chunks[i].beginIndex = -1;
+      chunks[i].endIndex = std::numeric_limits<long>::max();
+      ASCIITokenizer_p chunk(bounds[i], bounds[i+1]);
+      if (!ANCFileIONextRow_p(&chunk, &first, &last))
+        continue;
+      ASCIITokenizer_p row(first, last);
+      if (!ANCFileIOExtractRowIndex_p(&row, firstTime, rate, &(chunks[i].beginIndex)))
+        return false;
+      if (previous == -1)
+      {
+        if (chunks[i].beginIndex != 0)
+          return false;
+      }
+      else if (chunks[i].beginIndex <= chunks[previous].beginIndex)
+        return false;
+      else
+        chunks[previous].endIndex = chunks[i].beginIndex;
+      previous = i;
+    }
+    ProcessASCIIChunks_p(&chunks, &ANCFileIOExtractChunk_p);
+    // Validation
+    long nextIndex = 0;
+    for (int i = 0 ; i < numberOfThreads ; ++i)
+    {
+      if (!chunks[i].valid)
+        return false;
+      if (chunks[i].firstIndex == -1)
+        continue;
+      if (chunks[i].firstIndex != nextIndex)
+        return false;
+      nextIndex = chunks[i].lastIndex + 1;
+    }
+    return (static_cast<size_t>(nextIndex) >= data->frameNumber);
+  };
+  
+  // Formats the rows of the data section: time (6 decimals) and integer values of each channel (value divided by its scale).
+  class ANCFileIOFormatter_p : public ASCIIRowFormatter_p
+  {
+  public:
+    ANCFileIOFormatter_p(Acquisition::ConstPointer input, double stepTime)
+    : m_Values(), m_Scales(), m_StepTime(stepTime)
+    {
+      // Const access: the values shared with a clone are not copied.
+      for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+      {
+        Analog::ConstPointer analog = *it;
+        this->m_Values.push_back(analog->GetValues().data());
+        this->m_Scales.push_back(analog->GetScale());
+      }
+    };
+    virtual void Format(int frame, std::string* out) const
+    {
+      out->push_back('\n');
+      AppendASCIIFixed_p(out, static_cast<double>(frame) * this->m_StepTime, 6);
+      out->push_back('\t');
+      for (size_t i = 0 ; i < this->m_Values.size() ; ++i)
+      {
+        AppendASCIIInteger_p(out, static_cast<int>(this->m_Values[i][frame] / this->m_Scales[i]));
+        out->push_back('\t');
+      }
+    };
+  private:
+    std::vector<const double*> m_Values;
+    std::vector<double> m_Scales;
+    double m_StepTime;
+  };
+  
   /**
    * @class ANCFileIOException btkANCFileIO.h
    * @brief Exception class for the ANCFileIO class.
@@ -75,6 +268,9 @@ namespace btk
    * You can use the method GetFileGeneration() and SetFileGeneration() to extract or set the 
    * the generation file respectively.
    *
+   * The data section of large files can be parsed and formatted with several threads. Use the method ANCFileIO::SetNumberOfThreads() to set it.
+   * The extracted data (or the written file) are exactly the same than with only one thread.
+   *
    * The ANC file format is created by Motion Analysis Corp.
    * @warning The force platforms contained in this file format seem to be only force platforms of type II. 
    * @warning Moreover, Due to the file format, it is impossible to detect the correct scale for the force platforms' channels. Then, it is supposed, that the gain is 4000 and the excitation voltage is 10V. Plus, the scale factor is set as the opposite of the result to compute reactive forces.
@@ -111,6 +307,16 @@ namespace btk
     return true;
   };
   
+  /**
+   * Checks if the buffer starts with the header of an ANC file.
+   */
+  AcquisitionFileIO::ProbeResult ANCFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    if ((size < 41) || (memcmp(buffer, "File_Type:	Analog R/C ASCII	Generation#:	", 41) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Checks if the suffix of @a filename is ANC.
    */
@@ -131,15 +337,16 @@ namespace btk
   void ANCFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
-    // Open the stream
-    std::ifstream ifs;
-    ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
+    // Map the file (no stream is used to extract the values)
+    ASCIIFileBuffer_p buffer;
     try
     {
+      if (!buffer.Open(filename))
+        throw(ANCFileIOException("Invalid file path."));
+      ASCIITokenizer_p tokenizer(buffer.Begin(), buffer.End());
       std::string line;
-      ifs.open(filename.c_str());
     // Check the first header keyword: "File_Type:"
-      std::getline(ifs, line);
+      ANCFileIONextLine_p(&tokenizer, &line);
       if (line.substr(0,41).compare("File_Type:	Analog R/C ASCII	Generation#:	") != 0)
         throw(ANCFileIOException("Invalid ANC file."));
     // Check the file generation.
@@ -148,23 +355,23 @@ namespace btk
         throw(ANCFileIOException("Unknown ANC file generation: " + line.substr(42,43) + "."));
     // Extract header data
       // Board_Type & Polarity
-      std::getline(ifs, line);
+      ANCFileIONextLine_p(&tokenizer, &line);
       std::string boardType = this->ExtractKeywordValue(line, "Board_Type:	");
       std::string polarity = this->ExtractKeywordValue(line, "Polarity:	");
       // Trial_Name, Trial#, Duration(Sec.), #Channels
-      std::getline(ifs, line);
+      ANCFileIONextLine_p(&tokenizer, &line);
       double duration = FromString<double>(this->ExtractKeywordValue(line, "Duration(Sec.):	"));
       size_t numberOfChannels = FromString<size_t>(this->ExtractKeywordValue(line, "#Channels:	"));
 
       // BitDepth & PreciseRate
-      std::getline(ifs, line);
+      ANCFileIONextLine_p(&tokenizer, &line);
       int bitDepth = FromString<int>(this->ExtractKeywordValue(line, "BitDepth:	"));
       double preciseRate = FromString<double>(this->ExtractKeywordValue(line, "PreciseRate:	"));
       // Four next lines are empty
-      std::getline(ifs, line);
-      std::getline(ifs, line);
-      std::getline(ifs, line);
-      std::getline(ifs, line);
+      ANCFileIONextLine_p(&tokenizer, &line);
+      ANCFileIONextLine_p(&tokenizer, &line);
+      ANCFileIONextLine_p(&tokenizer, &line);
+      ANCFileIONextLine_p(&tokenizer, &line);
 
       // DEVELOPER CHECK
       // Check polarity's value. Only Bipolar is supported for the moment.
@@ -176,7 +383,7 @@ namespace btk
       {
         // Analog channels' label
         std::list<std::string> labels, rates, ranges;
-        std::getline(ifs, line);
+        ANCFileIONextLine_p(&tokenizer, &line);
         this->ExtractDataInfo(line, "Name", labels);
         size_t numberOfLabels = labels.size();
         if (numberOfChannels != numberOfLabels)
@@ -185,10 +392,10 @@ namespace btk
           numberOfChannels = numberOfLabels;
         }
         // Analog channels' rate
-        std::getline(ifs, line);
+        ANCFileIONextLine_p(&tokenizer, &line);
         this->ExtractDataInfo(line, "Rate", rates);
         // Analog channels' range
-        std::getline(ifs, line);
+        ANCFileIONextLine_p(&tokenizer, &line);
         this->ExtractDataInfo(line, "Range", ranges);
         double nf = duration * preciseRate; // Must be separate in two step due to some rounding errors
         size_t numberOfFrames = static_cast<size_t>(nf) + 1;
@@ -210,15 +417,33 @@ namespace btk
         ANxFileIOStoreHeader_p(output, filename, preciseRate, numberOfFrames, numberOfChannels, channelLabel, channelRate, channelRange, boardType, bitDepth, this->m_Generation);
         
         // Extract values
-        std::string buf;
-        double val = 0.0;
-        for(size_t i = 0 ; i < numberOfFrames ; ++i)
+        ANCFileIOAnalogData_p data;
+        data.frameNumber = numberOfFrames;
+        data.values.resize(numberOfChannels);
+        data.scales.resize(numberOfChannels);
+        inc = 0;
+        for (AnalogCollection::Iterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
         {
-          ifs >> buf; // Time's value          
-          for (AnalogCollection::Iterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
+          data.values[inc] = (*it)->GetValues().data();
+          data.scales[inc] = (*it)->GetScale();
+          ++inc;
+        }
+        const int numberOfThreads = ComputeASCIIThreadNumber_p(this->m_NumberOfThreads, tokenizer.GetEnd() - tokenizer.GetPosition());
+        if ((numberOfThreads == 1) || !ANCFileIOExtractValues_p(tokenizer.GetPosition(), tokenizer.GetEnd(), &data, preciseRate, numberOfThreads))
+        {
+          const char* first = 0;
+          const char* last = 0;
+          double val = 0.0;
+          for(size_t i = 0 ; i < numberOfFrames ; ++i)
           {
-            ifs >> val;
-            (*it)->GetValues().coeffRef(static_cast<int>(i)) = val * (*it)->GetScale();
+            if (!tokenizer.NextToken(&first, &last)) // Time's value
+              throw(ANCFileIOException("Unexpected end of file."));
+            for (size_t j = 0 ; j < numberOfChannels ; ++j)
+            {
+              if (!tokenizer.NextNumber(&val))
+                throw(ANCFileIOException(tokenizer.AtEnd() ? "Unexpected end of file." : "Invalid analog value for the frame #" + ToString(i + 1) + "."));
+              data.values[j][i] = val * data.scales[j];
+            }
           }
         }
       }
@@ -226,41 +451,24 @@ namespace btk
       MetaData::Pointer btkPointConfig = MetaDataCreateChild(output->GetMetaData(), "BTK_POINT_CONFIG");
       MetaDataCreateChild(btkPointConfig, "NO_FIRST_FRAME", static_cast<int8_t>(1));
     }
-    catch (std::fstream::failure& )
-    {
-      std::string excmsg; 
-      if (!ifs.is_open())
-        excmsg = "Invalid file path.";
-      else if (ifs.eof())
-        excmsg = "Unexpected end of file.";
-      else if(ifs.bad())
-        excmsg = "Loss of integrity of the file stream.";
-      else if(ifs.fail())
-        excmsg = "Internal logic operation error on the stream associated with the file.";
-      else
-        excmsg = "Unknown error associated with the file stream.";
-      
-      if (ifs.is_open()) ifs.close();    
-      throw(ANCFileIOException(excmsg));
-    }
     catch (ANCFileIOException& )
     {
-      if (ifs.is_open()) ifs.close(); 
+      buffer.Close();
       throw;
     }
     catch (ANxFileIOException& e)
     {
-      if (ifs.is_open()) ifs.close();
+      buffer.Close();
       throw(ANCFileIOException(e.what()));
     }
     catch (std::exception& e)
     {
-      if (ifs.is_open()) ifs.close(); 
+      buffer.Close();
       throw(ANCFileIOException("Unexpected exception occurred: " + std::string(e.what())));
     }
     catch(...)
     {
-      if (ifs.is_open()) ifs.close(); 
+      buffer.Close();
       throw(ANCFileIOException("Unknown exception"));
     }
   };
@@ -316,7 +524,6 @@ namespace btk
     for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
       ofs << static_cast<int>(freq) << static_cast<std::string>("\t");
     ofs << static_cast<std::string>("\nRange\t");
-    double time = 0.0;
     if (this->m_Generation != 2)
     {
       btkWarningMacro(filename, "Only the second generation is now supported. The exportation in the first generation of ANC file was removed due to the lack of data and to stay compatible with the interoperability of file formats.");
@@ -335,15 +542,9 @@ namespace btk
     {
       btkWarningMacro(filename, "The scale factors used in the ANC file do not correspond to these of the acquisition. Some of the data might be scaled. In case of force platform data, you have to create a calibration file (CAL) to restore exactly the data.");
     }
-    for (int frame = 0 ; frame < input->GetAnalogFrameNumber() ; ++frame)
-    {
-      ofs.precision(6);
-      ofs << std::endl << time << static_cast<std::string>("\t");
-      for (AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
-        ofs << static_cast<int>((*it)->GetValues().coeff(frame) / (*it)->GetScale()) << static_cast<std::string>("\t");
-      time += stepTime;
-    };
-    ofs << std::endl;
+    ANCFileIOFormatter_p formatter(input, stepTime);
+    WriteASCIIRows_p(&ofs, &formatter, input->GetAnalogFrameNumber(), this->m_NumberOfThreads);
+    ofs << "\n";
     ofs.close();
   };
   
@@ -357,6 +558,22 @@ namespace btk
    * Set the generation of the ANC file.
    */
   
+  /**
+   * @fn int ANCFileIO::GetNumberOfThreads() const
+   * Returns the number of threads used to parse or format the data section (1 by default).
+   */
+  
+  /**
+   * @fn void ANCFileIO::SetNumberOfThreads(int num)
+   * Sets the number of threads used to parse the data section. A value lower than 1 means to use one thread by processor.
+   *
+   * The data section is split in ranges of complete rows and each thread parses one of them. The time of each row gives
+   * the frame where to store its values. If the rows are not consecutive or do not contain exactly one value by channel, 
+   * the data section is parsed again with only one thread. The number of threads is reduced for small files.
+   *
+   * When a file is written, the rows are formatted by blocks and each thread formats its own block. The blocks are written in the order of the frames.
+   */
+  
   /**
    * Constructor.
    */
@@ -364,6 +581,7 @@ namespace btk
   : AcquisitionFileIO(AcquisitionFileIO::ASCII)
   {
     this->m_Generation = 2;
+    this->m_NumberOfThreads = 1;
   };
 
   std::string ANCFileIO::ExtractKeywordValue(const std::string& line, const std::string& keyword) const
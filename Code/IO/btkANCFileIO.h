@@ -64,12 +64,15 @@ namespace btk
     // ~ANCFileIO(); // Implicit.
     
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
+    BTK_IO_EXPORT virtual ProbeResult CanReadBuffer(const char* buffer, size_t size, const std::string& extension, size_t fileSize);
     BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
     
     int GetFileGeneration() const {return this->m_Generation;};
     BTK_IO_EXPORT void SetFileGeneration(int gen) {this->m_Generation = gen;};
+    int GetNumberOfThreads() const {return this->m_NumberOfThreads;};
+    void SetNumberOfThreads(int num) {this->m_NumberOfThreads = num;};
     
   protected:
     BTK_IO_EXPORT ANCFileIO();
@@ -82,6 +85,7 @@ namespace btk
     ANCFileIO& operator=(const ANCFileIO& ); // Not implemented. 
     
     int m_Generation;
+    int m_NumberOfThreads;
    };
 };
 
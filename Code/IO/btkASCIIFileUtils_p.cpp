@@ -0,0 +1,502 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkASCIIFileUtils_p.h"
+
+#include <fstream>
+#include <sstream>
+#include <locale>
+#include <limits>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <clocale>
+#include <algorithm>
+
+// Minimum number of bytes given to each thread. Below, the cost to create the thread is not amortized.
+const size_t _btk_ascii_thread_minimum_size = 1048576;
+// Number of bytes formatted in memory by each thread before to be written in the file.
+const size_t _btk_ascii_format_chunk_size = 1048576;
+
+namespace btk
+{
+  /*
+   * Maps the file @a filename in memory. If it is not possible (empty file, no support of the memory mapped files, etc.), its content is read.
+   */
+  bool ASCIIFileBuffer_p::Open(const std::string& filename)
+  {
+    this->Close();
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    this->m_Stream.open(filename.c_str(), std::ios_base::in);
+    if (this->m_Stream.is_open())
+    {
+      this->mp_Begin = this->m_Stream.rdbuf()->data();
+      this->mp_End = this->mp_Begin + this->m_Stream.rdbuf()->size();
+      this->m_Opened = true;
+      return true;
+    }
+#endif
+    std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!ifs.is_open())
+      return false;
+    ifs.seekg(0, std::ios_base::end);
+    std::streamoff size = ifs.tellg();
+    ifs.seekg(0, std::ios_base::beg);
+    if (size < 0)
+      return false;
+    this->m_Data.resize(static_cast<size_t>(size));
+    if ((size != 0) && !ifs.read(&(this->m_Data[0]), size))
+    {
+      this->m_Data.clear();
+      return false;
+    }
+    this->mp_Begin = this->m_Data.empty() ? 0 : &(this->m_Data[0]);
+    this->mp_End = this->mp_Begin + this->m_Data.size();
+    this->m_Opened = true;
+    return true;
+  };
+  
+  void ASCIIFileBuffer_p::Close()
+  {
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    if (this->m_Stream.is_open())
+      this->m_Stream.close();
+#endif
+    std::vector<char>().swap(this->m_Data);
+    this->mp_Begin = 0;
+    this->mp_End = 0;
+    this->m_Opened = false;
+  };
+  
+  inline bool ASCIIMatchNoCase_p(const char* first, const char* last, const char* word)
+  {
+    const size_t len = strlen(word);
+    if (static_cast<size_t>(last - first) < len)
+      return false;
+    for (size_t i = 0 ; i < len ; ++i)
+    {
+      if ((first[i] | 0x20) != word[i])
+        return false;
+    }
+    return true;
+  };
+  
+  /*
+   * Conversion used when ParseASCIINumber_p cannot guarantee an exact result (too many digits, large exponent) and for the special values (inf, nan).
+   * The characters are copied and converted by a string stream using the classic locale.
+   */
+  const char* ParseASCIINumberSlow_p(const char* first, const char* last, double* value)
+  {
+    const char* p = first;
+    bool negative = false;
+    if ((p < last) && ((*p == '-') || (*p == '+')))
+    {
+      negative = (*p == '-');
+      ++p;
+    }
+    if (ASCIIMatchNoCase_p(p, last, "nan"))
+    {
+      *value = std::numeric_limits<double>::quiet_NaN();
+      return p + 3;
+    }
+    else if (ASCIIMatchNoCase_p(p, last, "inf"))
+    {
+      *value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+      return ASCIIMatchNoCase_p(p, last, "infinity") ? p + 8 : p + 3;
+    }
+    else if ((p == last) || (((*p < '0') || (*p > '9')) && (*p != '.')))
+      return first;
+    const char* e = p;
+    while ((e < last) && (((*e >= '0') && (*e <= '9')) || (*e == '.') || (*e == 'e') || (*e == 'E') || (*e == '-') || (*e == '+')))
+      ++e;
+    std::istringstream iss(std::string(first, e));
+    iss.imbue(std::locale::classic());
+    double v = 0.0;
+    if (!(iss >> v))
+      return first;
+    *value = v;
+    if (iss.eof())
+      return e;
+    std::streamoff consumed = iss.tellg();
+    return (consumed < 0) ? e : first + consumed;
+  };
+  
+  /*
+   * Returns the number of threads to use to parse @a size bytes. A value of @a numberOfThreads lower than 1 means one thread by processor.
+   * The number of threads is reduced for small buffers.
+   */
+  int ComputeASCIIThreadNumber_p(int numberOfThreads, size_t size)
+  {
+    const int num = (numberOfThreads < 1) ? thread_p::GetNumberOfProcessors() : numberOfThreads;
+    const size_t maxThreads = std::max(size / _btk_ascii_thread_minimum_size, static_cast<size_t>(1));
+    return static_cast<int>(std::min(static_cast<size_t>(std::max(num, 1)), maxThreads));
+  };
+  
+  /*
+   * Splits the buffer [begin, end) in @a number ranges of similar sizes containing only complete lines.
+   * The bounds are stored in @a bounds (number + 1 elements). The range #i is [bounds[i], bounds[i+1]). Some ranges can be empty.
+   */
+  void SplitASCIILines_p(const char* begin, const char* end, int number, std::vector<const char*>* bounds)
+  {
+    bounds->resize(number + 1);
+    (*bounds)[0] = begin;
+    const size_t size = static_cast<size_t>(end - begin);
+    for (int i = 1 ; i < number ; ++i)
+    {
+      const char* b = std::max(begin + static_cast<size_t>(static_cast<double>(size) * i / number), (*bounds)[i-1]);
+      while ((b < end) && (b > begin) && (*(b-1) != '\n'))
+        ++b;
+      (*bounds)[i] = b;
+    }
+    (*bounds)[number] = end;
+  };
+  
+  /*
+   * The C library uses the decimal point of the current C locale. The written files use always the point.
+   */
+  static void AppendASCIIBuffer_p(std::string* out, char* buffer, int len)
+  {
+    if (len <= 0)
+      return;
+    const char point = localeconv()->decimal_point[0];
+    if (point != '.')
+    {
+      for (int i = 0 ; i < len ; ++i)
+      {
+        if (buffer[i] == point)
+          buffer[i] = '.';
+      }
+    }
+    out->append(buffer, len);
+  };
+  
+  static const double _btk_ascii_powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  static const unsigned long long _btk_ascii_integer_powers_of_ten[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+                                                                        10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+                                                                        100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+                                                                        100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+                                                                        100000000000000000ULL};
+  
+  /*
+   * Exact product: a * b = *p + *e (Dekker's algorithm, valid without overflow and underflow).
+   */
+  static inline void ASCIITwoProduct_p(double a, double b, double* p, double* e)
+  {
+    const double split = 134217729.0; // 2^27 + 1
+    *p = a * b;
+    double t = split * a;
+    const double ah = t - (t - a), al = a - ah;
+    t = split * b;
+    const double bh = t - (t - b), bl = b - bh;
+    *e = ((ah * bh - *p) + ah * bl + al * bh) + al * bl;
+  };
+  
+  /*
+   * Rounds the exact value of a * 10^k (a >= 0, 0 <= k <= 22) to the nearest integer (ties to even).
+   * Returns false if the result is too large to be stored in @a n.
+   */
+  static bool ASCIIRoundScaled_p(double a, int k, unsigned long long* n)
+  {
+    double p = 0.0, e = 0.0;
+    ASCIITwoProduct_p(a, _btk_ascii_powers_of_ten[k], &p, &e);
+    if (!(p < 9.2e18))
+      return false;
+    if (p < 4503599627370496.0) // 2^52: the fractional part of p is exact and |e| is lower than the half of the spacing between two doubles.
+    {
+      const double r = floor(p);
+      const double d = p - r;
+      *n = static_cast<unsigned long long>(r);
+      if ((d > 0.5) || ((d == 0.5) && ((e > 0.0) || ((e == 0.0) && ((*n & 1) != 0)))))
+        ++*n;
+    }
+    else // p is an integer and e contains the fractional part.
+    {
+      const double i = floor(e);
+      const double half = i + 0.5;
+      *n = static_cast<unsigned long long>(p) + static_cast<unsigned long long>(static_cast<long long>(i));
+      if ((e > half) || ((e == half) && ((*n & 1) != 0)))
+        ++*n;
+    }
+    return true;
+  };
+  
+  /*
+   * Rounds @a a (finite, strictly positive) to @a digits significant digits (at most 17): a ~= n * 10^(x - digits + 1) with 10^(digits-1) <= n < 10^digits.
+   * Returns false if the rounding cannot be exactly done with ASCIIRoundScaled_p (very small or very large values).
+   */
+  static bool ASCIISignificantDigits_p(double a, int digits, unsigned long long* n, int* x)
+  {
+    int exponent = static_cast<int>(floor(log10(a)));
+    for (int i = 0 ; i < 3 ; ++i) // log10 can be wrong by one near the powers of ten.
+    {
+      const int k = digits - 1 - exponent;
+      if ((k < 0) || (k > 22) || !ASCIIRoundScaled_p(a, k, n))
+        return false;
+      if (*n >= _btk_ascii_integer_powers_of_ten[digits])
+        ++exponent;
+      else if (*n < _btk_ascii_integer_powers_of_ten[digits-1])
+        --exponent;
+      else
+      {
+        *x = exponent;
+        return true;
+      }
+    }
+    return false;
+  };
+  
+  /*
+   * Appends the significant digits @a n (@a precision digits) of a value with the exponent @a x using the rules of the format "%.*g".
+   */
+  static void ASCIIAppendGeneral_p(std::string* out, bool negative, unsigned long long n, int precision, int x)
+  {
+    char digits[20];
+    for (int i = precision - 1 ; i >= 0 ; --i)
+    {
+      digits[i] = static_cast<char>('0' + n % 10);
+      n /= 10;
+    }
+    int num = precision;
+    while ((num > 1) && (digits[num-1] == '0'))
+      --num;
+    if (negative)
+      out->push_back('-');
+    if ((x < -4) || (x >= precision))
+    {
+      out->push_back(digits[0]);
+      if (num > 1)
+      {
+        out->push_back('.');
+        out->append(digits + 1, num - 1);
+      }
+      out->push_back('e');
+      out->push_back((x < 0) ? '-' : '+');
+      const int ax = (x < 0) ? -x : x;
+      if (ax < 10)
+        out->push_back('0');
+      AppendASCIIInteger_p(out, ax);
+    }
+    else if (x < 0)
+    {
+      out->append("0.");
+      out->append(-x - 1, '0');
+      out->append(digits, num);
+    }
+    else
+    {
+      out->append(digits, std::min(num, x + 1));
+      if (num > x + 1)
+      {
+        out->push_back('.');
+        out->append(digits + x + 1, num - x - 1);
+      }
+      else
+        out->append(x + 1 - num, '0');
+    }
+  };
+  
+  /*
+   * Appends @a value with @a precision decimals to @a out. The characters are the same than with the format "%.*f" of the C library
+   * (and then than std::ostream with the flag std::ios::fixed).
+   *
+   * The value is scaled by a power of ten with an exact product and the rounding is decided on the exact scaled value.
+   * Large values, large precisions and special values are given to the C library.
+   */
+  void AppendASCIIFixed_p(std::string* out, double value, int precision)
+  {
+    const bool negative = (value < 0.0) || ((value == 0.0) && (1.0 / value < 0.0));
+    const double a = negative ? -value : value;
+    unsigned long long n = 0;
+    if ((precision >= 0) && (precision <= 17) && (a < 9.2e18) && ASCIIRoundScaled_p(a, precision, &n)) // NaN does not pass the third test.
+    {
+      char buffer[32];
+      char* c = buffer + sizeof(buffer);
+      int digits = 0;
+      do
+      {
+        *--c = static_cast<char>('0' + n % 10);
+        n /= 10;
+        if (++digits == precision)
+          *--c = '.';
+      }
+      while ((n != 0) || (digits <= precision));
+      if (negative)
+        *--c = '-';
+      out->append(c, buffer + sizeof(buffer) - c);
+      return;
+    }
+    char buffer[512];
+    AppendASCIIBuffer_p(out, buffer, sprintf(buffer, "%.*f", std::min(std::max(precision, 0), 100), value));
+  };
+  
+  /*
+   * Appends @a value with @a precision significant digits to @a out. The characters are the same than with the format "%.*g" of the C library
+   * (and then than std::ostream without flag). The values too small or too large to be exactly rounded are given to the C library.
+   */
+  void AppendASCIIGeneral_p(std::string* out, double value, int precision)
+  {
+    precision = std::max(precision, 1);
+    const bool negative = (value < 0.0) || ((value == 0.0) && (1.0 / value < 0.0));
+    const double a = negative ? -value : value;
+    unsigned long long n = 0;
+    int x = 0;
+    if (a == 0.0)
+      out->append(negative ? "-0" : "0");
+    else if ((precision <= 17) && (a < 1.0e300) && ASCIISignificantDigits_p(a, precision, &n, &x)) // Infinity and NaN do not pass the second test.
+      ASCIIAppendGeneral_p(out, negative, n, precision, x);
+    else
+    {
+      char buffer[64];
+      AppendASCIIBuffer_p(out, buffer, sprintf(buffer, "%.*g", std::min(precision, 40), value));
+    }
+  };
+  
+  /*
+   * Same than AppendASCIIShortest_p but with the C library. Used for the values too small or too large for the exact rounding.
+   */
+  static void ASCIIAppendShortestSlow_p(std::string* out, double value)
+  {
+    char buffer[64];
+    int len = 0;
+    for (int precision = 15 ; precision <= 17 ; ++precision)
+    {
+      len = sprintf(buffer, "%.*g", precision, value);
+      if (strtod(buffer, 0) == value) // strtod and sprintf use the same locale.
+        break;
+    }
+    AppendASCIIBuffer_p(out, buffer, len);
+  };
+  
+  /*
+   * Appends the shortest representation of @a value giving back exactly the same value when it is read (at most 17 significant digits).
+   *
+   * The value is rounded to 15, then 16 significant digits. The first rounding giving back the value is kept, otherwise 17 digits are used.
+   * When the significant digits are lower than 2^53, the conversion back to a double is exact with one division (or multiplication).
+   */
+  void AppendASCIIShortest_p(std::string* out, double value)
+  {
+    const bool negative = (value < 0.0) || ((value == 0.0) && (1.0 / value < 0.0));
+    const double a = negative ? -value : value;
+    if ((a == 0.0) || !(a <= std::numeric_limits<double>::max())) // Zero, infinity and NaN
+    {
+      AppendASCIIGeneral_p(out, value, 17);
+      return;
+    }
+    unsigned long long n = 0;
+    int x = 0;
+    for (int precision = 15 ; precision <= 16 ; ++precision)
+    {
+      if (!ASCIISignificantDigits_p(a, precision, &n, &x))
+      {
+        ASCIIAppendShortestSlow_p(out, value);
+        return;
+      }
+      const int k = precision - 1 - x; // Between 0 and 22
+      double v = 0.0;
+      if (n <= 9007199254740992ULL)
+        v = static_cast<double>(n) / _btk_ascii_powers_of_ten[k];
+      else
+      {
+        std::string str;
+        ASCIIAppendGeneral_p(&str, false, n, precision, x);
+        ParseASCIINumberSlow_p(str.data(), str.data() + str.size(), &v);
+      }
+      if (v == a)
+      {
+        ASCIIAppendGeneral_p(out, negative, n, precision, x);
+        return;
+      }
+    }
+    AppendASCIIGeneral_p(out, value, 17);
+  };
+  
+  struct ASCIIFormatChunk_p
+  {
+    const ASCIIRowFormatter_p* formatter;
+    int first;
+    int last;
+    std::string buffer;
+  };
+  
+  static void FormatASCIIChunk_p(void* data)
+  {
+    ASCIIFormatChunk_p* chunk = static_cast<ASCIIFormatChunk_p*>(data);
+    chunk->buffer.clear(); // The capacity is kept for the next rows.
+    for (int i = chunk->first ; i < chunk->last ; ++i)
+      chunk->formatter->Format(i, &(chunk->buffer));
+  };
+  
+  /*
+   * Formats the rows [0, rowNumber) with @a formatter and writes them in @a os, in order.
+   *
+   * The rows are formatted in memory by blocks of about 1 MB and each block is written at once. With several threads (a value 
+   * of @a numberOfThreads lower than 1 means one thread by processor), each thread formats its own block and the blocks are 
+   * then written in the order of the rows. The buffers are reused from one block to the next.
+   */
+  void WriteASCIIRows_p(std::ostream* os, const ASCIIRowFormatter_p* formatter, int rowNumber, int numberOfThreads)
+  {
+    if (rowNumber <= 0)
+      return;
+    std::vector<ASCIIFormatChunk_p> chunks(1);
+    chunks[0].formatter = formatter;
+    chunks[0].first = 0;
+    chunks[0].last = 1;
+    FormatASCIIChunk_p(&(chunks[0]));
+    os->write(chunks[0].buffer.data(), chunks[0].buffer.size());
+    // The size of the first row is used to estimate the size of the others.
+    const size_t rowSize = std::max(chunks[0].buffer.size(), static_cast<size_t>(1));
+    const int rowsPerChunk = static_cast<int>(std::max(_btk_ascii_format_chunk_size / rowSize, static_cast<size_t>(1)));
+    chunks.resize(ComputeASCIIThreadNumber_p(numberOfThreads, rowSize * static_cast<size_t>(rowNumber)), chunks[0]);
+    int row = 1;
+    while (row < rowNumber)
+    {
+      size_t used = 0;
+      while ((used < chunks.size()) && (row < rowNumber))
+      {
+        chunks[used].first = row;
+        row = (rowNumber - row > rowsPerChunk) ? row + rowsPerChunk : rowNumber;
+        chunks[used].last = row;
+        ++used;
+      }
+      chunks.resize(used);
+      ProcessASCIIChunks_p(&chunks, &FormatASCIIChunk_p);
+      for (size_t i = 0 ; i < chunks.size() ; ++i)
+        os->write(chunks[i].buffer.data(), chunks[i].buffer.size());
+    }
+  };
+};
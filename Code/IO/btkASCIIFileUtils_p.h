@@ -0,0 +1,362 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkASCIIFileUtils_p_h
+#define __btkASCIIFileUtils_p_h
+
+#include "btkBinaryFileStream.h"
+#include "btkThread_p.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+namespace btk
+{
+  // Content of an ASCII file accessed without copy. The file is mapped in memory when possible, otherwise it is entirely read.
+  class ASCIIFileBuffer_p
+  {
+  public:
+    ASCIIFileBuffer_p() : m_Data(), mp_Begin(0), mp_End(0), m_Opened(false) {};
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const {return this->m_Opened;};
+    const char* Begin() const {return this->mp_Begin;};
+    const char* End() const {return this->mp_End;};
+  private:
+    ASCIIFileBuffer_p(const ASCIIFileBuffer_p& ); // Not implemented.
+    ASCIIFileBuffer_p& operator=(const ASCIIFileBuffer_p& ); // Not implemented.
+    
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    mmfstream m_Stream;
+#endif
+    std::vector<char> m_Data;
+    const char* mp_Begin;
+    const char* mp_End;
+    bool m_Opened;
+  };
+  
+  // Scanner over a range of characters (a file, a line, etc.). Nothing is copied: the extracted tokens are given as ranges of the scanned buffer.
+  class ASCIITokenizer_p
+  {
+  public:
+    ASCIITokenizer_p(const char* begin, const char* end) : mp_Current(begin), mp_End(end) {};
+    bool AtEnd() const {return this->mp_Current >= this->mp_End;};
+    const char* GetPosition() const {return this->mp_Current;};
+    const char* GetEnd() const {return this->mp_End;};
+    inline bool NextLine(const char** first, const char** last);
+    inline bool NextLine(std::string* line);
+    inline bool NextField(char separator, const char** first, const char** last);
+    inline bool NextToken(const char** first, const char** last);
+    inline bool NextNumber(double* value);
+    inline void SkipBlanks();
+  private:
+    const char* mp_Current;
+    const char* mp_End;
+  };
+  
+  // Formats the rows of a data section (one row at a time, in any order). Each row must give the same characters whatever the formatting thread.
+  class ASCIIRowFormatter_p
+  {
+  public:
+    virtual ~ASCIIRowFormatter_p() {};
+    virtual void Format(int row, std::string* out) const = 0;
+  };
+  
+  inline bool IsASCIIBlank_p(char c) {return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') || (c == '\v') || (c == '\f');};
+  inline bool IsASCIIBlankRange_p(const char* first, const char* last);
+  inline const char* ParseASCIINumber_p(const char* first, const char* last, double* value);
+  inline bool ParseASCIIField_p(const char* first, const char* last, double* value);
+  const char* ParseASCIINumberSlow_p(const char* first, const char* last, double* value);
+  int ComputeASCIIThreadNumber_p(int numberOfThreads, size_t size);
+  void SplitASCIILines_p(const char* begin, const char* end, int number, std::vector<const char*>* bounds);
+  template <typename T> void ProcessASCIIChunks_p(std::vector<T>* chunks, thread_p::Function func);
+  inline void AppendASCIIInteger_p(std::string* out, int value);
+  void AppendASCIIFixed_p(std::string* out, double value, int precision);
+  void AppendASCIIGeneral_p(std::string* out, double value, int precision);
+  void AppendASCIIShortest_p(std::string* out, double value);
+  void WriteASCIIRows_p(std::ostream* os, const ASCIIRowFormatter_p* formatter, int rowNumber, int numberOfThreads);
+  
+  // ------------------------------------------------------------------------ //
+  
+  /*
+   * Extracts the next line (without the characters CR and LF).
+   * Returns false when the end of the range is already reached.
+   */
+  bool ASCIITokenizer_p::NextLine(const char** first, const char** last)
+  {
+    if (this->AtEnd())
+      return false;
+    const char* b = this->mp_Current;
+    const char* e = b;
+    while ((e < this->mp_End) && (*e != '\n'))
+      ++e;
+    this->mp_Current = (e < this->mp_End) ? e + 1 : e;
+    if ((e > b) && (*(e-1) == '\r'))
+      --e;
+    *first = b;
+    *last = e;
+    return true;
+  };
+  
+  /*
+   * Convenient method to copy the next line. Should be used only for the header of a file.
+   */
+  bool ASCIITokenizer_p::NextLine(std::string* line)
+  {
+    const char* first = 0;
+    const char* last = 0;
+    if (!this->NextLine(&first, &last))
+      return false;
+    line->assign(first, last);
+    return true;
+  };
+  
+  /*
+   * Extracts the characters until the next @a separator (excluded) or the end of the range.
+   * Consecutive separators give empty fields.
+   * Returns false only when the end of the range was already reached.
+   */
+  bool ASCIITokenizer_p::NextField(char separator, const char** first, const char** last)
+  {
+    if (this->AtEnd())
+      return false;
+    const char* e = this->mp_Current;
+    while ((e < this->mp_End) && (*e != separator))
+      ++e;
+    *first = this->mp_Current;
+    *last = e;
+    this->mp_Current = (e < this->mp_End) ? e + 1 : e;
+    return true;
+  };
+  
+  /*
+   * Extracts the next sequence of non blank characters.
+   */
+  bool ASCIITokenizer_p::NextToken(const char** first, const char** last)
+  {
+    this->SkipBlanks();
+    if (this->AtEnd())
+      return false;
+    const char* e = this->mp_Current;
+    while ((e < this->mp_End) && !IsASCIIBlank_p(*e))
+      ++e;
+    *first = this->mp_Current;
+    *last = e;
+    this->mp_Current = e;
+    return true;
+  };
+  
+  /*
+   * Extracts the next number after the blank characters (line breaks included).
+   * Returns false if the end of the range is reached or if the characters do not represent a number.
+   */
+  bool ASCIITokenizer_p::NextNumber(double* value)
+  {
+    this->SkipBlanks();
+    const char* e = ParseASCIINumber_p(this->mp_Current, this->mp_End, value);
+    if (e == this->mp_Current)
+      return false;
+    this->mp_Current = e;
+    return true;
+  };
+  
+  void ASCIITokenizer_p::SkipBlanks()
+  {
+    while ((this->mp_Current < this->mp_End) && IsASCIIBlank_p(*this->mp_Current))
+      ++this->mp_Current;
+  };
+  
+  bool IsASCIIBlankRange_p(const char* first, const char* last)
+  {
+    while ((first < last) && IsASCIIBlank_p(*first))
+      ++first;
+    return (first == last);
+  };
+  
+  /*
+   * Locale independent conversion of the number starting at @a first.
+   * The decimal separator is always the point. The characters are not copied and no memory is allocated.
+   * Returns the position after the number or @a first if no number was found.
+   *
+   * Numbers with significant digits lower than 2^53 and a small exponent are exactly converted by multiplying/dividing
+   * by a power of ten (both are exactly representable, so only one rounding occurs). The others are given to 
+   * ParseASCIINumberSlow_p.
+   */
+  const char* ParseASCIINumber_p(const char* first, const char* last, double* value)
+  {
+    static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* p = first;
+    bool negative = false;
+    if ((p < last) && ((*p == '-') || (*p == '+')))
+    {
+      negative = (*p == '-');
+      ++p;
+    }
+    unsigned long long mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool found = false;
+    while ((p < last) && (*p >= '0') && (*p <= '9'))
+    {
+      found = true;
+      if ((mantissa != 0) || (*p != '0'))
+      {
+        if (digits < 19)
+          mantissa = mantissa * 10 + (*p - '0');
+        else
+          ++exponent;
+        ++digits;
+      }
+      ++p;
+    }
+    if ((p < last) && (*p == '.'))
+    {
+      ++p;
+      while ((p < last) && (*p >= '0') && (*p <= '9'))
+      {
+        found = true;
+        if ((mantissa != 0) || (*p != '0'))
+        {
+          if (digits < 19)
+          {
+            mantissa = mantissa * 10 + (*p - '0');
+            --exponent;
+          }
+          ++digits;
+        }
+        else
+          --exponent;
+        ++p;
+      }
+    }
+    if (!found)
+      return ParseASCIINumberSlow_p(first, last, value); // Special values (inf, nan) or not a number.
+    if ((p < last) && ((*p == 'e') || (*p == 'E')))
+    {
+      const char* q = p + 1;
+      bool negativeExponent = false;
+      if ((q < last) && ((*q == '-') || (*q == '+')))
+      {
+        negativeExponent = (*q == '-');
+        ++q;
+      }
+      if ((q < last) && (*q >= '0') && (*q <= '9'))
+      {
+        int e = 0;
+        while ((q < last) && (*q >= '0') && (*q <= '9'))
+        {
+          if (e < 10000)
+            e = e * 10 + (*q - '0');
+          ++q;
+        }
+        exponent += negativeExponent ? -e : e;
+        p = q;
+      }
+    }
+    if (mantissa == 0)
+      *value = 0.0;
+    else if (((digits <= 15) || ((digits <= 19) && (mantissa <= 9007199254740992ULL))) && (exponent >= -22) && (exponent <= 22))
+    {
+      double v = static_cast<double>(mantissa);
+      if (exponent < 0)
+        v /= powersOfTen[-exponent];
+      else
+        v *= powersOfTen[exponent];
+      *value = v;
+    }
+    else
+      return ParseASCIINumberSlow_p(first, last, value);
+    if (negative)
+      *value = -*value;
+    return p;
+  };
+  
+  /*
+   * Converts the field [first, last) in a number. The surrounding blank characters are ignored.
+   * Returns false if the field is empty (or contains only blank characters) or if it is not a number.
+   */
+  bool ParseASCIIField_p(const char* first, const char* last, double* value)
+  {
+    while ((first < last) && IsASCIIBlank_p(*first))
+      ++first;
+    while ((last > first) && IsASCIIBlank_p(*(last-1)))
+      --last;
+    if (first == last)
+      return false;
+    return (ParseASCIINumber_p(first, last, value) == last);
+  };
+  
+  /*
+   * Appends the decimal representation of @a value to @a out (same characters than std::ostream).
+   */
+  void AppendASCIIInteger_p(std::string* out, int value)
+  {
+    char buffer[16];
+    char* p = buffer + sizeof(buffer);
+    unsigned int v = (value < 0) ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    do
+    {
+      *--p = static_cast<char>('0' + v % 10);
+      v /= 10;
+    }
+    while (v != 0);
+    if (value < 0)
+      *--p = '-';
+    out->append(p, buffer + sizeof(buffer) - p);
+  };
+  
+  /*
+   * Calls @a func for each chunk of @a chunks. Each one is processed in its own thread, except the last one which is processed by the calling thread.
+   */
+  template <typename T>
+  void ProcessASCIIChunks_p(std::vector<T>* chunks, thread_p::Function func)
+  {
+    const size_t num = chunks->size();
+    if (num == 0)
+      return;
+    thread_p* threads = new thread_p[num - 1];
+    for (size_t i = 0 ; i < num - 1 ; ++i)
+      threads[i].Start(func, &((*chunks)[i]));
+    func(&((*chunks)[num - 1]));
+    for (size_t i = 0 ; i < num - 1 ; ++i)
+      threads[i].Join();
+    delete[] threads;
+  };
+};
+
+#endif // __btkASCIIFileUtils_p_h
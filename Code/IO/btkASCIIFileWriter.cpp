@@ -34,10 +34,93 @@
  */
 
 #include "btkASCIIFileWriter.h"
+#include "btkASCIIFileUtils_p.h"
 #include "btkConvert.h"
 
+#include <algorithm>
+
 namespace btk
 {
+  // Formats the rows of the points or analogs section: time and values of each column. The values of an invalid point are replaced by 0.
+  class ASCIIFileWriterFormatter_p : public ASCIIRowFormatter_p
+  {
+  public:
+    ASCIIFileWriterFormatter_p(const std::string& separator, ASCIIFileWriter::NumberFormat format, int precision, int firstIndex, int timeIndexOffset, double timeStep)
+    : m_Separator(separator), m_Format(format), m_Precision(precision), m_FirstIndex(firstIndex), m_TimeIndexOffset(timeIndexOffset), m_TimeStep(timeStep),
+      m_Values(), m_Residuals(), m_Strides()
+    {};
+    // Const access: the values shared with a clone are not copied.
+    void AppendPoint(Point::ConstPointer point)
+    {
+      this->m_Values.push_back(point->GetValues().data());
+      this->m_Residuals.push_back(point->GetResiduals().data());
+      this->m_Strides.push_back(point->GetFrameNumber());
+    };
+    void AppendAnalog(Analog::ConstPointer analog)
+    {
+      this->m_Values.push_back(analog->GetValues().data());
+      this->m_Residuals.push_back(0);
+      this->m_Strides.push_back(0);
+    };
+    virtual void Format(int row, std::string* out) const
+    {
+      const int i = this->m_FirstIndex + row;
+      this->AppendNumber(out, static_cast<double>(i + this->m_TimeIndexOffset) * this->m_TimeStep);
+      for (size_t j = 0 ; j < this->m_Values.size() ; ++j)
+      {
+        const double* values = this->m_Values[j];
+        if (this->m_Residuals[j] == 0)
+        {
+          out->append(this->m_Separator);
+          this->AppendNumber(out, values[i]);
+        }
+        else if (this->m_Residuals[j][i] >= 0.0)
+        {
+          for (int k = 0 ; k < 3 ; ++k)
+          {
+            out->append(this->m_Separator);
+            this->AppendNumber(out, values[i + k * this->m_Strides[j]]);
+          }
+        }
+        else
+        {
+          for (int k = 0 ; k < 3 ; ++k)
+          {
+            out->append(this->m_Separator);
+            out->push_back('0');
+          }
+        }
+      }
+      out->push_back('\n');
+    };
+  private:
+    void AppendNumber(std::string* out, double value) const
+    {
+      switch (this->m_Format)
+      {
+      case ASCIIFileWriter::Fixed:
+        AppendASCIIFixed_p(out, value, this->m_Precision);
+        break;
+      case ASCIIFileWriter::Shortest:
+        AppendASCIIShortest_p(out, value);
+        break;
+      default:
+        AppendASCIIGeneral_p(out, value, this->m_Precision);
+        break;
+      }
+    };
+    
+    const std::string& m_Separator;
+    ASCIIFileWriter::NumberFormat m_Format;
+    int m_Precision;
+    int m_FirstIndex;
+    int m_TimeIndexOffset;
+    double m_TimeStep;
+    std::vector<const double*> m_Values;
+    std::vector<const double*> m_Residuals;
+    std::vector<int> m_Strides;
+  };
+  
   /**
    * @class ASCIIFileWriterException btkASCIIFileWriter.h
    * @brief Exception class for the ASCIIFileWriter class.
@@ -71,6 +154,9 @@ namespace btk
    *
    * You can export only a subset of the acquisition by specifying the frames of interest using the method SetFramesOfInterest().
    *
+   * The notation of the values is set with the method SetNumberFormat(). By default, the values are written with 6 significant
+   * digits (like a C++ stream). The rows of large sections can be formatted with several threads (see SetNumberOfThreads()).
+   *
    * There is some options in this class enabled/disabled by using the metadata of the given input.
    * This writer check if the metadata BTK_ASCII_EXPORT_OPTIONS exists and the check for its children. The used children metadata are:
    * - NO_HEADER: Disable the writing of the header if the metadata is set to 1.
@@ -181,12 +267,88 @@ namespace btk
     }
   };
   
+  /**
+   * @enum ASCIIFileWriter::NumberFormat
+   * Notation used to write the values of the points and analog channels.
+   */
+  /**
+   * @var ASCIIFileWriter::NumberFormat ASCIIFileWriter::General
+   * The values are written with a number of significant digits set by SetPrecision() (like the format "%g" of the C library).
+   */
+  /**
+   * @var ASCIIFileWriter::NumberFormat ASCIIFileWriter::Fixed
+   * The values are written with a number of decimals set by SetPrecision() (like the format "%f" of the C library).
+   */
+  /**
+   * @var ASCIIFileWriter::NumberFormat ASCIIFileWriter::Shortest
+   * The values are written with the smallest number of digits giving back exactly the same values when the file is read. The precision is not used.
+   */
+  
+  /**
+   * @fn NumberFormat ASCIIFileWriter::GetNumberFormat() const
+   * Returns the notation used to write the values (ASCIIFileWriter::General by default).
+   */
+  
+  /**
+   * Sets the notation used to write the values.
+   */
+  void ASCIIFileWriter::SetNumberFormat(NumberFormat format)
+  {
+    if (this->m_NumberFormat != format)
+    {
+      this->m_NumberFormat = format;
+      this->Modified();
+    }
+  };
+  
+  /**
+   * @fn int ASCIIFileWriter::GetPrecision() const
+   * Returns the number of significant digits (ASCIIFileWriter::General) or decimals (ASCIIFileWriter::Fixed) used to write the values (6 by default).
+   */
+  
+  /**
+   * Sets the number of significant digits (ASCIIFileWriter::General) or decimals (ASCIIFileWriter::Fixed) used to write the values.
+   * A negative value is replaced by 0.
+   */
+  void ASCIIFileWriter::SetPrecision(int precision)
+  {
+    precision = std::max(precision, 0);
+    if (this->m_Precision != precision)
+    {
+      this->m_Precision = precision;
+      this->Modified();
+    }
+  };
+  
+  /**
+   * @fn int ASCIIFileWriter::GetNumberOfThreads() const
+   * Returns the number of threads used to format the rows of the points and analogs sections (1 by default).
+   */
+  
+  /**
+   * Sets the number of threads used to format the rows of the points and analogs sections. A value lower than 1 means to use one thread by processor.
+   *
+   * The rows are formatted in memory by blocks and each thread formats its own block. The blocks are written in the order
+   * of the frames, so the file is exactly the same than with only one thread. The number of threads is reduced for small sections.
+   */
+  void ASCIIFileWriter::SetNumberOfThreads(int num)
+  {
+    if (this->m_NumberOfThreads != num)
+    {
+      this->m_NumberOfThreads = num;
+      this->Modified();
+    }
+  };
+  
   /**
    * Constructor. Sets the number of outputs equal to one. No input. Separator set to common (,).
    */
   ASCIIFileWriter::ASCIIFileWriter()
   : m_Filename(), m_Separator(",")
   {
+    this->m_NumberFormat = General;
+    this->m_Precision = 6;
+    this->m_NumberOfThreads = 1;
     this->m_FOI[0] = -1;
     this->m_FOI[1] = -1;
     this->SetInputNumber(1);
@@ -264,7 +426,7 @@ namespace btk
         ofs << "First frame" << this->m_Separator << ff << "\n";
         ofs << "Point frequency" << this->m_Separator << input->GetPointFrequency() << "\n";
         ofs << "Analog frequency" << this->m_Separator << input->GetAnalogFrequency() << "\n";
-        ofs << std::endl;
+        ofs << "\n";
       }
       
       if (writeEvent)
@@ -397,7 +559,7 @@ namespace btk
               ofs << this->m_Separator << times_sorted[i][j];
             ofs << "\n";
           }
-          ofs << std::endl;
+          ofs << "\n";
         }
       }
       
@@ -436,26 +598,23 @@ namespace btk
         // Label
         for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
           ofs << this->m_Separator << (*it)->GetLabel();
-        ofs << std::endl;
+        ofs << "\n";
         // Unit
         ofs << "s";
         for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
           ofs << this->m_Separator << (*it)->GetUnit();
-        ofs << std::endl;
+        ofs << "\n";
         // Data
         int ffi = (ff - input->GetFirstFrame()) * input->GetNumberAnalogSamplePerFrame();
         int lfi = (lf - input->GetFirstFrame() + 1) * input->GetNumberAnalogSamplePerFrame();
         double t = 0.0;
         if (input->GetAnalogFrequency() != 0.0)
           t = 1.0 / input->GetAnalogFrequency();
-        for (int i = ffi ; i < lfi ; ++i)
-        {
-          ofs << static_cast<double>(i + (input->GetFirstFrame()-1) * input->GetNumberAnalogSamplePerFrame()) * t;
-          for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
-            ofs << this->m_Separator << (*it)->GetValues().coeff(i);
-          ofs << std::endl;
-        }
-        ofs << std::endl;
+        ASCIIFileWriterFormatter_p formatter(this->m_Separator, this->m_NumberFormat, this->m_Precision, ffi, (input->GetFirstFrame()-1) * input->GetNumberAnalogSamplePerFrame(), t);
+        for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+          formatter.AppendAnalog(*it);
+        WriteASCIIRows_p(&ofs, &formatter, lfi - ffi, this->m_NumberOfThreads);
+        ofs << "\n";
       }
       
       ofs.close();
@@ -480,7 +639,7 @@ namespace btk
     // Label
     for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
       *ofs << this->m_Separator << (*it)->GetLabel() << this->m_Separator << this->m_Separator;
-    *ofs << std::endl;
+    *ofs << "\n";
     // Unit
     *ofs << "s";
     for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
@@ -488,29 +647,21 @@ namespace btk
       std::string unit = acq->GetPointUnit((*it)->GetType());
       *ofs << this->m_Separator << unit << this->m_Separator << unit << this->m_Separator << unit;
     }
-    *ofs << std::endl;
+    *ofs << "\n";
     // X/Y/Z
     for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
       *ofs << this->m_Separator << "X" << this->m_Separator << "Y" << this->m_Separator << "Z";
-    *ofs << std::endl;
+    *ofs << "\n";
     // Data
     double t = 0.0;
     if (acq->GetPointFrequency() != 0.0)
       t = 1.0 / acq->GetPointFrequency();
     int ffi = ff - acq->GetFirstFrame();
     int lfi = lf - acq->GetFirstFrame();
-    for (int i = ffi ; i <= lfi ; ++i)
-    {
-      *ofs << static_cast<double>(i + acq->GetFirstFrame() - 1) * t;
-      for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
-      {
-        if ((*it)->GetResiduals().coeff(i) >= 0.0)
-          *ofs << this->m_Separator << (*it)->GetValues().coeff(i,0) << this->m_Separator << (*it)->GetValues().coeff(i,1) << this->m_Separator << (*it)->GetValues().coeff(i,2);
-        else
-          *ofs << this->m_Separator << 0 << this->m_Separator << 0 << this->m_Separator << 0;
-      }
-      *ofs << std::endl;
-    }
-    *ofs << std::endl;
+    ASCIIFileWriterFormatter_p formatter(this->m_Separator, this->m_NumberFormat, this->m_Precision, ffi, acq->GetFirstFrame() - 1, t);
+    for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
+      formatter.AppendPoint(*it);
+    WriteASCIIRows_p(ofs, &formatter, lfi - ffi + 1, this->m_NumberOfThreads);
+    *ofs << "\n";
   };
 };
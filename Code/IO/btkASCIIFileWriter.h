@@ -60,6 +60,8 @@ namespace btk
     typedef btkSharedPtr<ASCIIFileWriter> Pointer;
     typedef btkSharedPtr<const ASCIIFileWriter> ConstPointer;
     
+    typedef enum {General = 0, Fixed, Shortest} NumberFormat;
+    
     virtual ~ASCIIFileWriter() {};
     
     static Pointer New() {return Pointer(new ASCIIFileWriter());};
@@ -76,6 +78,14 @@ namespace btk
     const int* GetFramesOfInterest() const {return this->m_FOI;};
     void GetFramesOfInterest(int& ff, int& lf) const {ff = this->m_FOI[0]; lf = this->m_FOI[1];};
     BTK_IO_EXPORT void SetFramesOfInterest(int ff = -1, int lf = -1);
+    
+    NumberFormat GetNumberFormat() const {return this->m_NumberFormat;};
+    BTK_IO_EXPORT void SetNumberFormat(NumberFormat format);
+    int GetPrecision() const {return this->m_Precision;};
+    BTK_IO_EXPORT void SetPrecision(int precision);
+    
+    int GetNumberOfThreads() const {return this->m_NumberOfThreads;};
+    BTK_IO_EXPORT void SetNumberOfThreads(int num);
   
   protected:
     BTK_IO_EXPORT ASCIIFileWriter();
@@ -92,6 +102,9 @@ namespace btk
     std::string m_Filename;
     std::string m_Separator;
     int m_FOI[2];
+    NumberFormat m_NumberFormat;
+    int m_Precision;
+    int m_NumberOfThreads;
   };
 };
 
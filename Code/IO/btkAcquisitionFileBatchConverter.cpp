@@ -0,0 +1,518 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkAcquisitionFileBatchConverter.h"
+#include "btkAcquisitionFileReader.h"
+#include "btkAcquisitionFileWriter.h"
+#include "btkAcquisitionFileIOFactory.h"
+#include "btkAcquisitionFileIOFactory_p.h"
+#include "btkLogger.h"
+#include "btkCriticalSection_p.h"
+#include "btkThread_p.h"
+
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <cctype>
+#include <cstdio> // std::remove
+#include <cstdlib> // realpath, _fullpath
+#include <climits> // PATH_MAX
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+  #include <Utilities/timeval.h>
+#else
+  #include <sys/time.h>
+  #include <dirent.h>
+#endif
+
+namespace btk
+{
+  // Wall clock timer (in seconds).
+  class AcquisitionFileBatchConverterTimer_p
+  {
+  public:
+    AcquisitionFileBatchConverterTimer_p() {this->Restart();};
+    void Restart() {gettimeofday(&this->m_Start, 0);};
+    double GetElapsed() const
+    {
+      struct timeval stop;
+      gettimeofday(&stop, 0);
+      return static_cast<double>(stop.tv_sec - this->m_Start.tv_sec) + static_cast<double>(stop.tv_usec - this->m_Start.tv_usec) * 1.0e-6;
+    };
+  private:
+    struct timeval m_Start;
+  };
+  
+  // Data shared by the workers: the index of the next task to convert and a lock.
+  struct AcquisitionFileBatchConverterShared_p
+  {
+    critical_section_p lock;
+    size_t next;
+  };
+  
+  // Data owned by each worker.
+  struct AcquisitionFileBatchConverterWorker_p
+  {
+    AcquisitionFileBatchConverter* converter;
+    AcquisitionFileBatchConverterShared_p* shared;
+    AcquisitionFileBatchConverter::Filter::Pointer filter;
+  };
+  
+  static double AcquisitionFileBatchConverterFileSize_p(const std::string& filename)
+  {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+      return 0.0;
+    return static_cast<double>(info.st_size);
+  };
+  
+  // Returns a key identifying the file on the disk (absolute path without symbolic links). For a file which 
+  // does not exist yet (e.g. an output), only its directory is resolved.
+  static std::string AcquisitionFileBatchConverterPathKey_p(const std::string& filename)
+  {
+    std::string key = filename;
+#if defined(_WIN32)
+    char buffer[_MAX_PATH];
+    if (_fullpath(buffer, filename.c_str(), _MAX_PATH) != 0)
+      key = buffer;
+    std::replace(key.begin(), key.end(), '/', '\\');
+    std::transform(key.begin(), key.end(), key.begin(), tolower);
+#else
+    char buffer[PATH_MAX];
+    if (realpath(filename.c_str(), buffer) != 0)
+      key = buffer;
+    else
+    {
+      std::string::size_type sep = filename.rfind('/');
+      std::string directory = (sep == std::string::npos) ? "." : ((sep == 0) ? "/" : filename.substr(0, sep));
+      if (realpath(directory.c_str(), buffer) != 0)
+      {
+        key = buffer;
+        if (*(key.rbegin()) != '/')
+          key += "/";
+        key += (sep == std::string::npos) ? filename : filename.substr(sep + 1);
+      }
+    }
+#endif
+    return key;
+  };
+  
+  // Lists the regular files (not hidden) of the given directory.
+  static void AcquisitionFileBatchConverterListDirectory_p(const std::string& directory, std::vector<std::string>* filenames)
+  {
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA((directory + "\\*").c_str(), &data);
+    if (handle == INVALID_HANDLE_VALUE)
+      return;
+    do
+    {
+      if (((data.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_HIDDEN)) == 0) && (data.cFileName[0] != '.'))
+        filenames->push_back(data.cFileName);
+    }
+    while (FindNextFileA(handle, &data) != 0);
+    FindClose(handle);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir == 0)
+      return;
+    struct dirent* entry = 0;
+    while ((entry = readdir(dir)) != 0)
+    {
+      if (entry->d_name[0] == '.')
+        continue;
+      struct stat info;
+      if ((stat((directory + "/" + entry->d_name).c_str(), &info) == 0) && S_ISREG(info.st_mode))
+        filenames->push_back(entry->d_name);
+    }
+    closedir(dir);
+#endif
+    std::sort(filenames->begin(), filenames->end());
+  };
+  
+  /**
+   * @class AcquisitionFileBatchConverter btkAcquisitionFileBatchConverter.h
+   * @brief Converts a list of acquisition files with a pool of threads.
+   *
+   * Each conversion is a pipeline reading an acquisition (see AcquisitionFileReader), processing it 
+   * with an optional filter (see AcquisitionFileBatchConverter::Filter) and writing it (see AcquisitionFileWriter).
+   * The files to convert are appended to this object as tasks, one by one (AppendTask()), from the content of a
+   * directory (AppendDirectory()) or from a manifest file (AppendManifest()).
+   *
+   * The method Update() distributes the tasks between a fixed number of workers (see SetNumberOfThreads()).
+   * Each worker reuses its own reader, writer and filter for all the files it converts. The failure of one file
+   * does not stop the conversion of the others: its error message is stored in its result (see GetResult()) 
+   * and its output file is removed. The throughput and the time spent by stage are summarized in a report (see GetReport()).
+   *
+   * @code
+   * btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+   * converter->AppendDirectory("/path/to/trials", "/path/to/output", "c3d");
+   * converter->SetNumberOfThreads(4);
+   * converter->Update();
+   * std::cout << converter->GetReport().GetFilesPerSecond() << " files/s" << std::endl;
+   * @endcode
+   *
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @class AcquisitionFileBatchConverter::Filter btkAcquisitionFileBatchConverter.h
+   * @brief Processing applied on each acquisition between its reading and its writing.
+   *
+   * As the filter is used by several threads, each worker uses its own copy created by the method Clone().
+   */
+  /**
+   * @typedef AcquisitionFileBatchConverter::Filter::Pointer
+   * Smart pointer associated with a Filter object.
+   */
+  /**
+   * @fn virtual AcquisitionFileBatchConverter::Filter::~Filter()
+   * Empty destructor.
+   */
+  /**
+   * @fn virtual Pointer AcquisitionFileBatchConverter::Filter::Clone() const = 0
+   * Creates a new filter with the same settings. This copy will be used by only one worker.
+   */
+  /**
+   * @fn virtual Acquisition::Pointer AcquisitionFileBatchConverter::Filter::Process(Acquisition::Pointer input) = 0
+   * Processes the acquisition @a input and returns the acquisition to write. The returned acquisition can be @a input.
+   * An exception thrown by this method is considered as the failure of the conversion of the current file.
+   */
+  /**
+   * @fn AcquisitionFileBatchConverter::Filter::Filter()
+   * Constructor.
+   */
+  
+  /**
+   * @class AcquisitionFileBatchConverter::Task btkAcquisitionFileBatchConverter.h
+   * @brief Path of the file to read and path of the file to write.
+   */
+  
+  /**
+   * @class AcquisitionFileBatchConverter::Result btkAcquisitionFileBatchConverter.h
+   * @brief Status of the conversion of one file and time spent (in seconds) in each stage.
+   *
+   * The sizes of the files are given in bytes.
+   */
+  
+  /**
+   * @class AcquisitionFileBatchConverter::Report btkAcquisitionFileBatchConverter.h
+   * @brief Summary of the conversion of all the tasks.
+   *
+   * The member elapsedTime is the wall clock time of the method AcquisitionFileBatchConverter::Update() while
+   * the time by stage is accumulated over all the workers.
+   */
+  /**
+   * @fn double AcquisitionFileBatchConverter::Report::GetFilesPerSecond() const
+   * Returns the number of files converted (successfully or not) by second.
+   */
+  /**
+   * @fn double AcquisitionFileBatchConverter::Report::GetMegabytesPerSecond() const
+   * Returns the number of megabytes read by second.
+   */
+  
+  /**
+   * @typedef AcquisitionFileBatchConverter::Pointer
+   * Smart pointer associated with an AcquisitionFileBatchConverter object.
+   */
+  
+  /**
+   * @typedef AcquisitionFileBatchConverter::ConstPointer
+   * Smart pointer associated with a const AcquisitionFileBatchConverter object.
+   */
+  
+  /**
+   * @fn static Pointer AcquisitionFileBatchConverter::New()
+   * Creates a smart pointer associated with an AcquisitionFileBatchConverter object.
+   */
+  
+  /**
+   * @fn virtual AcquisitionFileBatchConverter::~AcquisitionFileBatchConverter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn int AcquisitionFileBatchConverter::GetTaskNumber() const
+   * Returns the number of files to convert.
+   */
+  
+  /**
+   * @fn const Task& AcquisitionFileBatchConverter::GetTask(int idx) const
+   * Returns the task at the index @a idx.
+   */
+  
+  /**
+   * @fn void AcquisitionFileBatchConverter::AppendTask(const std::string& input, const std::string& output)
+   * Appends the conversion of the file @a input into the file @a output.
+   */
+  
+  /**
+   * Appends the conversion of each file of the directory @a inputDirectory which has a suffix supported by 
+   * the AcquisitionFileIOFactory. The converted files are written in the directory @a outputDirectory with 
+   * the same name but with the suffix @a outputSuffix (which defines the output file format).
+   * Returns the number of appended tasks.
+   */
+  int AcquisitionFileBatchConverter::AppendDirectory(const std::string& inputDirectory, const std::string& outputDirectory, const std::string& outputSuffix)
+  {
+    std::vector<std::string> filenames;
+    AcquisitionFileBatchConverterListDirectory_p(inputDirectory, &filenames);
+    const AcquisitionFileIO::Extensions extensions = AcquisitionFileIOFactory::GetSupportedReadExtensions();
+    int num = 0;
+    for (size_t i = 0 ; i < filenames.size() ; ++i)
+    {
+      if (!AcquisitionFileIOFactoryMatchExtension_p(extensions, AcquisitionFileIOFactoryExtension_p(filenames[i])))
+        continue;
+      std::string basename = filenames[i].substr(0, filenames[i].rfind('.'));
+      this->AppendTask(inputDirectory + "/" + filenames[i], outputDirectory + "/" + basename + "." + outputSuffix);
+      ++num;
+    }
+    return num;
+  };
+  
+  /**
+   * Appends the conversions listed in the manifest @a filename. Each line contains the path of the file
+   * to read and the path of the file to write, separated by a tabulation. Empty lines and lines starting 
+   * by the character '#' are ignored.
+   * Returns the number of appended tasks or -1 if the manifest cannot be opened.
+   */
+  int AcquisitionFileBatchConverter::AppendManifest(const std::string& filename)
+  {
+    std::ifstream ifs(filename.c_str());
+    if (!ifs)
+    {
+      btkErrorMacro("Manifest can't be opened: " + filename);
+      return -1;
+    }
+    int num = 0;
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+      if (!line.empty() && (*(line.rbegin()) == '\r'))
+        line.resize(line.length() - 1);
+      if (line.empty() || (line[0] == '#'))
+        continue;
+      std::string::size_type sep = line.find('\t');
+      if (sep == std::string::npos)
+      {
+        btkWarningMacro("Line without output in the manifest: " + line);
+        continue;
+      }
+      this->AppendTask(line.substr(0, sep), line.substr(sep + 1));
+      ++num;
+    }
+    return num;
+  };
+  
+  /**
+   * Removes all the tasks and their results.
+   */
+  void AcquisitionFileBatchConverter::ClearTasks()
+  {
+    this->m_Tasks.clear();
+    this->m_Results.clear();
+    this->m_Report = Report();
+  };
+  
+  /**
+   * @fn Filter::Pointer AcquisitionFileBatchConverter::GetFilter() const
+   * Returns the filter applied on each acquisition (null by default).
+   */
+  
+  /**
+   * @fn void AcquisitionFileBatchConverter::SetFilter(Filter::Pointer filter)
+   * Sets the filter applied on each acquisition. Each worker uses its own copy of this filter.
+   */
+  
+  /**
+   * @fn int AcquisitionFileBatchConverter::GetNumberOfThreads() const
+   * Returns the number of workers used to convert the files (1 by default).
+   */
+  
+  /**
+   * @fn void AcquisitionFileBatchConverter::SetNumberOfThreads(int num)
+   * Sets the number of workers used to convert the files. A value lower than 1 means to use one worker by processor.
+   * The number of workers is never greater than the number of tasks.
+   */
+  
+  /**
+   * Converts all the tasks and updates the results and the report.
+   *
+   * As the tasks are converted concurrently, a task is not converted and is reported as failed if its 
+   * output is the input of a task (including itself) or if its output is already written by a previous task.
+   */
+  void AcquisitionFileBatchConverter::Update()
+  {
+    AcquisitionFileBatchConverterTimer_p timer;
+    this->m_Results.assign(this->m_Tasks.size(), Result());
+    this->m_Report = Report();
+    if (this->m_Tasks.empty())
+      return;
+    std::set<std::string> inputs;
+    for (size_t i = 0 ; i < this->m_Tasks.size() ; ++i)
+      inputs.insert(AcquisitionFileBatchConverterPathKey_p(this->m_Tasks[i].input));
+    std::map<std::string, size_t> outputs;
+    for (size_t i = 0 ; i < this->m_Tasks.size() ; ++i)
+    {
+      const std::string key = AcquisitionFileBatchConverterPathKey_p(this->m_Tasks[i].output);
+      if (inputs.find(key) != inputs.end())
+        this->m_Results[i].error = "The output file is also the input of a task\nFilename: " + this->m_Tasks[i].output;
+      else if (!outputs.insert(std::make_pair(key, i)).second)
+        this->m_Results[i].error = "The output file is already written by another task\nFilename: " + this->m_Tasks[i].output;
+    }
+    int num = (this->m_NumberOfThreads < 1) ? thread_p::GetNumberOfProcessors() : this->m_NumberOfThreads;
+    num = std::min(num, static_cast<int>(this->m_Tasks.size()));
+    AcquisitionFileBatchConverterShared_p shared;
+    shared.next = 0;
+    std::vector<AcquisitionFileBatchConverterWorker_p> workers(num);
+    for (int i = 0 ; i < num ; ++i)
+    {
+      workers[i].converter = this;
+      workers[i].shared = &shared;
+      if (this->m_Filter.get() != 0)
+        workers[i].filter = this->m_Filter->Clone();
+    }
+    // The first worker is executed by the calling thread.
+    thread_p* threads = new thread_p[num - 1];
+    for (int i = 1 ; i < num ; ++i)
+      threads[i-1].Start(&AcquisitionFileBatchConverter::Run, &(workers[i]));
+    AcquisitionFileBatchConverter::Run(&(workers[0]));
+    delete[] threads; // Join the threads
+    // Summary
+    for (size_t i = 0 ; i < this->m_Results.size() ; ++i)
+    {
+      const Result& result = this->m_Results[i];
+      if (!result.succeeded)
+        ++this->m_Report.failureNumber;
+      this->m_Report.readTime += result.readTime;
+      this->m_Report.filterTime += result.filterTime;
+      this->m_Report.writeTime += result.writeTime;
+      this->m_Report.inputSize += result.inputSize;
+      this->m_Report.outputSize += result.outputSize;
+    }
+    this->m_Report.fileNumber = static_cast<int>(this->m_Results.size());
+    this->m_Report.elapsedTime = timer.GetElapsed();
+  };
+  
+  /**
+   * @fn const Result& AcquisitionFileBatchConverter::GetResult(int idx) const
+   * Returns the result of the conversion of the task at the index @a idx. Valid only after a call to the method Update().
+   */
+  
+  /**
+   * @fn const Report& AcquisitionFileBatchConverter::GetReport() const
+   * Returns the summary of the last call to the method Update().
+   */
+  
+  /**
+   * Constructor. One worker is used by default.
+   */
+  AcquisitionFileBatchConverter::AcquisitionFileBatchConverter()
+  : m_Tasks(), m_Results(), m_Report(), m_Filter()
+  {
+    this->m_NumberOfThreads = 1;
+  };
+  
+  /**
+   * Converts the tasks until none is left. The argument @a data is a pointer to a AcquisitionFileBatchConverterWorker_p object.
+   */
+  void AcquisitionFileBatchConverter::Run(void* data)
+  {
+    AcquisitionFileBatchConverterWorker_p* worker = static_cast<AcquisitionFileBatchConverterWorker_p*>(data);
+    AcquisitionFileBatchConverter* self = worker->converter;
+    AcquisitionFileReader::Pointer reader = AcquisitionFileReader::New();
+    AcquisitionFileWriter::Pointer writer = AcquisitionFileWriter::New();
+    while (1)
+    {
+      worker->shared->lock.Lock();
+      size_t idx = worker->shared->next++;
+      worker->shared->lock.Unlock();
+      if (idx >= self->m_Tasks.size())
+        break;
+      const Task& task = self->m_Tasks[idx];
+      Result& result = self->m_Results[idx];
+      if (!result.error.empty()) // Conflict with another task (see Update())
+        continue;
+      bool writing = false;
+      AcquisitionFileBatchConverterTimer_p timer;
+      try
+      {
+        AcquisitionFileIO::Pointer input = AcquisitionFileIOFactory::CreateAcquisitionIO(task.input, AcquisitionFileIOFactory::ReadMode);
+        AcquisitionFileIO::Pointer output = AcquisitionFileIOFactory::CreateAcquisitionIO(task.output, AcquisitionFileIOFactory::WriteMode);
+        if (input.get() == 0)
+          throw AcquisitionFileReaderException("No IO found, the file doesn't exist, is not supported or valid\nFilename: " + task.input);
+        if (output.get() == 0)
+          throw AcquisitionFileWriterException("No IO found, the file suffix is not supported\nFilename: " + task.output);
+        result.inputSize = AcquisitionFileBatchConverterFileSize_p(task.input);
+        reader->SetFilename(task.input);
+        reader->SetAcquisitionIO(input);
+        reader->Update();
+        Acquisition::Pointer acq = reader->GetOutput();
+        result.readTime = timer.GetElapsed();
+        timer.Restart();
+        if (worker->filter.get() != 0)
+          acq = worker->filter->Process(acq);
+        result.filterTime = timer.GetElapsed();
+        timer.Restart();
+        writing = true;
+        writer->SetInput(acq);
+        writer->SetFilename(task.output);
+        writer->SetAcquisitionIO(output);
+        writer->Update();
+        result.writeTime = timer.GetElapsed();
+        result.outputSize = AcquisitionFileBatchConverterFileSize_p(task.output);
+        result.succeeded = true;
+      }
+      catch (std::exception& e)
+      {
+        result.error = e.what();
+      }
+      catch (...)
+      {
+        result.error = "Unknown exception";
+      }
+      if (!result.succeeded)
+      {
+        reader->ResetState();
+        writer->ResetState();
+        if (writing)
+          std::remove(task.output.c_str());
+      }
+    }
+  };
+};
@@ -0,0 +1,141 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkAcquisitionFileBatchConverter_h
+#define __btkAcquisitionFileBatchConverter_h
+
+#include "btkAcquisition.h"
+
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  class AcquisitionFileBatchConverter
+  {
+  public:
+    typedef btkSharedPtr<AcquisitionFileBatchConverter> Pointer;
+    typedef btkSharedPtr<const AcquisitionFileBatchConverter> ConstPointer;
+    
+    class Filter
+    {
+    public:
+      typedef btkSharedPtr<Filter> Pointer;
+      virtual ~Filter() {};
+      virtual Pointer Clone() const = 0;
+      virtual Acquisition::Pointer Process(Acquisition::Pointer input) = 0;
+    protected:
+      Filter() {};
+    private:
+      Filter(const Filter& ); // Not implemented.
+      Filter& operator=(const Filter& ); // Not implemented.
+    };
+    
+    class Task
+    {
+    public:
+      Task(const std::string& i, const std::string& o) : input(i), output(o) {};
+      std::string input;
+      std::string output;
+    };
+    
+    class Result
+    {
+    public:
+      Result() : succeeded(false), error(), readTime(0.0), filterTime(0.0), writeTime(0.0), inputSize(0.0), outputSize(0.0) {};
+      bool succeeded;
+      std::string error;
+      double readTime;
+      double filterTime;
+      double writeTime;
+      double inputSize;
+      double outputSize;
+    };
+    
+    class Report
+    {
+    public:
+      Report() : fileNumber(0), failureNumber(0), elapsedTime(0.0), readTime(0.0), filterTime(0.0), writeTime(0.0), inputSize(0.0), outputSize(0.0) {};
+      double GetFilesPerSecond() const {return (this->elapsedTime > 0.0) ? static_cast<double>(this->fileNumber) / this->elapsedTime : 0.0;};
+      double GetMegabytesPerSecond() const {return (this->elapsedTime > 0.0) ? this->inputSize / this->elapsedTime / 1048576.0 : 0.0;};
+      int fileNumber;
+      int failureNumber;
+      double elapsedTime;
+      double readTime;
+      double filterTime;
+      double writeTime;
+      double inputSize;
+      double outputSize;
+    };
+    
+    static Pointer New() {return Pointer(new AcquisitionFileBatchConverter());};
+    virtual ~AcquisitionFileBatchConverter() {};
+    
+    int GetTaskNumber() const {return static_cast<int>(this->m_Tasks.size());};
+    const Task& GetTask(int idx) const {return this->m_Tasks[idx];};
+    void AppendTask(const std::string& input, const std::string& output) {this->m_Tasks.push_back(Task(input, output));};
+    BTK_IO_EXPORT int AppendDirectory(const std::string& inputDirectory, const std::string& outputDirectory, const std::string& outputSuffix);
+    BTK_IO_EXPORT int AppendManifest(const std::string& filename);
+    BTK_IO_EXPORT void ClearTasks();
+    
+    Filter::Pointer GetFilter() const {return this->m_Filter;};
+    void SetFilter(Filter::Pointer filter) {this->m_Filter = filter;};
+    int GetNumberOfThreads() const {return this->m_NumberOfThreads;};
+    void SetNumberOfThreads(int num) {this->m_NumberOfThreads = num;};
+    
+    BTK_IO_EXPORT void Update();
+    
+    const Result& GetResult(int idx) const {return this->m_Results[idx];};
+    const Report& GetReport() const {return this->m_Report;};
+    
+  protected:
+    BTK_IO_EXPORT AcquisitionFileBatchConverter();
+    
+  private:
+    static void Run(void* data);
+    
+    std::vector<Task> m_Tasks;
+    std::vector<Result> m_Results;
+    Report m_Report;
+    Filter::Pointer m_Filter;
+    int m_NumberOfThreads;
+    
+    AcquisitionFileBatchConverter(const AcquisitionFileBatchConverter& ); // Not implemented.
+    AcquisitionFileBatchConverter& operator=(const AcquisitionFileBatchConverter& ); // Not implemented.
+  };
+};
+
+#endif // __btkAcquisitionFileBatchConverter_h
@@ -102,6 +102,14 @@ namespace btk
   * @var AcquisitionFileIO::m_InternalsUpdate
   * Configuration used to update file format internals when an acquisition is writed.
   */
+ /**
+  * @var AcquisitionFileIO::m_LazyLoading
+  * Request to load the values of the points and analog channels only when they are accessed.
+  */
+ /**
+  * @var AcquisitionFileIO::m_PointStorage
+  * Storage mode of the points set in the acquisition read.
+  */
   
   /**
    * @typedef AcquisitionFileIO::Pointer
@@ -195,6 +203,23 @@ namespace btk
    * enum {MyFirstOption = AcquisitionFileIO::FileFormatOption, MySecondOption = 2*AcquisitionFileIO::FileFormatOption};
    * @endcode
    */
+  
+  /**
+   * @enum AcquisitionFileIO::ProbeResult
+   * Result of the detection of a file format from the first bytes of a file (see AcquisitionFileIO::CanReadBuffer()).
+   */
+  /**
+   * @var AcquisitionFileIO::ProbeResult AcquisitionFileIO::ProbeUnavailable
+   * The file IO cannot decide from a buffer. The method AcquisitionFileIO::CanReadFile() has to be used.
+   */
+  /**
+   * @var AcquisitionFileIO::ProbeResult AcquisitionFileIO::ProbeRejected
+   * The buffer does not correspond to a file supported by the file IO.
+   */
+  /**
+   * @var AcquisitionFileIO::ProbeResult AcquisitionFileIO::ProbeAccepted
+   * The buffer corresponds to a file supported by the file IO.
+   */
     
   /** 
    * @fn static bool AcquisitionFileIO::HasReadOperation()
@@ -301,13 +326,54 @@ namespace btk
   * @fn bool AcquisitionFileIO::HasInternalsUpdateOption(int option) const
   * Returns true if the given @a option is used or false if not.
   */
-    
+
+ /**
+  * @fn bool AcquisitionFileIO::GetLazyLoading() const
+  * Returns true if the values of the points and analog channels are loaded only when they are accessed.
+  */
+
+ /**
+  * @fn void AcquisitionFileIO::SetLazyLoading(bool enabled)
+  * Enable/disable the lazy loading of the points and analog channels.
+  *
+  * When enabled, the method Read() extracts the metadata, the labels and the number of frames, but the data of each
+  * measure are extracted only the first time their values are accessed (see MeasureData::SetLoader()). Only the file
+  * formats which can access directly to each channel in the file support this option (currently the C3D file format
+  * when the file is mapped in memory). The others ignore it and load all the data.
+  *
+  * @warning The file must not be modified (or overwritten) until all the needed values are loaded.
+  */
+  
+ /**
+  * @fn Acquisition::PointStorage AcquisitionFileIO::GetPointStorage() const
+  * Returns the storage mode of the points used by the method Read().
+  */
+
+ /**
+  * @fn void AcquisitionFileIO::SetPointStorage(Acquisition::PointStorage storage)
+  * Sets the storage mode of the points used by the method Read() (see Acquisition::SetPointStorage()).
+  *
+  * With the mode Acquisition::ContiguousPointStorage, the file formats which can decode directly their data 
+  * in the block of the points (currently the C3D file format) avoid the allocation of one matrix per point. 
+  */
+
  /**
   * @fn virtual bool AcquisitionFileIO::CanReadFile(const std::string& filename) = 0
   * Checks if @a filename can be read by this AcquisitionFileIO. This methods 
   * should try to read the file header instead to check the file's suffix.
   */
   
+  /**
+   * @fn virtual ProbeResult AcquisitionFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& extension, size_t fileSize)
+   * Checks if the file starting with the @a size bytes of @a buffer can be read by this AcquisitionFileIO.
+   * The @a extension is given in uppercase without the dot (empty if the file has no suffix) and @a fileSize
+   * is the total size of the file in bytes. The @a buffer contains only the beginning of the file (see 
+   * AcquisitionFileIOFactory::ProbeSize) and can be shorter than expected for a small file.
+   *
+   * This method is used by the AcquisitionFileIOFactory to detect the format of a file by opening it only once.
+   * By default, it returns ProbeUnavailable and the factory calls AcquisitionFileIO::CanReadFile() instead.
+   */
+  
   /**
    * @fn virtual bool AcquisitionFileIO::CanWriteFile(const std::string& filename) = 0
    * Checks if @a filename can be write by this AcquisitionFileIO. This method 
@@ -334,6 +400,8 @@ namespace btk
     this->m_ByteOrder = b;
     this->m_StorageFormat = s;
     this->m_InternalsUpdate = internalsUpdate;
+    this->m_LazyLoading = false;
+    this->m_PointStorage = Acquisition::SeparatePointStorage;
   };
   
   /**
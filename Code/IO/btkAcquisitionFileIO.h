@@ -57,6 +57,7 @@ namespace btk
     typedef enum {OrderNotApplicable = 0, IEEE_LittleEndian, VAX_LittleEndian, IEEE_BigEndian} ByteOrder;
     typedef enum {StorageNotApplicable = 0, Float = -1, Integer = 1} StorageFormat;
     typedef enum {UpdateNotApplicable = 0, NoUpdate = UpdateNotApplicable, DataBasedUpdate = 1, MetaDataBasedUpdate = 2, FileFormatOption = 512} InternalsUpdateOption;
+    typedef enum {ProbeUnavailable = -1, ProbeRejected = 0, ProbeAccepted = 1} ProbeResult;
     
     virtual const Extensions& GetSupportedExtensions() const = 0;
 
@@ -73,8 +74,15 @@ namespace btk
     int GetInternalsUpdateOptions() const {return this->m_InternalsUpdate;};
     void SetInternalsUpdateOptions(int options) {this->m_InternalsUpdate = options;};
     bool HasInternalsUpdateOption(int option) const {return ((this->m_InternalsUpdate & option) == option);};
+    
+    bool GetLazyLoading() const {return this->m_LazyLoading;};
+    void SetLazyLoading(bool enabled) {this->m_LazyLoading = enabled;};
+    
+    Acquisition::PointStorage GetPointStorage() const {return this->m_PointStorage;};
+    void SetPointStorage(Acquisition::PointStorage storage) {this->m_PointStorage = storage;};
 
     virtual bool CanReadFile(const std::string& filename) = 0;
+    virtual ProbeResult CanReadBuffer(const char* /* buffer */, size_t /* size */, const std::string& /* extension */, size_t /* fileSize */) {return ProbeUnavailable;};
     virtual bool CanWriteFile(const std::string& filename) = 0;
     virtual void Read(const std::string& filename, Acquisition::Pointer output) = 0;
     virtual void Write(const std::string& filename, Acquisition::Pointer input) = 0;
@@ -117,6 +125,8 @@ namespace btk
     ByteOrder m_ByteOrder;
     StorageFormat m_StorageFormat;
     int m_InternalsUpdate;
+    bool m_LazyLoading;
+    Acquisition::PointStorage m_PointStorage;
     
   private:
     enum {ReadOp = 1, WriteOp = 1};
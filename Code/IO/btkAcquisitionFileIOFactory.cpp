@@ -35,9 +35,68 @@
 
 #include "btkAcquisitionFileIOFactory.h"
 #include "btkAcquisitionFileIOFactory_p.h"
+#include "btkCriticalSection_p.h"
+
+#include <fstream>
+#include <algorithm>
+#include <vector>
+#include <cctype>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 namespace btk
 {
+  // Returns the suffix of the given filename in uppercase and without the dot.
+  std::string AcquisitionFileIOFactoryExtension_p(const std::string& filename)
+  {
+    std::string::size_type sep = filename.find_last_of("/\\");
+    std::string::size_type dot = filename.rfind('.');
+    if ((dot == std::string::npos) || ((sep != std::string::npos) && (dot < sep)))
+      return std::string();
+    std::string extension = filename.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), toupper);
+    return extension;
+  };
+  
+  // Checks if the suffix is one of the given extensions. The character '*' matches any character.
+  bool AcquisitionFileIOFactoryMatchExtension_p(const AcquisitionFileIO::Extensions& extensions, const std::string& extension)
+  {
+    for (AcquisitionFileIO::Extensions::ConstIterator it = extensions.Begin() ; it != extensions.End() ; ++it)
+    {
+      if (it->name.length() != extension.length())
+        continue;
+      size_t i = 0;
+      for ( ; i < extension.length() ; ++i)
+      {
+        if ((it->name[i] != '*') && (toupper(it->name[i]) != extension[i]))
+          break;
+      }
+      if (i == extension.length())
+        return true;
+    }
+    return false;
+  };
+  
+  // Uses the probing buffer if supported by the file IO, otherwise the file is opened by the file IO.
+  static bool AcquisitionFileIOFactoryProbe_p(AcquisitionFileIO::Pointer io, const std::string& filename, const char* buffer, size_t size, const std::string& extension, size_t fileSize)
+  {
+    AcquisitionFileIO::ProbeResult result = io->CanReadBuffer(buffer, size, extension, fileSize);
+    if (result == AcquisitionFileIO::ProbeUnavailable)
+      return io->CanReadFile(filename);
+    return (result == AcquisitionFileIO::ProbeAccepted);
+  };
+  
+  // Protects the list of the registered file IOs and the cache of the detected file formats.
+  static critical_section_p& AcquisitionFileIOFactoryLock_p()
+  {
+    static critical_section_p cs;
+    return cs;
+  };
+  
+  // Forces the initialization of the registered file IOs and of the lock when the library is loaded (i.e. before 
+  // the creation of any thread), as the initialization of a local static variable is not thread-safe with every compiler.
+  static int _btk_acquisition_file_io_factory_init = AcquisitionFileIOFactory::GetCacheSize();
+  
   /**
    * @class AcquisitionFileIOFactory btkAcquisitionFileIOFactory.h
    * @brief Manage all the acquisition file IOs and detect if a file is readable or writable.
@@ -49,6 +108,12 @@ namespace btk
    * If you want to add a new file format to this factory, you can use the method AcquisitionFileIOFactory::AddFileIO.
    * Or you if you work directly into the source-code of BTK, you can register direclty the new file format using the file btkAcquisitionFileIOFactory_registration.cpp
    *
+   * All the static methods of this factory can be called concurrently from several threads. The registered file IOs 
+   * are initialized when the library is loaded and each call to CreateAcquisitionIO() returns a new file IO object.
+   * Thus, independent acquisitions can be read and written at the same time by several threads (each one using 
+   * its own AcquisitionFileReader or AcquisitionFileWriter object). The same reader, writer or acquisition must not 
+   * be used by several threads at the same time.
+   *
    * @sa AcquisitionFileIORegister
    * 
    * @ingroup BTKIO
@@ -67,26 +132,102 @@ namespace btk
    * Enum value for the write mode
    */
   
+  /**
+   * @var AcquisitionFileIOFactory::ProbeSize
+   * Number of bytes read at the beginning of a file to detect its format.
+   */
+  /**
+   * @var AcquisitionFileIOFactory::CacheCapacity
+   * Maximum number of detected file formats kept in the cache. The cache is emptied when this number is reached.
+   */
+  
   /**
    * Try to find the AcquisitionFileIO helper to read/write the file. This method has
    * to be modified each time a new AcquisitionFileIO is added in this library. The order
    * of the IO is important as the first AcquisitionFileIO which can read/write the file
    * is returned.
+   *
+   * In read mode, the file is opened only once: its first bytes (see ProbeSize) are given to 
+   * the method AcquisitionFileIO::CanReadBuffer() of each file IO. The file IOs supporting 
+   * the suffix of the file are tested first. The file IOs not able to detect their format from 
+   * a buffer are tested with the method AcquisitionFileIO::CanReadFile(). The detected format 
+   * is cached for the given filename and reused until the modification time or the size 
+   * of the file change.
    */
   AcquisitionFileIO::Pointer AcquisitionFileIOFactory::CreateAcquisitionIO(const std::string& filename, OpenMode mode)
   {
     AcquisitionFileIO::Pointer io;
     if (mode == ReadMode)
     {
-      for (AcquisitionFileIOHandles::ConstIterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+      AcquisitionFileIOHandles* handles = AcquisitionFileIOFactory::GetInfoIOs();
+      struct stat info;
+      if (stat(filename.c_str(), &info) != 0)
+        return io;
+      const size_t fileSize = static_cast<size_t>(info.st_size);
+      // The registered file IOs are copied to probe the file without holding the lock.
+      std::list<AcquisitionFileIOHandle::Pointer> list;
+      AcquisitionFileIOFactoryLock_p().Lock();
+      std::map<std::string, AcquisitionFileIOHandles::CacheEntry>::iterator cached = handles->cache.find(filename);
+      if (cached != handles->cache.end())
       {
-        if ((*it)->HasReadOperation() && (io = (*it)->GetFileIO())->CanReadFile(filename))
-          return io;
+        if ((cached->second.modificationTime == info.st_mtime) && (cached->second.fileSize == fileSize))
+        {
+          AcquisitionFileIOHandle::Functor::Pointer functor = cached->second.functor;
+          AcquisitionFileIOFactoryLock_p().Unlock();
+          return functor->GetFileIO();
+        }
+        handles->cache.erase(cached);
+      }
+      list = handles->list;
+      AcquisitionFileIOFactoryLock_p().Unlock();
+      char buffer[ProbeSize];
+      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      if (!ifs.is_open())
+        return io;
+      ifs.read(buffer, ProbeSize);
+      const size_t size = static_cast<size_t>(ifs.gcount());
+      ifs.close();
+      const std::string extension = AcquisitionFileIOFactoryExtension_p(filename);
+      AcquisitionFileIOHandle::Functor::Pointer functor;
+      std::vector<AcquisitionFileIOHandles::ConstIterator> others;
+      for (AcquisitionFileIOHandles::ConstIterator it = list.begin() ; it != list.end() ; ++it)
+      {
+        if (!(*it)->HasReadOperation())
+          continue;
+        io = (*it)->GetFileIO();
+        if (!AcquisitionFileIOFactoryMatchExtension_p(io->GetSupportedExtensions(), extension))
+          others.push_back(it);
+        else if (AcquisitionFileIOFactoryProbe_p(io, filename, buffer, size, extension, fileSize))
+        {
+          functor = (*it)->GetFunctor();
+          break;
+        }
+      }
+      for (size_t i = 0 ; (functor.get() == 0) && (i < others.size()) ; ++i)
+      {
+        io = (*others[i])->GetFileIO();
+        if (AcquisitionFileIOFactoryProbe_p(io, filename, buffer, size, extension, fileSize))
+          functor = (*others[i])->GetFunctor();
       }
+      if (functor.get() == 0)
+        return AcquisitionFileIO::Pointer();
+      AcquisitionFileIOHandles::CacheEntry entry;
+      entry.modificationTime = info.st_mtime;
+      entry.fileSize = fileSize;
+      entry.functor = functor;
+      AcquisitionFileIOFactoryLock_p().Lock();
+      if (handles->cache.size() >= CacheCapacity)
+        handles->cache.clear();
+      handles->cache[filename] = entry;
+      AcquisitionFileIOFactoryLock_p().Unlock();
+      return io;
     }
     else
     {
-      for (AcquisitionFileIOHandles::ConstIterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+      AcquisitionFileIOFactoryLock_p().Lock();
+      std::list<AcquisitionFileIOHandle::Pointer> list = AcquisitionFileIOFactory::GetInfoIOs()->list;
+      AcquisitionFileIOFactoryLock_p().Unlock();
+      for (AcquisitionFileIOHandles::ConstIterator it = list.begin() ; it != list.end() ; ++it)
       {
         if ((*it)->HasWriteOperation() && (io = (*it)->GetFileIO())->CanWriteFile(filename))
           return io;
@@ -102,12 +243,18 @@ namespace btk
    */
   bool AcquisitionFileIOFactory::AddFileIO(AcquisitionFileIOHandle::Pointer infoIO)
   {
+    AcquisitionFileIOFactoryLock_p().Lock();
     for (AcquisitionFileIOHandles::ConstIterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
     {
       if ((*it)->GetFunctor() == infoIO->GetFunctor())
+      {
+        AcquisitionFileIOFactoryLock_p().Unlock();
         return false;
+      }
     }
     AcquisitionFileIOFactory::GetInfoIOs()->list.push_front(infoIO);
+    AcquisitionFileIOFactory::GetInfoIOs()->cache.clear();
+    AcquisitionFileIOFactoryLock_p().Unlock();
     return true;
   };
   
@@ -118,15 +265,42 @@ namespace btk
    */
   bool AcquisitionFileIOFactory::RemoveFileIO(AcquisitionFileIOHandle::Pointer infoIO)
   {
+    bool removed = false;
+    AcquisitionFileIOFactoryLock_p().Lock();
     for (AcquisitionFileIOHandles::Iterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
     {
       if ((*it)->GetFunctor() == infoIO->GetFunctor())
       {
         AcquisitionFileIOFactory::GetInfoIOs()->list.erase(it);
-        return true;
+        AcquisitionFileIOFactory::GetInfoIOs()->cache.clear();
+        removed = true;
+        break;
       }
     }
-    return false;
+    AcquisitionFileIOFactoryLock_p().Unlock();
+    return removed;
+  };
+  
+  /**
+   * Returns the number of file formats stored in the cache of the factory.
+   */
+  int AcquisitionFileIOFactory::GetCacheSize()
+  {
+    AcquisitionFileIOFactoryLock_p().Lock();
+    int size = static_cast<int>(AcquisitionFileIOFactory::GetInfoIOs()->cache.size());
+    AcquisitionFileIOFactoryLock_p().Unlock();
+    return size;
+  };
+  
+  /**
+   * Removes all the file formats stored in the cache of the factory. 
+   * The next call to CreateAcquisitionIO() will probe again the given file.
+   */
+  void AcquisitionFileIOFactory::ClearCache()
+  {
+    AcquisitionFileIOFactoryLock_p().Lock();
+    AcquisitionFileIOFactory::GetInfoIOs()->cache.clear();
+    AcquisitionFileIOFactoryLock_p().Unlock();
   };
   
   /**
@@ -137,11 +311,13 @@ namespace btk
   AcquisitionFileIO::Extensions AcquisitionFileIOFactory::GetSupportedReadExtensions()
   {
     AcquisitionFileIO::Extensions exts;
+    AcquisitionFileIOFactoryLock_p().Lock();
     for (AcquisitionFileIOHandles::Iterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
     {
       if ((*it)->HasReadOperation())
         exts.Append((*it)->GetFileIO()->GetSupportedExtensions());
     }
+    AcquisitionFileIOFactoryLock_p().Unlock();
     return exts;
   };
   
@@ -153,11 +329,13 @@ namespace btk
   AcquisitionFileIO::Extensions AcquisitionFileIOFactory::GetSupportedWrittenExtensions()
   {
     AcquisitionFileIO::Extensions exts;
+    AcquisitionFileIOFactoryLock_p().Lock();
     for (AcquisitionFileIOHandles::Iterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
     {
       if ((*it)->HasWriteOperation())
         exts.Append((*it)->GetFileIO()->GetSupportedExtensions());
     }
+    AcquisitionFileIOFactoryLock_p().Unlock();
     return exts;
   };
   
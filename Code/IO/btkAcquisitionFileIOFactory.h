@@ -49,8 +49,12 @@ namespace btk
   {
   public:
     typedef enum {ReadMode, WriteMode} OpenMode;
+    enum {ProbeSize = 4096, CacheCapacity = 256};
     BTK_IO_EXPORT static AcquisitionFileIO::Pointer CreateAcquisitionIO(const std::string& filename, OpenMode mode);
     
+    BTK_IO_EXPORT static int GetCacheSize();
+    BTK_IO_EXPORT static void ClearCache();
+    
     BTK_IO_EXPORT static bool AddFileIO(AcquisitionFileIOHandle::Pointer infoIO);
     BTK_IO_EXPORT static bool RemoveFileIO(AcquisitionFileIOHandle::Pointer infoIO);
     
@@ -38,12 +38,15 @@
 
 #include "btkAcquisitionFileIORegister.h"
 
+#include <map>
+#include <ctime>
+
 #define BTK_REGISTER_ACQUISITION_FILE_IO(classname) \
   this->list.push_back(btk::AcquisitionFileIORegister<classname>::New());
    
 #define BTK_ACQUISITON_FILE_IO_FACTORY_INIT \
    AcquisitionFileIOHandles::AcquisitionFileIOHandles() \
-   : list()
+   : list(), cache()
 
 namespace btk
 {
@@ -54,7 +57,18 @@ namespace btk
     typedef std::list<AcquisitionFileIOHandle::Pointer>::const_iterator ConstIterator;
     AcquisitionFileIOHandles();
     std::list<AcquisitionFileIOHandle::Pointer> list;
+    // Cache of the detected file formats (key: filename).
+    struct CacheEntry
+    {
+      time_t modificationTime;
+      size_t fileSize;
+      AcquisitionFileIOHandle::Functor::Pointer functor;
+    };
+    std::map<std::string, CacheEntry> cache;
   };
+  
+  std::string AcquisitionFileIOFactoryExtension_p(const std::string& filename);
+  bool AcquisitionFileIOFactoryMatchExtension_p(const AcquisitionFileIO::Extensions& extensions, const std::string& extension);
 }
 
 #endif // __btkAcquisitionFileIOFactory_p_h
\ No newline at end of file
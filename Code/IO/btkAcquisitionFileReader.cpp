@@ -37,9 +37,23 @@
 #include "btkAcquisitionFileIOFactory.h"
 
 #include <fstream>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 namespace btk
 {
+  // Throws an exception if the file is missing or cannot be opened.
+  // Used only after a failure as the file is opened only by the factory and the file IO (see AcquisitionFileReader::GenerateData()).
+  static void AcquisitionFileReaderCheckFile_p(const std::string& filename)
+  {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+      throw AcquisitionFileReaderException("File doesn't exist\nFilename: " + filename);
+    std::ifstream ifs(filename.c_str());
+    if (!ifs.is_open())
+      throw AcquisitionFileReaderException("File can't be opened. Have you the permission to read this file?\nFilename: " + filename);
+  };
+  
   /**
    * @class AcquisitionFileReaderException btkAcquisitionFileReader.h
    * @brief Exception class for the AcquisitionFileReader class.
@@ -157,6 +171,67 @@ namespace btk
     }
   };
   
+  /**
+   * @fn bool AcquisitionFileReader::GetLazyLoading() const
+   * Returns true if the values of the points and analog channels are extracted only when they are accessed.
+   */
+  
+  /**
+   * Enable/disable the lazy loading of the points and analog channels (disabled by default).
+   * This option is forwarded to the AcquisitionIO helper class (see AcquisitionFileIO::SetLazyLoading()).
+   */
+  void AcquisitionFileReader::SetLazyLoading(bool enabled)
+  {
+    if (this->m_LazyLoading != enabled)
+    {
+      this->m_LazyLoading = enabled;
+      this->Modified();
+    }
+  };
+  
+  /**
+   * @fn Acquisition::PointStorage AcquisitionFileReader::GetPointStorage() const
+   * Returns the storage mode of the points of the output.
+   */
+  
+  /**
+   * Sets the storage mode of the points of the output (Acquisition::SeparatePointStorage by default).
+   * This option is forwarded to the AcquisitionIO helper class (see AcquisitionFileIO::SetPointStorage()).
+   * The formats which do not support it have their points moved in the requested storage after the reading.
+   *
+   * @note The option is ignored with the lazy loading, as the points are then extracted independently.
+   */
+  void AcquisitionFileReader::SetPointStorage(Acquisition::PointStorage storage)
+  {
+    if (this->m_PointStorage != storage)
+    {
+      this->m_PointStorage = storage;
+      this->Modified();
+    }
+  };
+  
+  /**
+   * @fn bool AcquisitionFileReader::GetMemoryArenaEnabled() const
+   * Returns true if the content of the output is allocated in a memory arena.
+   */
+  
+  /**
+   * Enable/disable the allocation of the content of the output in a memory arena (disabled by default).
+   *
+   * When enabled, a new arena is created for each reading. The objects created by the AcquisitionIO helper class
+   * (points, analog channels, events, metadata, ...) are allocated inside and released all together
+   * when the output and its content are destroyed. The arena is stored in the output (see Acquisition::GetMemoryArena())
+   * and gives the number of allocations saved.
+   */
+  void AcquisitionFileReader::SetMemoryArenaEnabled(bool enabled)
+  {
+    if (this->m_MemoryArenaEnabled != enabled)
+    {
+      this->m_MemoryArenaEnabled = enabled;
+      this->Modified();
+    }
+  };
+  
   /**
    * Constructor. Sets the number of outputs equal to one. No input.
    */
@@ -165,6 +240,9 @@ namespace btk
   {
     this->SetOutputNumber(1);
     this->m_FilenameExtensionDisabled = false;
+    this->m_LazyLoading = false;
+    this->m_PointStorage = Acquisition::SeparatePointStorage;
+    this->m_MemoryArenaEnabled = false;
   };
   
   /**
@@ -182,8 +260,8 @@ namespace btk
   };
   
   /**
-   * Check the file integrety, find a AcquisitionIO helper class if no one has
-   * been specified and finally read the file.
+   * Find a AcquisitionIO helper class if no one has been specified and read the file.
+   * The file is not opened before: a missing or unreadable file is detected after the failure of the detection of its format or of its reading.
    */
   void AcquisitionFileReader::GenerateData()
   {
@@ -195,23 +273,36 @@ namespace btk
         return;
     }
     
-    std::ifstream ifs;
-    ifs.open(this->m_Filename.c_str());
-    // check if the file exists
-    if (!ifs.is_open())
-      throw AcquisitionFileReaderException("File doesn't exist\nFilename: " + this->m_Filename);
-    // check if the file is not read only
-    if(ifs.fail())
-      throw AcquisitionFileReaderException("File can't be opened. Have you the permission to read this file?\nFilename: " + this->m_Filename);
-    ifs.close();
-    
+    // Messages sent during the reading are tagged with the filename.
+    Logger::ThreadTag tag(btkStripPathMacro(this->m_Filename.c_str()));
     if (this->m_AcquisitionIO.get() == 0)
     {
       this->m_AcquisitionIO = AcquisitionFileIOFactory::CreateAcquisitionIO(this->m_Filename.c_str(), AcquisitionFileIOFactory::ReadMode);
       if (this->m_AcquisitionIO.get() == 0)
+      {
+        AcquisitionFileReaderCheckFile_p(this->m_Filename);
         throw AcquisitionFileReaderException("No IO found, the file is not supported or valid or the file suffix is misspelled (Some IO use it to verify they can read the file)\nFilename: " + this->m_Filename);
+      }
     }
     
-    this->m_AcquisitionIO->Read(this->m_Filename, this->GetOutput());
+    this->m_AcquisitionIO->SetLazyLoading(this->m_LazyLoading);
+    this->m_AcquisitionIO->SetPointStorage(this->m_LazyLoading ? Acquisition::SeparatePointStorage : this->m_PointStorage);
+    MemoryArena::Pointer arena;
+    if (this->m_MemoryArenaEnabled)
+      arena = MemoryArena::New();
+    MemoryArena::Scope scope(arena);
+    try
+    {
+      this->m_AcquisitionIO->Read(this->m_Filename, this->GetOutput());
+    }
+    catch (...)
+    {
+      // A missing or unreadable file is reported as with the detection of the file format.
+      AcquisitionFileReaderCheckFile_p(this->m_Filename);
+      throw;
+    }
+    if (!this->m_LazyLoading)
+      this->GetOutput()->SetPointStorage(this->m_PointStorage);
+    this->GetOutput()->SetMemoryArena(arena);
   };
 };
@@ -72,6 +72,12 @@ namespace btk
     AcquisitionFileIO::Pointer GetAcquisitionIO() {return this->m_AcquisitionIO;};
     AcquisitionFileIO::ConstPointer GetAcquisitionIO() const {return this->m_AcquisitionIO;};
     BTK_IO_EXPORT void SetAcquisitionIO(AcquisitionFileIO::Pointer io = AcquisitionFileIO::Pointer());
+    bool GetLazyLoading() const {return this->m_LazyLoading;};
+    BTK_IO_EXPORT void SetLazyLoading(bool enabled);
+    Acquisition::PointStorage GetPointStorage() const {return this->m_PointStorage;};
+    BTK_IO_EXPORT void SetPointStorage(Acquisition::PointStorage storage);
+    bool GetMemoryArenaEnabled() const {return this->m_MemoryArenaEnabled;};
+    BTK_IO_EXPORT void SetMemoryArenaEnabled(bool enabled);
   
   protected:
     BTK_IO_EXPORT AcquisitionFileReader();
@@ -88,6 +94,9 @@ namespace btk
     AcquisitionFileReader& operator=(const AcquisitionFileReader& ); // Not implemented.
 
     bool m_FilenameExtensionDisabled;
+    bool m_LazyLoading;
+    Acquisition::PointStorage m_PointStorage;
+    bool m_MemoryArenaEnabled;
   };
 };
 
@@ -40,6 +40,23 @@
 
 namespace btk
 {
+  // Loads the measures extracted lazily (see AcquisitionFileIO::SetLazyLoading()). Their loaders can read the file overwritten by the writer.
+  static void LoadLazyMeasures_p(Acquisition::ConstPointer input)
+  {
+    if (!input)
+      return;
+    for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+    {
+      Point::ConstPointer point = *it;
+      point->GetValues();
+    }
+    for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+    {
+      Analog::ConstPointer analog = *it;
+      analog->GetValues();
+    }
+  };
+  
   /**
    * @class AcquisitionFileWriterException btkAcquisitionFileWriter.h
    * @brief Exception class for the AcquisitionFileWriter class.
@@ -191,18 +208,25 @@ namespace btk
   /**
    * Check the file integrety, find a AcquisitionIO helper class if no one has
    * been specified and finally read the file.
+   *
+   * The measures of the input extracted lazily are loaded before to open the file. 
+   * Then, an acquisition read lazily can be written in the same file.
    */
   void AcquisitionFileWriter::GenerateData()
   {
     if (this->m_Filename.empty())
       throw AcquisitionFileWriterException("Filename must be specified.");
     
+    LoadLazyMeasures_p(this->GetInput());
+    
     std::ofstream ofs(this->m_Filename.c_str());
     // check if the file exists
     if (!ofs)
       throw AcquisitionFileWriterException("File can't be opened. Have you the permission to write this file?\nFilename: " + this->m_Filename);
     ofs.close();
     
+    // Messages sent during the writing are tagged with the filename.
+    Logger::ThreadTag tag(btkStripPathMacro(this->m_Filename.c_str()));
     if (this->m_AcquisitionIO.get() == 0)
     {
       this->m_AcquisitionIO = AcquisitionFileIOFactory::CreateAcquisitionIO(this->m_Filename.c_str(), AcquisitionFileIOFactory::WriteMode);
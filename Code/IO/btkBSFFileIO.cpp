@@ -135,6 +135,17 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the first word (little endian) of the buffer is equal to 100.
+   */
+  AcquisitionFileIO::ProbeResult BSFFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    static const char key[4] = {100, 0x00, 0x00, 0x00};
+    if ((size < 4) || (memcmp(buffer, key, 4) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
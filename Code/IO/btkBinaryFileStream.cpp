@@ -34,7 +34,9 @@
  */
 
 #include "btkBinaryFileStream.h"
+#include "btkBinaryFileStream_p.h"
 #include "btkConfigure.h"
+#include "btkMacro.h" // btkNotUsed
 
 #include <cstring>
 
@@ -276,8 +278,7 @@ namespace btk
    */
   void BinaryFileStream::ReadChar(size_t nb, char* values)
   {
-    for (size_t i = 0 ; i < nb ; ++i)
-      values[i] = this->ReadU8();
+    ReadBlock_p(this->mp_Stream, nb, values);
   };
   
   /** 
@@ -314,8 +315,7 @@ namespace btk
    */
   void BinaryFileStream::ReadI8(size_t nb, int8_t* values)
   {
-    for (size_t i = 0 ; i < nb ; ++i)
-      values[i] = this->ReadI8();
+    ReadBlock_p(this->mp_Stream, nb, values);
   };
   
   /** 
@@ -352,8 +352,7 @@ namespace btk
    */
   void BinaryFileStream::ReadU8(size_t nb, uint8_t* values)
   {
-    for (size_t i = 0 ; i < nb ; ++i)
-      values[i] = this->ReadU8();
+    ReadBlock_p(this->mp_Stream, nb, values);
   };
   
   /** 
@@ -688,6 +687,33 @@ namespace btk
     return nb;
   };
   
+  /**
+   * Gives the final size of the file to write (in bytes). With a memory mapped file, the file is resized 
+   * only once instead of growing during the writing. The file is truncated to the number of bytes written
+   * when it is closed. This method has no effect if the memory mapped file is not used (see RawFileStream).
+   * @return Returns true if the space was reserved.
+   */
+  bool BinaryFileStream::Reserve(size_t size)
+  {
+#if defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    btkNotUsed(size);
+    return false;
+#else
+    return this->mp_Stream->reserve(static_cast<std::streamsize>(size));
+#endif
+  };
+  
+  /**
+   * Writes the @a nb chars of the array @a values in one operation and return their size.
+   * The content is written as is, without conversion. It can be used to write a block of values already encoded.
+   */
+  size_t BinaryFileStream::WriteChar(size_t nb, const char* values)
+  {
+    if (nb != 0)
+      this->mp_Stream->write(values, static_cast<std::streamsize>(nb));
+    return nb;
+  };
+  
   /** 
    * @fn void BinaryFileStream::SeekWrite(StreamOffset offset, SeekDir dir)
    * Moves the set pointer by @a nb bytes in the seeking direction @a dir.
@@ -1017,6 +1043,110 @@ namespace btk
 #endif
   };
 
+  /**
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadI16(size_t nb, int16_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadI16(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadU16(size_t nb, uint16_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadU16(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb signed 32-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadI32(size_t nb, int32_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapWords32_p);
+#else
+    this->BinaryFileStream::ReadI32(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 32-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadU32(size_t nb, uint32_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapWords32_p);
+#else
+    this->BinaryFileStream::ReadU32(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb signed 64-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadI64(size_t nb, int64_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapWords64_p);
+#else
+    this->BinaryFileStream::ReadI64(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 64-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadU64(size_t nb, uint64_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapWords64_p);
+#else
+    this->BinaryFileStream::ReadU64(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb floats and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadFloat(size_t nb, float* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &VAXToIEEEFloat_p);
+#else
+    this->BinaryFileStream::ReadFloat(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb doubles and set them in the array @a values.
+   * The whole block is extracted at once and converted in place from the VAX format.
+   */
+  void VAXLittleEndianBinaryFileStream::ReadDouble(size_t nb, double* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &VAXToIEEEDouble_p);
+#else
+    this->BinaryFileStream::ReadDouble(nb, values);
+#endif
+  };
+  
   /**
    * Writes the signed 16-bit integer @a i16 in the stream an return its size.
    */
@@ -1265,6 +1395,110 @@ namespace btk
 #endif
   };
 
+  /**
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadI16(size_t nb, int16_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes16_p);
+#else
+    this->BinaryFileStream::ReadI16(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadU16(size_t nb, uint16_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes16_p);
+#else
+    this->BinaryFileStream::ReadU16(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb signed 32-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadI32(size_t nb, int32_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes32_p);
+#else
+    this->BinaryFileStream::ReadI32(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 32-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadU32(size_t nb, uint32_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes32_p);
+#else
+    this->BinaryFileStream::ReadU32(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb signed 64-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadI64(size_t nb, int64_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes64_p);
+#else
+    this->BinaryFileStream::ReadI64(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 64-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadU64(size_t nb, uint64_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes64_p);
+#else
+    this->BinaryFileStream::ReadU64(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb floats and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadFloat(size_t nb, float* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes32_p);
+#else
+    this->BinaryFileStream::ReadFloat(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb doubles and set them in the array @a values.
+   * The whole block is extracted at once and its bytes are swapped in place.
+   */
+  void IEEEBigEndianBinaryFileStream::ReadDouble(size_t nb, double* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values, &SwapBytes64_p);
+#else
+    this->BinaryFileStream::ReadDouble(nb, values);
+#endif
+  };
+  
   /**
    * Writes the signed 16-bit integer @a i16 in the stream an return its size.
    */
@@ -1513,6 +1747,110 @@ namespace btk
 #endif
   };
 
+  /**
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadI16(size_t nb, int16_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadI16(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadU16(size_t nb, uint16_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadU16(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb signed 32-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadI32(size_t nb, int32_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadI32(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 32-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadU32(size_t nb, uint32_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadU32(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb signed 64-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadI64(size_t nb, int64_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadI64(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb unsigned 64-bit integers and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadU64(size_t nb, uint64_t* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadU64(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb floats and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadFloat(size_t nb, float* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadFloat(nb, values);
+#endif
+  };
+  
+  /**
+   * Extracts @a nb doubles and set them in the array @a values.
+   * The whole block is extracted at once and copied directly in @a values.
+   */
+  void IEEELittleEndianBinaryFileStream::ReadDouble(size_t nb, double* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    ReadBlock_p(this->mp_Stream, nb, values);
+#else
+    this->BinaryFileStream::ReadDouble(nb, values);
+#endif
+  };
+  
   /**
    * Writes the signed 16-bit integer @a i16 in the stream an return its size.
    */
@@ -154,35 +154,35 @@ namespace btk
     void ReadU8(std::vector<uint8_t>& values) {if (values.empty()) return; this->ReadU8(values.size(), &(values[0]));};
     std::vector<uint8_t> ReadU8(size_t nb) {std::vector<uint8_t> values(nb); this->ReadU8(values); return values;};
     virtual int16_t ReadI16() = 0;
-    BTK_IO_EXPORT void ReadI16(size_t nb, int16_t* values);
+    BTK_IO_EXPORT virtual void ReadI16(size_t nb, int16_t* values);
     void ReadI16(std::vector<int16_t>& values) {if (values.empty()) return; this->ReadI16(values.size(), &(values[0]));};
     std::vector<int16_t> ReadI16(size_t nb) {std::vector<int16_t> values(nb); this->ReadI16(values); return values;};
     virtual uint16_t ReadU16() = 0;
-    BTK_IO_EXPORT void ReadU16(size_t nb, uint16_t* values);
+    BTK_IO_EXPORT virtual void ReadU16(size_t nb, uint16_t* values);
     void ReadU16(std::vector<uint16_t>& values) {if (values.empty()) return; this->ReadU16(values.size(), &(values[0]));};
     std::vector<uint16_t> ReadU16(size_t nb) {std::vector<uint16_t> values(nb); this->ReadU16(values); return values;};
     virtual int32_t ReadI32() = 0;
-    BTK_IO_EXPORT void ReadI32(size_t nb, int32_t* values);
+    BTK_IO_EXPORT virtual void ReadI32(size_t nb, int32_t* values);
     void ReadI32(std::vector<int32_t>& values) {if (values.empty()) return; this->ReadI32(values.size(), &(values[0]));};
     std::vector<int32_t> ReadI32(size_t nb) {std::vector<int32_t> values(nb); this->ReadI32(values); return values;};
     virtual uint32_t ReadU32() = 0;
-    BTK_IO_EXPORT void ReadU32(size_t nb, uint32_t* values);
+    BTK_IO_EXPORT virtual void ReadU32(size_t nb, uint32_t* values);
     void ReadU32(std::vector<uint32_t>& values) {if (values.empty()) return; this->ReadU32(values.size(), &(values[0]));};
     std::vector<uint32_t> ReadU32(size_t nb) {std::vector<uint32_t> values(nb); this->ReadU32(values); return values;};
     virtual int64_t ReadI64() = 0;
-    BTK_IO_EXPORT void ReadI64(size_t nb, int64_t* values);
+    BTK_IO_EXPORT virtual void ReadI64(size_t nb, int64_t* values);
     void ReadI64(std::vector<int64_t>& values) {if (values.empty()) return; this->ReadI64(values.size(), &(values[0]));};
     std::vector<int64_t> ReadI64(size_t nb) {std::vector<int64_t> values(nb); this->ReadI64(values); return values;};
     virtual uint64_t ReadU64() = 0;
-    BTK_IO_EXPORT void ReadU64(size_t nb, uint64_t* values);
+    BTK_IO_EXPORT virtual void ReadU64(size_t nb, uint64_t* values);
     void ReadU64(std::vector<uint64_t>& values) {if (values.empty()) return; this->ReadU64(values.size(), &(values[0]));};
     std::vector<uint64_t> ReadU64(size_t nb) {std::vector<uint64_t> values(nb); this->ReadU64(values); return values;};
     virtual float ReadFloat() = 0;
-    BTK_IO_EXPORT void ReadFloat(size_t nb, float* values);
+    BTK_IO_EXPORT virtual void ReadFloat(size_t nb, float* values);
     void ReadFloat(std::vector<float>& values) {if (values.empty()) return; this->ReadFloat(values.size(), &(values[0]));};
     std::vector<float> ReadFloat(size_t nb) {std::vector<float> values(nb); this->ReadFloat(values); return values;};
     virtual double ReadDouble() = 0;
-    BTK_IO_EXPORT void ReadDouble(size_t nb, double* values);
+    BTK_IO_EXPORT virtual void ReadDouble(size_t nb, double* values);
     void ReadDouble(std::vector<double>& values) {if (values.empty()) return; this->ReadDouble(values.size(), &(values[0]));};
     std::vector<double> ReadDouble(size_t nb) {std::vector<double> values(nb); this->ReadDouble(values); return values;};
     BTK_IO_EXPORT std::string ReadString(size_t nbChar);
@@ -194,6 +194,8 @@ namespace btk
     StreamPosition TellRead() const {return this->mp_Stream->tellg();};
     
     BTK_IO_EXPORT size_t Fill(size_t nb);
+    BTK_IO_EXPORT bool Reserve(size_t size);
+    BTK_IO_EXPORT size_t WriteChar(size_t nb, const char* values);
     void SeekWrite(StreamOffset offset, SeekDir dir) {this->mp_Stream->seekp(offset, dir);};
     // Note: MSVC doesn't like the following commented methods.
     //       char and int8_t are the same for it...
@@ -234,20 +236,28 @@ namespace btk
     VAXLittleEndianBinaryFileStream(const std::string& filename, OpenMode mode) : BinaryFileStream(filename, mode) {};
     // ~VAXLittleEndianBinaryFileStream(); // Implicit.  
     BTK_IO_EXPORT virtual int16_t ReadI16();
+    BTK_IO_EXPORT virtual void ReadI16(size_t nb, int16_t* values);
     using BinaryFileStream::ReadI16;
     BTK_IO_EXPORT virtual uint16_t ReadU16();
+    BTK_IO_EXPORT virtual void ReadU16(size_t nb, uint16_t* values);
     using BinaryFileStream::ReadU16;
     BTK_IO_EXPORT virtual int32_t ReadI32(); 
+    BTK_IO_EXPORT virtual void ReadI32(size_t nb, int32_t* values);
     using BinaryFileStream::ReadI32;
     BTK_IO_EXPORT virtual uint32_t ReadU32();
+    BTK_IO_EXPORT virtual void ReadU32(size_t nb, uint32_t* values);
     using BinaryFileStream::ReadU32;
     BTK_IO_EXPORT virtual int64_t ReadI64(); 
+    BTK_IO_EXPORT virtual void ReadI64(size_t nb, int64_t* values);
     using BinaryFileStream::ReadI64;
     BTK_IO_EXPORT virtual uint64_t ReadU64();
+    BTK_IO_EXPORT virtual void ReadU64(size_t nb, uint64_t* values);
     using BinaryFileStream::ReadU64;
     BTK_IO_EXPORT virtual float ReadFloat();
+    BTK_IO_EXPORT virtual void ReadFloat(size_t nb, float* values);
     using BinaryFileStream::ReadFloat;
     BTK_IO_EXPORT virtual double ReadDouble();
+    BTK_IO_EXPORT virtual void ReadDouble(size_t nb, double* values);
     using BinaryFileStream::ReadDouble;
     BTK_IO_EXPORT virtual size_t Write(int16_t i16);
     BTK_IO_EXPORT virtual size_t Write(uint16_t u16);
@@ -268,20 +278,28 @@ namespace btk
     IEEELittleEndianBinaryFileStream(const std::string& filename, OpenMode mode) : BinaryFileStream(filename, mode) {};
     // ~IEEELittleEndianBinaryFileStream(); // Implicit.  
     BTK_IO_EXPORT virtual int16_t ReadI16(); 
+    BTK_IO_EXPORT virtual void ReadI16(size_t nb, int16_t* values);
     using BinaryFileStream::ReadI16;
     BTK_IO_EXPORT virtual uint16_t ReadU16();
+    BTK_IO_EXPORT virtual void ReadU16(size_t nb, uint16_t* values);
     using BinaryFileStream::ReadU16;
     BTK_IO_EXPORT virtual int32_t ReadI32(); 
+    BTK_IO_EXPORT virtual void ReadI32(size_t nb, int32_t* values);
     using BinaryFileStream::ReadI32;
     BTK_IO_EXPORT virtual uint32_t ReadU32();
+    BTK_IO_EXPORT virtual void ReadU32(size_t nb, uint32_t* values);
     using BinaryFileStream::ReadU32;
     BTK_IO_EXPORT virtual int64_t ReadI64(); 
+    BTK_IO_EXPORT virtual void ReadI64(size_t nb, int64_t* values);
     using BinaryFileStream::ReadI64;
     BTK_IO_EXPORT virtual uint64_t ReadU64();
+    BTK_IO_EXPORT virtual void ReadU64(size_t nb, uint64_t* values);
     using BinaryFileStream::ReadU64;
     BTK_IO_EXPORT virtual float ReadFloat();
+    BTK_IO_EXPORT virtual void ReadFloat(size_t nb, float* values);
     using BinaryFileStream::ReadFloat;
     BTK_IO_EXPORT virtual double ReadDouble();
+    BTK_IO_EXPORT virtual void ReadDouble(size_t nb, double* values);
     using BinaryFileStream::ReadDouble;
     BTK_IO_EXPORT virtual size_t Write(int16_t i16);
     BTK_IO_EXPORT virtual size_t Write(uint16_t u16);
@@ -302,20 +320,28 @@ namespace btk
     IEEEBigEndianBinaryFileStream(const std::string& filename, OpenMode mode) : BinaryFileStream(filename, mode) {};
     // ~IEEEBigEndianBinaryFileStream(); // Implicit.  
     BTK_IO_EXPORT virtual int16_t ReadI16();
+    BTK_IO_EXPORT virtual void ReadI16(size_t nb, int16_t* values);
     using BinaryFileStream::ReadI16;
     BTK_IO_EXPORT virtual uint16_t ReadU16();
+    BTK_IO_EXPORT virtual void ReadU16(size_t nb, uint16_t* values);
     using BinaryFileStream::ReadU16;
     BTK_IO_EXPORT virtual int32_t ReadI32(); 
+    BTK_IO_EXPORT virtual void ReadI32(size_t nb, int32_t* values);
     using BinaryFileStream::ReadI32;
     BTK_IO_EXPORT virtual uint32_t ReadU32();
+    BTK_IO_EXPORT virtual void ReadU32(size_t nb, uint32_t* values);
     using BinaryFileStream::ReadU32;
     BTK_IO_EXPORT virtual int64_t ReadI64(); 
+    BTK_IO_EXPORT virtual void ReadI64(size_t nb, int64_t* values);
     using BinaryFileStream::ReadI64;
     BTK_IO_EXPORT virtual uint64_t ReadU64();
+    BTK_IO_EXPORT virtual void ReadU64(size_t nb, uint64_t* values);
     using BinaryFileStream::ReadU64;
     BTK_IO_EXPORT virtual float ReadFloat();
+    BTK_IO_EXPORT virtual void ReadFloat(size_t nb, float* values);
     using BinaryFileStream::ReadFloat;
     BTK_IO_EXPORT virtual double ReadDouble();
+    BTK_IO_EXPORT virtual void ReadDouble(size_t nb, double* values);
     using BinaryFileStream::ReadDouble;
     BTK_IO_EXPORT virtual size_t Write(int16_t i16);
     BTK_IO_EXPORT virtual size_t Write(uint16_t u16);
@@ -36,6 +36,9 @@
 #include "btkBinaryFileStream_mmfstream.h"
 #include "btkMacro.h" // btkNotUsed
 
+#include <cstring> // memcpy
+#include <algorithm> // std::max
+
 #if defined(HAVE_SYS_MMAP)
   #if defined(HAVE_64_BIT)
     #ifndef _LARGEFILE_SOURCE
@@ -257,6 +260,21 @@ namespace btk
    * Returns directly the content of the buffer.
    */
   
+  /**
+   * Resizes the map (and the file) to contain at least @a n bytes. This method is only useful in write mode
+   * when the final size of the file is known to avoid the remapping of the file during the writing.
+   * The file is truncated to the number of bytes written when it is closed.
+   * @return Returns false if the map cannot be resized.
+   */
+  bool mmfilebuf::reserve(std::streamsize n)
+  {
+    if (!this->is_open() || !this->m_Writing)
+      return false;
+    if (n < this->m_BufferSize)
+      return true;
+    return (this->resizemap(n + 1) != 0);
+  };
+  
   /**
    * @fn std::streampos mmfilebuf::pubseekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out)
    * Sets internal position pointer to relative position.
@@ -289,9 +307,9 @@ namespace btk
       this->m_Position += off;
       break;
     case std::ios_base::end:
-      if (this->m_BufferSize + off < 0)
+      if (this->m_LogicalSize + off < 0)
         return -1;
-      this->m_Position = this->m_BufferSize + off;
+      this->m_Position = this->m_LogicalSize + off;
       break;
     default:
       return -1;
@@ -320,8 +338,8 @@ namespace btk
   std::streamsize mmfilebuf::sgetn(char* s, std::streamsize n)
   {
     std::streamoff n_ = (((this->m_Position + n)  == 0) || ((this->m_Position + n) > this->m_BufferSize)) ? ((this->m_BufferSize - this->m_Position - 1) > 0 ? this->m_BufferSize - this->m_Position - 1 : 0) : n;
-    for (std::streamoff i = 0 ; i < n_ ; ++i)
-      s[i] = this->mp_Buffer[this->m_Position + i];
+    if (n_ > 0)
+      memcpy(s, this->mp_Buffer + this->m_Position, static_cast<size_t>(n_));
     this->m_Position += n_;
     return n_;
   };
@@ -332,14 +350,13 @@ namespace btk
    */
   std::streamsize mmfilebuf::sputn(const char* s, std::streamsize n)
   {
-    while ((this->m_Position + n) >= this->m_BufferSize) 
-    {
-      if (!this->resizemap())
-        return 0;
-    }
+    // The map grows geometrically to limit the number of remapping when the final size is unknown.
+    if (((this->m_Position + n) >= this->m_BufferSize)
+        && !this->resizemap(std::max<std::streamsize>(this->m_Position + n + 1, 2 * this->m_BufferSize)))
+      return 0;
     
-    for (std::streamoff i = 0 ; i < n ; ++i)
-      this->mp_Buffer[this->m_Position + i] = s[i];
+    if (n > 0)
+      memcpy(this->mp_Buffer + this->m_Position, s, static_cast<size_t>(n));
     this->m_Position += n;
     
     if (this->m_Position >= this->m_LogicalSize)
@@ -375,14 +392,15 @@ namespace btk
   };
   
   /**
-   * Try to resize the map to be able to extract more data from the file.
+   * Try to resize the map to contain at least @a n bytes (rounded to a multiple of the granularity).
    * @return Returns 0 if an error occured.
    */
-  mmfilebuf* mmfilebuf::resizemap()
+  mmfilebuf* mmfilebuf::resizemap(std::streamsize n)
   {
     if (!this->is_open() || !this->m_Writing)
       return 0;
-    std::streamsize newBufferSize = this->m_BufferSize + this->granularity();
+    const std::streamsize g = this->granularity();
+    std::streamsize newBufferSize = ((n + g - 1) / g) * g;
 #if defined(_MSC_VER)
     if ((::UnmapViewOfFile(this->mp_Buffer) == 0) || (::CloseHandle(this->m_Map) == 0))
       return 0;
@@ -513,13 +531,19 @@ namespace btk
    */
   mmfstream& mmfstream::read(char* s, std::streamsize n)
   {
-    if (this->m_Filebuf.sgetn(s,n) != n)
+    this->m_Gcount = this->m_Filebuf.sgetn(s,n);
+    if (this->m_Gcount != n)
       this->setstate(std::ios_base::eofbit | std::ios_base::failbit);
     else if (this->m_Filebuf.is_eob())
       this->setstate(std::ios_base::eofbit);
     return *this;
   };
   
+  /**
+   * @fn std::streamsize mmfstream::gcount() const
+   * Returns the number of characters extracted by the last read operation.
+   */
+  
   /**
    * @fn std::streampos mmfstream::tellg()
    * Gets position of the get pointer.
@@ -68,6 +68,7 @@ namespace btk
     
     std::streamsize size() const {return this->m_BufferSize;};
     const char* data() const {return this->mp_Buffer;};
+    BTK_IO_EXPORT bool reserve(std::streamsize n);
     
     std::streampos pubseekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) {return this->seekoff(off, way, which);};
     std::streampos pubseekpos(std::streampos pos, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) {return this->seekpos(pos, which);};
@@ -79,7 +80,7 @@ namespace btk
     BTK_IO_EXPORT std::streampos seekpos(std::streampos pos, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out );
     
     BTK_IO_EXPORT mmfilebuf* mapfile();
-    BTK_IO_EXPORT mmfilebuf* resizemap();
+    BTK_IO_EXPORT mmfilebuf* resizemap(std::streamsize n);
     
     BTK_IO_EXPORT static int granularity();
     
@@ -125,12 +126,14 @@ namespace btk
     
     // Read
     mmfstream& read(char* s, std::streamsize n);
+    std::streamsize gcount() const {return this->m_Gcount;};
     std::streampos tellg() {return !this->fail() ? this->m_Filebuf.pubseekoff(0,std::ios_base::cur,std::ios_base::in) : std::streampos(std::streamoff(-1));};
     inline mmfstream& seekg(std::streampos pos);
     inline mmfstream& seekg(std::streamoff off, std::ios_base::seekdir dir);
     
     // Write
     mmfstream& write(const char* s, std::streamsize n);
+    bool reserve(std::streamsize n) {return !this->fail() && this->m_Filebuf.reserve(n);};
     inline mmfstream& seekp(std::streampos pos);
     inline mmfstream& seekp(std::streamoff off, std::ios_base::seekdir dir);
     
@@ -141,6 +144,7 @@ namespace btk
     mmfilebuf m_Filebuf;
     std::ios_base::iostate m_FilebufState;
     std::ios_base::iostate m_Exception;
+    std::streamsize m_Gcount;
   };
     
   // ------------------------------------------------------------ //
@@ -169,6 +173,7 @@ namespace btk
   {
     this->m_FilebufState = std::ios_base::goodbit;
     this->m_Exception = std::ios_base::goodbit;
+    this->m_Gcount = 0;
   };
   
   mmfstream::mmfstream(const char* s, std::ios_base::openmode mode)
@@ -176,6 +181,7 @@ namespace btk
   {
     this->m_FilebufState = std::ios_base::goodbit;
     this->m_Exception = std::ios_base::goodbit;
+    this->m_Gcount = 0;
     this->open(s, mode);
   };
   
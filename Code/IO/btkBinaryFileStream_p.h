@@ -0,0 +1,247 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkBinaryFileStream_p_h
+#define __btkBinaryFileStream_p_h
+
+#include "btkBinaryFileStream.h"
+
+#include <cstring> // memcpy
+
+// Block decoders are vectorized with SSE2 when available (x86_64 has it by default).
+#if (PROCESSOR_TYPE == 1) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+  #define BTK_BINARYFILESTREAM_USE_SSE2
+  #include <emmintrin.h>
+#endif
+
+// NOTE: The following kernels convert in place blocks of values read on an IEEE little endian processor.
+//       They use memcpy to access the elements and avoid any aliasing issue between the integer and floating types.
+
+namespace btk
+{
+  typedef void (*BlockDecoder_p)(char* data, size_t nb);
+  
+  // Swap the bytes of each 16-bit element: 0 1 => 1 0
+  inline void SwapBytes16_p(char* data, size_t nb)
+  {
+    size_t i = 0;
+#if defined(BTK_BINARYFILESTREAM_USE_SSE2)
+    for ( ; i + 8 <= nb ; i += 8)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i));
+      v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 2 * i), v);
+    }
+#endif
+    for ( ; i < nb ; ++i)
+    {
+      uint16_t v; memcpy(&v, data + 2 * i, 2);
+      v = static_cast<uint16_t>((v << 8) | (v >> 8));
+      memcpy(data + 2 * i, &v, 2);
+    }
+  };
+  
+  // Reverse the bytes of each 32-bit element: 0 1 2 3 => 3 2 1 0
+  inline void SwapBytes32_p(char* data, size_t nb)
+  {
+    size_t i = 0;
+#if defined(BTK_BINARYFILESTREAM_USE_SSE2)
+    for ( ; i + 4 <= nb ; i += 4)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+      v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2,3,0,1)), _MM_SHUFFLE(2,3,0,1));
+      v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4 * i), v);
+    }
+#endif
+    for ( ; i < nb ; ++i)
+    {
+      uint32_t v; memcpy(&v, data + 4 * i, 4);
+      v = (v >> 24) | ((v >> 8) & 0x0000FF00u) | ((v << 8) & 0x00FF0000u) | (v << 24);
+      memcpy(data + 4 * i, &v, 4);
+    }
+  };
+  
+  // Reverse the bytes of each 64-bit element: 0 1 2 3 4 5 6 7 => 7 6 5 4 3 2 1 0
+  inline void SwapBytes64_p(char* data, size_t nb)
+  {
+    size_t i = 0;
+#if defined(BTK_BINARYFILESTREAM_USE_SSE2)
+    for ( ; i + 2 <= nb ; i += 2)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8 * i));
+      v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0,1,2,3)), _MM_SHUFFLE(0,1,2,3));
+      v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 8 * i), v);
+    }
+#endif
+    for ( ; i < nb ; ++i)
+    {
+      char* p = data + 8 * i;
+      char foo[8] = {p[7], p[6], p[5], p[4], p[3], p[2], p[1], p[0]};
+      memcpy(p, foo, 8);
+    }
+  };
+  
+  // Swap the 16-bit words of each 32-bit element: 0 1 2 3 => 2 3 0 1 (VAX integer)
+  inline void SwapWords32_p(char* data, size_t nb)
+  {
+    size_t i = 0;
+#if defined(BTK_BINARYFILESTREAM_USE_SSE2)
+    for ( ; i + 4 <= nb ; i += 4)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+      v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4 * i), v);
+    }
+#endif
+    for ( ; i < nb ; ++i)
+    {
+      uint32_t v; memcpy(&v, data + 4 * i, 4);
+      v = (v << 16) | (v >> 16);
+      memcpy(data + 4 * i, &v, 4);
+    }
+  };
+  
+  // Reverse the 16-bit words of each 64-bit element: 0 1 2 3 4 5 6 7 => 6 7 4 5 2 3 0 1 (VAX integer)
+  inline void SwapWords64_p(char* data, size_t nb)
+  {
+    size_t i = 0;
+#if defined(BTK_BINARYFILESTREAM_USE_SSE2)
+    for ( ; i + 2 <= nb ; i += 2)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8 * i));
+      v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0,1,2,3)), _MM_SHUFFLE(0,1,2,3));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 8 * i), v);
+    }
+#endif
+    for ( ; i < nb ; ++i)
+    {
+      char* p = data + 8 * i;
+      char foo[8] = {p[6], p[7], p[4], p[5], p[2], p[3], p[0], p[1]};
+      memcpy(p, foo, 8);
+    }
+  };
+  
+  // DEC/VAX float (F_floating) to IEEE float: swap the 16-bit words and decrement the exponent's high byte when not null.
+  // This is the block version of the method VAXLittleEndianBinaryFileStream::ReadFloat().
+  inline void VAXToIEEEFloat_p(char* data, size_t nb)
+  {
+    size_t i = 0;
+#if defined(BTK_BINARYFILESTREAM_USE_SSE2)
+    const __m128i highByte = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m128i one = _mm_set1_epi32(0x01000000);
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 4 <= nb ; i += 4)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+      v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+      __m128i isNull = _mm_cmpeq_epi32(_mm_and_si128(v, highByte), zero);
+      v = _mm_sub_epi32(v, _mm_andnot_si128(isNull, one));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4 * i), v);
+    }
+#endif
+    for ( ; i < nb ; ++i)
+    {
+      uint32_t v; memcpy(&v, data + 4 * i, 4);
+      v = (v << 16) | (v >> 16);
+      if ((v & 0xFF000000u) != 0)
+        v -= 0x01000000u;
+      memcpy(data + 4 * i, &v, 4);
+    }
+  };
+  
+  // IEEE float to DEC/VAX float (F_floating): increment the exponent's high byte when not null and swap the 16-bit words.
+  // This is the block version of the method VAXLittleEndianBinaryFileStream::Write(float).
+  inline void IEEEToVAXFloat_p(char* data, size_t nb)
+  {
+    size_t i = 0;
+#if defined(BTK_BINARYFILESTREAM_USE_SSE2)
+    const __m128i highByte = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m128i one = _mm_set1_epi32(0x01000000);
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 4 <= nb ; i += 4)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+      __m128i isNull = _mm_cmpeq_epi32(_mm_and_si128(v, highByte), zero);
+      v = _mm_add_epi32(v, _mm_andnot_si128(isNull, one));
+      v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4 * i), v);
+    }
+#endif
+    for ( ; i < nb ; ++i)
+    {
+      uint32_t v; memcpy(&v, data + 4 * i, 4);
+      if ((v & 0xFF000000u) != 0)
+        v += 0x01000000u;
+      v = (v << 16) | (v >> 16);
+      memcpy(data + 4 * i, &v, 4);
+    }
+  };
+  
+  // DEC/VAX double to IEEE double: block version of the method VAXLittleEndianBinaryFileStream::ReadDouble().
+  inline void VAXToIEEEDouble_p(char* data, size_t nb)
+  {
+    SwapWords64_p(data, nb);
+    for (size_t i = 0 ; i < nb ; ++i)
+    {
+      char* p = data + 8 * i + 7;
+      if (*p != 0)
+        *p -= 1;
+    }
+  };
+  
+  // Read a block of values and decode them in place. 
+  // In case of failure, only the values completely extracted before the end of the stream are decoded before to rethrow the exception.
+  template <typename T>
+  inline void ReadBlock_p(RawFileStream* stream, size_t nb, T* values, BlockDecoder_p decode = 0)
+  {
+    if (nb == 0)
+      return;
+    char* data = reinterpret_cast<char*>(values);
+    try
+    {
+      stream->read(data, static_cast<std::streamsize>(nb * sizeof(T)));
+    }
+    catch (BinaryFileStreamFailure& )
+    {
+      if (decode) decode(data, static_cast<size_t>(stream->gcount()) / sizeof(T));
+      throw;
+    }
+    if (decode) decode(data, nb);
+  };
+};
+
+#endif // __btkBinaryFileStream_p_h
@@ -34,6 +34,8 @@
  */
 
 #include "btkC3DFileIO.h"
+#include "btkC3DFileIOUtils_p.h"
+#include "btkThread_p.h"
 #include "btkMetaDataUtils.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
@@ -81,6 +83,9 @@ namespace btk
    *
    * To write a C3D file with a given processor architecture (called byte order in BTK), you have to use the method C3DFileIO::SetByteOrder().
    *
+   * The data section of large files can be decoded with several threads. Use the method C3DFileIO::SetNumberOfThreads() to set it.
+   * The extracted data are exactly the same than with only one thread.
+   *
    * For more informations on this file's format: http:://www.c3d.org
    *
    * @ingroup BTKIO
@@ -179,6 +184,19 @@ namespace btk
    * @fn void C3DFileIO::SetAnalogUniversalScale(double s)
    * Sets Returns the universal scale factor used to scale analog channels.
    */
+  
+  /**
+   * @fn int C3DFileIO::GetNumberOfThreads() const
+   * Returns the number of threads used to decode the data section (1 by default).
+   */
+  
+  /**
+   * @fn void C3DFileIO::SetNumberOfThreads(int num)
+   * Sets the number of threads used to decode the data section. A value lower than 1 means to use one thread by processor.
+   *
+   * Each thread decodes a contiguous range of frames. The number of threads is reduced for small files.
+   * This option is only used when the file can be mapped in memory (see the class mmfstream). 
+   */
 
   /**
    * Checks if the first byte of the file corresponds to C3D header.
@@ -193,6 +211,16 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the first bytes of the buffer correspond to C3D header.
+   */
+  AcquisitionFileIO::ProbeResult C3DFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    if ((size < 2) || (static_cast<int8_t>(buffer[0]) <= 0) || (buffer[1] != 80))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Checks if the suffix of @a filename is C3D.
    */
@@ -766,47 +794,123 @@ namespace btk
           fdf = new FloatFormat(ibfs);
         }
         int frameNumber = lastFrame - output->GetFirstFrame() + 1;
-        output->Init(pointNumber, frameNumber, analogNumber, numberSamplesPerAnalogChannel);
-        output->SetPointFrequency(pointFrameRate);
-        try
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+        C3DMappedDataSection_p::Pointer lazySource;
+        if (this->m_LazyLoading && CanDecodeC3DDataSection_p(this->GetByteOrder()))
         {
-          for (int frame = 0 ; frame < frameNumber ; ++frame)
+          // Lazy extraction: the file is mapped a second time and kept opened by the loaders. Each channel is decoded when its values are accessed.
+          lazySource = C3DMappedDataSection_p::Pointer(new C3DMappedDataSection_p());
+          lazySource->stream.open(filename.c_str(), std::ios_base::binary | std::ios_base::in);
+          if (!lazySource->stream.is_open())
+            throw(C3DFileIOException("Impossible to map the file to extract lazily its data"));
+          const mmfilebuf* buffer = lazySource->stream.rdbuf();
+          const size_t dataOffset = 512 * (dataFirstBlock - 1);
+          const size_t fileSize = static_cast<size_t>(buffer->size());
+          lazySource->analogZeroOffset = this->m_AnalogZeroOffset;
+          lazySource->analogChannelScale = this->m_AnalogChannelScale;
+          C3DDataSection_p& section = lazySource->section;
+          section.byteOrder = this->GetByteOrder();
+          section.storageFormat = this->m_StorageFormat;
+          section.unsignedAnalog = (this->m_StorageFormat == Integer) && (this->m_AnalogIntegerFormat == Unsigned);
+          section.pointScale = this->m_PointScale;
+          section.analogZeroOffset = lazySource->analogZeroOffset.empty() ? 0 : &(lazySource->analogZeroOffset[0]);
+          section.analogChannelScale = lazySource->analogChannelScale.empty() ? 0 : &(lazySource->analogChannelScale[0]);
+          section.analogUniversalScale = this->m_AnalogUniversalScale;
+          InitC3DDataSection_p(&section, pointNumber, analogNumber, numberSamplesPerAnalogChannel, frameNumber, buffer->data() + std::min(dataOffset, fileSize), (fileSize > dataOffset) ? fileSize - dataOffset : 0);
+          // Same labels than with the method Acquisition::Init() but without the allocation of the data.
+          output->Init(0, frameNumber, 0, numberSamplesPerAnalogChannel, Acquisition::SeparatePointStorage);
+          for (int inc = 0 ; inc < pointNumber ; ++inc)
           {
-            Acquisition::PointIterator itM = output->BeginPoint(); 
-            while (itM != output->EndPoint())
-            {
-              Point* point = itM->get();
-              fdf->ReadPoint(&(point->GetValues().data()[frame]),
-                             &(point->GetValues().data()[frame + frameNumber]),
-                             &(point->GetValues().data()[frame + 2*frameNumber]),
-                             &(point->GetResiduals().data()[frame]),
-                             this->m_PointScale);
-              ++itM;
-            }
-            unsigned inc = 0, incChannel = 0, analogFrame = numberSamplesPerAnalogChannel * frame;
-            Acquisition::AnalogIterator itA = output->BeginAnalog();
-            while (itA != output->EndAnalog())
+            Point::Data::Pointer data = Point::Data::New(0);
+            data->SetLoader(Point::Data::Loader::Pointer(new C3DPointLoader_p(lazySource, inc)));
+            Point::Pointer point = Point::New("uname*" + ToString(inc + 1));
+            point->SetData(data);
+            point->SetParent(output.get());
+            output->AppendPoint(point);
+          }
+          for (int inc = 0 ; inc < analogNumber ; ++inc)
+          {
+            Analog::Data::Pointer data = Analog::Data::New(0);
+            data->SetLoader(Analog::Data::Loader::Pointer(new C3DAnalogLoader_p(lazySource, inc)));
+            Analog::Pointer analog = Analog::New("uname*" + ToString(inc + 1));
+            analog->SetData(data);
+            analog->SetParent(output.get());
+            output->AppendAnalog(analog);
+          }
+          output->SetPointFrequency(pointFrameRate);
+          const size_t frameWords = 4 * pointNumber + analogNumber * numberSamplesPerAnalogChannel;
+          if (section.wordsAvailable < frameWords * frameNumber)
+          {
+            btkWarningMacro(filename, "Some points and/or analog data cannot be extracted and are set as invalid.");
+          }
+        }
+        else if (CanDecodeC3DDataSection_p(this->GetByteOrder()))
+        {
+          output->Init(pointNumber, frameNumber, analogNumber, numberSamplesPerAnalogChannel, this->m_PointStorage);
+          output->SetPointFrequency(pointFrameRate);
+          // Zero-copy extraction: the data section is decoded by blocks of frames directly from the mapped file (possibly by several threads).
+          const mmfilebuf* buffer = ibfs->GetStream()->rdbuf();
+          const size_t dataOffset = 512 * (dataFirstBlock - 1);
+          const size_t fileSize = static_cast<size_t>(buffer->size());
+          C3DDataSection_p section;
+          section.byteOrder = this->GetByteOrder();
+          section.storageFormat = this->m_StorageFormat;
+          section.unsignedAnalog = (this->m_StorageFormat == Integer) && (this->m_AnalogIntegerFormat == Unsigned);
+          section.pointScale = this->m_PointScale;
+          section.analogZeroOffset = this->m_AnalogZeroOffset.empty() ? 0 : &(this->m_AnalogZeroOffset[0]);
+          section.analogChannelScale = this->m_AnalogChannelScale.empty() ? 0 : &(this->m_AnalogChannelScale[0]);
+          section.analogUniversalScale = this->m_AnalogUniversalScale;
+          InitC3DDataSection_p(&section, output, buffer->data() + std::min(dataOffset, fileSize), (fileSize > dataOffset) ? fileSize - dataOffset : 0);
+          if (!DecodeC3DDataSection_p(&section, (this->m_NumberOfThreads < 1) ? thread_p::GetNumberOfProcessors() : this->m_NumberOfThreads))
+          {
+            btkWarningMacro(filename, "Some points and/or analog data cannot be extracted and are set as invalid.");
+          }
+        }
+        else
+#endif
+        {
+          output->Init(pointNumber, frameNumber, analogNumber, numberSamplesPerAnalogChannel, this->m_PointStorage);
+          output->SetPointFrequency(pointFrameRate);
+          try
+          {
+            for (int frame = 0 ; frame < frameNumber ; ++frame)
             {
-              (*itA)->GetValues().data()[analogFrame] = (fdf->ReadAnalog() - this->m_AnalogZeroOffset[incChannel]) * this->m_AnalogChannelScale[incChannel] * this->m_AnalogUniversalScale;
-              ++itA; ++incChannel;
-              if ((itA == output->EndAnalog()) && (inc < static_cast<unsigned>(numberSamplesPerAnalogChannel - 1)))
+              Acquisition::PointIterator itM = output->BeginPoint(); 
+              while (itM != output->EndPoint())
               {
-                itA = output->BeginAnalog();
-                incChannel = 0;
-                ++inc; ++analogFrame;
+                Point* point = itM->get();
+                fdf->ReadPoint(&(point->GetValues().data()[frame]),
+                               &(point->GetValues().data()[frame + frameNumber]),
+                               &(point->GetValues().data()[frame + 2*frameNumber]),
+                               &(point->GetResiduals().data()[frame]),
+                               this->m_PointScale);
+                ++itM;
+              }
+              unsigned inc = 0, incChannel = 0, analogFrame = numberSamplesPerAnalogChannel * frame;
+              Acquisition::AnalogIterator itA = output->BeginAnalog();
+              while (itA != output->EndAnalog())
+              {
+                (*itA)->GetValues().data()[analogFrame] = (fdf->ReadAnalog() - this->m_AnalogZeroOffset[incChannel]) * this->m_AnalogChannelScale[incChannel] * this->m_AnalogUniversalScale;
+                ++itA; ++incChannel;
+                if ((itA == output->EndAnalog()) && (inc < static_cast<unsigned>(numberSamplesPerAnalogChannel - 1)))
+                {
+                  itA = output->BeginAnalog();
+                  incChannel = 0;
+                  ++inc; ++analogFrame;
+                }
               }
             }
           }
-        }
-        catch (BinaryFileStreamFailure& )
-        {
-          // Let's try to continue even if the file is corrupted
-          if (ibfs->EndFile())
-          {  
-            btkWarningMacro(filename, "Some points and/or analog data cannot be extracted and are set as invalid.");
+          catch (BinaryFileStreamFailure& )
+          {
+            // Let's try to continue even if the file is corrupted
+            if (ibfs->EndFile())
+            {  
+              btkWarningMacro(filename, "Some points and/or analog data cannot be extracted and are set as invalid.");
+            }
+            else
+              throw;
           }
-          else
-            throw;
         }
     // Label, description, unit and type
         size_t inc = 0; 
@@ -852,21 +956,22 @@ namespace btk
             inc = 0; for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
               (*it)->SetLabel(collapsed[inc++]);
             // Set correctly coordinates and residuals for occluded markers
-            for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+            if (lazySource)
+              lazySource->occlusionFromCoordinates = true;
+            else
+#endif
+            if (output->GetPointStorage() == Acquisition::ContiguousPointStorage)
             {
-              Point::Values& coords = (*it)->GetValues();
-              Eigen::Matrix<double, Eigen::Dynamic, 1> diff = (coords.rowwise().sum() / 3.0).array() - 9999999.0;
-              Point::Residuals& res = (*it)->GetResiduals();
-              for (int k = 0 ; k < (*it)->GetFrameNumber() ; ++k)
-              {
-                if (fabs(diff.coeff(k)) < std::numeric_limits<float>::epsilon())
-                {
-                  coords.coeffRef(k,0) = 0.0;
-                  coords.coeffRef(k,1) = 0.0;
-                  coords.coeffRef(k,2) = 0.0;
-                  res.coeffRef(k) = -1.0;
-                }
-              }
+              Acquisition::PointValuesBlock& values = output->GetPointValuesBlock();
+              Acquisition::PointResidualsBlock& residuals = output->GetPointResidualsBlock();
+              for (int i = 0 ; i < output->GetPointNumber() ; ++i)
+                C3DOcclusionFromCoordinates_p(values.data() + 3 * i * values.rows(), residuals.data() + i * residuals.rows(), static_cast<int>(values.rows()));
+            }
+            else
+            {
+              for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
+                C3DOcclusionFromCoordinates_p((*it)->GetValues(), (*it)->GetResiduals());
             }
           }
           // Point's type
@@ -1216,7 +1321,7 @@ namespace btk
       // POINT:DATA_START final
       if (!templateFile)
       {
-        size_t totalWrittenBytes = writtenBytes + (1 + 1 + dataStart->GetLabel().length() + 2 + 1 + 1 + dataStart->GetInfo()->GetDimensions().size() + (dataStart->GetInfo()->GetValues().size() * abs(dataStart->GetInfo()->GetFormat())) + 1 + dataStart->GetDescription().length());
+        size_t totalWrittenBytes = writtenBytes + (1 + 1 + dataStart->GetLabel().length() + 2 + 1 + 1 + dataStart->GetInfo()->GetDimensions().size() + (dataStart->GetInfo()->GetValueNumber() * abs(dataStart->GetInfo()->GetFormat())) + 1 + dataStart->GetDescription().length());
         totalWrittenBytes += (512 - (totalWrittenBytes % 512));
         uint8_t pNB = static_cast<uint8_t>(totalWrittenBytes / 512);
         dS = 2 + pNB;
@@ -1245,47 +1350,67 @@ namespace btk
       // -= DATA =-
       if (!templateFile)
       {
+        // The size of the file is known: it is resized once instead of growing during the writing of the data.
+        const size_t frameSize = (4 * input->GetPointNumber() + input->GetAnalogNumber() * numberSamplesPerAnalogChannel) * ((this->m_StorageFormat == Integer) ? 2 : 4);
+        obfs->Reserve(512 * (dS - 1) + frameSize * frameNumber);
         obfs->SeekWrite(512 * (dS - 1), BinaryFileStream::Begin);
-        if (this->m_StorageFormat == Integer) // integer
+        if (CanEncodeC3DDataSection_p(this->GetByteOrder()))
         {
-          if (this->m_AnalogIntegerFormat == Unsigned)
-            fdf = new IntegerFormatUnsignedAnalog(obfs);
-          else
-            fdf = new IntegerFormatSignedAnalog(obfs);
+          // Frames are encoded by blocks and each block is written at once.
+          C3DDataSection_p section;
+          section.byteOrder = this->GetByteOrder();
+          section.storageFormat = this->m_StorageFormat;
+          section.unsignedAnalog = (this->m_StorageFormat == Integer) && (this->m_AnalogIntegerFormat == Unsigned);
+          section.pointScale = this->m_PointScale;
+          section.analogZeroOffset = this->m_AnalogZeroOffset.empty() ? 0 : &(this->m_AnalogZeroOffset[0]);
+          section.analogChannelScale = this->m_AnalogChannelScale.empty() ? 0 : &(this->m_AnalogChannelScale[0]);
+          section.analogUniversalScale = this->m_AnalogUniversalScale;
+          InitC3DDataSection_p(&section, input);
+          EncodeC3DDataSection_p(&section, obfs);
         }
-        else // float
-        {
-          fdf = new FloatFormat(obfs);
-        }
-        for (int frame = 0 ; frame < frameNumber ; ++frame)
+        else
         {
-          Acquisition::PointConstIterator itM = input->BeginPoint();
-          while (itM != input->EndPoint())
+          if (this->m_StorageFormat == Integer) // integer
           {
-            Point* point = itM->get();
-            fdf->WritePoint(point->GetValues().data()[frame],
-                            point->GetValues().data()[frame + frameNumber],
-                            point->GetValues().data()[frame + 2*frameNumber],
-                            point->GetResiduals().data()[frame],
-                            this->m_PointScale);
-            ++itM;
+            if (this->m_AnalogIntegerFormat == Unsigned)
+              fdf = new IntegerFormatUnsignedAnalog(obfs);
+            else
+              fdf = new IntegerFormatSignedAnalog(obfs);
           }
-          
-          size_t inc = 0, incChannel = 0, analogFrame = numberSamplesPerAnalogChannel * frame;
-          Acquisition::AnalogConstIterator itA = input->BeginAnalog();
-          while (itA != input->EndAnalog())
+          else // float
+          {
+            fdf = new FloatFormat(obfs);
+          }
+          for (int frame = 0 ; frame < frameNumber ; ++frame)
           {
-            fdf->WriteAnalog(
-                (*itA)->GetValues().data()[analogFrame]
-                / this->m_AnalogChannelScale[incChannel]
-                / this->m_AnalogUniversalScale
-                + this->m_AnalogZeroOffset[incChannel]);
-            ++itA; ++incChannel;
-            if ((itA == input->EndAnalog()) && (inc < static_cast<size_t>(numberSamplesPerAnalogChannel - 1)))
+            Acquisition::PointConstIterator itM = input->BeginPoint();
+            while (itM != input->EndPoint())
             {
-              itA = input->BeginAnalog();
-              incChannel = 0;
-              ++inc; ++analogFrame;
+              const Point* point = itM->get();
+              fdf->WritePoint(point->GetValues().data()[frame],
+                              point->GetValues().data()[frame + frameNumber],
+                              point->GetValues().data()[frame + 2*frameNumber],
+                              point->GetResiduals().data()[frame],
+                              this->m_PointScale);
+              ++itM;
+            }
+          
+            size_t inc = 0, incChannel = 0, analogFrame = numberSamplesPerAnalogChannel * frame;
+            Acquisition::AnalogConstIterator itA = input->BeginAnalog();
+            while (itA != input->EndAnalog())
+            {
+              fdf->WriteAnalog(
+                  static_cast<const Analog*>(itA->get())->GetValues().data()[analogFrame]
+                  / this->m_AnalogChannelScale[incChannel]
+                  / this->m_AnalogUniversalScale
+                  + this->m_AnalogZeroOffset[incChannel]);
+              ++itA; ++incChannel;
+              if ((itA == input->EndAnalog()) && (inc < static_cast<size_t>(numberSamplesPerAnalogChannel - 1)))
+              {
+                itA = input->BeginAnalog();
+                incChannel = 0;
+                ++inc; ++analogFrame;
+              }
             }
           }
         }
@@ -1329,6 +1454,7 @@ namespace btk
   {
     this->m_PointScale = 0.1;
     this->m_AnalogUniversalScale = 1.0;
+    this->m_NumberOfThreads = 1;
     this->m_AnalogIntegerFormat = Signed;
   };
 
@@ -1475,7 +1601,7 @@ namespace btk
     // POINT:SCALE
     double max = 0.0;
     for (Acquisition::PointConstIterator itPoint = input->BeginPoint() ; itPoint != input->EndPoint() ; ++itPoint)
-      max = std::max(max, (*itPoint)->GetValues().array().abs().maxCoeff());
+      max = std::max(max, static_cast<const Point*>(itPoint->get())->GetValues().array().abs().maxCoeff());
     const int currentMax = static_cast<int>(this->m_PointScale * 32000);
     // Guess to compute a new point scaling factor.
     if (((max > currentMax) || (max <= (currentMax / 2))) && (max > std::numeric_limits<double>::epsilon()))
@@ -1565,7 +1691,7 @@ namespace btk
         MetaData::ConstIterator itAnalogOffset = (*itAnalog)->FindChild("OFFSET");
         if (itAnalogOffset != (*itAnalog)->End())
         {
-          if ((*itAnalogOffset)->GetInfo()->GetValues().size() < analogNumber)
+          if (static_cast<size_t>((*itAnalogOffset)->GetInfo()->GetValueNumber()) < analogNumber)
           {
             btkWarningMacro("No enough analog offsets. Missing offset will be set to 0.");
           }
@@ -1603,7 +1729,7 @@ namespace btk
         MetaData::ConstIterator itAnalogScale = (*itAnalog)->FindChild("SCALE");
         if (itAnalogScale != (*itAnalog)->End())
         {
-          if ((*itAnalogScale)->GetInfo()->GetValues().size() < analogNumber)
+          if (static_cast<size_t>((*itAnalogScale)->GetInfo()->GetValueNumber()) < analogNumber)
           {
             btkWarningMacro("No enough analog scaling factors. Impossible to update analog offsets.");
           }
@@ -79,8 +79,11 @@ namespace btk
     void SetAnalogZeroOffset(const std::vector<double>& s) {this->m_AnalogZeroOffset = s;};
     double GetAnalogUniversalScale() const {return this->m_AnalogUniversalScale;};
     void SetAnalogUniversalScale(double s) {this->m_AnalogUniversalScale = s;};
+    int GetNumberOfThreads() const {return this->m_NumberOfThreads;};
+    void SetNumberOfThreads(int num) {this->m_NumberOfThreads = num;};
     
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
+    BTK_IO_EXPORT virtual ProbeResult CanReadBuffer(const char* buffer, size_t size, const std::string& extension, size_t fileSize);
     BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
@@ -218,6 +221,7 @@ namespace btk
     std::vector<double> m_AnalogZeroOffset;
     double m_AnalogUniversalScale;
     AnalogIntegerFormat m_AnalogIntegerFormat;
+    int m_NumberOfThreads;
   };
 };
 
@@ -0,0 +1,668 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkC3DFileIOUtils_p.h"
+#include "btkBinaryFileStream_p.h"
+#include "btkMacro.h"
+#include "btkThread_p.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Number of bytes decoded at once. The block must stay in the cache between the decoding and the scaling passes.
+const size_t _btk_c3d_data_block_size = 262144;
+// Minimum number of bytes given to each thread. Below, the cost to create the thread is not amortized.
+const size_t _btk_c3d_data_thread_minimum_size = _btk_c3d_data_block_size;
+
+namespace btk
+{
+  // Conversion of the words stored in the data section (integer format)
+  inline double C3DCoordinate_p(int16_t word, double pointScaleFactor) {return word * pointScaleFactor;};
+  inline int16_t C3DResidualAndMask_p(int16_t word) {return word;};
+  inline double C3DResidual_p(int16_t residualAndMask, double pointScaleFactor, int16_t )
+  {
+    // The high byte is the mask, the low byte the residual.
+    return (residualAndMask >= 0) ? static_cast<double>(static_cast<int8_t>(residualAndMask & 0xFF)) * pointScaleFactor : -1.0;
+  };
+  inline double C3DAnalog_p(int16_t word, bool unsignedAnalog) {return unsignedAnalog ? static_cast<double>(static_cast<uint16_t>(word)) : static_cast<double>(word);};
+  
+  // Conversion of the words stored in the data section (float format)
+  inline double C3DCoordinate_p(float word, double ) {return word;};
+  inline int16_t C3DResidualAndMask_p(float word) {return static_cast<int16_t>(word);};
+  inline double C3DResidual_p(int16_t residualAndMask, double pointScaleFactor, float )
+  {
+    // FIX: It seems that for UNSGINED 16 bits in float format, the residual is negative (see C3DFileIO::FloatFormat).
+    return (residualAndMask >= 0) ? fabs(static_cast<double>(static_cast<int8_t>(residualAndMask & 0xFF)) * pointScaleFactor) : -1.0;
+  };
+  inline double C3DAnalog_p(float word, bool ) {return word;};
+  
+  inline bool C3DIsScaled_p(int16_t ) {return true;};
+  inline bool C3DIsScaled_p(float ) {return false;};
+  
+  // Returns the in place decoder to convert a block of words to the native format (0 if none is required).
+  inline BlockDecoder_p C3DWordDecoder_p(AcquisitionFileIO::ByteOrder byteOrder, int16_t )
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    return (byteOrder == AcquisitionFileIO::IEEE_BigEndian) ? &SwapBytes16_p : 0;
+#else
+    btkNotUsed(byteOrder);
+    return 0;
+#endif
+  };
+  inline BlockDecoder_p C3DWordDecoder_p(AcquisitionFileIO::ByteOrder byteOrder, float )
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    if (byteOrder == AcquisitionFileIO::IEEE_BigEndian)
+      return &SwapBytes32_p;
+    else if (byteOrder == AcquisitionFileIO::VAX_LittleEndian)
+      return &VAXToIEEEFloat_p;
+#else
+    btkNotUsed(byteOrder);
+#endif
+    return 0;
+  };
+  
+  // Decode @a num complete frames starting at the frame @a first.
+  // Words are scattered in the column-major matrices and then scaled channel by channel with vectorized passes.
+  template <typename T>
+  static void DecodeC3DFrames_p(const C3DDataSection_p* section, const T* words, int first, int num, std::vector<int16_t>& residualsAndMasks)
+  {
+    typedef Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 1> > Segment;
+    const size_t stride = 4 * section->pointNumber + section->analogNumber * section->numberSamplesPerAnalogChannel;
+    // Points
+    for (int p = 0 ; p < section->pointNumber ; ++p)
+    {
+      double* x = section->pointValues[p] + first;
+      double* y = x + section->frameNumber;
+      double* z = y + section->frameNumber;
+      const T* w = words + 4 * p;
+      for (int f = 0 ; f < num ; ++f, w += stride)
+      {
+        x[f] = static_cast<double>(w[0]);
+        y[f] = static_cast<double>(w[1]);
+        z[f] = static_cast<double>(w[2]);
+        residualsAndMasks[f] = C3DResidualAndMask_p(w[3]);
+      }
+      if (C3DIsScaled_p(T()))
+      {
+        Segment(x, num) *= section->pointScale;
+        Segment(y, num) *= section->pointScale;
+        Segment(z, num) *= section->pointScale;
+      }
+      double* r = section->pointResiduals[p] + first;
+      for (int f = 0 ; f < num ; ++f)
+        r[f] = C3DResidual_p(residualsAndMasks[f], section->pointScale, T());
+    }
+    // Analog channels
+    const int numSamples = section->numberSamplesPerAnalogChannel;
+    for (int c = 0 ; c < section->analogNumber ; ++c)
+    {
+      double* a = section->analogValues[c] + first * numSamples;
+      const T* w = words + 4 * section->pointNumber + c;
+      for (int f = 0 ; f < num ; ++f, w += stride)
+      {
+        for (int s = 0 ; s < numSamples ; ++s)
+          a[f * numSamples + s] = C3DAnalog_p(w[s * section->analogNumber], section->unsignedAnalog);
+      }
+      // Same operations (and order) than in the per-sample extraction: (value - offset) * scale * universal scale.
+      Segment segment(a, num * numSamples);
+      segment.array() -= section->analogZeroOffset[c];
+      segment *= section->analogChannelScale[c];
+      segment *= section->analogUniversalScale;
+    }
+  };
+  
+  // Decode the first @a count words of the frame @a frame. Only the values having all their words are set.
+  template <typename T>
+  static void DecodeC3DPartialFrame_p(const C3DDataSection_p* section, const T* words, int frame, size_t count)
+  {
+    size_t inc = 0;
+    for (int p = 0 ; p < section->pointNumber ; ++p)
+    {
+      double* values = section->pointValues[p];
+      for (int i = 0 ; i < 3 ; ++i)
+      {
+        if (inc >= count)
+          return;
+        values[frame + i * section->frameNumber] = C3DCoordinate_p(words[inc++], section->pointScale);
+      }
+      if (inc >= count)
+        return;
+      section->pointResiduals[p][frame] = C3DResidual_p(C3DResidualAndMask_p(words[inc++]), section->pointScale, T());
+    }
+    const int numSamples = section->numberSamplesPerAnalogChannel;
+    for (int s = 0 ; s < numSamples ; ++s)
+    {
+      for (int c = 0 ; c < section->analogNumber ; ++c)
+      {
+        if (inc >= count)
+          return;
+        section->analogValues[c][frame * numSamples + s] = (C3DAnalog_p(words[inc++], section->unsignedAnalog) - section->analogZeroOffset[c]) * section->analogChannelScale[c] * section->analogUniversalScale;
+      }
+    }
+  };
+  
+  template <typename T>
+  static bool DecodeC3DDataSectionBlocks_p(const C3DDataSection_p* section, int firstFrame, int lastFrame)
+  {
+    const size_t stride = 4 * section->pointNumber + section->analogNumber * section->numberSamplesPerAnalogChannel;
+    if ((stride == 0) || (lastFrame <= firstFrame))
+      return true;
+    const int blockFrames = static_cast<int>(std::max(static_cast<size_t>(1), _btk_c3d_data_block_size / (stride * sizeof(T))));
+    BlockDecoder_p decode = C3DWordDecoder_p(section->byteOrder, T());
+    std::vector<T> buffer(decode ? blockFrames * stride : 0);
+    std::vector<int16_t> residualsAndMasks(blockFrames);
+    int num = 0;
+    for (int frame = firstFrame ; frame < lastFrame ; frame += num)
+    {
+      num = std::min(blockFrames, lastFrame - frame);
+      const size_t offset = static_cast<size_t>(frame) * stride;
+      size_t count = num * stride;
+      const bool complete = (offset + count <= section->wordsAvailable);
+      if (!complete)
+        count = (section->wordsAvailable > offset) ? section->wordsAvailable - offset : 0;
+      // Words are used directly from the mapped file when no conversion is required.
+      const T* words = reinterpret_cast<const T*>(section->data) + offset;
+      if (decode && (count != 0))
+      {
+        memcpy(&(buffer[0]), words, count * sizeof(T));
+        decode(reinterpret_cast<char*>(&(buffer[0])), count);
+        words = &(buffer[0]);
+      }
+      const int full = static_cast<int>(count / stride);
+      if (full != 0)
+        DecodeC3DFrames_p(section, words, frame, full, residualsAndMasks);
+      if (!complete)
+      {
+        DecodeC3DPartialFrame_p(section, words + full * stride, frame + full, count % stride);
+        return false;
+      }
+    }
+    return true;
+  };
+  
+  // Conversion of the values to the words stored in the data section (integer format).
+  // Same rounding and casts than in the class C3DFileIO::IntegerFormatSignedAnalog (and unsigned).
+  inline int16_t C3DCoordinateWord_p(double value, int16_t )
+  {
+#if defined(_MSC_VER)
+    return static_cast<int16_t>(floor(value + 0.5));
+#else
+    return static_cast<int16_t>(static_cast<float>(value));
+#endif
+  };
+  inline int16_t C3DResidualAndMaskWord_p(int16_t residualAndMask, int16_t ) {return residualAndMask;};
+  inline int16_t C3DAnalogWord_p(double value, bool unsignedAnalog, int16_t ) {return unsignedAnalog ? static_cast<int16_t>(static_cast<uint16_t>(value)) : static_cast<int16_t>(value);};
+  
+  // Conversion of the values to the words stored in the data section (float format)
+  inline float C3DCoordinateWord_p(double value, float ) {return static_cast<float>(value);};
+  inline float C3DResidualAndMaskWord_p(int16_t residualAndMask, float ) {return static_cast<float>(residualAndMask);};
+  inline float C3DAnalogWord_p(double value, bool , float ) {return static_cast<float>(value);};
+  
+  // The high byte is the mask (0: visible, -1: occluded), the low byte the residual.
+  inline int16_t C3DResidualAndMask_p(double residual, double pointScaleFactor)
+  {
+    return (residual >= 0.0) ? static_cast<int16_t>(static_cast<uint8_t>(static_cast<int8_t>(residual / pointScaleFactor))) : static_cast<int16_t>(-1);
+  };
+  
+  // Returns the in place encoder to convert a block of native words to the given byte order (0 if none is required).
+  inline BlockDecoder_p C3DWordEncoder_p(AcquisitionFileIO::ByteOrder byteOrder, int16_t )
+  {
+    // Swapping the bytes is its own inverse.
+    return C3DWordDecoder_p(byteOrder, int16_t());
+  };
+  inline BlockDecoder_p C3DWordEncoder_p(AcquisitionFileIO::ByteOrder byteOrder, float )
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    if (byteOrder == AcquisitionFileIO::IEEE_BigEndian)
+      return &SwapBytes32_p;
+    else if (byteOrder == AcquisitionFileIO::VAX_LittleEndian)
+      return &IEEEToVAXFloat_p;
+#else
+    btkNotUsed(byteOrder);
+#endif
+    return 0;
+  };
+  
+  // Encode @a num frames starting at the frame @a first in the frame records @a words.
+  // This is the inverse of DecodeC3DFrames_p: each channel is scaled with a vectorized pass in @a scaled
+  // and then quantized while it is interleaved in the records.
+  template <typename T>
+  static void EncodeC3DFrames_p(const C3DDataSection_p* section, T* words, int first, int num, std::vector<double>& scaled)
+  {
+    typedef Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 1> > Segment;
+    typedef Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 1> > ConstSegment;
+    const size_t stride = 4 * section->pointNumber + section->analogNumber * section->numberSamplesPerAnalogChannel;
+    // Points
+    for (int p = 0 ; p < section->pointNumber ; ++p)
+    {
+      const double* x = section->pointValues[p] + first;
+      const double* y = x + section->frameNumber;
+      const double* z = y + section->frameNumber;
+      const double* r = section->pointResiduals[p] + first;
+      if (C3DIsScaled_p(T()))
+      {
+        Segment(&(scaled[0]), num) = ConstSegment(x, num) / section->pointScale;
+        Segment(&(scaled[num]), num) = ConstSegment(y, num) / section->pointScale;
+        Segment(&(scaled[2 * num]), num) = ConstSegment(z, num) / section->pointScale;
+        x = &(scaled[0]);
+        y = &(scaled[num]);
+        z = &(scaled[2 * num]);
+      }
+      T* w = words + 4 * p;
+      for (int f = 0 ; f < num ; ++f, w += stride)
+      {
+        w[0] = C3DCoordinateWord_p(x[f], T());
+        w[1] = C3DCoordinateWord_p(y[f], T());
+        w[2] = C3DCoordinateWord_p(z[f], T());
+        w[3] = C3DResidualAndMaskWord_p(C3DResidualAndMask_p(r[f], section->pointScale), T());
+      }
+    }
+    // Analog channels
+    const int numSamples = section->numberSamplesPerAnalogChannel;
+    for (int c = 0 ; c < section->analogNumber ; ++c)
+    {
+      // Same operations (and order) than in the per-sample writing: value / scale / universal scale + offset.
+      Segment segment(&(scaled[0]), num * numSamples);
+      segment = ConstSegment(section->analogValues[c] + first * numSamples, num * numSamples) / section->analogChannelScale[c];
+      segment /= section->analogUniversalScale;
+      segment.array() += section->analogZeroOffset[c];
+      T* w = words + 4 * section->pointNumber + c;
+      for (int f = 0 ; f < num ; ++f, w += stride)
+      {
+        for (int s = 0 ; s < numSamples ; ++s)
+          w[s * section->analogNumber] = C3DAnalogWord_p(scaled[f * numSamples + s], section->unsignedAnalog, T());
+      }
+    }
+  };
+  
+  template <typename T>
+  static void EncodeC3DDataSectionBlocks_p(const C3DDataSection_p* section, BinaryFileStream* obfs)
+  {
+    const size_t stride = 4 * section->pointNumber + section->analogNumber * section->numberSamplesPerAnalogChannel;
+    if ((stride == 0) || (section->frameNumber <= 0))
+      return;
+    const int blockFrames = static_cast<int>(std::max(static_cast<size_t>(1), _btk_c3d_data_block_size / (stride * sizeof(T))));
+    BlockDecoder_p encode = C3DWordEncoder_p(section->byteOrder, T());
+    std::vector<T> buffer(blockFrames * stride);
+    std::vector<double> scaled(blockFrames * std::max(3, section->numberSamplesPerAnalogChannel));
+    int num = 0;
+    for (int frame = 0 ; frame < section->frameNumber ; frame += num)
+    {
+      num = std::min(blockFrames, section->frameNumber - frame);
+      const size_t count = num * stride;
+      EncodeC3DFrames_p(section, &(buffer[0]), frame, num, scaled);
+      if (encode)
+        encode(reinterpret_cast<char*>(&(buffer[0])), count);
+      obfs->WriteChar(count * sizeof(T), reinterpret_cast<const char*>(&(buffer[0])));
+    }
+  };
+  
+  // Decode all the frames of one channel. Its words (@a wordsPerFrame words by frame, starting at @a firstWord and separated by @a step words)
+  // are gathered in a compact buffer which is decoded as the data section @a channel containing only this channel.
+  template <typename T>
+  static bool DecodeC3DChannel_p(const C3DDataSection_p* section, const C3DDataSection_p* channel, size_t firstWord, size_t step, int wordsPerFrame)
+  {
+    const size_t stride = 4 * section->pointNumber + section->analogNumber * section->numberSamplesPerAnalogChannel;
+    if ((section->frameNumber <= 0) || (wordsPerFrame <= 0))
+      return true;
+    std::vector<T> buffer(static_cast<size_t>(section->frameNumber) * wordsPerFrame);
+    const T* words = reinterpret_cast<const T*>(section->data);
+    size_t count = 0;
+    bool complete = true;
+    for (int f = 0 ; complete && (f < section->frameNumber) ; ++f)
+    {
+      const size_t offset = static_cast<size_t>(f) * stride + firstWord;
+      for (int k = 0 ; k < wordsPerFrame ; ++k)
+      {
+        const size_t idx = offset + k * step;
+        if (idx >= section->wordsAvailable)
+        {
+          complete = false;
+          break;
+        }
+        buffer[count++] = words[idx];
+      }
+    }
+    BlockDecoder_p decode = C3DWordDecoder_p(section->byteOrder, T());
+    if (decode && (count != 0))
+      decode(reinterpret_cast<char*>(&(buffer[0])), count);
+    const int full = static_cast<int>(count / wordsPerFrame);
+    if (full != 0)
+    {
+      std::vector<int16_t> residualsAndMasks(full);
+      DecodeC3DFrames_p(channel, &(buffer[0]), 0, full, residualsAndMasks);
+    }
+    if (!complete)
+      DecodeC3DPartialFrame_p(channel, &(buffer[0]) + full * wordsPerFrame, full, count % wordsPerFrame);
+    return complete;
+  };
+  
+  // Copy the scalar properties of the data section.
+  static C3DDataSection_p C3DChannelSection_p(const C3DDataSection_p* section, int pointNumber, int analogNumber)
+  {
+    C3DDataSection_p channel;
+    channel.data = 0;
+    channel.wordsAvailable = 0;
+    channel.byteOrder = section->byteOrder;
+    channel.storageFormat = section->storageFormat;
+    channel.unsignedAnalog = section->unsignedAnalog;
+    channel.pointNumber = pointNumber;
+    channel.analogNumber = analogNumber;
+    channel.numberSamplesPerAnalogChannel = section->numberSamplesPerAnalogChannel;
+    channel.frameNumber = section->frameNumber;
+    channel.pointScale = section->pointScale;
+    channel.analogZeroOffset = 0;
+    channel.analogChannelScale = 0;
+    channel.analogUniversalScale = section->analogUniversalScale;
+    return channel;
+  };
+  
+  // Range of frames decoded by one thread.
+  struct C3DDataSectionRange_p
+  {
+    const C3DDataSection_p* section;
+    int firstFrame;
+    int lastFrame;
+    bool complete;
+  };
+  
+  static void DecodeC3DDataSectionRange_p(void* data)
+  {
+    C3DDataSectionRange_p* range = static_cast<C3DDataSectionRange_p*>(data);
+    range->complete = DecodeC3DDataSection_p(range->section, range->firstFrame, range->lastFrame);
+  };
+  
+  /**
+   * Returns true if the data section stored with the given byte order can be decoded directly from the mapped file.
+   */
+  bool CanDecodeC3DDataSection_p(AcquisitionFileIO::ByteOrder byteOrder)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    return (byteOrder == AcquisitionFileIO::IEEE_LittleEndian) || (byteOrder == AcquisitionFileIO::VAX_LittleEndian) || (byteOrder == AcquisitionFileIO::IEEE_BigEndian);
+#else
+    btkNotUsed(byteOrder);
+    return false;
+#endif
+  };
+  
+  /**
+   * Sets the pointer to the data section (@a data of @a size bytes) and its dimensions.
+   * The storage format of @a section must be already set. No matrix is associated with the section.
+   */
+  void InitC3DDataSection_p(C3DDataSection_p* section, int pointNumber, int analogNumber, int numberSamplesPerAnalogChannel, int frameNumber, const char* data, size_t size)
+  {
+    section->data = data;
+    section->wordsAvailable = size / ((section->storageFormat == AcquisitionFileIO::Float) ? 4 : 2);
+    section->pointNumber = pointNumber;
+    section->analogNumber = analogNumber;
+    section->numberSamplesPerAnalogChannel = numberSamplesPerAnalogChannel;
+    section->frameNumber = frameNumber;
+  };
+  
+  /**
+   * Sets the pointers to the data section (@a data of @a size bytes) and to the matrices of @a output.
+   * The acquisition must be already initialized and the storage format of @a section must be set.
+   */
+  void InitC3DDataSection_p(C3DDataSection_p* section, Acquisition::Pointer output, const char* data, size_t size)
+  {
+    InitC3DDataSection_p(section, output->GetPointNumber(), output->GetAnalogNumber(), output->GetNumberAnalogSamplePerFrame(), output->GetPointFrameNumber(), data, size);
+    section->pointValues.resize(section->pointNumber);
+    section->pointResiduals.resize(section->pointNumber);
+    section->analogValues.resize(section->analogNumber);
+    int inc = 0;
+    if (output->GetPointStorage() == Acquisition::ContiguousPointStorage)
+    {
+      // The points are directly decoded in the block of the acquisition.
+      double* values = output->GetPointValuesBlock().data();
+      double* residuals = output->GetPointResidualsBlock().data();
+      for (inc = 0 ; inc < section->pointNumber ; ++inc)
+      {
+        section->pointValues[inc] = values + 3 * inc * section->frameNumber;
+        section->pointResiduals[inc] = residuals + inc * section->frameNumber;
+      }
+    }
+    else
+    {
+      for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it, ++inc)
+      {
+        section->pointValues[inc] = (*it)->GetValues().data();
+        section->pointResiduals[inc] = (*it)->GetResiduals().data();
+      }
+    }
+    inc = 0;
+    for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it, ++inc)
+      section->analogValues[inc] = (*it)->GetValues().data();
+  };
+  
+  /**
+   * Sets the pointers to the matrices of @a input to encode them (see EncodeC3DDataSection_p()).
+   * The matrices are only read: the values are accessed with the const methods to not copy the ones shared with a clone (copy-on-write).
+   * The acquisition is not const only to gather its points in their block when they are stored contiguously.
+   */
+  void InitC3DDataSection_p(C3DDataSection_p* section, Acquisition::Pointer input)
+  {
+    InitC3DDataSection_p(section, input->GetPointNumber(), input->GetAnalogNumber(), input->GetNumberAnalogSamplePerFrame(), input->GetPointFrameNumber(), 0, 0);
+    section->pointValues.resize(section->pointNumber);
+    section->pointResiduals.resize(section->pointNumber);
+    section->analogValues.resize(section->analogNumber);
+    int inc = 0;
+    if (input->GetPointStorage() == Acquisition::ContiguousPointStorage)
+    {
+      double* values = input->GetPointValuesBlock().data();
+      double* residuals = input->GetPointResidualsBlock().data();
+      for (inc = 0 ; inc < section->pointNumber ; ++inc)
+      {
+        section->pointValues[inc] = values + 3 * inc * section->frameNumber;
+        section->pointResiduals[inc] = residuals + inc * section->frameNumber;
+      }
+    }
+    else
+    {
+      for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it, ++inc)
+      {
+        Point::ConstPointer point = *it;
+        section->pointValues[inc] = const_cast<double*>(point->GetValues().data());
+        section->pointResiduals[inc] = const_cast<double*>(point->GetResiduals().data());
+      }
+    }
+    inc = 0;
+    for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it, ++inc)
+    {
+      Analog::ConstPointer analog = *it;
+      section->analogValues[inc] = const_cast<double*>(analog->GetValues().data());
+    }
+  };
+  
+  /**
+   * Returns true if the data section can be encoded by blocks for the given byte order (see EncodeC3DDataSection_p).
+   */
+  bool CanEncodeC3DDataSection_p(AcquisitionFileIO::ByteOrder byteOrder)
+  {
+    return CanDecodeC3DDataSection_p(byteOrder);
+  };
+  
+  /**
+   * Decodes the frames [@a firstFrame, @a lastFrame[ of the data section and scatter them in the matrices.
+   * Returns false if the data section is truncated. In this case, values which cannot be extracted are not modified.
+   */
+  bool DecodeC3DDataSection_p(const C3DDataSection_p* section, int firstFrame, int lastFrame)
+  {
+    if (section->storageFormat == AcquisitionFileIO::Float)
+      return DecodeC3DDataSectionBlocks_p<float>(section, firstFrame, lastFrame);
+    else
+      return DecodeC3DDataSectionBlocks_p<int16_t>(section, firstFrame, lastFrame);
+  };
+  
+  /**
+   * Decodes all the frames of the data section using @a numberOfThreads threads.
+   * Each thread decodes a contiguous range of frames and writes directly in the matrices.
+   * The result is the same than with a single thread (see DecodeC3DDataSection_p(const C3DDataSection_p*, int, int)).
+   */
+  bool DecodeC3DDataSection_p(const C3DDataSection_p* section, int numberOfThreads)
+  {
+    const size_t frameSize = (4 * section->pointNumber + section->analogNumber * section->numberSamplesPerAnalogChannel) * ((section->storageFormat == AcquisitionFileIO::Float) ? 4 : 2);
+    const size_t maxThreads = (frameSize == 0) ? 1 : frameSize * section->frameNumber / _btk_c3d_data_thread_minimum_size;
+    const int num = static_cast<int>(std::min(static_cast<size_t>(std::max(numberOfThreads, 1)), std::max(maxThreads, static_cast<size_t>(1))));
+    if (num == 1)
+      return DecodeC3DDataSection_p(section, 0, section->frameNumber);
+    std::vector<C3DDataSectionRange_p> ranges(num);
+    thread_p* threads = new thread_p[num - 1];
+    for (int i = 0 ; i < num ; ++i)
+    {
+      ranges[i].section = section;
+      ranges[i].firstFrame = static_cast<int>(static_cast<int64_t>(section->frameNumber) * i / num);
+      ranges[i].lastFrame = static_cast<int>(static_cast<int64_t>(section->frameNumber) * (i + 1) / num);
+      ranges[i].complete = true;
+    }
+    // The last range is decoded in the calling thread.
+    for (int i = 0 ; i < num - 1 ; ++i)
+      threads[i].Start(&DecodeC3DDataSectionRange_p, &(ranges[i]));
+    DecodeC3DDataSectionRange_p(&(ranges[num - 1]));
+    bool complete = true;
+    for (int i = 0 ; i < num ; ++i)
+    {
+      if (i < num - 1)
+        threads[i].Join();
+      complete &= ranges[i].complete;
+    }
+    delete[] threads;
+    return complete;
+  };
+  
+  /**
+   * Decodes all the frames of the point @a index and writes them in @a values (3 columns) and @a residuals.
+   * Only the words of this point are read in the data section. The matrices of @a section are not used.
+   * Returns false if the data section is truncated. In this case, values which cannot be extracted are not modified.
+   */
+  bool DecodeC3DPoint_p(const C3DDataSection_p* section, int index, double* values, double* residuals)
+  {
+    C3DDataSection_p channel = C3DChannelSection_p(section, 1, 0);
+    channel.pointValues.assign(1, values);
+    channel.pointResiduals.assign(1, residuals);
+    if (section->storageFormat == AcquisitionFileIO::Float)
+      return DecodeC3DChannel_p<float>(section, &channel, 4 * index, 1, 4);
+    else
+      return DecodeC3DChannel_p<int16_t>(section, &channel, 4 * index, 1, 4);
+  };
+  
+  /**
+   * Decodes all the samples of the analog channel @a index and writes them in @a values.
+   * Only the words of this channel are read in the data section. The matrices of @a section are not used.
+   * Returns false if the data section is truncated. In this case, values which cannot be extracted are not modified.
+   */
+  bool DecodeC3DAnalog_p(const C3DDataSection_p* section, int index, double* values)
+  {
+    C3DDataSection_p channel = C3DChannelSection_p(section, 0, 1);
+    channel.analogZeroOffset = section->analogZeroOffset + index;
+    channel.analogChannelScale = section->analogChannelScale + index;
+    channel.analogValues.assign(1, values);
+    const size_t firstWord = 4 * section->pointNumber + index;
+    if (section->storageFormat == AcquisitionFileIO::Float)
+      return DecodeC3DChannel_p<float>(section, &channel, firstWord, section->analogNumber, section->numberSamplesPerAnalogChannel);
+    else
+      return DecodeC3DChannel_p<int16_t>(section, &channel, firstWord, section->analogNumber, section->numberSamplesPerAnalogChannel);
+  };
+  
+  /**
+   * Encodes all the frames of the matrices associated with @a section and writes them in @a obfs at its current position.
+   * The frames are transposed by blocks into the interleaved records of the data section, converted to the byte order of the section,
+   * and each block is written in one operation. The content is the same than the one written value by value with the class C3DFileIO::Format.
+   */
+  void EncodeC3DDataSection_p(const C3DDataSection_p* section, BinaryFileStream* obfs)
+  {
+    if (section->storageFormat == AcquisitionFileIO::Float)
+      EncodeC3DDataSectionBlocks_p<float>(section, obfs);
+    else
+      EncodeC3DDataSectionBlocks_p<int16_t>(section, obfs);
+  };
+  
+  /**
+   * Set as occluded the frames where the coordinates are equal to 9999999 (C3D files exported by Motion Analysis Corp. softwares).
+   */
+  void C3DOcclusionFromCoordinates_p(Point::Values& coords, Point::Residuals& residuals)
+  {
+    C3DOcclusionFromCoordinates_p(coords.data(), residuals.data(), static_cast<int>(coords.rows()));
+  };
+  
+  /**
+   * Same as above but for the coordinates (3 columns stored contiguously) and the residuals of a point with @a frameNumber frames.
+   */
+  void C3DOcclusionFromCoordinates_p(double* coords, double* residuals, int frameNumber)
+  {
+    Eigen::Map<Point::Values> c(coords, frameNumber, 3);
+    Eigen::Map<Point::Residuals> r(residuals, frameNumber);
+    Eigen::Matrix<double, Eigen::Dynamic, 1> diff = (c.rowwise().sum() / 3.0).array() - 9999999.0;
+    for (int k = 0 ; k < frameNumber ; ++k)
+    {
+      if (fabs(diff.coeff(k)) < std::numeric_limits<float>::epsilon())
+      {
+        c.coeffRef(k,0) = 0.0;
+        c.coeffRef(k,1) = 0.0;
+        c.coeffRef(k,2) = 0.0;
+        r.coeffRef(k) = -1.0;
+      }
+    }
+  };
+  
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+  /**
+   * Extracts the point from the mapped data section.
+   */
+  void C3DPointLoader_p::Load(MeasureData<Point>* data)
+  {
+    Point::Data* pointData = static_cast<Point::Data*>(data);
+    const int frameNumber = this->GetFrameNumber();
+    Point::Values& values = pointData->GetValues();
+    Point::Residuals& residuals = pointData->GetResiduals();
+    values.setZero(frameNumber, 3);
+    residuals.setZero(frameNumber);
+    DecodeC3DPoint_p(&(this->mp_Source->section), this->m_Index, values.data(), residuals.data());
+    if (this->mp_Source->occlusionFromCoordinates)
+      C3DOcclusionFromCoordinates_p(values, residuals);
+  };
+  
+  /**
+   * Extracts the analog channel from the mapped data section.
+   */
+  void C3DAnalogLoader_p::Load(MeasureData<Analog>* data)
+  {
+    Analog::Values& values = data->GetValues();
+    values.setZero(this->GetFrameNumber());
+    DecodeC3DAnalog_p(&(this->mp_Source->section), this->m_Index, values.data());
+  };
+#endif
+};
@@ -0,0 +1,122 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkC3DFileIOUtils_p_h
+#define __btkC3DFileIOUtils_p_h
+
+#include "btkAcquisition.h"
+#include "btkAcquisitionFileIO.h"
+#include "btkBinaryFileStream.h"
+
+#include <vector>
+
+namespace btk
+{
+  // Description of the data section of a C3D file mapped in memory and of the matrices where to scatter its content.
+  struct C3DDataSection_p
+  {
+    const char* data; // First byte of the data section
+    size_t wordsAvailable; // Number of complete words available after the first byte
+    AcquisitionFileIO::ByteOrder byteOrder;
+    AcquisitionFileIO::StorageFormat storageFormat;
+    bool unsignedAnalog;
+    int pointNumber;
+    int analogNumber;
+    int numberSamplesPerAnalogChannel;
+    int frameNumber;
+    double pointScale;
+    const double* analogZeroOffset;
+    const double* analogChannelScale;
+    double analogUniversalScale;
+    std::vector<double*> pointValues;
+    std::vector<double*> pointResiduals;
+    std::vector<double*> analogValues;
+  };
+  
+  bool CanDecodeC3DDataSection_p(AcquisitionFileIO::ByteOrder byteOrder);
+  void InitC3DDataSection_p(C3DDataSection_p* section, int pointNumber, int analogNumber, int numberSamplesPerAnalogChannel, int frameNumber, const char* data, size_t size);
+  void InitC3DDataSection_p(C3DDataSection_p* section, Acquisition::Pointer output, const char* data, size_t size);
+  void InitC3DDataSection_p(C3DDataSection_p* section, Acquisition::Pointer input);
+  bool DecodeC3DDataSection_p(const C3DDataSection_p* section, int firstFrame, int lastFrame);
+  bool DecodeC3DDataSection_p(const C3DDataSection_p* section, int numberOfThreads);
+  bool DecodeC3DPoint_p(const C3DDataSection_p* section, int index, double* values, double* residuals);
+  bool DecodeC3DAnalog_p(const C3DDataSection_p* section, int index, double* values);
+  bool CanEncodeC3DDataSection_p(AcquisitionFileIO::ByteOrder byteOrder);
+  void EncodeC3DDataSection_p(const C3DDataSection_p* section, BinaryFileStream* obfs);
+  void C3DOcclusionFromCoordinates_p(Point::Values& coords, Point::Residuals& residuals);
+  void C3DOcclusionFromCoordinates_p(double* coords, double* residuals, int frameNumber);
+  
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+  // Data section of a C3D file kept mapped in memory for the loaders of its channels (lazy loading).
+  class C3DMappedDataSection_p
+  {
+  public:
+    typedef btkSharedPtr<C3DMappedDataSection_p> Pointer;
+    C3DMappedDataSection_p() : stream(), section(), analogZeroOffset(), analogChannelScale(), occlusionFromCoordinates(false) {};
+    mmfstream stream;
+    C3DDataSection_p section;
+    std::vector<double> analogZeroOffset;
+    std::vector<double> analogChannelScale;
+    bool occlusionFromCoordinates; // See C3DOcclusionFromCoordinates_p
+  private:
+    C3DMappedDataSection_p(const C3DMappedDataSection_p& ); // Not implemented.
+    C3DMappedDataSection_p& operator=(const C3DMappedDataSection_p& ); // Not implemented.
+  };
+  
+  class C3DPointLoader_p : public MeasureDataLoader<Point>
+  {
+  public:
+    C3DPointLoader_p(C3DMappedDataSection_p::Pointer source, int index) : MeasureDataLoader<Point>(), mp_Source(source), m_Index(index) {};
+    virtual int GetFrameNumber() const {return this->mp_Source->section.frameNumber;};
+    virtual void Load(MeasureData<Point>* data);
+  private:
+    C3DMappedDataSection_p::Pointer mp_Source;
+    int m_Index;
+  };
+  
+  class C3DAnalogLoader_p : public MeasureDataLoader<Analog>
+  {
+  public:
+    C3DAnalogLoader_p(C3DMappedDataSection_p::Pointer source, int index) : MeasureDataLoader<Analog>(), mp_Source(source), m_Index(index) {};
+    virtual int GetFrameNumber() const {return this->mp_Source->section.frameNumber * this->mp_Source->section.numberSamplesPerAnalogChannel;};
+    virtual void Load(MeasureData<Analog>* data);
+  private:
+    C3DMappedDataSection_p::Pointer mp_Source;
+    int m_Index;
+  };
+#endif
+};
+
+#endif // __btkC3DFileIOUtils_p_h
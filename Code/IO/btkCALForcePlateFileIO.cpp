@@ -114,6 +114,18 @@ namespace btk
     return ok;
   };
   
+  /**
+   * Checks if the first value of the buffer is the index of the first force plate (i.e. 1).
+   */
+  AcquisitionFileIO::ProbeResult CALForcePlateFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    std::istringstream iss(std::string(buffer, std::min(size, static_cast<size_t>(64))));
+    int index = 0;
+    if (!(iss >> index) || (index != 1))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Checks if the suffix of @a filename is CAL.
    */
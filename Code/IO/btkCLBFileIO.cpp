@@ -123,6 +123,16 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the buffer starts with the string CONTEC DATA LOGGER.
+   */
+  AcquisitionFileIO::ProbeResult CLBFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    if ((size < 18) || (memcmp(buffer, "CONTEC DATA LOGGER", 18) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -96,6 +96,16 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the buffer starts with the string DEMG.
+   */
+  AcquisitionFileIO::ProbeResult DelsysEMGFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    if ((size < 4) || (memcmp(buffer, "DEMG", 4) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
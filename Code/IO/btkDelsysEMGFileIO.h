@@ -65,6 +65,7 @@ namespace btk
     // ~DelsysEMGFileIO(); // Implicit.
     
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
+    BTK_IO_EXPORT virtual ProbeResult CanReadBuffer(const char* buffer, size_t size, const std::string& extension, size_t fileSize);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     
     int GetFileVersion() const {return this->m_Version;};
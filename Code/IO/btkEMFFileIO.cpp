@@ -34,6 +34,7 @@
  */
 
 #include "btkEMFFileIO.h"
+#include "btkASCIIFileUtils_p.h"
 #include "btkConvert.h"
 #include "btkMetaDataUtils.h"
 #include "btkLogger.h"
@@ -101,6 +102,16 @@ namespace btk
     return true;
   };
   
+  /**
+   * Checks if the buffer starts with the header of an EMF file.
+   */
+  AcquisitionFileIO::ProbeResult EMFFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    if ((size < 42) || (memcmp(buffer, "EMF1.0     ## HyperVision EMF ASCII Format", 42) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -192,8 +203,7 @@ namespace btk
         throw(EMFFileIOException("Corrupted EMF file. No :Data section."));
 
       ifs.exceptions(std::ios_base::goodbit); // Remove exceptions
-      int indexMarker;
-      double x,y,z;
+      double indexMarker, x, y, z;
       for(int i = 0 ; i < numFrames ; ++i)
       {
         if (ifs.eof())
@@ -203,8 +213,9 @@ namespace btk
         for (PointCollection::Iterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
         {
           std::getline(ifs, line);
-          std::istringstream iss(line, std::istringstream::in);
-          iss >> indexMarker ; iss >> x; iss >> y; iss >> z;
+          ASCIITokenizer_p tokenizer(line.data(), line.data() + line.length());
+          x = y = z = 0.0;
+          tokenizer.NextNumber(&indexMarker); tokenizer.NextNumber(&x); tokenizer.NextNumber(&y); tokenizer.NextNumber(&z);
           if ((x == 0.0) && (y == 0.0) && (z == 0.0)) // occlusion
           {
             (*it)->GetValues().coeffRef(i, 0) = 0.0;
@@ -103,6 +103,16 @@ namespace btk
     return false;
   };
   
+  /**
+   * Checks if the suffix of the file is GR1, GR2, ..., or GR9.
+   */
+  AcquisitionFileIO::ProbeResult GRxFileIO::CanReadBuffer(const char* /* buffer */, size_t /* size */, const std::string& extension, size_t /* fileSize */)
+  {
+    if ((extension.length() == 3) && (extension.compare(0, 2, "GR") == 0) && (extension[2] >= 0x31) && (extension[2] <= 0x39))
+      return ProbeAccepted;
+    return ProbeRejected;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -115,6 +115,17 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the buffer starts with the chunk ID 0x1000 followed by the string datx.
+   */
+  AcquisitionFileIO::ProbeResult HPFFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    static const char key[8] = {0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    if ((size < 20) || (memcmp(buffer, key, 8) != 0) || (memcmp(buffer + 16, "datx", 4) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -94,6 +94,18 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the first word of the buffer is equal to 2.
+   */
+  AcquisitionFileIO::ProbeResult KistlerDATFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    int32_t version = 0;
+    if (size < 4)
+      return ProbeRejected;
+    memcpy(&version, buffer, 4);
+    return (version == 2) ? ProbeAccepted : ProbeRejected;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
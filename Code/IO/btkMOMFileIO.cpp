@@ -104,6 +104,14 @@ namespace btk
     return false;
   };
   
+  /**
+   * Checks if the suffix of the file is MOM.
+   */
+  AcquisitionFileIO::ProbeResult MOMFileIO::CanReadBuffer(const char* /* buffer */, size_t /* size */, const std::string& extension, size_t /* fileSize */)
+  {
+    return (extension.compare("MOM") == 0) ? ProbeAccepted : ProbeRejected;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
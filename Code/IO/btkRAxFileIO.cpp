@@ -99,6 +99,14 @@ namespace btk
     return false;
   };
   
+  /**
+   * Checks if the suffix of the file is RAH or RAW.
+   */
+  AcquisitionFileIO::ProbeResult RAxFileIO::CanReadBuffer(const char* /* buffer */, size_t /* size */, const std::string& extension, size_t /* fileSize */)
+  {
+    return ((extension.compare("RAH") == 0) || (extension.compare("RAW") == 0)) ? ProbeAccepted : ProbeRejected;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
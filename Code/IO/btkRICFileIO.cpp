@@ -100,6 +100,14 @@ namespace btk
     return false;
   };
   
+  /**
+   * Checks if the suffix of the file is RIC or RIF.
+   */
+  AcquisitionFileIO::ProbeResult RICFileIO::CanReadBuffer(const char* /* buffer */, size_t /* size */, const std::string& extension, size_t /* fileSize */)
+  {
+    return ((extension.compare("RIC") == 0) || (extension.compare("RIF") == 0)) ? ProbeAccepted : ProbeRejected;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
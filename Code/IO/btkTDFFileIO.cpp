@@ -97,6 +97,23 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the buffer starts with the TDF key.
+   */
+  AcquisitionFileIO::ProbeResult TDFFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    if (size < 16)
+      return ProbeRejected;
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      const unsigned char* b = reinterpret_cast<const unsigned char*>(buffer) + 4 * i;
+      uint32_t word = static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) | (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+      if (word != TDFKey[i])
+        return ProbeRejected;
+    }
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -374,7 +391,7 @@ namespace btk
                 if (j + shift < numAnalogFrames)
                 {
                   int k = 0;
-                  for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
+                  for (std::list<Analog::Pointer>::iterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
                     (*it)->SetDataSlice(j + shift, data[k++]);
                 }
               }
@@ -445,7 +462,7 @@ namespace btk
           numPFFramesFinal = (numPFFramesFinal >= numAnalogFrames) ? numAnalogFrames : numPFFramesFinal;
           for (int i = 0 ; i < numPFFramesFinal ; ++i)
           {
-            for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
+            for (std::list<Analog::Pointer>::iterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
               (*it)->SetDataSlice(i + shift, bifs.ReadFloat());
           }
         }
@@ -490,7 +507,7 @@ namespace btk
                 if (j + shift < output->GetAnalogFrameNumber())
                 {
                   int k = 0;
-                  for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
+                  for (std::list<Analog::Pointer>::iterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
                     (*it)->SetDataSlice(j + shift, data[k++]);
                 }
               }
@@ -611,7 +628,7 @@ namespace btk
           numPFFramesFinal = (numPFFramesFinal >= numAnalogFrames) ? numAnalogFrames : numPFFramesFinal;
           for (int i = 0 ; i < numPFFramesFinal ; ++i)
           {
-            for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
+            for (std::list<Analog::Pointer>::iterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
               (*it)->SetDataSlice(i + shift, bifs.ReadFloat());
           }
         }
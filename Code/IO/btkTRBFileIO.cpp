@@ -141,6 +141,17 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the four first words of the buffer are 0x0000 0000 FFFF FFFF.
+   */
+  AcquisitionFileIO::ProbeResult TRBFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    static const char key[8] = {0x00, 0x00, 0x00, 0x00, static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF), static_cast<char>(0xFF)};
+    if ((size < 8) || (memcmp(buffer, key, 8) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -34,6 +34,7 @@
  */
 
 #include "btkTRCFileIO.h"
+#include "btkASCIIFileUtils_p.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
 
@@ -41,11 +42,259 @@
 #include <algorithm>
 #include <cctype>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <sstream>
 
 namespace btk
 {
+  // Destination of the coordinates extracted from the rows of a TRC file.
+  struct TRCFileIOPointsData_p
+  {
+    int frameNumber;
+    std::vector<double*> values;
+    std::vector<double*> residuals;
+  };
+  
+  inline void TRCFileIOInitPointsData_p(TRCFileIOPointsData_p* data, Acquisition::Pointer output)
+  {
+    data->frameNumber = output->GetPointFrameNumber();
+    data->values.resize(output->GetPointNumber());
+    data->residuals.resize(output->GetPointNumber());
+    int inc = 0;
+    for (PointCollection::Iterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
+    {
+      data->values[inc] = (*it)->GetValues().data();
+      data->residuals[inc] = (*it)->GetResiduals().data();
+      ++inc;
+    }
+  };
+  
+  // Extracts the next line containing data (the blank lines are skipped).
+  inline bool TRCFileIONextRow_p(ASCIITokenizer_p* tokenizer, const char** first, const char** last)
+  {
+    do
+    {
+      if (!tokenizer->NextLine(first, last))
+        return false;
+    }
+    while (IsASCIIBlankRange_p(*first, *last));
+    return true;
+  };
+  
+  // Returns the position of the first coordinate in the row (after the frame number, the time and their separator).
+  inline const char* TRCFileIOSkipFrameAndTime_p(const char* first, const char* last)
+  {
+    ASCIITokenizer_p row(first, last);
+    const char* b = 0;
+    const char* e = 0;
+    row.NextToken(&b, &e); // Frame#
+    row.NextToken(&b, &e); // Time
+    const char* values = row.GetPosition();
+    return (values < last) ? values + 1 : last;
+  };
+  
+  inline void TRCFileIOExtractValuesForFrame_p(const char* first, const char* last, const TRCFileIOPointsData_p* data, int frameIndex)
+  {
+    ASCIITokenizer_p row(TRCFileIOSkipFrameAndTime_p(first, last), last);
+    const char* b = 0;
+    const char* e = 0;
+    const int n = data->frameNumber;
+    double coords[3];
+    for (size_t i = 0 ; i < data->values.size() ; ++i)
+    {
+      bool occluded = false;
+      for (int j = 0 ; j < 3 ; ++j)
+      {
+        // An empty or a non numeric coordinate (e.g. 1.#QNAN written by MSVC for a NaN) is an occlusion.
+        if (!row.NextField('\t', &b, &e) || !ParseASCIIField_p(b, e, &coords[j]))
+          occluded = true;
+      }
+      double* values = data->values[i] + frameIndex;
+      if (occluded)
+      {
+        values[0] = 0.0;
+        values[n] = 0.0;
+        values[2*n] = 0.0;
+        data->residuals[i][frameIndex] = -1.0;
+      }
+      else
+      {
+        values[0] = coords[0];
+        values[n] = coords[1];
+        values[2*n] = coords[2];
+        data->residuals[i][frameIndex] = 0.0;
+      }
+    }
+  };
+  
+  // Rows of the data section parsed by one thread. The index of each row is given by its frame number.
+  struct TRCFileIOChunk_p
+  {
+    const char* begin;
+    const char* end;
+    const TRCFileIOPointsData_p* data;
+    double firstFrameNumber; // Frame number of the first row of the data section
+    int beginIndex; // Expected index of the first row (-1 if the chunk has no row)
+    int endIndex; // Index of the first row of the next chunk (the rows stored by each chunk are in disjoint ranges)
+    int firstIndex; // Index of the first row parsed (-1 if the chunk has no row)
+    int lastIndex; // Index of the last row parsed
+    bool valid; // False if a row cannot be parsed or if the frame numbers are not consecutive
+  };
+  
+  inline bool TRCFileIOExtractFrameIndex_p(const char* first, const char* last, double firstFrameNumber, int* index)
+  {
+    ASCIITokenizer_p row(first, last);
+    const char* b = 0;
+    const char* e = 0;
+    double frameNumber = 0.0;
+    if (!row.NextToken(&b, &e) || !ParseASCIIField_p(b, e, &frameNumber))
+      return false;
+    const double d = frameNumber - firstFrameNumber;
+    if ((d < 0.0) || (d > 2147483647.0) || (d != static_cast<double>(static_cast<int>(d))))
+      return false;
+    *index = static_cast<int>(d);
+    return true;
+  };
+  
+  void TRCFileIOExtractChunk_p(void* chunk)
+  {
+    TRCFileIOChunk_p* c = static_cast<TRCFileIOChunk_p*>(chunk);
+    c->firstIndex = -1;
+    c->lastIndex = -1;
+    c->valid = true;
+    ASCIITokenizer_p tokenizer(c->begin, c->end);
+    const char* first = 0;
+    const char* last = 0;
+    int index = 0;
+    while (TRCFileIONextRow_p(&tokenizer, &first, &last))
+    {
+      if (!TRCFileIOExtractFrameIndex_p(first, last, c->firstFrameNumber, &index)
+          || (index != ((c->lastIndex == -1) ? c->beginIndex : c->lastIndex + 1))
+          || (index >= c->endIndex))
+      {
+        c->valid = false;
+        return;
+      }
+      if (c->firstIndex == -1)
+        c->firstIndex = index;
+      c->lastIndex = index;
+      if (index < c->data->frameNumber)
+        TRCFileIOExtractValuesForFrame_p(first, last, c->data, index);
+    }
+  };
+  
+  /*
+   * Parses the data section [begin, end) with several threads. Each thread parses a range of complete rows and uses the frame 
+   * number of each row to know where to store its coordinates. The index of the first row of each range is extracted before: 
+   * a thread stops at the first row which is not in its own range of indices, so two threads never store the same row. 
+   * The ranges are then validated: the frame numbers must be consecutive from the first row to the last expected frame. 
+   * Returns false otherwise and the data section must be parsed sequentially (the coordinates already extracted are overwritten).
+   */
+  bool TRCFileIOExtractValues_p(const char* begin, const char* end, const TRCFileIOPointsData_p* data, int numberOfThreads)
+  {
+    ASCIITokenizer_p tokenizer(begin, end);
+    const char* first = 0;
+    const char* last = 0;
+    if (!TRCFileIONextRow_p(&tokenizer, &first, &last))
+      return false;
+    ASCIITokenizer_p row(first, last);
+    const char* b = 0;
+    const char* e = 0;
+    double firstFrameNumber = 0.0;
+    if (!row.NextToken(&b, &e) || !ParseASCIIField_p(b, e, &firstFrameNumber))
+      return false;
+    std::vector<const char*> bounds;
+    SplitASCIILines_p(first, end, numberOfThreads, &bounds);
+    std::vector<TRCFileIOChunk_p> chunks(numberOfThreads);
+    int previous = -1; // Last chunk with rows
+    for (int i = 0 ; i < numberOfThreads ; ++i)
+    {
+      chunks[i].begin = bounds[i];
+      chunks[i].end = bounds[i+1];
+      chunks[i].data = data;
+      chunks[i].firstFrameNumber = firstFrameNumber;
+      chunks[i].beginIndex = -1;
+      chunks[i].endIndex = std::numeric_limits<int>::max();
+      ASCIITokenizer_p chunk(bounds[i], bounds[i+1]);
+      if (!TRCFileIONextRow_p(&chunk, &first, &last))
+        continue;
+      if (!TRCFileIOExtractFrameIndex_p(first, last, firstFrameNumber, &(chunks[i].beginIndex)))
+        return false;
+      if (previous == -1)
+      {
+        if (chunks[i].beginIndex != 0)
+          return false;
+      }
+      else if (chunks[i].beginIndex <= chunks[previous].beginIndex)
+        return false;
+      else
+        chunks[previous].endIndex = chunks[i].beginIndex;
+      previous = i;
+    }
+    ProcessASCIIChunks_p(&chunks, &TRCFileIOExtractChunk_p);
+    // Validation
+    int nextIndex = 0;
+    for (int i = 0 ; i < numberOfThreads ; ++i)
+    {
+      if (!chunks[i].valid)
+        return false;
+      if (chunks[i].firstIndex == -1)
+        continue;
+      if (chunks[i].firstIndex != nextIndex)
+        return false;
+      nextIndex = chunks[i].lastIndex + 1;
+    }
+    return (nextIndex >= data->frameNumber);
+  };
+  
+  // Formats the rows of the data section: frame number, time (3 decimals) and coordinates (5 decimals). An occluded marker gives empty fields.
+  class TRCFileIOFormatter_p : public ASCIIRowFormatter_p
+  {
+  public:
+    TRCFileIOFormatter_p(PointCollection::ConstPointer markers, int frameNumber, double stepTime)
+    : m_Values(), m_Residuals(), m_FrameNumber(frameNumber), m_StepTime(stepTime), m_Zero(Eigen::NumTraits<double>::dummy_precision())
+    {
+      // Const access: the values shared with a clone are not copied.
+      for (PointCollection::ConstIterator it = markers->Begin() ; it != markers->End() ; ++it)
+      {
+        Point::ConstPointer marker = *it;
+        this->m_Values.push_back(marker->GetValues().data());
+        this->m_Residuals.push_back(marker->GetResiduals().data());
+      }
+    };
+    virtual void Format(int frame, std::string* out) const
+    {
+      out->push_back('\n');
+      AppendASCIIInteger_p(out, frame + 1);
+      out->push_back('\t');
+      AppendASCIIFixed_p(out, static_cast<double>(frame) * this->m_StepTime, 3);
+      for (size_t i = 0 ; i < this->m_Values.size() ; ++i)
+      {
+        const double* values = this->m_Values[i];
+        const double x = values[frame], y = values[frame + this->m_FrameNumber], z = values[frame + 2 * this->m_FrameNumber];
+        if ((this->m_Residuals[i][frame] == -1.0) && (fabs(x) <= this->m_Zero) && (fabs(y) <= this->m_Zero) && (fabs(z) <= this->m_Zero))
+          out->append("\t\t\t");
+        else
+        {
+          out->push_back('\t');
+          AppendASCIIFixed_p(out, x, 5);
+          out->push_back('\t');
+          AppendASCIIFixed_p(out, y, 5);
+          out->push_back('\t');
+          AppendASCIIFixed_p(out, z, 5);
+        }
+      }
+      out->push_back(' ');
+    };
+  private:
+    std::vector<const double*> m_Values;
+    std::vector<const double*> m_Residuals;
+    int m_FrameNumber;
+    double m_StepTime;
+    double m_Zero; // Same tolerance than Eigen::DenseBase::isZero()
+  };
+  
   /**
    * @class TRCFileIOException btkTRCFileIO.h
    * @brief Exception class for the TRCFileIO class.
@@ -67,6 +316,11 @@ namespace btk
    *
    * The TRC file format is created by Motion Analysis Corp.
    *
+   * A marker with an empty or a non numeric coordinate (e.g. 1.#QNAN) is considered as occluded for this frame.
+   *
+   * The data section of large files can be parsed and formatted with several threads. Use the method TRCFileIO::SetNumberOfThreads() to set it.
+   * The extracted data (or the written file) are exactly the same than with only one thread.
+   *
    * @ingroup BTKIO
    */
   
@@ -85,6 +339,22 @@ namespace btk
    * Create a TRCFileIO object an return it as a smart pointer.
    */
   
+  /**
+   * @fn int TRCFileIO::GetNumberOfThreads() const
+   * Returns the number of threads used to parse or format the data section (1 by default).
+   */
+  
+  /**
+   * @fn void TRCFileIO::SetNumberOfThreads(int num)
+   * Sets the number of threads used to parse the data section. A value lower than 1 means to use one thread by processor.
+   *
+   * The data section is split in ranges of complete rows and each thread parses one of them. The frame number of each row gives
+   * the frame where to store its coordinates. If the frame numbers are not consecutive, the data section is parsed again with 
+   * only one thread. The number of threads is reduced for small files.
+   *
+   * When a file is written, the rows are formatted by blocks and each thread formats its own block. The blocks are written in the order of the frames.
+   */
+  
   /**
    * Checks if the first word in the file corresponds to "PathFileType".
    */
@@ -99,6 +369,16 @@ namespace btk
     return true;
   };
   
+  /**
+   * Checks if the buffer starts with the word PathFileType.
+   */
+  AcquisitionFileIO::ProbeResult TRCFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    if ((size < 12) || (memcmp(buffer, "PathFileType", 12) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Checks if the suffix of @a filename is TRC.
    */
@@ -119,23 +399,26 @@ namespace btk
   void TRCFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
-    // Open the stream
-    std::ifstream ifs;
-    ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
+    // Map the file (no stream is used to extract the values)
+    ASCIIFileBuffer_p buffer;
     try
     {
+      if (!buffer.Open(filename))
+        throw(TRCFileIOException("Invalid file path."));
+      ASCIITokenizer_p tokenizer(buffer.Begin(), buffer.End());
       std::string line;
-      ifs.open(filename.c_str());
     // Check the first header keyword: "PathFileType"
-      std::getline(ifs, line);
+      if (!tokenizer.NextLine(&line))
+        throw(TRCFileIOException("Unexpected end of file."));
       if (line.substr(0,12).compare("PathFileType") != 0)
         throw(TRCFileIOException("Invalid TRC file."));
     // Extract header data
       // Required TRC keywords : DataRate, NumFrames, NumMarkers, Units, OrigDataStartFrame
       std::map<std::string, std::string> keywords;
       std::string k, v;
-      std::getline(ifs, k); // keywords
-      std::getline(ifs, v); // corresponding values
+      if (!tokenizer.NextLine(&k) // keywords
+          || !tokenizer.NextLine(&v)) // corresponding values
+        throw(TRCFileIOException("Unexpected end of file."));
       size_t kf2 = -1, kf1 = 0, vf2 = -1, vf1 = 0;
       char sep = '\t';
       while(1)
@@ -169,10 +452,13 @@ namespace btk
         btkWarningMacro(filename, "No 'Units' keyword. Default unit is millimeter (mm)");
         output->SetPointUnit("mm");
       }
+      const char* first = 0;
+      const char* last = 0;
       if (numberOfPoints != 0)
       {
-        std::getline(ifs, line);
-        std::istringstream iss(line.substr(0, line.length() - 1), std::istringstream::in); // No need of the carriage return character
+        if (!tokenizer.NextLine(&line))
+          throw(TRCFileIOException("Unexpected end of file."));
+        std::istringstream iss(line, std::istringstream::in);
         std::string buf;
         std::list<std::string> labels;
         iss >> buf; // Frame#
@@ -183,7 +469,8 @@ namespace btk
           if (!buf.empty())
           {
             btkTrimString(&buf);
-            labels.push_back(buf);
+            if (!buf.empty())
+              labels.push_back(buf);
           }
         }
         int numberOfLabels = static_cast<int>(labels.size());
@@ -192,7 +479,8 @@ namespace btk
           btkWarningMacro(filename, "Mismatch between the number of points and the number of labels extracted. Final number of points corresponds to the number of labels extracted.");
           numberOfPoints = numberOfLabels;
         }
-        std::getline(ifs, line); // Coordinate's label (X1, Y1, Z1, ...)
+        if (!tokenizer.NextLine(&first, &last)) // Coordinate's label (X1, Y1, Z1, ...)
+          throw(TRCFileIOException("Unexpected end of file."));
         output->Init(numberOfPoints, numberOfFrames);
         std::list<std::string>::const_iterator itLabel = labels.begin();
         for (PointCollection::Iterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
@@ -200,18 +488,17 @@ namespace btk
           (*it)->SetLabel(*itLabel);
           ++itLabel;
         }
-        ifs.exceptions(std::ios_base::goodbit); // Remove exceptions
-        for(int i = 0 ; i < numberOfFrames ; ++i)
+        TRCFileIOPointsData_p data;
+        TRCFileIOInitPointsData_p(&data, output);
+        const int numberOfThreads = ComputeASCIIThreadNumber_p(this->m_NumberOfThreads, tokenizer.GetEnd() - tokenizer.GetPosition());
+        if ((numberOfThreads == 1) || !TRCFileIOExtractValues_p(tokenizer.GetPosition(), tokenizer.GetEnd(), &data, numberOfThreads))
         {
-          if (ifs.eof())
-            throw(TRCFileIOException("Unexpected end of file."));
-          
-          ifs >> buf; // Frame#
-          ifs >> buf; // Time
-          std::getline(ifs, line);
-          line[0] = ' '; // was '\t'
-          line[line.length() - 1] = '\t'; // was '\n'
-          this->ExtractValuesForFrame(line, output, i);
+          for(int i = 0 ; i < numberOfFrames ; ++i)
+          {
+            if (!TRCFileIONextRow_p(&tokenizer, &first, &last))
+              throw(TRCFileIOException("Unexpected end of file."));
+            TRCFileIOExtractValuesForFrame_p(first, last, &data, i);
+          }
         }
       }
       // In case there is only unlabel markers in the TRC file (see issue #70 - https://code.google.com/p/b-tk/issues/detail?id=70)
@@ -219,30 +506,23 @@ namespace btk
       {
         btkWarningMacro(filename, "Number of point is null but the number of frames. Trying to find values for unlabeled markers...")
         output->Init(0, numberOfFrames); 
-        std::getline(ifs, line); // Frame#, Time and normaly markers' labels
-        std::getline(ifs, line); // Coordinate's label (X1, Y1, Z1, ...)
-        ifs.exceptions(std::ios_base::goodbit); // Remove exceptions
+        if (!tokenizer.NextLine(&first, &last) // Frame#, Time and normaly markers' labels
+            || !tokenizer.NextLine(&first, &last)) // Coordinate's label (X1, Y1, Z1, ...)
+          throw(TRCFileIOException("Unexpected end of file."));
+        TRCFileIOPointsData_p data;
+        TRCFileIOInitPointsData_p(&data, output);
         for(int i = 0 ; i < numberOfFrames ; ++i)
         {
-          if (ifs.eof())
+          if (!TRCFileIONextRow_p(&tokenizer, &first, &last))
             throw(TRCFileIOException("Unexpected end of file."));
-          
-          std::string buf;
-          ifs >> buf; // Frame#
-          ifs >> buf; // Time
-          std::getline(ifs, line);
-          line[0] = ' '; // was '\t'
-          line[line.length() - 1] = '\t'; // was '\n'
-          if (line.size() == 2) // correspond to " \t"
+          // Count the number of fields after the time
+          const char* values = TRCFileIOSkipFrameAndTime_p(first, last);
+          while ((last > values) && ((*(last-1) == ' ') || (*(last-1) == '\r')))
+            --last;
+          if (values == last)
             continue;
-          // Count the number of tab
-          int numTabs = 0;
-          for (size_t j = 0 ; j < line.length() ; ++j)
-          {
-            if (line[j] == '\t')
-              ++numTabs;
-          }
-          int numMarkers = numTabs / 3;
+          int numFields = 1 + static_cast<int>(std::count(values, last, '\t'));
+          int numMarkers = numFields / 3;
           if (output->GetPointNumber() < numMarkers)
           {
             for (int k = output->GetPointNumber() ; k < numMarkers ; ++k)
@@ -251,42 +531,26 @@ namespace btk
               marker->GetResiduals().setConstant(-1.0); // In case the markers was not detected for the first frames.
               output->AppendPoint(marker);
             }
+            TRCFileIOInitPointsData_p(&data, output);
           }
           if (numMarkers > 0)
-            this->ExtractValuesForFrame(line, output, i);
+            TRCFileIOExtractValuesForFrame_p(first, last, &data, i);
         }
       }
     }
-    catch (std::fstream::failure& )
-    {
-      std::string excmsg; 
-      if (!ifs.is_open())
-        excmsg = "Invalid file path.";
-      else if (ifs.eof())
-        excmsg = "Unexpected end of file.";
-      else if(ifs.bad())
-        excmsg = "Loss of integrity of the file stream.";
-      else if(ifs.fail())
-        excmsg = "Internal logic operation error on the stream associated with the file.";
-      else
-        excmsg = "Unknown error associated with the file stream.";
-      
-      if (ifs.is_open()) ifs.close();    
-      throw(TRCFileIOException(excmsg));
-    }
     catch (TRCFileIOException& )
     {
-      if (ifs.is_open()) ifs.close(); 
+      buffer.Close();
       throw;
     }
     catch (std::exception& e)
     {
-      if (ifs.is_open()) ifs.close(); 
+      buffer.Close();
       throw(TRCFileIOException("Unexpected exception occurred: " + std::string(e.what())));
     }
     catch(...)
     {
-      if (ifs.is_open()) ifs.close(); 
+      buffer.Close();
       throw(TRCFileIOException("Unknown exception"));
     }
   };
@@ -347,26 +611,9 @@ namespace btk
       ++idx;
     }
     ofs << "\n";
-    double time = 0.0;
-    for (int frame = 0 ; frame < input->GetPointFrameNumber() ; ++frame)
-    {
-      ofs.precision(3);
-      ofs << std::endl << frame + 1 << "\t" << time;
-      ofs.precision(5);
-
-      for (PointCollection::ConstIterator it = markers->Begin() ; it != markers->End() ; ++it)
-      {
-        if ((*it)->GetValues().row(frame).isZero() && ((*it)->GetResiduals().coeff(frame) == -1))
-          ofs << "\t\t\t";
-        else
-           ofs << "\t" << (*it)->GetValues().coeff(frame, 0)
-               << "\t" << (*it)->GetValues().coeff(frame, 1)
-               << "\t" << (*it)->GetValues().coeff(frame, 2);
-      };
-      ofs << " ";
-      time += stepTime;
-    };
-    ofs << std::endl;
+    TRCFileIOFormatter_p formatter(markers, input->GetPointFrameNumber(), stepTime);
+    WriteASCIIRows_p(&ofs, &formatter, input->GetPointFrameNumber(), this->m_NumberOfThreads);
+    ofs << "\n";
     ofs.close();
   };
   
@@ -375,32 +622,7 @@ namespace btk
    */
   TRCFileIO::TRCFileIO()
   : AcquisitionFileIO(AcquisitionFileIO::ASCII)
-  {};
-  
-  void TRCFileIO::ExtractValuesForFrame(std::string& line, Acquisition::Pointer output, int frameIdx)
   {
-    std::istringstream iss(line, std::istringstream::in);
-    for (PointCollection::Iterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
-    {
-      std::string x="", y="", z="";
-      std::getline(iss, x, '\t');
-      std::getline(iss, y, '\t');
-      std::getline(iss, z, '\t');
-      
-      if (x.empty() || y.empty() || z.empty()) // occlusion
-      {
-        (*it)->GetValues().coeffRef(frameIdx, 0) = 0.0;
-        (*it)->GetValues().coeffRef(frameIdx, 1) = 0.0;
-        (*it)->GetValues().coeffRef(frameIdx, 2) = 0.0;
-        (*it)->GetResiduals().coeffRef(frameIdx) = -1.0;
-      }
-      else
-      {
-        FromString(x, (*it)->GetValues().coeffRef(frameIdx, 0));
-        FromString(y, (*it)->GetValues().coeffRef(frameIdx, 1));
-        FromString(z, (*it)->GetValues().coeffRef(frameIdx, 2));
-        (*it)->GetResiduals().coeffRef(frameIdx) = 0.0;
-      }
-    }
+    this->m_NumberOfThreads = 1;
   };
 };
@@ -64,15 +64,19 @@ namespace btk
     // ~TRCFileIO(); // Implicit.
     
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
+    BTK_IO_EXPORT virtual ProbeResult CanReadBuffer(const char* buffer, size_t size, const std::string& extension, size_t fileSize);
     BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
     
+    int GetNumberOfThreads() const {return this->m_NumberOfThreads;};
+    void SetNumberOfThreads(int num) {this->m_NumberOfThreads = num;};
+    
   protected:
     BTK_IO_EXPORT TRCFileIO();
     
   private:
-    inline void ExtractValuesForFrame(std::string& line, Acquisition::Pointer output, int frameIndex);
+    int m_NumberOfThreads;
     
     TRCFileIO(const TRCFileIO& ); // Not implemented.
     TRCFileIO& operator=(const TRCFileIO& ); // Not implemented. 
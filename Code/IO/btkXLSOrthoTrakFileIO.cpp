@@ -106,6 +106,21 @@ namespace btk
     return canBeRead;
   };
   
+  /**
+   * Checks if the two first lines of the buffer start with the words Version and Starting Frame.
+   */
+  AcquisitionFileIO::ProbeResult XLSOrthoTrakFileIO::CanReadBuffer(const char* buffer, size_t size, const std::string& /* extension */, size_t /* fileSize */)
+  {
+    const char* end = buffer + size;
+    const char* eol = std::find(buffer, end, '\n');
+    if ((eol == end) || (eol - buffer < 8) || (memcmp(buffer, "Version\t", 8) != 0))
+      return ProbeRejected;
+    ++eol;
+    if ((end - eol < 15) || (memcmp(eol, "Starting Frame\t", 15) != 0))
+      return ProbeRejected;
+    return ProbeAccepted;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -0,0 +1,35 @@
+function [values residuals labels] = btkGetPointsArray(h, labels, nthreads) %#ok
+%BTKGETPOINTSARRAY Extract points' values and residuals in one call
+% 
+%  VALUES = BTKGETPOINTSARRAY(H) returns an array of real with a size
+%  F x 3 x N where F is the number of frames in the acquisition and N the
+%  number of points. The point #i is stored in VALUES(:,:,i).
+%  The biomechanical acquisition handle H is represented as a double
+%  and can be only used with the btk* functions.
+%
+%  [VALUES RESIDUALS] = BTKGETPOINTSARRAY(H) returns also the residuals
+%  in a matrix of size F x N.
+%
+%  [VALUES RESIDUALS LABELS] = BTKGETPOINTSARRAY(H) returns also the
+%  labels of the extracted points in a cell array of strings (1 x N).
+%
+%  [...] = BTKGETPOINTSARRAY(H, LABELS) extracts only the points
+%  with the given labels (a string or a cell array of strings), in
+%  the same order. An empty value extracts all the points. An error
+%  is thrown if one of the labels is unknown.
+%
+%  [...] = BTKGETPOINTSARRAY(H, LABELS, NTHREADS) uses NTHREADS
+%  threads to copy the data. If NTHREADS is lower than 1, one thread
+%  per processor is used. Small acquisitions are always copied with
+%  one thread.
+
+%  Author: A. Barré
+%  Copyright 2009-2014 Biomechanical ToolKit (BTK).
+
+% The following comment, MATLAB compiler pragma, is necessary to avoid 
+% compiling this M-file instead of linking against the MEX-file.  Don't remove.
+%# mex
+
+error(generatemsgid('NotSupported'),'MEX file for BTKGETPOINTSARRAY not found');
+
+% [EOF] btkGetPointsArray.m
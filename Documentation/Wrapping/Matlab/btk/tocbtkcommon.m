@@ -45,6 +45,7 @@ function tocbtkcommon
 %   <a href="matlab:help btkGetPoint">btkGetPoint</a>                       - Point extraction
 %   <a href="matlab:help btkGetPointsValues">btkGetPointsValues</a>                - Points' values accessor
 %   <a href="matlab:help btkGetPointsResiduals">btkGetPointsResiduals</a>             - Points' residuals accessor
+%   <a href="matlab:help btkGetPointsArray">btkGetPointsArray</a>                 - Points' values and residuals extracted in one call
 %   <a href="matlab:help btkGetAngles">btkGetAngles</a>                      - Angles extraction
 %   <a href="matlab:help btkGetAnglesValues">btkGetAnglesValues</a>                - Extracts angles as a simple matrix 
 %   <a href="matlab:help btkGetForces">btkGetForces</a>                      - Forces extraction
@@ -33,57 +33,83 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <btkAcquisitionFileReader.h>
-#include <btkAcquisitionFileWriter.h>
+#include <btkAcquisitionFileBatchConverter.h>
 #include <btkMacro.h> // btkStripPathMacro
 
 #include <iostream> // std::cerr
-#include <cstdio> // Include std::remove for Linux
+#include <cstdlib> // atoi
+#include <cstring> // strcmp
+
+static void PrintUsage(const char* program)
+{
+  std::cerr << "Usage: " << program << " input output\n"
+            << "       " << program << " -d inputDirectory outputDirectory suffix [-j threads]\n"
+            << "       " << program << " -m manifest [-j threads]\n\n"
+            << "Convert acquisition files into other ones, whatever the formats used.\n\n"
+            << "  -d  Convert each supported file of the input directory. The output files are\n"
+            << "      written in the output directory with the given suffix (e.g. c3d, trc).\n"
+            << "  -m  Convert the files listed in the manifest (one 'input<TAB>output' by line).\n"
+            << "  -j  Number of files converted in parallel (default: one by processor)."
+            << std::endl;
+};
 
 int main(int argc, char *argv[])
 {
-  if (argc != 3)
+  // New instantiation of a batch converter. Each of its workers reuses its own reader and writer.
+  btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+  converter->SetNumberOfThreads(0);
+  int argn = 1;
+  if ((argc >= 5) && (strcmp(argv[1], "-d") == 0))
   {
-    std::cerr << "No enough input arguements.\n\n"
-              << "Usage: " << btkStripPathMacro(argv[0]) << " input output\n\n"
-              << "Convert an acquisition file into another one, whatever the formats used."
-              << std::endl;
-    return -1;
+    if (converter->AppendDirectory(argv[2], argv[3], argv[4]) == 0)
+      std::cerr << "No supported file found in the directory " << argv[2] << std::endl;
+    argn = 5;
   }
- 
-  // New instantiation of an acquisition file reader. 
-  btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
-  // Set the path of the acquisition to read.
-  reader->SetFilename(argv[1]);
-  // New instamtiation of an acquisition file writer
-  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
-  // Set the path of the file to write. The acquisition will be exported in this file.
-  writer->SetFilename(argv[2]);
-  // Link the writer with the reader.
-  writer->SetInput(reader->GetOutput());
-
-  // Manage possible exceptions during the update of the pipeline.
-  try 
+  else if ((argc >= 3) && (strcmp(argv[1], "-m") == 0))
   {
-    writer->Update();
+    if (converter->AppendManifest(argv[2]) == -1)
+      return -1;
+    argn = 3;
   }
-  catch(btk::Exception& e)
+  else if ((argc == 3) && (argv[1][0] != '-'))
   {
-    std::cerr << "Exception: " << e.what() << std::endl;
-    std::remove(argv[2]);    
-    return -2;
+    converter->AppendTask(argv[1], argv[2]);
+    argn = 3;
   }
-  catch(std::exception& e)
+  else
+    argn = 0;
+  if ((argn != 0) && (argc == argn + 2) && (strcmp(argv[argn], "-j") == 0))
   {
-    std::cerr << "Unknown exception: " << e.what() << std::endl;
-    std::remove(argv[2]);    
-    return -3;
+    converter->SetNumberOfThreads(atoi(argv[argn + 1]));
+    argn += 2;
   }
-  catch(...)
+  if ((argn == 0) || (argn != argc))
   {
-    std::cerr << "Unknown exception";
-    return -3;
+    std::cerr << "Wrong input arguments.\n\n";
+    PrintUsage(btkStripPathMacro(argv[0]));
+    return -1;
   }
-
+  
+  // Convert all the files. An error does not stop the conversion of the other files.
+  converter->Update();
+  
+  // Errors and summary
+  const btk::AcquisitionFileBatchConverter::Report& report = converter->GetReport();
+  for (int i = 0 ; i < converter->GetTaskNumber() ; ++i)
+  {
+    if (!converter->GetResult(i).succeeded)
+      std::cerr << "Error: " << converter->GetTask(i).input << "\n  " << converter->GetResult(i).error << std::endl;
+  }
+  if (converter->GetTaskNumber() > 1)
+  {
+    std::cout << "Converted files: " << report.fileNumber - report.failureNumber << "/" << report.fileNumber << "\n"
+              << "Elapsed time: " << report.elapsedTime << " s\n"
+              << "Throughput: " << report.GetFilesPerSecond() << " files/s, " << report.GetMegabytesPerSecond() << " MB/s\n"
+              << "Time by stage (all workers): read " << report.readTime << " s, filter " << report.filterTime << " s, write " << report.writeTime << " s"
+              << std::endl;
+  }
+  
+  if (report.failureNumber != 0)
+    return -2;
   return 0;
 };
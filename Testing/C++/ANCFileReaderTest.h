@@ -2,6 +2,51 @@
 #define ANCFileReaderTest_h
 
 #include <btkAcquisitionFileReader.h>
+#include <btkANCFileIO.h>
+#include <btkConvert.h>
+
+#include "ASCIIFile_Util.h"
+
+#include <cstdio>
+
+// Appends the rows of a synthetic ANC file.
+struct ANCFileReaderTest_LargeRow
+{
+  int channelNumber;
+  int period;
+  void operator()(int f, std::string* content) const
+  {
+    char buffer[64];
+    sprintf(buffer, "%f", 0.001 * ((this->period > 0) ? f % this->period : f));
+    content->append(buffer);
+    for (int c = 0 ; c < this->channelNumber ; ++c)
+    {
+      sprintf(buffer, "\t%i", ((f * 37 + c * 101) % 65536) - 32768);
+      content->append(buffer);
+    }
+    content->append("\t\n");
+  };
+};
+
+// Generates an ANC file large enough to be parsed by several threads. The times restart every @a period rows (if positive).
+inline std::string ANCFileReaderTest_WriteLarge(const std::string& name, int frameNumber, int period = 0)
+{
+  const ANCFileReaderTest_LargeRow row = {16, period};
+  std::string header = "File_Type:\tAnalog R/C ASCII\tGeneration#:\t2\n"
+                       "Board_Type:\tNational PCI-6071E\tPolarity:\tBipolar\n"
+                       "Trial_Name:\tLarge\tTrial#:\t1\tDuration(Sec.):\t" + btk::ToString((frameNumber - 1) / 1000.0) + "\t#Channels:\t" + btk::ToString(row.channelNumber) + "\n"
+                       "BitDepth:\t16\tPreciseRate:\t1000.000000\n\n\n\n\n";
+  std::string rates = "Rate", ranges = "Range";
+  header += "Name";
+  for (int c = 0 ; c < row.channelNumber ; ++c)
+  {
+    header += "\tC" + btk::ToString(c);
+    rates += "\t1000";
+    ranges += "\t10000";
+  }
+  header += "\t\n" + rates + "\t\n" + ranges + "\t\n";
+  return ASCIIFileUtil_WriteLarge(ANCFilePathOUT + name, header, frameNumber, row);
+};
 
 CXXTEST_SUITE(ANCFileReaderTest)
 {
@@ -148,6 +193,76 @@ CXXTEST_SUITE(ANCFileReaderTest)
       }
     }
   }
+  
+  CXXTEST_TEST(Synthetic)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ASCIIFileUtil_WriteText(ANCFilePathOUT + "Synthetic.anc",
+      "File_Type:\tAnalog R/C ASCII\tGeneration#:\t2\r\n"
+      "Board_Type:\tNational PCI-6071E\tPolarity:\tBipolar\r\n"
+      "Trial_Name:\tSynthetic\tTrial#:\t1\tDuration(Sec.):\t0.002000\t#Channels:\t2\r\n"
+      "BitDepth:\t16\tPreciseRate:\t1000.000000\r\n"
+      "\r\n\r\n\r\n\r\n"
+      "Name\tf1x\tf1z\t\r\n"
+      "Rate\t1000\t1000\t\r\n"
+      "Range\t10000\t5000\t\r\n"
+      "0.000000\t100\t-200\t\r\n"
+      "0.001000\t32767\t0\t\r\n"
+      "0.002000\t-5\t7\t\r\n"));
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    TS_ASSERT_EQUALS(acq->GetAnalogFrequency(), 1000.0);
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), 2);
+    TS_ASSERT_EQUALS(acq->GetAnalogFrameNumber(), 3);
+    TS_ASSERT_EQUALS(acq->GetAnalog(0)->GetLabel(), "f1x");
+    TS_ASSERT_EQUALS(acq->GetAnalog(1)->GetLabel(), "f1z");
+    const double s0 = acq->GetAnalog(0)->GetScale();
+    const double s1 = acq->GetAnalog(1)->GetScale();
+    TS_ASSERT_EQUALS(acq->GetAnalog(0)->GetValues()(0), 100.0 * s0);
+    TS_ASSERT_EQUALS(acq->GetAnalog(1)->GetValues()(0), -200.0 * s1);
+    TS_ASSERT_EQUALS(acq->GetAnalog(0)->GetValues()(1), 32767.0 * s0);
+    TS_ASSERT_EQUALS(acq->GetAnalog(1)->GetValues()(1), 0.0);
+    TS_ASSERT_EQUALS(acq->GetAnalog(0)->GetValues()(2), -5.0 * s0);
+    TS_ASSERT_EQUALS(acq->GetAnalog(1)->GetValues()(2), 7.0 * s1);
+  };
+  
+  CXXTEST_TEST(SyntheticTruncated)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ASCIIFileUtil_WriteText(ANCFilePathOUT + "SyntheticTruncated.anc",
+      "File_Type:\tAnalog R/C ASCII\tGeneration#:\t2\r\n"
+      "Board_Type:\tNational PCI-6071E\tPolarity:\tBipolar\r\n"
+      "Trial_Name:\tSynthetic\tTrial#:\t1\tDuration(Sec.):\t0.002000\t#Channels:\t2\r\n"
+      "BitDepth:\t16\tPreciseRate:\t1000.000000\r\n"
+      "\r\n\r\n\r\n\r\n"
+      "Name\tf1x\tf1z\t\r\n"
+      "Rate\t1000\t1000\t\r\n"
+      "Range\t10000\t5000\t\r\n"
+      "0.000000\t100\t-200\t\r\n"
+      "0.001000\t32767\t0\t\r\n"
+      "0.002000\t-5\r\n"));
+    TS_ASSERT_THROWS_EQUALS(reader->Update(), const btk::Exception &e, e.what(), std::string("Unexpected end of file."));
+  };
+  
+  CXXTEST_TEST(SyntheticThreads)
+  {
+    const std::string filename = ANCFileReaderTest_WriteLarge("SyntheticThreads.anc", 40001);
+    btk::Acquisition::Pointer ref = ASCIIFileUtil_Read<btk::ANCFileIO>(filename, 1);
+    TS_ASSERT_EQUALS(ref->GetAnalogFrameNumber(), 40001);
+    TS_ASSERT_EQUALS(ref->GetAnalogNumber(), 16);
+    TS_ASSERT_EQUALS(ref->GetAnalog(3)->GetValues()(30000), (((30000 * 37 + 3 * 101) % 65536) - 32768) * ref->GetAnalog(3)->GetScale());
+    ASCIIFileUtil_Compare(ASCIIFileUtil_Read<btk::ANCFileIO>(filename, 4), ref);
+  };
+  
+  CXXTEST_TEST(SyntheticThreadsRepeatedTimes)
+  {
+    // The times restart in the middle of the file: each thread must only store the rows of its own range.
+    const std::string filename = ANCFileReaderTest_WriteLarge("SyntheticThreadsRepeatedTimes.anc", 40001, 10000);
+    btk::Acquisition::Pointer ref = ASCIIFileUtil_Read<btk::ANCFileIO>(filename, 1);
+    TS_ASSERT_EQUALS(ref->GetAnalogFrameNumber(), 40001);
+    for (int i = 0 ; i < 10 ; ++i)
+      ASCIIFileUtil_Compare(ASCIIFileUtil_Read<btk::ANCFileIO>(filename, 4), ref);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ANCFileReaderTest)
@@ -156,4 +271,8 @@ CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, MisspelledFile)
 CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, Truncated)
 CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, Gait)
 CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, Res16Bits)
+CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, Synthetic)
+CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, SyntheticTruncated)
+CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, SyntheticThreads)
+CXXTEST_TEST_REGISTRATION(ANCFileReaderTest, SyntheticThreadsRepeatedTimes)
 #endif
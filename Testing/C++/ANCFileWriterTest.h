@@ -5,6 +5,30 @@
 #include <btkAcquisitionFileReader.h>
 #include <btkANCFileIO.h>
 
+#include <fstream>
+#include <sstream>
+
+// Content of the file after its header (which contains the name of the file).
+inline std::string ANCFileWriterTest_Data(const std::string& filename)
+{
+  std::ifstream ifs(filename.c_str());
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+  const std::string content = oss.str();
+  return content.substr(content.find("\nName\t"));
+};
+
+inline void ANCFileWriterTest_Write(const std::string& filename, btk::Acquisition::Pointer acq, int numberOfThreads)
+{
+  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+  btk::ANCFileIO::Pointer io = btk::ANCFileIO::New();
+  io->SetNumberOfThreads(numberOfThreads);
+  writer->SetAcquisitionIO(io);
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  writer->Update();
+};
+
 CXXTEST_SUITE(ANCFileWriterTest)
 {
   CXXTEST_TEST(NoFileNoInput)
@@ -189,6 +213,39 @@ CXXTEST_SUITE(ANCFileWriterTest)
       TS_ASSERT_DELTA(acq->GetAnalog(5)->GetValues()(j), acq2->GetAnalog(5)->GetValues()(j) * s6, 1e-5);
     }
   };
+
+  CXXTEST_TEST(SyntheticThreads)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 40001, 16, 1);
+    acq->SetPointFrequency(1000.0);
+    const double scale = 10.0 / 32768.0;
+    for (int c = 0 ; c < 16 ; ++c)
+    {
+      btk::Analog::Pointer analog = acq->GetAnalog(c);
+      analog->SetScale(scale);
+      for (int i = 0 ; i < 40001 ; ++i)
+        analog->GetValues().coeffRef(i) = static_cast<double>((i * 37 + c * 1013) % 65535 - 32767) * scale;
+    }
+    ANCFileWriterTest_Write(ANCFilePathOUT + "SyntheticThreads1.anc", acq, 1);
+    ANCFileWriterTest_Write(ANCFilePathOUT + "SyntheticThreads4.anc", acq, 4);
+    const std::string data = ANCFileWriterTest_Data(ANCFilePathOUT + "SyntheticThreads1.anc");
+    TS_ASSERT(data.size() > 3000000);
+    TS_ASSERT(data == ANCFileWriterTest_Data(ANCFilePathOUT + "SyntheticThreads4.anc"));
+    TS_ASSERT(data.find("\n40.000000\t") != std::string::npos);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ANCFilePathOUT + "SyntheticThreads4.anc");
+    reader->Update();
+    btk::Acquisition::Pointer output = reader->GetOutput();
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 40001);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 16);
+    for (int c = 0 ; c < 16 ; ++c)
+    {
+      // The scale of the read channels depends on the range written in the file. The integer values are the same.
+      for (int i = 0 ; i < 40001 ; i += 11)
+        TS_ASSERT_DELTA(output->GetAnalog(c)->GetValues()(i) / output->GetAnalog(c)->GetScale(), acq->GetAnalog(c)->GetValues()(i) / scale, 1e-6);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ANCFileWriterTest)
@@ -198,5 +255,6 @@ CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, NoFileWithIO)
 CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Gait_rewrited)
 CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Gait_from_c3d)
 CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Res16bits_rewrited)
-CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Shd01_from_c3d) 
+CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Shd01_from_c3d)
+CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, SyntheticThreads)
 #endif
@@ -0,0 +1,95 @@
+#ifndef ASCIIFileReaderBenchmark_h
+#define ASCIIFileReaderBenchmark_h
+
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkTRCFileIO.h>
+#include <btkANCFileIO.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+template <typename T>
+static btk::Acquisition::Pointer ASCIIFileReaderBenchmark_Read(const std::string& label, const std::string& filename, int numberOfThreads)
+{
+  struct stat info;
+  stat(filename.c_str(), &info);
+  btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+  typename T::Pointer io = T::New();
+  io->SetNumberOfThreads(numberOfThreads);
+  reader->SetAcquisitionIO(io);
+  reader->SetFilename(filename);
+  TDDBenchmark_Timer timer;
+  reader->Update();
+  TDDBenchmark_Report(label, timer.GetElapsed(), static_cast<double>(info.st_size));
+  return reader->GetOutput();
+};
+
+// Acquisition with a layout similar to the large exports of the optoelectronic systems (many markers, many analog channels).
+static btk::Acquisition::Pointer ASCIIFileReaderBenchmark_Generate(int pointNumber, int analogNumber, int frameNumber)
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(pointNumber, frameNumber, analogNumber, 1);
+  acq->SetPointFrequency(100.0);
+  for (int p = 0 ; p < pointNumber ; ++p)
+  {
+    btk::Point::Pointer point = acq->GetPoint(p);
+    for (int f = 0 ; f < frameNumber ; ++f)
+    {
+      point->GetValues().coeffRef(f,0) = 250.0 * sin(0.01 * f + p);
+      point->GetValues().coeffRef(f,1) = 120.0 * cos(0.02 * f - p) + 10.0 * p;
+      point->GetValues().coeffRef(f,2) = 900.0 + 0.5 * (f % 1000) - 30.0 * p;
+      point->GetResiduals().coeffRef(f) = ((f + p) % 7 == 0) ? -1.0 : 0.0;
+    }
+  }
+  for (int c = 0 ; c < analogNumber ; ++c)
+  {
+    btk::Analog::Pointer analog = acq->GetAnalog(c);
+    analog->SetScale(10.0 / 32768.0);
+    for (int i = 0 ; i < analog->GetFrameNumber() ; ++i)
+      analog->GetValues().coeffRef(i) = 5.0 * sin(0.003 * i + c);
+  }
+  return acq;
+};
+
+static void ASCIIFileReaderBenchmark_Write(const std::string& filename, btk::Acquisition::Pointer acq)
+{
+  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  writer->Update();
+};
+
+CXXTEST_SUITE(ASCIIFileReaderBenchmark)
+{
+  CXXTEST_TEST(TRC)
+  {
+    std::string filename = TRCFilePathOUT + "bench_read.trc";
+    btk::Acquisition::Pointer acq = ASCIIFileReaderBenchmark_Generate(50, 0, 10000);
+    ASCIIFileReaderBenchmark_Write(filename, acq);
+    btk::Acquisition::Pointer output = ASCIIFileReaderBenchmark_Read<btk::TRCFileIO>("TRC read (1 thread)", filename, 1);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), acq->GetPointFrameNumber());
+    TS_ASSERT_EQUALS(output->GetPointNumber(), acq->GetPointNumber());
+    btk::Acquisition::Pointer parallel = ASCIIFileReaderBenchmark_Read<btk::TRCFileIO>("TRC read (1 thread per processor)", filename, 0);
+    for (int p = 0 ; p < output->GetPointNumber() ; ++p)
+      TS_ASSERT(output->GetPoint(p)->GetValues() == parallel->GetPoint(p)->GetValues());
+  };
+
+  CXXTEST_TEST(ANC)
+  {
+    std::string filename = ANCFilePathOUT + "bench_read.anc";
+    btk::Acquisition::Pointer acq = ASCIIFileReaderBenchmark_Generate(0, 28, 100000);
+    ASCIIFileReaderBenchmark_Write(filename, acq);
+    btk::Acquisition::Pointer output = ASCIIFileReaderBenchmark_Read<btk::ANCFileIO>("ANC read (1 thread)", filename, 1);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), acq->GetAnalogFrameNumber());
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), acq->GetAnalogNumber());
+    btk::Acquisition::Pointer parallel = ASCIIFileReaderBenchmark_Read<btk::ANCFileIO>("ANC read (1 thread per processor)", filename, 0);
+    for (int c = 0 ; c < output->GetAnalogNumber() ; ++c)
+      TS_ASSERT(output->GetAnalog(c)->GetValues() == parallel->GetAnalog(c)->GetValues());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ASCIIFileReaderBenchmark)
+CXXTEST_TEST_REGISTRATION(ASCIIFileReaderBenchmark, TRC)
+CXXTEST_TEST_REGISTRATION(ASCIIFileReaderBenchmark, ANC)
+#endif
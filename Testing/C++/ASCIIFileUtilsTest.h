@@ -0,0 +1,286 @@
+#ifndef ASCIIFileUtilsTest_h
+#define ASCIIFileUtilsTest_h
+
+#include <btkASCIIFileUtils_p.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <sstream>
+
+inline bool ASCIIFileUtilsTest_Parse(const char* str, double* value)
+{
+  const char* last = str + strlen(str);
+  return btk::ParseASCIINumber_p(str, last, value) == last;
+};
+
+inline std::string ASCIIFileUtilsTest_Fixed(double value, int precision)
+{
+  std::string str;
+  btk::AppendASCIIFixed_p(&str, value, precision);
+  return str;
+};
+
+inline std::string ASCIIFileUtilsTest_Shortest(double value)
+{
+  std::string str;
+  btk::AppendASCIIShortest_p(&str, value);
+  return str;
+};
+
+class ASCIIFileUtilsTest_Formatter : public btk::ASCIIRowFormatter_p
+{
+public:
+  virtual void Format(int row, std::string* out) const
+  {
+    btk::AppendASCIIInteger_p(out, row);
+    out->append(100, ' ');
+    out->push_back('\n');
+  };
+};
+
+CXXTEST_SUITE(ASCIIFileUtilsTest)
+{
+  CXXTEST_TEST(ParseNumber)
+  {
+    double value = 0.0;
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("12.5", &value)); TS_ASSERT_EQUALS(value, 12.5);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("-0.25", &value)); TS_ASSERT_EQUALS(value, -0.25);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("+3.", &value)); TS_ASSERT_EQUALS(value, 3.0);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse(".5", &value)); TS_ASSERT_EQUALS(value, 0.5);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("1e3", &value)); TS_ASSERT_EQUALS(value, 1000.0);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("-2.5E-2", &value)); TS_ASSERT_EQUALS(value, -0.025);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("0000.000", &value)); TS_ASSERT_EQUALS(value, 0.0);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("1.2345678901234567890123", &value)); TS_ASSERT_DELTA(value, 1.2345678901234567, 1e-15);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("1e300", &value)); TS_ASSERT_EQUALS(value, 1e300);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("-inf", &value)); TS_ASSERT(value < 0.0); TS_ASSERT(value == 2.0 * value);
+    TS_ASSERT(ASCIIFileUtilsTest_Parse("NaN", &value)); TS_ASSERT(value != value);
+    // Only the point is a decimal separator, whatever the locale.
+    const char* str = "1,5";
+    TS_ASSERT_EQUALS(btk::ParseASCIINumber_p(str, str + 3, &value), str + 1); TS_ASSERT_EQUALS(value, 1.0);
+    str = "abc";
+    TS_ASSERT_EQUALS(btk::ParseASCIINumber_p(str, str + 3, &value), str);
+    str = "-";
+    TS_ASSERT_EQUALS(btk::ParseASCIINumber_p(str, str + 1, &value), str);
+    // The exponent is not part of the number if no digit follows.
+    str = "2e";
+    TS_ASSERT_EQUALS(btk::ParseASCIINumber_p(str, str + 2, &value), str + 1); TS_ASSERT_EQUALS(value, 2.0);
+    // The end of the range is respected.
+    str = "123456";
+    TS_ASSERT_EQUALS(btk::ParseASCIINumber_p(str, str + 3, &value), str + 3); TS_ASSERT_EQUALS(value, 123.0);
+  };
+
+  CXXTEST_TEST(ParseNumberExact)
+  {
+    srand(7);
+    char str[64];
+    for (int i = 0 ; i < 10000 ; ++i)
+    {
+      double ref = (static_cast<double>(rand()) / RAND_MAX - 0.5) * pow(10.0, rand() % 10 - 3);
+      sprintf(str, (i % 2) ? "%.5f" : "%.17g", ref);
+      ref = strtod(str, 0);
+      double value = 0.0;
+      TS_ASSERT(ASCIIFileUtilsTest_Parse(str, &value));
+      TS_ASSERT_EQUALS(value, ref);
+    }
+  };
+
+  CXXTEST_TEST(ParseField)
+  {
+    double value = 1.0;
+    const char* str = "";
+    TS_ASSERT_EQUALS(btk::ParseASCIIField_p(str, str, &value), false);
+    str = " \r";
+    TS_ASSERT_EQUALS(btk::ParseASCIIField_p(str, str + 2, &value), false);
+    str = " 42.125 ";
+    TS_ASSERT_EQUALS(btk::ParseASCIIField_p(str, str + 8, &value), true); TS_ASSERT_EQUALS(value, 42.125);
+    str = "42.1x";
+    TS_ASSERT_EQUALS(btk::ParseASCIIField_p(str, str + 5, &value), false);
+  };
+
+  CXXTEST_TEST(TokenizerLines)
+  {
+    const char* str = "first\r\n\nthird\tline\nlast";
+    btk::ASCIITokenizer_p tokenizer(str, str + strlen(str));
+    std::string line;
+    TS_ASSERT(tokenizer.NextLine(&line)); TS_ASSERT_EQUALS(line, "first");
+    TS_ASSERT(tokenizer.NextLine(&line)); TS_ASSERT_EQUALS(line, "");
+    TS_ASSERT(tokenizer.NextLine(&line)); TS_ASSERT_EQUALS(line, "third\tline");
+    TS_ASSERT(tokenizer.NextLine(&line)); TS_ASSERT_EQUALS(line, "last");
+    TS_ASSERT(!tokenizer.NextLine(&line));
+    TS_ASSERT(tokenizer.AtEnd());
+  };
+
+  CXXTEST_TEST(TokenizerFields)
+  {
+    const char* str = "1.5\t\t-2\t ";
+    btk::ASCIITokenizer_p tokenizer(str, str + strlen(str));
+    const char* first = 0;
+    const char* last = 0;
+    double value = 0.0;
+    TS_ASSERT(tokenizer.NextField('\t', &first, &last)); TS_ASSERT(btk::ParseASCIIField_p(first, last, &value)); TS_ASSERT_EQUALS(value, 1.5);
+    TS_ASSERT(tokenizer.NextField('\t', &first, &last)); TS_ASSERT_EQUALS(first, last);
+    TS_ASSERT(tokenizer.NextField('\t', &first, &last)); TS_ASSERT(btk::ParseASCIIField_p(first, last, &value)); TS_ASSERT_EQUALS(value, -2.0);
+    TS_ASSERT(tokenizer.NextField('\t', &first, &last)); TS_ASSERT(btk::IsASCIIBlankRange_p(first, last));
+    TS_ASSERT(!tokenizer.NextField('\t', &first, &last));
+  };
+
+  CXXTEST_TEST(TokenizerNumbers)
+  {
+    const char* str = "0.000\t12 -3\r\n4.5e1\n";
+    btk::ASCIITokenizer_p tokenizer(str, str + strlen(str));
+    const char* first = 0;
+    const char* last = 0;
+    double value = 0.0;
+    TS_ASSERT(tokenizer.NextToken(&first, &last)); TS_ASSERT_EQUALS(std::string(first, last), "0.000");
+    TS_ASSERT(tokenizer.NextNumber(&value)); TS_ASSERT_EQUALS(value, 12.0);
+    TS_ASSERT(tokenizer.NextNumber(&value)); TS_ASSERT_EQUALS(value, -3.0);
+    TS_ASSERT(tokenizer.NextNumber(&value)); TS_ASSERT_EQUALS(value, 45.0);
+    TS_ASSERT(!tokenizer.NextNumber(&value));
+    TS_ASSERT(tokenizer.AtEnd());
+  };
+
+  CXXTEST_TEST(FormatInteger)
+  {
+    std::string str;
+    btk::AppendASCIIInteger_p(&str, 0);
+    btk::AppendASCIIInteger_p(&str, -12);
+    btk::AppendASCIIInteger_p(&str, 2147483647);
+    btk::AppendASCIIInteger_p(&str, -2147483647 - 1);
+    TS_ASSERT_EQUALS(str, "0-122147483647-2147483648");
+  };
+
+  CXXTEST_TEST(FormatFixed)
+  {
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(0.0, 3), "0.000");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(-0.0, 2), "-0.00");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(-0.0001, 3), "-0.000");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(12.5, 0), "12");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(13.5, 0), "14");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(0.125, 2), "0.12");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(1.005, 2), "1.00"); // 1.00499999999999989...
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(0.005, 5), "0.00500");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(-987.654321, 5), "-987.65432");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(1e20, 1), "100000000000000000000.0");
+    // Same characters than the C library (and then std::ostream).
+    srand(11);
+    char str[512];
+    for (int i = 0 ; i < 20000 ; ++i)
+    {
+      double value = (static_cast<double>(rand()) / RAND_MAX - 0.5) * pow(10.0, rand() % 14 - 6);
+      if (i % 4 == 0)
+        value = floor(value * 1000.0) / 1000.0 + 0.0005; // Near ties
+      const int precision = i % 9;
+      sprintf(str, "%.*f", precision, value);
+      TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Fixed(value, precision), std::string(str));
+    }
+  };
+
+  CXXTEST_TEST(FormatGeneral)
+  {
+    std::ostringstream oss;
+    oss << 1234567.0 << " " << 0.1 << " " << -2.5e-7;
+    std::string str;
+    btk::AppendASCIIGeneral_p(&str, 1234567.0, 6);
+    str.push_back(' ');
+    btk::AppendASCIIGeneral_p(&str, 0.1, 6);
+    str.push_back(' ');
+    btk::AppendASCIIGeneral_p(&str, -2.5e-7, 6);
+    TS_ASSERT_EQUALS(str, oss.str());
+    // Same characters than the C library.
+    srand(17);
+    char buffer[64];
+    for (int i = 0 ; i < 20000 ; ++i)
+    {
+      double value = (static_cast<double>(rand()) / RAND_MAX - 0.5) * pow(10.0, rand() % 40 - 20);
+      const int precision = 1 + i % 17;
+      if (i % 3 == 0)
+        value = floor(value * 1000.0) / 1000.0 + 0.0005; // Near ties
+      sprintf(buffer, "%.*g", precision, value);
+      str.clear();
+      btk::AppendASCIIGeneral_p(&str, value, precision);
+      TS_ASSERT_EQUALS(str, std::string(buffer));
+    }
+  };
+
+  CXXTEST_TEST(FormatShortest)
+  {
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Shortest(0.1), "0.1");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Shortest(0.1 + 0.2), "0.30000000000000004");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Shortest(-1250.0), "-1250");
+    TS_ASSERT_EQUALS(ASCIIFileUtilsTest_Shortest(1e-300), "1e-300");
+    srand(13);
+    char buffer[64];
+    for (int i = 0 ; i < 10000 ; ++i)
+    {
+      double value = (static_cast<double>(rand()) / RAND_MAX - 0.5) * pow(10.0, rand() % 40 - 20);
+      if (i % 2)
+        value = static_cast<float>(value);
+      const std::string str = ASCIIFileUtilsTest_Shortest(value);
+      double v = 0.0;
+      TS_ASSERT(ASCIIFileUtilsTest_Parse(str.c_str(), &v));
+      TS_ASSERT_EQUALS(v, value);
+      // No less digits with the C library
+      int precision = 15;
+      for ( ; precision < 17 ; ++precision)
+      {
+        sprintf(buffer, "%.*g", precision, value);
+        if (strtod(buffer, 0) == value)
+          break;
+      }
+      sprintf(buffer, "%.*g", precision, value);
+      TS_ASSERT_EQUALS(str, std::string(buffer));
+    }
+  };
+
+  CXXTEST_TEST(WriteRows)
+  {
+    ASCIIFileUtilsTest_Formatter formatter;
+    std::ostringstream serial, parallel;
+    btk::WriteASCIIRows_p(&serial, &formatter, 50000, 1);
+    btk::WriteASCIIRows_p(&parallel, &formatter, 50000, 3);
+    TS_ASSERT_EQUALS(serial.str().size(), 5288890u);
+    TS_ASSERT(serial.str() == parallel.str());
+    std::ostringstream empty;
+    btk::WriteASCIIRows_p(&empty, &formatter, 0, 3);
+    TS_ASSERT(empty.str().empty());
+    std::ostringstream one;
+    btk::WriteASCIIRows_p(&one, &formatter, 1, 3);
+    TS_ASSERT_EQUALS(one.str(), "0" + std::string(100, ' ') + "\n");
+  };
+
+  CXXTEST_TEST(FileBuffer)
+  {
+    btk::ASCIIFileBuffer_p buffer;
+    TS_ASSERT(!buffer.Open(TRCFilePathOUT + "ASCIIFileUtilsNoFile.txt"));
+    TS_ASSERT(!buffer.IsOpen());
+    const std::string filename = TRCFilePathOUT + "ASCIIFileUtilsEmpty.txt";
+    std::ofstream ofs(filename.c_str(), std::ios_base::binary | std::ios_base::trunc);
+    ofs.close();
+    TS_ASSERT(buffer.Open(filename));
+    TS_ASSERT_EQUALS(buffer.End() - buffer.Begin(), 0);
+    ofs.open(filename.c_str(), std::ios_base::binary | std::ios_base::trunc);
+    ofs << "Hello\tworld\n";
+    ofs.close();
+    TS_ASSERT(buffer.Open(filename));
+    TS_ASSERT_EQUALS(std::string(buffer.Begin(), buffer.End()), "Hello\tworld\n");
+    buffer.Close();
+    TS_ASSERT(!buffer.IsOpen());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ASCIIFileUtilsTest)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, ParseNumber)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, ParseNumberExact)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, ParseField)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, TokenizerLines)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, TokenizerFields)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, TokenizerNumbers)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, FormatInteger)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, FormatFixed)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, FormatGeneral)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, FormatShortest)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, WriteRows)
+CXXTEST_TEST_REGISTRATION(ASCIIFileUtilsTest, FileBuffer)
+#endif
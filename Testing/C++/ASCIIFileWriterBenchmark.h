@@ -0,0 +1,70 @@
+#ifndef ASCIIFileWriterBenchmark_h
+#define ASCIIFileWriterBenchmark_h
+
+#include <btkASCIIFileWriter.h>
+
+#include "ASCIIFileReaderBenchmark.h"
+
+template <typename T>
+static void ASCIIFileWriterBenchmark_Write(const std::string& label, const std::string& filename, btk::Acquisition::Pointer acq, int numberOfThreads)
+{
+  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+  typename T::Pointer io = T::New();
+  io->SetNumberOfThreads(numberOfThreads);
+  writer->SetAcquisitionIO(io);
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  TDDBenchmark_Timer timer;
+  writer->Update();
+  double elapsed = timer.GetElapsed();
+  struct stat info;
+  TS_ASSERT_EQUALS(stat(filename.c_str(), &info), 0);
+  TDDBenchmark_Report(label, elapsed, static_cast<double>(info.st_size));
+};
+
+static void ASCIIFileWriterBenchmark_Export(const std::string& label, const std::string& filename, btk::Acquisition::Pointer acq, btk::ASCIIFileWriter::NumberFormat format, int numberOfThreads)
+{
+  btk::ASCIIFileWriter::Pointer writer = btk::ASCIIFileWriter::New();
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  writer->SetNumberFormat(format);
+  writer->SetNumberOfThreads(numberOfThreads);
+  TDDBenchmark_Timer timer;
+  writer->Update();
+  double elapsed = timer.GetElapsed();
+  struct stat info;
+  TS_ASSERT_EQUALS(stat(filename.c_str(), &info), 0);
+  TDDBenchmark_Report(label, elapsed, static_cast<double>(info.st_size));
+};
+
+CXXTEST_SUITE(ASCIIFileWriterBenchmark)
+{
+  CXXTEST_TEST(TRC)
+  {
+    btk::Acquisition::Pointer acq = ASCIIFileReaderBenchmark_Generate(50, 0, 10000);
+    ASCIIFileWriterBenchmark_Write<btk::TRCFileIO>("TRC write (1 thread)", TRCFilePathOUT + "bench_write.trc", acq, 1);
+    ASCIIFileWriterBenchmark_Write<btk::TRCFileIO>("TRC write (1 thread per processor)", TRCFilePathOUT + "bench_write.trc", acq, 0);
+  };
+
+  CXXTEST_TEST(ANC)
+  {
+    btk::Acquisition::Pointer acq = ASCIIFileReaderBenchmark_Generate(0, 28, 100000);
+    ASCIIFileWriterBenchmark_Write<btk::ANCFileIO>("ANC write (1 thread)", ANCFilePathOUT + "bench_write.anc", acq, 1);
+    ASCIIFileWriterBenchmark_Write<btk::ANCFileIO>("ANC write (1 thread per processor)", ANCFilePathOUT + "bench_write.anc", acq, 0);
+  };
+
+  CXXTEST_TEST(CSV)
+  {
+    btk::Acquisition::Pointer acq = ASCIIFileReaderBenchmark_Generate(20, 200, 60000);
+    ASCIIFileWriterBenchmark_Export("CSV export (general, 1 thread)", C3DFilePathOUT + "bench_export.csv", acq, btk::ASCIIFileWriter::General, 1);
+    ASCIIFileWriterBenchmark_Export("CSV export (fixed, 1 thread)", C3DFilePathOUT + "bench_export.csv", acq, btk::ASCIIFileWriter::Fixed, 1);
+    ASCIIFileWriterBenchmark_Export("CSV export (shortest, 1 thread)", C3DFilePathOUT + "bench_export.csv", acq, btk::ASCIIFileWriter::Shortest, 1);
+    ASCIIFileWriterBenchmark_Export("CSV export (general, 1 thread per processor)", C3DFilePathOUT + "bench_export.csv", acq, btk::ASCIIFileWriter::General, 0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ASCIIFileWriterBenchmark)
+CXXTEST_TEST_REGISTRATION(ASCIIFileWriterBenchmark, TRC)
+CXXTEST_TEST_REGISTRATION(ASCIIFileWriterBenchmark, ANC)
+CXXTEST_TEST_REGISTRATION(ASCIIFileWriterBenchmark, CSV)
+#endif
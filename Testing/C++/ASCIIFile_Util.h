@@ -0,0 +1,59 @@
+#ifndef ASCIIFileUtil_h
+#define ASCIIFileUtil_h
+
+#include <btkAcquisitionFileReader.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+// Writes @a content as is (binary mode) in the file @a filename and returns its name.
+inline std::string ASCIIFileUtil_WriteText(const std::string& filename, const std::string& content)
+{
+  std::ofstream ofs(filename.c_str(), std::ios_base::binary | std::ios_base::trunc);
+  ofs << content;
+  ofs.close();
+  return filename;
+};
+
+// Generates a file large enough to be parsed by several threads: the @a header followed by @a rowNumber rows.
+// The functor @a row appends the row of the given index (end of line included) to the content.
+template <typename T>
+inline std::string ASCIIFileUtil_WriteLarge(const std::string& filename, const std::string& header, int rowNumber, const T& row)
+{
+  std::string content = header;
+  for (int i = 0 ; i < rowNumber ; ++i)
+    row(i, &content);
+  return ASCIIFileUtil_WriteText(filename, content);
+};
+
+// Reads the file @a filename with the file IO @a T and the given number of threads.
+template <typename T>
+inline btk::Acquisition::Pointer ASCIIFileUtil_Read(const std::string& filename, int numberOfThreads)
+{
+  btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+  typename T::Pointer io = T::New();
+  io->SetNumberOfThreads(numberOfThreads);
+  reader->SetAcquisitionIO(io);
+  reader->SetFilename(filename);
+  reader->Update();
+  return reader->GetOutput();
+};
+
+// Checks that the points and the analog channels of @a acq are exactly the same than the ones of @a ref.
+inline void ASCIIFileUtil_Compare(btk::Acquisition::Pointer acq, btk::Acquisition::Pointer ref)
+{
+  TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), ref->GetPointFrameNumber());
+  TS_ASSERT_EQUALS(acq->GetPointNumber(), ref->GetPointNumber());
+  for (int p = 0 ; p < std::min(acq->GetPointNumber(), ref->GetPointNumber()) ; ++p)
+  {
+    TS_ASSERT(acq->GetPoint(p)->GetValues() == ref->GetPoint(p)->GetValues());
+    TS_ASSERT(acq->GetPoint(p)->GetResiduals() == ref->GetPoint(p)->GetResiduals());
+  }
+  TS_ASSERT_EQUALS(acq->GetAnalogFrameNumber(), ref->GetAnalogFrameNumber());
+  TS_ASSERT_EQUALS(acq->GetAnalogNumber(), ref->GetAnalogNumber());
+  for (int c = 0 ; c < std::min(acq->GetAnalogNumber(), ref->GetAnalogNumber()) ; ++c)
+    TS_ASSERT(acq->GetAnalog(c)->GetValues() == ref->GetAnalog(c)->GetValues());
+};
+
+#endif // ASCIIFileUtil_h
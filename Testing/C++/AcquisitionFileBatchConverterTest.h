@@ -0,0 +1,212 @@
+#ifndef AcquisitionFileBatchConverterTest_h
+#define AcquisitionFileBatchConverterTest_h
+
+#include <btkAcquisitionFileBatchConverter.h>
+
+#include "C3DFile_Util.h"
+
+#include <cstdio>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+  #include <direct.h>
+#endif
+
+class AcquisitionFileBatchConverterTest_RemoveFirstPoint : public btk::AcquisitionFileBatchConverter::Filter
+{
+public:
+  static Pointer New() {return Pointer(new AcquisitionFileBatchConverterTest_RemoveFirstPoint());};
+  virtual Pointer Clone() const {return New();};
+  virtual btk::Acquisition::Pointer Process(btk::Acquisition::Pointer input)
+  {
+    btk::Acquisition::Pointer output = input->Clone();
+    output->RemovePoint(0);
+    return output;
+  };
+};
+
+inline std::string AcquisitionFileBatchConverterTest_Filename(const std::string& prefix, int idx, const std::string& suffix)
+{
+  std::ostringstream oss;
+  oss << C3DFilePathOUT << prefix << idx << "." << suffix;
+  return oss.str();
+};
+
+// Writes @a num C3D files (numbered from @a first) and appends the conversion of each one into a new C3D file.
+inline void AcquisitionFileBatchConverterTest_AppendTasks(btk::AcquisitionFileBatchConverter::Pointer converter, btk::Acquisition::Pointer acq, int num, int first = 0)
+{
+  for (int i = first ; i < first + num ; ++i)
+  {
+    std::string input = AcquisitionFileBatchConverterTest_Filename("BatchInput", i, "c3d");
+    C3DFileUtil_WriteAcquisition(input, acq, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    converter->AppendTask(input, AcquisitionFileBatchConverterTest_Filename("BatchOutput", i, "c3d"));
+  }
+};
+
+CXXTEST_SUITE(AcquisitionFileBatchConverterTest)
+{
+  CXXTEST_TEST(Default)
+  {
+    btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+    TS_ASSERT_EQUALS(converter->GetTaskNumber(), 0);
+    TS_ASSERT_EQUALS(converter->GetNumberOfThreads(), 1);
+    TS_ASSERT(converter->GetFilter().get() == 0);
+    converter->Update();
+    TS_ASSERT_EQUALS(converter->GetReport().fileNumber, 0);
+    TS_ASSERT_EQUALS(converter->GetReport().failureNumber, 0);
+  };
+
+  CXXTEST_TEST(ConvertWithThreads)
+  {
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(1234, false);
+    btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+    AcquisitionFileBatchConverterTest_AppendTasks(converter, acq, 8);
+    converter->SetNumberOfThreads(4);
+    converter->Update();
+    const btk::AcquisitionFileBatchConverter::Report& report = converter->GetReport();
+    TS_ASSERT_EQUALS(report.fileNumber, 8);
+    TS_ASSERT_EQUALS(report.failureNumber, 0);
+    TS_ASSERT(report.inputSize > 0.0);
+    TS_ASSERT(report.outputSize > 0.0);
+    TS_ASSERT(report.GetFilesPerSecond() > 0.0);
+    for (int i = 0 ; i < converter->GetTaskNumber() ; ++i)
+    {
+      TS_ASSERT_EQUALS(converter->GetResult(i).succeeded, true);
+      TS_ASSERT_EQUALS(converter->GetResult(i).error, "");
+      btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+      reader->SetFilename(converter->GetTask(i).output);
+      reader->Update();
+      C3DFileUtil_CompareWithOriginal(reader->GetOutput(), acq);
+    }
+  };
+
+  CXXTEST_TEST(ErrorIsolation)
+  {
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(1234, false);
+    btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+    AcquisitionFileBatchConverterTest_AppendTasks(converter, acq, 2);
+    converter->AppendTask(C3DFilePathOUT + "BatchMissing.c3d", C3DFilePathOUT + "BatchMissingOutput.c3d");
+    converter->AppendTask(AcquisitionFileBatchConverterTest_Filename("BatchInput", 0, "c3d"), C3DFilePathOUT + "BatchOutput.unknown");
+    // Other outputs: two tasks must not write the same file at the same time.
+    AcquisitionFileBatchConverterTest_AppendTasks(converter, acq, 2, 2);
+    converter->SetNumberOfThreads(3);
+    converter->Update();
+    TS_ASSERT_EQUALS(converter->GetReport().fileNumber, 6);
+    TS_ASSERT_EQUALS(converter->GetReport().failureNumber, 2);
+    TS_ASSERT_EQUALS(converter->GetResult(0).succeeded, true);
+    TS_ASSERT_EQUALS(converter->GetResult(1).succeeded, true);
+    TS_ASSERT_EQUALS(converter->GetResult(2).succeeded, false);
+    TS_ASSERT(!converter->GetResult(2).error.empty());
+    TS_ASSERT_EQUALS(converter->GetResult(3).succeeded, false);
+    TS_ASSERT(!converter->GetResult(3).error.empty());
+    TS_ASSERT_EQUALS(converter->GetResult(4).succeeded, true);
+    TS_ASSERT_EQUALS(converter->GetResult(5).succeeded, true);
+  };
+
+  CXXTEST_TEST(Conflicts)
+  {
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(1234, false);
+    btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+    AcquisitionFileBatchConverterTest_AppendTasks(converter, acq, 2);
+    const std::string input0 = AcquisitionFileBatchConverterTest_Filename("BatchInput", 0, "c3d");
+    const std::string input1 = AcquisitionFileBatchConverterTest_Filename("BatchInput", 1, "c3d");
+    // Same output than the first task (written with another path).
+    converter->AppendTask(input1, C3DFilePathOUT + "./BatchOutput0.c3d");
+    // Output overwriting its own input and the input of another task.
+    converter->AppendTask(input0, input0);
+    converter->AppendTask(input0, input1);
+    converter->SetNumberOfThreads(4);
+    converter->Update();
+    TS_ASSERT_EQUALS(converter->GetReport().fileNumber, 5);
+    TS_ASSERT_EQUALS(converter->GetReport().failureNumber, 3);
+    TS_ASSERT_EQUALS(converter->GetResult(0).succeeded, true);
+    TS_ASSERT_EQUALS(converter->GetResult(1).succeeded, true);
+    for (int i = 2 ; i < 5 ; ++i)
+    {
+      TS_ASSERT_EQUALS(converter->GetResult(i).succeeded, false);
+      TS_ASSERT(!converter->GetResult(i).error.empty());
+    }
+    // The inputs are untouched.
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(input1);
+    reader->Update();
+    C3DFileUtil_CompareWithOriginal(reader->GetOutput(), acq);
+  };
+
+  CXXTEST_TEST(Filter)
+  {
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(1234, false);
+    btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+    AcquisitionFileBatchConverterTest_AppendTasks(converter, acq, 4);
+    converter->SetFilter(AcquisitionFileBatchConverterTest_RemoveFirstPoint::New());
+    converter->SetNumberOfThreads(2);
+    converter->Update();
+    TS_ASSERT_EQUALS(converter->GetReport().failureNumber, 0);
+    for (int i = 0 ; i < converter->GetTaskNumber() ; ++i)
+    {
+      btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+      reader->SetFilename(converter->GetTask(i).output);
+      reader->Update();
+      TS_ASSERT_EQUALS(reader->GetOutput()->GetPointNumber(), acq->GetPointNumber() - 1);
+    }
+  };
+
+  CXXTEST_TEST(Manifest)
+  {
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(1234, false);
+    const std::string input = AcquisitionFileBatchConverterTest_Filename("BatchInput", 0, "c3d");
+    C3DFileUtil_WriteAcquisition(input, acq, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Integer);
+    const std::string manifest = C3DFilePathOUT + "BatchManifest.txt";
+    std::ofstream ofs(manifest.c_str());
+    ofs << "# Input\tOutput\n" << input << "\t" << C3DFilePathOUT << "BatchManifest0.c3d\n\n" << input << "\t" << C3DFilePathOUT << "BatchManifest1.trc\r\n";
+    ofs.close();
+    btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+    TS_ASSERT_EQUALS(converter->AppendManifest(manifest), 2);
+    TS_ASSERT_EQUALS(converter->GetTask(1).output, C3DFilePathOUT + "BatchManifest1.trc");
+    converter->Update();
+    TS_ASSERT_EQUALS(converter->GetReport().failureNumber, 0);
+    converter->ClearTasks();
+    TS_ASSERT_EQUALS(converter->GetTaskNumber(), 0);
+  };
+
+  CXXTEST_TEST(Directory)
+  {
+    const std::string inputDirectory = C3DFilePathOUT + "BatchDirectory";
+#if defined(_WIN32)
+    _mkdir(inputDirectory.c_str());
+#else
+    mkdir(inputDirectory.c_str(), 0755);
+#endif
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(1234, false);
+    C3DFileUtil_WriteAcquisition(inputDirectory + "/A.c3d", acq, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    C3DFileUtil_WriteAcquisition(inputDirectory + "/B.c3d", acq, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    std::ofstream ofs((inputDirectory + "/Notes.txt").c_str());
+    ofs << "Not an acquisition";
+    ofs.close();
+    std::remove((inputDirectory + "/A.trc").c_str());
+    std::remove((inputDirectory + "/B.trc").c_str());
+    btk::AcquisitionFileBatchConverter::Pointer converter = btk::AcquisitionFileBatchConverter::New();
+    TS_ASSERT_EQUALS(converter->AppendDirectory(inputDirectory, inputDirectory, "trc"), 2);
+    TS_ASSERT_EQUALS(converter->GetTask(0).input, inputDirectory + "/A.c3d");
+    TS_ASSERT_EQUALS(converter->GetTask(0).output, inputDirectory + "/A.trc");
+    TS_ASSERT_EQUALS(converter->GetTask(1).output, inputDirectory + "/B.trc");
+    converter->SetNumberOfThreads(0);
+    converter->Update();
+    TS_ASSERT_EQUALS(converter->GetReport().failureNumber, 0);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(inputDirectory + "/B.trc");
+    reader->Update();
+    TS_ASSERT_EQUALS(reader->GetOutput()->GetPointNumber(), acq->GetPointNumber());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionFileBatchConverterTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchConverterTest, Default)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchConverterTest, ConvertWithThreads)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchConverterTest, ErrorIsolation)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchConverterTest, Conflicts)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchConverterTest, Filter)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchConverterTest, Manifest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchConverterTest, Directory)
+#endif
@@ -0,0 +1,116 @@
+#ifndef AcquisitionFileIOFactoryTest_h
+#define AcquisitionFileIOFactoryTest_h
+
+#include <btkAcquisitionFileIOFactory.h>
+#include <btkC3DFileIO.h>
+#include <btkTRCFileIO.h>
+#include <btkEMxFileIO.h>
+#include <btkDelsysEMGFileIO.h>
+#include <btkGRxFileIO.h>
+
+#include "ASCIIFile_Util.h"
+#include "C3DFile_Util.h"
+
+#include <limits>
+
+CXXTEST_SUITE(AcquisitionFileIOFactoryTest)
+{
+  CXXTEST_TEST(CanReadBufferC3D)
+  {
+    btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+    const char header[2] = {0x02, 0x50};
+    TS_ASSERT_EQUALS(io->CanReadBuffer(header, 2, "C3D", 512), btk::AcquisitionFileIO::ProbeAccepted);
+    TS_ASSERT_EQUALS(io->CanReadBuffer(header, 1, "C3D", 1), btk::AcquisitionFileIO::ProbeRejected);
+    TS_ASSERT_EQUALS(io->CanReadBuffer("PathFileType", 12, "C3D", 12), btk::AcquisitionFileIO::ProbeRejected);
+  };
+
+  CXXTEST_TEST(CanReadBufferTRC)
+  {
+    btk::TRCFileIO::Pointer io = btk::TRCFileIO::New();
+    TS_ASSERT_EQUALS(io->CanReadBuffer("PathFileType\t4", 14, "", 14), btk::AcquisitionFileIO::ProbeAccepted);
+    TS_ASSERT_EQUALS(io->CanReadBuffer("PathFile", 8, "TRC", 8), btk::AcquisitionFileIO::ProbeRejected);
+  };
+
+  CXXTEST_TEST(CanReadBufferExtension)
+  {
+    btk::GRxFileIO::Pointer io = btk::GRxFileIO::New();
+    TS_ASSERT_EQUALS(io->CanReadBuffer("", 0, "GR1", 0), btk::AcquisitionFileIO::ProbeAccepted);
+    TS_ASSERT_EQUALS(io->CanReadBuffer("", 0, "GR9", 0), btk::AcquisitionFileIO::ProbeAccepted);
+    TS_ASSERT_EQUALS(io->CanReadBuffer("", 0, "GR0", 0), btk::AcquisitionFileIO::ProbeRejected);
+    TS_ASSERT_EQUALS(io->CanReadBuffer("", 0, "GRF", 0), btk::AcquisitionFileIO::ProbeRejected);
+  };
+
+  CXXTEST_TEST(CreateNoFile)
+  {
+    btk::AcquisitionFileIOFactory::ClearCache();
+    TS_ASSERT(btk::AcquisitionFileIOFactory::CreateAcquisitionIO(C3DFilePathOUT + "FactoryNoFile.c3d", btk::AcquisitionFileIOFactory::ReadMode).get() == 0);
+    TS_ASSERT_EQUALS(btk::AcquisitionFileIOFactory::GetCacheSize(), 0);
+  };
+
+  CXXTEST_TEST(CreateC3D)
+  {
+    btk::AcquisitionFileIOFactory::ClearCache();
+    const std::string filename = C3DFilePathOUT + "FactoryProbe.c3d";
+    C3DFileUtil_WriteAcquisition(filename, C3DFileUtil_GenerateAcquisition(1234, false), btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(filename, btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::C3DFileIO*>(io.get()) != 0);
+    TS_ASSERT_EQUALS(btk::AcquisitionFileIOFactory::GetCacheSize(), 1);
+    // Cached
+    btk::AcquisitionFileIO::Pointer io2 = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(filename, btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::C3DFileIO*>(io2.get()) != 0);
+    TS_ASSERT(io.get() != io2.get());
+    TS_ASSERT_EQUALS(btk::AcquisitionFileIOFactory::GetCacheSize(), 1);
+    btk::AcquisitionFileIOFactory::ClearCache();
+    TS_ASSERT_EQUALS(btk::AcquisitionFileIOFactory::GetCacheSize(), 0);
+  };
+
+  CXXTEST_TEST(CreateMisleadingExtension)
+  {
+    btk::AcquisitionFileIOFactory::ClearCache();
+    const std::string filename = C3DFilePathOUT + "FactoryProbe.c3d";
+    const std::string misleading = C3DFilePathOUT + "FactoryProbeC3D.trc";
+    C3DFileUtil_WriteAcquisition(filename, C3DFileUtil_GenerateAcquisition(1234, false), btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Integer);
+    C3DFileUtil_TruncateFile(filename, misleading, std::numeric_limits<size_t>::max());
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(misleading, btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::C3DFileIO*>(io.get()) != 0);
+  };
+
+  CXXTEST_TEST(CreateExtensionFirst)
+  {
+    btk::AcquisitionFileIOFactory::ClearCache();
+    const std::string filename = C3DFilePathOUT + "FactoryProbe.emg";
+    ASCIIFileUtil_WriteText(filename, "DEMG");
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(filename, btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::DelsysEMGFileIO*>(io.get()) != 0);
+    btk::AcquisitionFileIOFactory::ClearCache();
+    ASCIIFileUtil_WriteText(filename, "BTS-EMG");
+    io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(filename, btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::EMxFileIO*>(io.get()) != 0);
+  };
+
+  CXXTEST_TEST(CreateModifiedFile)
+  {
+    btk::AcquisitionFileIOFactory::ClearCache();
+    const std::string filename = C3DFilePathOUT + "FactoryProbeModified.dat";
+    const char header[4] = {0x02, 0x50, 0x00, 0x00};
+    ASCIIFileUtil_WriteText(filename, std::string(header, 4));
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(filename, btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::C3DFileIO*>(io.get()) != 0);
+    // The size of the file changed: the cache entry is not valid anymore.
+    ASCIIFileUtil_WriteText(filename, "PathFileType\t4\t(X/Y/Z)\tFactoryProbe.trc");
+    io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(filename, btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::TRCFileIO*>(io.get()) != 0);
+    TS_ASSERT_EQUALS(btk::AcquisitionFileIOFactory::GetCacheSize(), 1);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionFileIOFactoryTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CanReadBufferC3D)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CanReadBufferTRC)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CanReadBufferExtension)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CreateNoFile)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CreateC3D)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CreateMisleadingExtension)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CreateExtensionFirst)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, CreateModifiedFile)
+#endif
@@ -0,0 +1,278 @@
+#ifndef AcquisitionFileIOStressTest_h
+#define AcquisitionFileIOStressTest_h
+
+#include <btkAcquisitionFileIOFactory.h>
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkThread_p.h>
+#include <btkConvert.h>
+
+#include "C3DFile_Util.h"
+
+#include <typeinfo>
+#include <vector>
+
+// Files read by one thread. Each thread reads all the files, starting with a different one.
+struct AcquisitionFileIOStressTest_Job
+{
+  int index;
+  int repetitions;
+  const std::vector<std::string>* filenames;
+  std::vector<btk::Acquisition::Pointer> outputs; // One per file and per repetition
+  std::vector<std::string> formats; // Type of the file IO detected for each output (empty if none)
+};
+
+// Returns the type of the file IO (empty if there is none).
+inline std::string AcquisitionFileIOStressTest_Format(btk::AcquisitionFileIO::Pointer io)
+{
+  return io ? std::string(typeid(*io).name()) : std::string();
+};
+
+inline btk::Acquisition::Pointer AcquisitionFileIOStressTest_Read(const std::string& filename, std::string* format = 0)
+{
+  btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+  btk::Acquisition::Pointer output;
+  try
+  {
+    reader->SetFilename(filename);
+    reader->Update();
+    output = reader->GetOutput();
+  }
+  catch (std::exception& )
+  {}
+  if (format != 0)
+    *format = AcquisitionFileIOStressTest_Format(reader->GetAcquisitionIO());
+  return output;
+};
+
+inline void AcquisitionFileIOStressTest_Run(void* data)
+{
+  AcquisitionFileIOStressTest_Job* job = static_cast<AcquisitionFileIOStressTest_Job*>(data);
+  const int num = static_cast<int>(job->filenames->size());
+  job->outputs.resize(num * job->repetitions);
+  job->formats.resize(num * job->repetitions);
+  for (int r = 0 ; r < job->repetitions ; ++r)
+  {
+    for (int i = 0 ; i < num ; ++i)
+    {
+      const int idx = (i + job->index) % num;
+      job->outputs[r * num + idx] = AcquisitionFileIOStressTest_Read((*job->filenames)[idx], &(job->formats[r * num + idx]));
+    }
+  }
+};
+
+template <typename T>
+inline bool AcquisitionFileIOStressTest_SameValues(const T& lhs, const T& rhs)
+{
+  if ((lhs.rows() != rhs.rows()) || (lhs.cols() != rhs.cols()))
+    return false;
+  for (int i = 0 ; i < lhs.size() ; ++i)
+  {
+    const double l = lhs.data()[i], r = rhs.data()[i];
+    if ((l != r) && !((l != l) && (r != r))) // NaN values are considered equal
+      return false;
+  }
+  return true;
+};
+
+// Returns true if the two acquisitions are identical (the same file was read twice).
+inline bool AcquisitionFileIOStressTest_Compare(btk::Acquisition::Pointer lhs, btk::Acquisition::Pointer rhs)
+{
+  if (!lhs || !rhs)
+    return false;
+  if ((lhs->GetFirstFrame() != rhs->GetFirstFrame())
+      || (lhs->GetPointFrequency() != rhs->GetPointFrequency())
+      || (lhs->GetPointFrameNumber() != rhs->GetPointFrameNumber())
+      || (lhs->GetAnalogFrameNumber() != rhs->GetAnalogFrameNumber())
+      || (lhs->GetPointNumber() != rhs->GetPointNumber())
+      || (lhs->GetAnalogNumber() != rhs->GetAnalogNumber())
+      || (lhs->GetEventNumber() != rhs->GetEventNumber()))
+    return false;
+  for (int i = 0 ; i < lhs->GetPointNumber() ; ++i)
+  {
+    btk::Point::Pointer l = lhs->GetPoint(i), r = rhs->GetPoint(i);
+    if ((l->GetLabel() != r->GetLabel()) || (l->GetType() != r->GetType())
+        || !AcquisitionFileIOStressTest_SameValues(l->GetValues(), r->GetValues())
+        || !AcquisitionFileIOStressTest_SameValues(l->GetResiduals(), r->GetResiduals()))
+      return false;
+  }
+  for (int i = 0 ; i < lhs->GetAnalogNumber() ; ++i)
+  {
+    btk::Analog::Pointer l = lhs->GetAnalog(i), r = rhs->GetAnalog(i);
+    if ((l->GetLabel() != r->GetLabel()) || (l->GetScale() != r->GetScale()) || (l->GetOffset() != r->GetOffset())
+        || !AcquisitionFileIOStressTest_SameValues(l->GetValues(), r->GetValues()))
+      return false;
+  }
+  for (int i = 0 ; i < lhs->GetEventNumber() ; ++i)
+  {
+    if (!(*(lhs->GetEvent(i)) == *(rhs->GetEvent(i))))
+      return false;
+  }
+  return (*(lhs->GetMetaData()) == *(rhs->GetMetaData()));
+};
+
+// Acquisition written with every registered writer, followed by the sample files of the readers (if available).
+inline std::vector<std::string> AcquisitionFileIOStressTest_Filenames()
+{
+  std::vector<std::string> filenames;
+  btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(500, false);
+  btk::AcquisitionFileIO::Extensions exts = btk::AcquisitionFileIOFactory::GetSupportedWrittenExtensions();
+  for (btk::AcquisitionFileIO::Extensions::ConstIterator it = exts.Begin() ; it != exts.End() ; ++it)
+  {
+    if (it->name.find('*') != std::string::npos)
+      continue;
+    const std::string filename = C3DFilePathOUT + "Stress." + it->name;
+    try
+    {
+      btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+      writer->SetInput(acq);
+      writer->SetFilename(filename);
+      writer->Update();
+      filenames.push_back(filename);
+    }
+    catch (std::exception& ) {}
+  }
+  const std::string samples[] = {
+    ANBFilePathIN + "Gait.anb",
+    ANCFilePathIN + "Gait.anc",
+    BSFFilePathIN + "Trial01868.bsf",
+    C3DFilePathIN + "sample01/Eb015pi.c3d",
+    C3DFilePathIN + "sample01/Eb015vr.c3d",
+    C3DFilePathIN + "others/Empty.c3d",
+    CALForcePlateFilePathIN + "Forcepla.cal",
+    CLBFilePathIN + "NoScale.clb",
+    DelsysEMGFilePathIN + "Set1[Rep2]_v3.emg",
+    EMFFilePathIN + "test.emf",
+    EliteFilePathIN + "1123xa01/1123xa01.ANG",
+    EliteFilePathIN + "1123xa01/1123xa01.EMG",
+    EliteFilePathIN + "1123xa01/1123xa01.GR1",
+    EliteFilePathIN + "1123xa01/1123xa01.MOM",
+    EliteFilePathIN + "1123xa01/1123xa01.PWR",
+    EliteFilePathIN + "1123xa01/1123xa01.RAH",
+    EliteFilePathIN + "1123xa01/1123xa01.RAW",
+    EliteFilePathIN + "1123xa01/1123xa01.RIC",
+    EliteFilePathIN + "BlO05.RIF",
+    HPFFilePathIN + "Run_number_34_VTT_Rep_1.6.hpf",
+    KistlerDATFilePathIN + "BioWare17.dat",
+    MDFFilePathIN + "gait-bilateral-1997-Kistlerx1.mdf",
+    TDFFilePathIN + "gait9.tdf",
+    TRBFilePathIN + "gait.trb",
+    TRCFilePathIN + "MOTEK/T.trc",
+    XLSOrthoTrakFilePathIN + "Gait.xls",
+    XMOVEFilePathIN + "ADemo1_rewrite_XMove.xml"
+  };
+  for (size_t i = 0 ; i < sizeof(samples) / sizeof(samples[0]) ; ++i)
+  {
+    std::ifstream ifs(samples[i].c_str());
+    if (ifs.is_open())
+      filenames.push_back(samples[i]);
+  }
+  return filenames;
+};
+
+CXXTEST_SUITE(AcquisitionFileIOStressTest)
+{
+  CXXTEST_TEST(ConcurrentFactory)
+  {
+    btk::AcquisitionFileIOFactory::ClearCache();
+    const std::vector<std::string> filenames = AcquisitionFileIOStressTest_Filenames();
+    const int threadNumber = 8;
+    AcquisitionFileIOStressTest_Job jobs[threadNumber];
+    btk::thread_p* threads = new btk::thread_p[threadNumber];
+    for (int i = 0 ; i < threadNumber ; ++i)
+    {
+      jobs[i].index = i;
+      jobs[i].repetitions = 1;
+      jobs[i].filenames = &filenames;
+      threads[i].Start(&AcquisitionFileIOStressTest_Run, &jobs[i]);
+    }
+    delete[] threads; // Joined
+    TS_ASSERT(btk::AcquisitionFileIOFactory::GetCacheSize() <= static_cast<int>(filenames.size()));
+    btk::AcquisitionFileIOFactory::ClearCache();
+    for (size_t j = 0 ; j < filenames.size() ; ++j)
+    {
+      // Every thread must have found the same file format than a serial detection.
+      const std::string format = AcquisitionFileIOStressTest_Format(btk::AcquisitionFileIOFactory::CreateAcquisitionIO(filenames[j], btk::AcquisitionFileIOFactory::ReadMode));
+      bool read = (jobs[0].outputs[j].get() != 0);
+      for (int i = 0 ; i < threadNumber ; ++i)
+      {
+        TSM_ASSERT_EQUALS(filenames[j], jobs[i].formats[j], format);
+        TSM_ASSERT_EQUALS(filenames[j], jobs[i].outputs[j].get() != 0, read);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(ParallelMatchesSerial)
+  {
+    const std::vector<std::string> filenames = AcquisitionFileIOStressTest_Filenames();
+    TS_ASSERT(filenames.size() >= 2); // At least the C3D and TRC writers
+    std::vector<btk::Acquisition::Pointer> serial(filenames.size());
+    for (size_t j = 0 ; j < filenames.size() ; ++j)
+      serial[j] = AcquisitionFileIOStressTest_Read(filenames[j]);
+    const int threadNumber = 6, repetitions = 3;
+    AcquisitionFileIOStressTest_Job jobs[threadNumber];
+    btk::thread_p* threads = new btk::thread_p[threadNumber];
+    for (int i = 0 ; i < threadNumber ; ++i)
+    {
+      jobs[i].index = i;
+      jobs[i].repetitions = repetitions;
+      jobs[i].filenames = &filenames;
+      threads[i].Start(&AcquisitionFileIOStressTest_Run, &jobs[i]);
+    }
+    delete[] threads; // Joined
+    int compared = 0;
+    for (size_t j = 0 ; j < filenames.size() ; ++j)
+    {
+      if (!serial[j])
+        continue;
+      ++compared;
+      for (int i = 0 ; i < threadNumber ; ++i)
+      {
+        for (int r = 0 ; r < repetitions ; ++r)
+          TSM_ASSERT(filenames[j], AcquisitionFileIOStressTest_Compare(jobs[i].outputs[r * filenames.size() + j], serial[j]));
+      }
+    }
+    TS_ASSERT(compared >= 2);
+  };
+  
+  CXXTEST_TEST(ConcurrentReadWrite)
+  {
+    // Each thread reads its own file and the main thread writes others at the same time.
+    const std::vector<std::string> filenames = AcquisitionFileIOStressTest_Filenames();
+    std::vector<std::string> inputs;
+    for (size_t j = 0 ; j < filenames.size() ; ++j)
+    {
+      if ((filenames[j].find(C3DFilePathOUT + "Stress.") == 0) && AcquisitionFileIOStressTest_Read(filenames[j]))
+        inputs.push_back(filenames[j]);
+    }
+    const int threadNumber = 4;
+    AcquisitionFileIOStressTest_Job jobs[threadNumber];
+    btk::thread_p* threads = new btk::thread_p[threadNumber];
+    for (int i = 0 ; i < threadNumber ; ++i)
+    {
+      jobs[i].index = i;
+      jobs[i].repetitions = 2;
+      jobs[i].filenames = &inputs;
+      threads[i].Start(&AcquisitionFileIOStressTest_Run, &jobs[i]);
+    }
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(2500, true);
+    for (int i = 0 ; i < 8 ; ++i)
+      C3DFileUtil_WriteAcquisition(C3DFilePathOUT + "StressWrite" + btk::ToString(i) + ".c3d", acq, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Integer);
+    delete[] threads; // Joined
+    for (int i = 0 ; i < threadNumber ; ++i)
+    {
+      for (size_t j = 0 ; j < jobs[i].outputs.size() ; ++j)
+        TS_ASSERT(jobs[i].outputs[j].get() != 0);
+    }
+    btk::Acquisition::Pointer output = AcquisitionFileIOStressTest_Read(C3DFilePathOUT + "StressWrite7.c3d");
+    TS_ASSERT(output.get() != 0);
+    if (output)
+      C3DFileUtil_CompareWithOriginal(output, acq);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionFileIOStressTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOStressTest, ConcurrentFactory)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOStressTest, ParallelMatchesSerial)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOStressTest, ConcurrentReadWrite)
+#endif
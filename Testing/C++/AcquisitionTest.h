@@ -158,6 +158,104 @@ CXXTEST_SUITE(AcquisitionTest)
     TS_ASSERT_EQUALS(test->GetPoint(1)->GetParent(), test.get());
     TS_ASSERT_EQUALS(test->GetPoint(2)->GetParent(), test.get());
   }
+  
+  CXXTEST_TEST(ContiguousPointStorage)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    TS_ASSERT_EQUALS(test->GetPointStorage(), btk::Acquisition::SeparatePointStorage);
+    TS_ASSERT_THROWS(test->GetPointValuesBlock(), btk::LogicError);
+    test->Init(4, 10, 0, 1, btk::Acquisition::ContiguousPointStorage);
+    TS_ASSERT_EQUALS(test->GetPointStorage(), btk::Acquisition::ContiguousPointStorage);
+    TS_ASSERT_EQUALS(test->GetPoint(3)->GetLabel(), "uname*4");
+    TS_ASSERT_EQUALS(test->GetPoint(3)->GetFrameNumber(), 10);
+    btk::Acquisition::PointValuesBlock& values = test->GetPointValuesBlock();
+    TS_ASSERT_EQUALS(values.rows(), 10);
+    TS_ASSERT_EQUALS(values.cols(), 12);
+    TS_ASSERT_EQUALS(test->GetPointResidualsBlock().cols(), 4);
+    for (int i = 0 ; i < values.cols() ; ++i)
+      values.col(i).setConstant(static_cast<double>(i));
+    test->GetPointResidualsBlock().col(2).setConstant(-1.0);
+    TS_ASSERT(test->GetPoint(0)->GetData()->IsLazy());
+    // Individual access
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(5,0), 3.0);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(5,2), 5.0);
+    TS_ASSERT_EQUALS(test->GetPoint(2)->GetResiduals().coeff(9), -1.0);
+    test->GetPoint(1)->GetValues().coeffRef(5,0) = 100.0;
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(5,3), 100.0);
+    TS_ASSERT(test->GetPoint(1)->GetData()->IsLazy());
+    // Mixed access: only the point accessed individually is copied back, in the same block.
+    const double* blockData = test->GetPointValuesBlock().data();
+    test->GetPoint(2)->GetValues().coeffRef(0,1) = -2.0;
+    TS_ASSERT(!test->GetPoint(2)->GetData()->IsLazy());
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().data(), blockData);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(0,7), -2.0);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(0,6), 6.0);
+    TS_ASSERT_EQUALS(test->GetPointResidualsBlock().coeff(9,2), -1.0);
+    TS_ASSERT(test->GetPoint(2)->GetData()->IsLazy());
+    // Clone
+    btk::Acquisition::Pointer clone = test->Clone();
+    TS_ASSERT_EQUALS(clone->GetPointStorage(), btk::Acquisition::ContiguousPointStorage);
+    clone->GetPointValuesBlock().setZero();
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(5,3), 100.0);
+    TS_ASSERT_EQUALS(clone->GetPoint(1)->GetValues().coeff(5,0), 0.0);
+    btk::Point::Pointer point = test->GetPoint(3)->Clone();
+    test->GetPointValuesBlock().setZero();
+    TS_ASSERT_EQUALS(point->GetValues().coeff(0,0), 9.0);
+    // Resizing
+    test->GetPointValuesBlock().col(11).setConstant(11.0);
+    test->Resize(5, 15);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().rows(), 15);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().cols(), 15);
+    TS_ASSERT_EQUALS(test->GetPoint(3)->GetValues().coeff(9,2), 11.0);
+    TS_ASSERT_EQUALS(test->GetPoint(3)->GetValues().coeff(10,2), 0.0);
+    TS_ASSERT_EQUALS(test->GetPoint(4)->GetFrameNumber(), 15);
+    test->AppendPoint(btk::Point::New("Foo", 15));
+    test->GetPoint(5)->GetValues().setConstant(6.0);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().cols(), 18);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(14,17), 6.0);
+    test->RemovePoint(0);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().cols(), 15);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(14,14), 6.0);
+    // Back to the separate storage
+    test->SetPointStorage(btk::Acquisition::SeparatePointStorage);
+    TS_ASSERT(!test->GetPoint(4)->GetData()->IsLazy());
+    TS_ASSERT_EQUALS(test->GetPoint(4)->GetValues().coeff(14,2), 6.0);
+    TS_ASSERT_EQUALS(test->GetPoint(2)->GetValues().coeff(9,2), 11.0);
+  };
+  
+  CXXTEST_TEST(ContiguousPointStorageMixedAccess)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    test->Init(3, 20, 0, 1, btk::Acquisition::ContiguousPointStorage);
+    btk::Acquisition::PointValuesBlock& values = test->GetPointValuesBlock();
+    btk::Acquisition::PointResidualsBlock& residuals = test->GetPointResidualsBlock();
+    for (int i = 0 ; i < values.cols() ; ++i)
+      values.col(i).setConstant(static_cast<double>(i));
+    // The point is only read individually: the modifications done after in the block are kept.
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(4,0), 3.0);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetResiduals().coeff(4), 0.0);
+    TS_ASSERT(!test->GetPoint(1)->GetData()->IsLazy());
+    values.coeffRef(4,3) = 42.0;
+    residuals.coeffRef(4,1) = -1.0;
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().data(), values.data());
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(4,3), 42.0);
+    TS_ASSERT_EQUALS(test->GetPointResidualsBlock().coeff(4,1), -1.0);
+    TS_ASSERT(test->GetPoint(1)->GetData()->IsLazy());
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(4,0), 42.0);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetResiduals().coeff(4), -1.0);
+    // The point is modified individually and not in the block: the point is copied back.
+    test->GetPoint(1)->GetValues().coeffRef(5,0) = 100.0;
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(5,3), 100.0);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(4,3), 42.0);
+    // Both are modified: the individual modifications are kept.
+    test->GetPoint(2)->GetValues().coeffRef(0,0) = -6.0;
+    values.coeffRef(1,6) = 1234.0;
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(0,6), -6.0);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().coeff(1,6), 6.0);
+    // The other points are not affected.
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().col(0).isConstant(0.0), true);
+    TS_ASSERT_EQUALS(test->GetPointValuesBlock().col(8).isConstant(8.0), true);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(AcquisitionTest)
@@ -172,4 +270,6 @@ CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeFromEnd)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, RemoveLastPoint)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, SetFirstFrameAdaptEvent)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeParent)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, ContiguousPointStorage)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, ContiguousPointStorageMixedAccess)
 #endif
@@ -13,9 +13,28 @@ CXXTEST_SUITE(AnalogTest)
     for (int i = 0 ; i < 5 ; ++i)
       TS_ASSERT_DELTA(cloned->GetValues().coeff(i),analog->GetValues().coeff(i),1e-15);
   };
+  
+  CXXTEST_TEST(DataCopyOnWrite)
+  {
+    btk::Analog::Pointer analog = btk::Analog::New("FZ1", 5);
+    analog->SetValues(Eigen::Matrix<double,Eigen::Dynamic,1>::Random(5,1));
+    btk::Analog::Pointer cloned = analog->Clone();
+    TS_ASSERT(cloned->GetData()->IsShared());
+    const double v = analog->GetData()->GetValues().coeff(0);
+    cloned->GetValues().coeffRef(0) = 1234.0;
+    TS_ASSERT(!cloned->GetData()->IsShared());
+    TS_ASSERT(!analog->GetData()->IsShared());
+    TS_ASSERT_EQUALS(analog->GetValues().coeff(0), v);
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(0), 1234.0);
+    btk::Analog::Pointer cloned2 = cloned->Clone();
+    cloned2->GetData()->SetValues(Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(2,1));
+    TS_ASSERT_EQUALS(cloned->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(0), 1234.0);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(AnalogTest)
 CXXTEST_TEST_REGISTRATION(AnalogTest, DataClone)  
+CXXTEST_TEST_REGISTRATION(AnalogTest, DataCopyOnWrite)
 
 #endif // Analog
\ No newline at end of file
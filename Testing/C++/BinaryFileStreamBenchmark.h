@@ -0,0 +1,86 @@
+#ifndef BinaryFileStreamBenchmark_h
+#define BinaryFileStreamBenchmark_h
+
+#include <btkBinaryFileStream.h>
+#include <cstdio>
+#include <vector>
+
+template <class Stream, typename T>
+static void BinaryFileStreamBenchmark_Compare(const std::string& label, const std::string& filename, int num, T (Stream::*read)(), void (Stream::*bulk)(size_t, T*))
+{
+  std::remove(filename.c_str());
+  Stream obfs(filename, btk::BinaryFileStream::Out);
+  for (int i = 0 ; i < num ; ++i)
+    obfs.Write(static_cast<T>((i % 2000) - 1000) / static_cast<T>(8));
+  obfs.Close();
+  
+  std::vector<T> single(num), block(num);
+  Stream ibfs(filename, btk::BinaryFileStream::In);
+  TDDBenchmark_Timer timer;
+  for (int i = 0 ; i < num ; ++i)
+    single[i] = (ibfs.*read)();
+  TDDBenchmark_Report(label + " (per element)", timer.GetElapsed(), static_cast<double>(num * sizeof(T)));
+  ibfs.SeekRead(0, btk::BinaryFileStream::Begin);
+  timer.Restart();
+  (ibfs.*bulk)(num, &block[0]);
+  TDDBenchmark_Report(label + " (bulk)", timer.GetElapsed(), static_cast<double>(num * sizeof(T)));
+  ibfs.Close();
+  std::remove(filename.c_str());
+  
+  TS_ASSERT(single == block);
+};
+
+// Writes the given number of floats value by value. The size of the file can be given before the writing.
+static void BinaryFileStreamBenchmark_Write(const std::string& label, const std::string& filename, int num, bool reserve)
+{
+  std::remove(filename.c_str());
+  TDDBenchmark_Timer timer;
+  btk::IEEELittleEndianBinaryFileStream obfs(filename, btk::BinaryFileStream::Out);
+  if (reserve)
+    obfs.Reserve(num * sizeof(float));
+  for (int i = 0 ; i < num ; ++i)
+    obfs.Write(static_cast<float>(i % 2000) / 8.0f);
+  obfs.Close();
+  TDDBenchmark_Report(label, timer.GetElapsed(), static_cast<double>(num * sizeof(float)));
+  btk::IEEELittleEndianBinaryFileStream ibfs(filename, btk::BinaryFileStream::In);
+  TS_ASSERT_EQUALS(ibfs.GetStream()->rdbuf()->size(), static_cast<std::streamsize>(num * sizeof(float)));
+  ibfs.Close();
+  std::remove(filename.c_str());
+};
+
+CXXTEST_SUITE(BinaryFileStreamBenchmark)
+{
+  CXXTEST_TEST(IEEEBigEndianI16)
+  {
+    BinaryFileStreamBenchmark_Compare<btk::IEEEBigEndianBinaryFileStream, int16_t>("IEEE BE int16", C3DFilePathOUT + "bench_i16.bin", 8000000, &btk::IEEEBigEndianBinaryFileStream::ReadI16, &btk::IEEEBigEndianBinaryFileStream::ReadI16);
+  };
+  
+  CXXTEST_TEST(IEEELittleEndianFloat)
+  {
+    BinaryFileStreamBenchmark_Compare<btk::IEEELittleEndianBinaryFileStream, float>("IEEE LE float", C3DFilePathOUT + "bench_float.bin", 4000000, &btk::IEEELittleEndianBinaryFileStream::ReadFloat, &btk::IEEELittleEndianBinaryFileStream::ReadFloat);
+  };
+  
+  CXXTEST_TEST(IEEEBigEndianFloat)
+  {
+    BinaryFileStreamBenchmark_Compare<btk::IEEEBigEndianBinaryFileStream, float>("IEEE BE float", C3DFilePathOUT + "bench_float.bin", 4000000, &btk::IEEEBigEndianBinaryFileStream::ReadFloat, &btk::IEEEBigEndianBinaryFileStream::ReadFloat);
+  };
+  
+  CXXTEST_TEST(VAXLittleEndianFloat)
+  {
+    BinaryFileStreamBenchmark_Compare<btk::VAXLittleEndianBinaryFileStream, float>("VAX LE float", C3DFilePathOUT + "bench_float.bin", 4000000, &btk::VAXLittleEndianBinaryFileStream::ReadFloat, &btk::VAXLittleEndianBinaryFileStream::ReadFloat);
+  };
+  
+  CXXTEST_TEST(WriteFloat)
+  {
+    BinaryFileStreamBenchmark_Write("IEEE LE float write (growing file)", C3DFilePathOUT + "bench_write.bin", 16000000, false);
+    BinaryFileStreamBenchmark_Write("IEEE LE float write (reserved file)", C3DFilePathOUT + "bench_write.bin", 16000000, true);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(BinaryFileStreamBenchmark)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamBenchmark, IEEEBigEndianI16)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamBenchmark, IEEELittleEndianFloat)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamBenchmark, IEEEBigEndianFloat)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamBenchmark, VAXLittleEndianFloat)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamBenchmark, WriteFloat)
+#endif
@@ -3,6 +3,82 @@
 
 #include <btkBinaryFileStream.h>
 #include <cstdio>
+#include <vector>
+
+template <class Stream>
+static void BinaryFileStreamTest_BulkRead(const std::string& filename)
+{
+  const int num = 1031; // Not a multiple of the vector width.
+  std::remove(filename.c_str());
+  Stream obfs(filename, btk::BinaryFileStream::Out);
+  for (int i = 0 ; i < num ; ++i)
+  {
+    obfs.Write(static_cast<int16_t>(i * 37 - 16000));
+    obfs.Write(static_cast<uint16_t>(i * 61));
+    obfs.Write(static_cast<int32_t>(i * 104729 - 50000000));
+    obfs.Write(static_cast<uint32_t>(i * 2654435761u));
+    obfs.Write(static_cast<float>(i - num / 2) * 0.0123f);
+  }
+  obfs.Close();
+  
+  std::vector<int16_t> i16(num), bi16(num);
+  std::vector<uint16_t> u16(num), bu16(num);
+  std::vector<int32_t> i32(num), bi32(num);
+  std::vector<uint32_t> u32(num), bu32(num);
+  std::vector<float> f(num), bf(num);
+  Stream ibfs(filename, btk::BinaryFileStream::In);
+  for (int i = 0 ; i < num ; ++i)
+  {
+    i16[i] = ibfs.ReadI16();
+    u16[i] = ibfs.ReadU16();
+    i32[i] = ibfs.ReadI32();
+    u32[i] = ibfs.ReadU32();
+    f[i] = ibfs.ReadFloat();
+  }
+  ibfs.SeekRead(0, btk::BinaryFileStream::Begin);
+  // Interleaved content: the bulk API is used with blocks of one element.
+  for (int i = 0 ; i < num ; ++i)
+  {
+    ibfs.ReadI16(1, &bi16[i]);
+    ibfs.ReadU16(1, &bu16[i]);
+    ibfs.ReadI32(1, &bi32[i]);
+    ibfs.ReadU32(1, &bu32[i]);
+    ibfs.ReadFloat(1, &bf[i]);
+  }
+  ibfs.Close();
+  for (int i = 0 ; i < num ; ++i)
+  {
+    TS_ASSERT_EQUALS(i16[i], bi16[i]);
+    TS_ASSERT_EQUALS(u16[i], bu16[i]);
+    TS_ASSERT_EQUALS(i32[i], bi32[i]);
+    TS_ASSERT_EQUALS(u32[i], bu32[i]);
+    TS_ASSERT_EQUALS(f[i], bf[i]);
+    TS_ASSERT_DELTA(f[i], static_cast<float>(i - num / 2) * 0.0123f, 1e-5);
+  }
+  
+  // Large homogeneous blocks (the vectorized path)
+  std::remove(filename.c_str());
+  obfs.Open(filename, btk::BinaryFileStream::Out);
+  for (int i = 0 ; i < num ; ++i)
+    obfs.Write(static_cast<float>(i - num / 2) * 1.5e-3f);
+  for (int i = 0 ; i < num ; ++i)
+    obfs.Write(static_cast<int16_t>(i * 37 - 16000));
+  for (int i = 0 ; i < num ; ++i)
+    obfs.Write(static_cast<uint32_t>(i * 2654435761u));
+  obfs.Close();
+  ibfs.Open(filename, btk::BinaryFileStream::In);
+  ibfs.ReadFloat(num, &bf[0]);
+  ibfs.ReadI16(num, &bi16[0]);
+  ibfs.ReadU32(num, &bu32[0]);
+  ibfs.SeekRead(0, btk::BinaryFileStream::Begin);
+  for (int i = 0 ; i < num ; ++i)
+    TS_ASSERT_EQUALS(ibfs.ReadFloat(), bf[i]);
+  for (int i = 0 ; i < num ; ++i)
+    TS_ASSERT_EQUALS(ibfs.ReadI16(), bi16[i]);
+  for (int i = 0 ; i < num ; ++i)
+    TS_ASSERT_EQUALS(ibfs.ReadU32(), bu32[i]);
+  ibfs.Close();
+};
 
 CXXTEST_SUITE(BinaryFileStreamTest)
 {
@@ -459,6 +535,89 @@ CXXTEST_SUITE(BinaryFileStreamTest)
     TS_ASSERT_EQUALS(bfs.Bad(), false);
     TS_ASSERT_EQUALS(bfs.Fail(), false);
   };
+  
+  CXXTEST_TEST(Reserve)
+  {
+    std::string filename = C3DFilePathOUT + "reserve.bin";
+    std::remove(filename.c_str());
+    btk::IEEELittleEndianBinaryFileStream obfs(filename, btk::BinaryFileStream::Out);
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    TS_ASSERT_EQUALS(obfs.Reserve(1000000), true);
+    TS_ASSERT_EQUALS(obfs.GetStream()->rdbuf()->size() > 1000000, true);
+#endif
+    for (int i = 0 ; i < 100 ; ++i)
+      obfs.Write(static_cast<int16_t>(i));
+    TS_ASSERT_EQUALS(obfs.Good(), true);
+    obfs.Close();
+    btk::IEEELittleEndianBinaryFileStream ibfs(filename, btk::BinaryFileStream::In);
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    TS_ASSERT_EQUALS(ibfs.GetStream()->rdbuf()->size(), 200);
+#endif
+    std::vector<int16_t> values = ibfs.ReadI16(100);
+    for (int i = 0 ; i < 100 ; ++i)
+      TS_ASSERT_EQUALS(values[i], i);
+  };
+  
+  CXXTEST_TEST(WriteGrowth)
+  {
+    std::string filename = C3DFilePathOUT + "growth.bin";
+    std::remove(filename.c_str());
+    btk::IEEELittleEndianBinaryFileStream obfs(filename, btk::BinaryFileStream::Out);
+    for (int i = 0 ; i < 500000 ; ++i)
+      obfs.Write(static_cast<int32_t>(i));
+    TS_ASSERT_EQUALS(obfs.Good(), true);
+    obfs.Close();
+    btk::IEEELittleEndianBinaryFileStream ibfs(filename, btk::BinaryFileStream::In);
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    TS_ASSERT_EQUALS(ibfs.GetStream()->rdbuf()->size(), 2000000);
+#endif
+    std::vector<int32_t> values = ibfs.ReadI32(500000);
+    bool equal = true;
+    for (int i = 0 ; i < 500000 ; ++i)
+      equal &= (values[i] == i);
+    TS_ASSERT_EQUALS(equal, true);
+  };
+  
+  CXXTEST_TEST(BulkReadVAXLittleEndian)
+  {
+    BinaryFileStreamTest_BulkRead<btk::VAXLittleEndianBinaryFileStream>(C3DFilePathOUT + "bulk_vax.bin");
+  };
+  
+  CXXTEST_TEST(BulkReadIEEELittleEndian)
+  {
+    BinaryFileStreamTest_BulkRead<btk::IEEELittleEndianBinaryFileStream>(C3DFilePathOUT + "bulk_ieee_le.bin");
+  };
+  
+  CXXTEST_TEST(BulkReadIEEEBigEndian)
+  {
+    BinaryFileStreamTest_BulkRead<btk::IEEEBigEndianBinaryFileStream>(C3DFilePathOUT + "bulk_ieee_be.bin");
+  };
+  
+  CXXTEST_TEST(BulkReadEOFException)
+  {
+    std::string filename = C3DFilePathOUT + "bulk_eof.bin";
+    std::remove(filename.c_str());
+    btk::IEEEBigEndianBinaryFileStream obfs(filename, btk::BinaryFileStream::Out);
+    for (int i = 0 ; i < 10 ; ++i)
+      obfs.Write(static_cast<int16_t>(i));
+    obfs.Close();
+    btk::IEEEBigEndianBinaryFileStream ibfs;
+    ibfs.SetExceptions(btk::BinaryFileStream::EndFileBit | btk::BinaryFileStream::FailBit | btk::BinaryFileStream::BadBit);
+    ibfs.Open(filename, btk::BinaryFileStream::In);
+    int16_t values[20];
+    ibfs.ReadI16(5, values);
+    for (int i = 0 ; i < 5 ; ++i)
+      TS_ASSERT_EQUALS(values[i], i);
+    for (int i = 0 ; i < 20 ; ++i)
+      values[i] = 0x1234;
+    TS_ASSERT_THROWS(ibfs.ReadI16(20, values), btk::BinaryFileStreamFailure);
+    TS_ASSERT_EQUALS(ibfs.EndFile(), true);
+    // Only the values extracted are decoded (the last one can be partially extracted).
+    for (int i = 0 ; i < 4 ; ++i)
+      TS_ASSERT_EQUALS(values[i], i + 5);
+    for (int i = 5 ; i < 20 ; ++i)
+      TS_ASSERT_EQUALS(values[i], 0x1234);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(BinaryFileStreamTest)
@@ -487,4 +646,10 @@ CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, ReadEOFException)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, Write)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, SeekWrite)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, SuperSeekWrite)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, Reserve)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, WriteGrowth)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, BulkReadVAXLittleEndian)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, BulkReadIEEELittleEndian)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, BulkReadIEEEBigEndian)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, BulkReadEOFException)
 #endif
@@ -0,0 +1,68 @@
+#ifndef C3DFileReaderBenchmark_h
+#define C3DFileReaderBenchmark_h
+
+#include <btkAcquisitionFileReader.h>
+#include <btkC3DFileIO.h>
+
+#include "C3DFile_Util.h"
+
+static btk::Acquisition::Pointer C3DFileReaderBenchmark_Read(const std::string& label, const std::string& filename, int numberOfThreads)
+{
+  btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+  btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+  io->SetNumberOfThreads(numberOfThreads);
+  reader->SetAcquisitionIO(io);
+  reader->SetFilename(filename);
+  TDDBenchmark_Timer timer;
+  reader->Update();
+  TDDBenchmark_Report(label, timer.GetElapsed());
+  return reader->GetOutput();
+};
+
+// Reads and destroys an acquisition with or without memory arena and reports the number of objects allocated in the free store.
+static void C3DFileReaderBenchmark_ReadArena(const std::string& label, const std::string& filename, bool arenaEnabled)
+{
+  unsigned long heap = btk::MemoryArena::GetHeapAllocationNumber();
+  TDDBenchmark_Timer timer;
+  for (int i = 0 ; i < 10 ; ++i)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetMemoryArenaEnabled(arenaEnabled);
+    reader->SetFilename(filename);
+    reader->Update();
+  }
+  TDDBenchmark_Report(label, timer.GetElapsed() / 10.0);
+  std::cout << " - objects allocated in the free store per reading: " << (btk::MemoryArena::GetHeapAllocationNumber() - heap) / 10 << std::flush;
+};
+
+CXXTEST_SUITE(C3DFileReaderBenchmark)
+{
+  CXXTEST_TEST(DataSectionThreads)
+  {
+    std::string filename = C3DFilePathOUT + "bench_threads.c3d";
+    C3DFileUtil_WriteAcquisition(filename, C3DFileUtil_GenerateAcquisition(200000, false), btk::AcquisitionFileIO::IEEE_BigEndian, btk::AcquisitionFileIO::Float);
+    btk::Acquisition::Pointer serial = C3DFileReaderBenchmark_Read("C3D read (1 thread)", filename, 1);
+    btk::Acquisition::Pointer parallel = C3DFileReaderBenchmark_Read("C3D read (1 thread per processor)", filename, 0);
+    for (int p = 0 ; p < serial->GetPointNumber() ; ++p)
+      TS_ASSERT(serial->GetPoint(p)->GetValues() == parallel->GetPoint(p)->GetValues());
+    for (int c = 0 ; c < serial->GetAnalogNumber() ; ++c)
+      TS_ASSERT(serial->GetAnalog(c)->GetValues() == parallel->GetAnalog(c)->GetValues());
+  };
+  
+  CXXTEST_TEST(MemoryArena)
+  {
+    std::string filename = C3DFilePathOUT + "bench_arena.c3d";
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2000, 100, 500, 1);
+    for (int i = 0 ; i < 200 ; ++i)
+      acq->AppendEvent(btk::Event::New("Foot Strike", 0.01 * i, "Right"));
+    C3DFileUtil_WriteAcquisition(filename, acq, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    C3DFileReaderBenchmark_ReadArena("C3D read and release (free store)", filename, false);
+    C3DFileReaderBenchmark_ReadArena("C3D read and release (memory arena)", filename, true);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(C3DFileReaderBenchmark)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderBenchmark, DataSectionThreads)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderBenchmark, MemoryArena)
+#endif
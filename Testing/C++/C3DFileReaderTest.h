@@ -4,6 +4,8 @@
 #include <btkAcquisitionFileReader.h>
 #include <btkC3DFileIO.h>
 
+#include "C3DFile_Util.h"
+
 CXXTEST_SUITE(C3DFileReaderTest)
 {
   CXXTEST_TEST(NoFile)
@@ -19,6 +21,14 @@ CXXTEST_SUITE(C3DFileReaderTest)
     TS_ASSERT_THROWS_EQUALS(reader->Update(), const btk::AcquisitionFileReaderException &e, e.what(), std::string("File doesn't exist\nFilename: test.c3d"));
   };
   
+  CXXTEST_TEST(MisspelledFileWithIO)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetAcquisitionIO(btk::C3DFileIO::New());
+    reader->SetFilename("test.c3d");
+    TS_ASSERT_THROWS_EQUALS(reader->Update(), const btk::AcquisitionFileReaderException &e, e.what(), std::string("File doesn't exist\nFilename: test.c3d"));
+  };
+  
   CXXTEST_TEST(Empty)
   {
     btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
@@ -654,11 +664,259 @@ CXXTEST_SUITE(C3DFileReaderTest)
     TS_ASSERT_EQUALS(acq->GetPoint(26)->GetLabel(), "AbcdeFghijk:LFIN");
 #endif
   };
+  
+  CXXTEST_TEST(DataSection_IEEELittleEndianIntegerSignedAnalog)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_IEEELittleEndian_Integer_Signed.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, false);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Integer);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_IEEELittleEndianIntegerUnsignedAnalog)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_IEEELittleEndian_Integer_Unsigned.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, true);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Integer);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_IEEELittleEndianFloat)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_IEEELittleEndian_Float.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, false);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_VAXLittleEndianIntegerSignedAnalog)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_VAXLittleEndian_Integer_Signed.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, false);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::VAX_LittleEndian, btk::AcquisitionFileIO::Integer);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_VAXLittleEndianIntegerUnsignedAnalog)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_VAXLittleEndian_Integer_Unsigned.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, true);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::VAX_LittleEndian, btk::AcquisitionFileIO::Integer);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_VAXLittleEndianFloat)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_VAXLittleEndian_Float.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, false);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::VAX_LittleEndian, btk::AcquisitionFileIO::Float);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_IEEEBigEndianIntegerSignedAnalog)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_IEEEBigEndian_Integer_Signed.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, false);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_BigEndian, btk::AcquisitionFileIO::Integer);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_IEEEBigEndianIntegerUnsignedAnalog)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_IEEEBigEndian_Integer_Unsigned.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, true);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_BigEndian, btk::AcquisitionFileIO::Integer);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_IEEEBigEndianFloat)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_IEEEBigEndian_Float.c3d";
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(2500, false);
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_BigEndian, btk::AcquisitionFileIO::Float);
+    C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename), original);
+  };
+  
+  CXXTEST_TEST(DataSection_Truncated)
+  {
+    const btk::AcquisitionFileIO::StorageFormat formats[] = {btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::Float};
+    const btk::AcquisitionFileIO::ByteOrder orders[] = {btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::VAX_LittleEndian, btk::AcquisitionFileIO::IEEE_BigEndian};
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+      {
+        std::string filename = C3DFilePathOUT + "DataSection_Full.c3d";
+        C3DFileUtil_WriteAcquisition(filename, C3DFileUtil_GenerateAcquisition(100, false), orders[j], formats[i]);
+        // One frame uses 32 words (5 points and 3 analog channels sampled 4 times).
+        const size_t dataOffset = C3DFileUtil_DataSectionOffset(filename, orders[j]);
+        const size_t frameSize = 32 * (i == 0 ? 2 : 4);
+        const size_t offsets[] = {0, 1, frameSize / 4 + 1, frameSize / 2 + 3, 50 * frameSize, 50 * frameSize + frameSize - 1};
+        for (int k = 0 ; k < 6 ; ++k)
+        {
+          C3DFileUtil_TruncateFile(filename, C3DFilePathOUT + "DataSection_Truncated.c3d", dataOffset + offsets[k]);
+          C3DFileUtil_CompareWithReference(C3DFilePathOUT + "DataSection_Truncated.c3d");
+        }
+      }
+    }
+  };
+  
+  CXXTEST_TEST(DataSection_MultiThreaded)
+  {
+    const btk::AcquisitionFileIO::StorageFormat formats[] = {btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::Float};
+    const btk::AcquisitionFileIO::ByteOrder orders[] = {btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::VAX_LittleEndian, btk::AcquisitionFileIO::IEEE_BigEndian};
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(20011, false);
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+      {
+        std::string filename = C3DFilePathOUT + "DataSection_MultiThreaded.c3d";
+        C3DFileUtil_WriteAcquisition(filename, original, orders[j], formats[i]);
+        btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+        btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+        io->SetNumberOfThreads(4);
+        reader->SetAcquisitionIO(io);
+        C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename, reader), original);
+        TS_ASSERT_EQUALS(io->GetNumberOfThreads(), 4);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(DataSection_MultiThreadedTruncated)
+  {
+    std::string filename = C3DFilePathOUT + "DataSection_Full.c3d";
+    C3DFileUtil_WriteAcquisition(filename, C3DFileUtil_GenerateAcquisition(20011, true), btk::AcquisitionFileIO::IEEE_BigEndian, btk::AcquisitionFileIO::Integer);
+    const size_t dataOffset = C3DFileUtil_DataSectionOffset(filename, btk::AcquisitionFileIO::IEEE_BigEndian);
+    // Truncation in the first, second and last ranges of frames.
+    const size_t offsets[] = {1, 64 * 1000 + 17, 64 * 6000 + 3, 64 * 19000 + 63};
+    const int threads[] = {0, 3};
+    for (int k = 0 ; k < 4 ; ++k)
+    {
+      C3DFileUtil_TruncateFile(filename, C3DFilePathOUT + "DataSection_Truncated.c3d", dataOffset + offsets[k]);
+      for (int t = 0 ; t < 2 ; ++t)
+      {
+        btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+        btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+        io->SetNumberOfThreads(threads[t]);
+        reader->SetAcquisitionIO(io);
+        C3DFileUtil_CompareWithReference(C3DFilePathOUT + "DataSection_Truncated.c3d", reader);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(LazyLoading)
+  {
+    const btk::AcquisitionFileIO::StorageFormat formats[] = {btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::Float};
+    const btk::AcquisitionFileIO::ByteOrder orders[] = {btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::VAX_LittleEndian, btk::AcquisitionFileIO::IEEE_BigEndian};
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+      {
+        btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(1234, (i == 0) && (j == 1));
+        std::string filename = C3DFilePathOUT + "LazyLoading.c3d";
+        C3DFileUtil_WriteAcquisition(filename, original, orders[j], formats[i]);
+        btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+        reader->SetLazyLoading(true);
+        reader->SetFilename(filename);
+        reader->Update();
+        btk::Acquisition::Pointer acq = reader->GetOutput();
+        TS_ASSERT(reader->GetAcquisitionIO()->GetLazyLoading());
+        TS_ASSERT_EQUALS(acq->GetPointNumber(), 5);
+        TS_ASSERT_EQUALS(acq->GetAnalogNumber(), 3);
+        TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "uname*1");
+        TS_ASSERT_EQUALS(acq->GetPoint(4)->GetFrameNumber(), 1234);
+        TS_ASSERT_EQUALS(acq->GetAnalog(2)->GetFrameNumber(), 4 * 1234);
+        for (int p = 0 ; p < 5 ; ++p)
+          TS_ASSERT(acq->GetPoint(p)->GetData()->IsLazy());
+        for (int c = 0 ; c < 3 ; ++c)
+          TS_ASSERT(acq->GetAnalog(c)->GetData()->IsLazy());
+        // Only the accessed channels are extracted.
+        TS_ASSERT_EIGEN_DELTA(acq->GetPoint(3)->GetValues(), original->GetPoint(3)->GetValues(), 0.1);
+        TS_ASSERT_EIGEN_DELTA(acq->GetAnalog(1)->GetValues(), original->GetAnalog(1)->GetValues(), 0.02);
+        TS_ASSERT(!acq->GetPoint(3)->GetData()->IsLazy());
+        TS_ASSERT(!acq->GetAnalog(1)->GetData()->IsLazy());
+        TS_ASSERT(acq->GetPoint(2)->GetData()->IsLazy());
+        TS_ASSERT(acq->GetAnalog(0)->GetData()->IsLazy());
+        btk::Acquisition::Pointer clone = acq->Clone();
+        // Same values than with the extraction of the complete data section.
+        C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename, reader), original);
+        C3DFileUtil_CompareWithOriginal(clone, original);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(ContiguousPointStorage)
+  {
+    const btk::AcquisitionFileIO::StorageFormat formats[] = {btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::Float};
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(1234, false);
+      std::string filename = C3DFilePathOUT + "ContiguousPointStorage.c3d";
+      C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_LittleEndian, formats[i]);
+      btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+      reader->SetPointStorage(btk::Acquisition::ContiguousPointStorage);
+      reader->SetFilename(filename);
+      reader->Update();
+      btk::Acquisition::Pointer acq = reader->GetOutput();
+      TS_ASSERT_EQUALS(acq->GetPointStorage(), btk::Acquisition::ContiguousPointStorage);
+      TS_ASSERT_EQUALS(acq->GetPointValuesBlock().rows(), 1234);
+      TS_ASSERT_EQUALS(acq->GetPointValuesBlock().cols(), 15);
+      TS_ASSERT_EQUALS(acq->GetPointResidualsBlock().cols(), 5);
+      for (int p = 0 ; p < 5 ; ++p)
+      {
+        TS_ASSERT_EIGEN_DELTA(acq->GetPointValuesBlock().block(0, 3 * p, 1234, 3), original->GetPoint(p)->GetValues(), 0.1);
+        TS_ASSERT(((acq->GetPointResidualsBlock().col(p).array() < 0.0) == (original->GetPoint(p)->GetResiduals().array() < 0.0)).all());
+      }
+      C3DFileUtil_CompareWithOriginal(C3DFileUtil_CompareWithReference(filename, reader), original);
+    }
+  };
+  
+  CXXTEST_TEST(MemoryArena)
+  {
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(1234, false);
+    std::string filename = C3DFilePathOUT + "MemoryArena.c3d";
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Integer);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    TS_ASSERT_EQUALS(reader->GetMemoryArenaEnabled(), false);
+    reader->SetMemoryArenaEnabled(true);
+    unsigned long heap = btk::MemoryArena::GetHeapAllocationNumber();
+    btk::Acquisition::Pointer acq = C3DFileUtil_CompareWithReference(filename, reader);
+    btk::MemoryArena::Pointer arena = acq->GetMemoryArena();
+    TS_ASSERT(arena.get() != 0);
+    TS_ASSERT(arena->GetAllocationNumber() > static_cast<size_t>(acq->GetPointNumber() + acq->GetAnalogNumber()));
+    TS_ASSERT(btk::MemoryArena::GetCurrent() == 0);
+    C3DFileUtil_CompareWithOriginal(acq, original);
+    // Only the reference acquisition is allocated in the free store.
+    TS_ASSERT(btk::MemoryArena::GetHeapAllocationNumber() - heap < arena->GetAllocationNumber());
+    reader->SetMemoryArenaEnabled(false);
+    reader->Update();
+    TS_ASSERT(reader->GetOutput()->GetMemoryArena().get() == 0);
+  };
+  
+  CXXTEST_TEST(LazyLoadingTruncated)
+  {
+    const btk::AcquisitionFileIO::StorageFormat formats[] = {btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::Float};
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      std::string filename = C3DFilePathOUT + "DataSection_Full.c3d";
+      C3DFileUtil_WriteAcquisition(filename, C3DFileUtil_GenerateAcquisition(100, false), btk::AcquisitionFileIO::IEEE_BigEndian, formats[i]);
+      const size_t dataOffset = C3DFileUtil_DataSectionOffset(filename, btk::AcquisitionFileIO::IEEE_BigEndian);
+      const size_t frameSize = 32 * (i == 0 ? 2 : 4);
+      const size_t offsets[] = {0, 1, frameSize / 4 + 1, frameSize / 2 + 3, 50 * frameSize, 50 * frameSize + frameSize - 1};
+      for (int k = 0 ; k < 6 ; ++k)
+      {
+        C3DFileUtil_TruncateFile(filename, C3DFilePathOUT + "DataSection_Truncated.c3d", dataOffset + offsets[k]);
+        btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+        reader->SetLazyLoading(true);
+        C3DFileUtil_CompareWithReference(C3DFilePathOUT + "DataSection_Truncated.c3d", reader);
+      }
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(C3DFileReaderTest)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, NoFile)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, MisspelledFile)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, MisspelledFileWithIO)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, Empty)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, Sample01_Eb015pi)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, Sample01_Eb015si)
@@ -691,5 +949,21 @@ CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, Sample28_type1)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, ParameterOverflow)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, Mocap36)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, BadParameterOffset)
-CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, UTF8)  
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, UTF8)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_IEEELittleEndianIntegerSignedAnalog)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_IEEELittleEndianIntegerUnsignedAnalog)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_IEEELittleEndianFloat)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_VAXLittleEndianIntegerSignedAnalog)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_VAXLittleEndianIntegerUnsignedAnalog)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_VAXLittleEndianFloat)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_IEEEBigEndianIntegerSignedAnalog)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_IEEEBigEndianIntegerUnsignedAnalog)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_IEEEBigEndianFloat)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_Truncated)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_MultiThreaded)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, DataSection_MultiThreadedTruncated)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, LazyLoading)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, ContiguousPointStorage)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, MemoryArena)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, LazyLoadingTruncated)
 #endif
@@ -0,0 +1,39 @@
+#ifndef C3DFileWriterBenchmark_h
+#define C3DFileWriterBenchmark_h
+
+#include <btkAcquisitionFileWriter.h>
+#include <btkC3DFileIO.h>
+
+#include "C3DFile_Util.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+static void C3DFileWriterBenchmark_Write(const std::string& label, const std::string& filename, btk::Acquisition::Pointer acq, btk::AcquisitionFileIO::StorageFormat storageFormat)
+{
+  std::remove(filename.c_str());
+  TDDBenchmark_Timer timer;
+  C3DFileUtil_WriteAcquisition(filename, acq, btk::AcquisitionFileIO::IEEE_LittleEndian, storageFormat);
+  double elapsed = timer.GetElapsed();
+  struct stat info;
+  TS_ASSERT_EQUALS(stat(filename.c_str(), &info), 0);
+  TDDBenchmark_Report(label, elapsed, static_cast<double>(info.st_size));
+};
+
+CXXTEST_SUITE(C3DFileWriterBenchmark)
+{
+  CXXTEST_TEST(DataSection)
+  {
+    btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(400000, false);
+    C3DFileWriterBenchmark_Write("C3D write (float)", C3DFilePathOUT + "bench_write_float.c3d", acq, btk::AcquisitionFileIO::Float);
+    C3DFileWriterBenchmark_Write("C3D write (integer)", C3DFilePathOUT + "bench_write_integer.c3d", acq, btk::AcquisitionFileIO::Integer);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathOUT + "bench_write_float.c3d");
+    reader->Update();
+    C3DFileUtil_CompareWithOriginal(reader->GetOutput(), acq);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(C3DFileWriterBenchmark)
+CXXTEST_TEST_REGISTRATION(C3DFileWriterBenchmark, DataSection)
+#endif
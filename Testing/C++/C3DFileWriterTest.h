@@ -6,6 +6,8 @@
 #include <btkC3DFileIO.h>
 #include <btkConvert.h>
 
+#include "C3DFile_Util.h"
+
 CXXTEST_SUITE(C3DFileWriterTest)
 {
   CXXTEST_TEST(NoFileNoInput)
@@ -1864,6 +1866,54 @@ CXXTEST_SUITE(C3DFileWriterTest)
     
     TS_ASSERT(acq->GetAnalog(0)->GetValues().cwiseAbs().maxCoeff() <= 1e-5);
   };
+
+  CXXTEST_TEST(BlockEncoding)
+  {
+    const btk::AcquisitionFileIO::ByteOrder byteOrders[3] = {btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::VAX_LittleEndian, btk::AcquisitionFileIO::IEEE_BigEndian};
+    const btk::AcquisitionFileIO::StorageFormat storageFormats[2] = {btk::AcquisitionFileIO::Float, btk::AcquisitionFileIO::Integer};
+    for (int u = 0 ; u < 2 ; ++u)
+    {
+      // More than one block of frames is encoded.
+      btk::Acquisition::Pointer acq = C3DFileUtil_GenerateAcquisition(12345, u == 1);
+      for (int i = 0 ; i < 3 ; ++i)
+      {
+        for (int j = 0 ; j < 2 ; ++j)
+        {
+          const std::string filename = C3DFilePathOUT + "BlockEncoding.c3d";
+          C3DFileUtil_WriteAcquisition(filename, acq, byteOrders[i], storageFormats[j]);
+          // The words written are checked with the value by value extraction.
+          btk::Acquisition::Pointer output = C3DFileUtil_CompareWithReference(filename);
+          C3DFileUtil_CompareWithOriginal(output, acq);
+        }
+      }
+    }
+  };
+  
+  CXXTEST_TEST(LazyLoadingOverwriteSameFile)
+  {
+    btk::Acquisition::Pointer original = C3DFileUtil_GenerateAcquisition(5000, false);
+    const std::string filename = C3DFilePathOUT + "LazyLoadingOverwrite.c3d";
+    C3DFileUtil_WriteAcquisition(filename, original, btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetLazyLoading(true);
+    reader->SetFilename(filename);
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    // Only one channel is extracted before the writing: the others are still read from the mapped file.
+    acq->GetPoint(1)->GetValues();
+    TS_ASSERT(acq->GetPoint(0)->GetData()->IsLazy());
+    TS_ASSERT(acq->GetAnalog(2)->GetData()->IsLazy());
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(filename);
+    writer->Update();
+    TS_ASSERT(!acq->GetPoint(0)->GetData()->IsLazy());
+    TS_ASSERT(!acq->GetAnalog(2)->GetData()->IsLazy());
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(filename);
+    reader2->Update();
+    C3DFileUtil_CompareWithOriginal(reader2->GetOutput(), original);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(C3DFileWriterTest)
@@ -1909,4 +1959,6 @@ CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, InternalsUpdateUpdateMetaDataBased)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, InternalsUpdateUpdateMetaDataBased_EventsHeader)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, AnalogOffsetStoredAsReal_12Bits)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, AnalogOffsetStoredAsReal_16Bits)
+CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, BlockEncoding)
+CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, LazyLoadingOverwriteSameFile)
 #endif
@@ -0,0 +1,170 @@
+#ifndef C3DFileUtil_h
+#define C3DFileUtil_h
+
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkBinaryFileStream.h>
+#include <btkC3DFileIO.h>
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// Creates a synthetic acquisition with occluded markers and scaled analog channels.
+inline btk::Acquisition::Pointer C3DFileUtil_GenerateAcquisition(int frameNumber, bool unsignedAnalog)
+{
+  const int pointNumber = 5, analogNumber = 3, numberSamplesPerAnalogChannel = 4;
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(pointNumber, frameNumber, analogNumber, numberSamplesPerAnalogChannel);
+  acq->SetPointFrequency(100.0);
+  for (int p = 0 ; p < pointNumber ; ++p)
+  {
+    btk::Point::Pointer point = acq->GetPoint(p);
+    for (int f = 0 ; f < frameNumber ; ++f)
+    {
+      point->GetValues().coeffRef(f,0) = 250.0 * sin(0.01 * f + p);
+      point->GetValues().coeffRef(f,1) = 120.0 * cos(0.02 * f - p) + 10.0 * p;
+      point->GetValues().coeffRef(f,2) = 900.0 + 0.5 * (f % 1000) - 30.0 * p;
+      point->GetResiduals().coeffRef(f) = ((f + p) % 7 == 0) ? -1.0 : 0.1 * ((f + 3 * p) % 50);
+    }
+  }
+  for (int c = 0 ; c < analogNumber ; ++c)
+  {
+    btk::Analog::Pointer analog = acq->GetAnalog(c);
+    analog->SetScale(0.005 * (c + 1));
+    analog->SetOffset(unsignedAnalog ? 2048.0 : 0.0);
+    for (int i = 0 ; i < analog->GetFrameNumber() ; ++i)
+      analog->GetValues().coeffRef(i) = 5.0 * (c + 1) * sin(0.003 * i + c);
+  }
+  if (unsignedAnalog)
+  {
+    btk::MetaData::Pointer analog = btk::MetaData::New("ANALOG");
+    analog->AppendChild(btk::MetaData::New("FORMAT", std::vector<std::string>(1, "UNSIGNED")));
+    acq->GetMetaData()->AppendChild(analog);
+  }
+  return acq;
+};
+
+inline void C3DFileUtil_WriteAcquisition(const std::string& filename, btk::Acquisition::Pointer acq, btk::AcquisitionFileIO::ByteOrder byteOrder, btk::AcquisitionFileIO::StorageFormat storageFormat)
+{
+  btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+  io->SetByteOrder(byteOrder);
+  io->SetStorageFormat(storageFormat);
+  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+  writer->SetAcquisitionIO(io);
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  writer->Update();
+};
+
+// Copies only the first @a size bytes of the file @a in to simulate a corrupted file.
+inline void C3DFileUtil_TruncateFile(const std::string& in, const std::string& out, size_t size)
+{
+  std::ifstream ifs(in.c_str(), std::ios_base::binary);
+  std::vector<char> buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  ifs.close();
+  std::ofstream ofs(out.c_str(), std::ios_base::binary | std::ios_base::trunc);
+  ofs.write(&(buffer[0]), std::min(size, buffer.size()));
+  ofs.close();
+};
+
+inline btk::BinaryFileStream* C3DFileUtil_OpenStream(const std::string& filename, btk::AcquisitionFileIO::ByteOrder byteOrder)
+{
+  if (byteOrder == btk::AcquisitionFileIO::VAX_LittleEndian)
+    return new btk::VAXLittleEndianBinaryFileStream(filename, btk::BinaryFileStream::In);
+  else if (byteOrder == btk::AcquisitionFileIO::IEEE_BigEndian)
+    return new btk::IEEEBigEndianBinaryFileStream(filename, btk::BinaryFileStream::In);
+  return new btk::IEEELittleEndianBinaryFileStream(filename, btk::BinaryFileStream::In);
+};
+
+// Returns the position (in bytes) of the data section (header word 09).
+inline size_t C3DFileUtil_DataSectionOffset(const std::string& filename, btk::AcquisitionFileIO::ByteOrder byteOrder)
+{
+  btk::BinaryFileStream* bfs = C3DFileUtil_OpenStream(filename, byteOrder);
+  bfs->SeekRead(16, btk::BinaryFileStream::Begin);
+  size_t offset = 512 * (bfs->ReadU16() - 1);
+  delete bfs;
+  return offset;
+};
+
+// Extracts the data section value by value (as done originally by the C3DFileIO class) to give a reference.
+inline btk::Acquisition::Pointer C3DFileUtil_ReadReferenceData(const std::string& filename, btk::C3DFileIO::Pointer io, btk::Acquisition::Pointer acq)
+{
+  btk::BinaryFileStream* bfs = C3DFileUtil_OpenStream(filename, io->GetByteOrder());
+  bfs->SetExceptions(btk::BinaryFileStream::EndFileBit | btk::BinaryFileStream::FailBit | btk::BinaryFileStream::BadBit);
+  const bool isFloat = (io->GetStorageFormat() == btk::AcquisitionFileIO::Float);
+  const bool isUnsigned = (io->GetAnalogIntegerFormat() == btk::C3DFileIO::Unsigned);
+  const double scale = io->GetPointScale();
+  const int frameNumber = acq->GetPointFrameNumber(), numSamples = acq->GetNumberAnalogSamplePerFrame();
+  btk::Acquisition::Pointer ref = btk::Acquisition::New();
+  ref->Init(acq->GetPointNumber(), frameNumber, acq->GetAnalogNumber(), numSamples);
+  bfs->SeekRead(C3DFileUtil_DataSectionOffset(filename, io->GetByteOrder()), btk::BinaryFileStream::Begin);
+  try
+  {
+    for (int f = 0 ; f < frameNumber ; ++f)
+    {
+      for (int p = 0 ; p < ref->GetPointNumber() ; ++p)
+      {
+        double* values = ref->GetPoint(p)->GetValues().data();
+        for (int i = 0 ; i < 3 ; ++i)
+          values[f + i * frameNumber] = isFloat ? bfs->ReadFloat() : bfs->ReadI16() * scale;
+        int16_t residualAndMask = isFloat ? static_cast<int16_t>(bfs->ReadFloat()) : bfs->ReadI16();
+        double residual = static_cast<double>(static_cast<int8_t>(residualAndMask & 0xFF)) * scale;
+        ref->GetPoint(p)->GetResiduals().coeffRef(f) = (residualAndMask >= 0) ? (isFloat ? fabs(residual) : residual) : -1.0;
+      }
+      for (int s = 0 ; s < numSamples ; ++s)
+      {
+        for (int c = 0 ; c < ref->GetAnalogNumber() ; ++c)
+        {
+          double raw = isFloat ? bfs->ReadFloat() : (isUnsigned ? static_cast<double>(bfs->ReadU16()) : static_cast<double>(bfs->ReadI16()));
+          ref->GetAnalog(c)->GetValues().coeffRef(f * numSamples + s) = (raw - io->GetAnalogZeroOffset()[c]) * io->GetAnalogChannelScale()[c] * io->GetAnalogUniversalScale();
+        }
+      }
+    }
+  }
+  catch (btk::BinaryFileStreamFailure& )
+  {}
+  delete bfs;
+  return ref;
+};
+
+// Reads the file with the given reader and checks that the extracted data are exactly the same than the reference.
+inline btk::Acquisition::Pointer C3DFileUtil_CompareWithReference(const std::string& filename, btk::AcquisitionFileReader::Pointer reader)
+{
+  reader->SetFilename(filename);
+  reader->Update();
+  btk::Acquisition::Pointer acq = reader->GetOutput();
+  btk::C3DFileIO::Pointer io = static_pointer_cast<btk::C3DFileIO>(reader->GetAcquisitionIO());
+  btk::Acquisition::Pointer ref = C3DFileUtil_ReadReferenceData(filename, io, acq);
+  TS_ASSERT_EQUALS(acq->GetPointNumber(), ref->GetPointNumber());
+  TS_ASSERT_EQUALS(acq->GetAnalogNumber(), ref->GetAnalogNumber());
+  for (int p = 0 ; p < acq->GetPointNumber() ; ++p)
+  {
+    TS_ASSERT(acq->GetPoint(p)->GetValues() == ref->GetPoint(p)->GetValues());
+    TS_ASSERT(acq->GetPoint(p)->GetResiduals() == ref->GetPoint(p)->GetResiduals());
+  }
+  for (int c = 0 ; c < acq->GetAnalogNumber() ; ++c)
+    TS_ASSERT(acq->GetAnalog(c)->GetValues() == ref->GetAnalog(c)->GetValues());
+  return acq;
+};
+
+inline btk::Acquisition::Pointer C3DFileUtil_CompareWithReference(const std::string& filename)
+{
+  return C3DFileUtil_CompareWithReference(filename, btk::AcquisitionFileReader::New());
+};
+
+// Checks the extracted data against the original acquisition (only the quantization error is accepted).
+inline void C3DFileUtil_CompareWithOriginal(btk::Acquisition::Pointer acq, btk::Acquisition::Pointer original)
+{
+  TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), original->GetPointFrameNumber());
+  for (int p = 0 ; p < acq->GetPointNumber() ; ++p)
+  {
+    TS_ASSERT_EIGEN_DELTA(acq->GetPoint(p)->GetValues(), original->GetPoint(p)->GetValues(), 0.1);
+    TS_ASSERT(((acq->GetPoint(p)->GetResiduals().array() < 0.0) == (original->GetPoint(p)->GetResiduals().array() < 0.0)).all());
+  }
+  for (int c = 0 ; c < acq->GetAnalogNumber() ; ++c)
+    TS_ASSERT_EIGEN_DELTA(acq->GetAnalog(c)->GetValues(), original->GetAnalog(c)->GetValues(), 0.02);
+};
+
+#endif // C3DFileUtil_h
@@ -0,0 +1,49 @@
+#ifndef EigenFiltFiltBenchmark_h
+#define EigenFiltFiltBenchmark_h
+
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+#include <btkConvert.h>
+
+// 64 EMG channels and 6 force components sampled at 2 kHz during one minute.
+static void EigenFiltFiltBenchmark_Run(int order, double wn)
+{
+  Eigen::Matrix<double,Eigen::Dynamic,1> a,b;
+  btkEigen::butter(&b, &a, order, wn);
+  Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Random(120000, 70);
+  const double bytes = static_cast<double>(x.size() * sizeof(double));
+  const std::string suffix = " (order " + btk::ToString(order) + ", 70 x 120000 samples)";
+  
+  TDDBenchmark_Timer timer;
+  Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> ref = btkEigen::filtfilt(b, a, x);
+  TDDBenchmark_Report("filtfilt" + suffix, timer.GetElapsed(), bytes);
+  
+  timer.Restart();
+  Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y1 = btkEigen::filtfilt_batch(b, a, x, 1);
+  TDDBenchmark_Report("filtfilt_batch, 1 thread" + suffix, timer.GetElapsed(), bytes);
+  
+  timer.Restart();
+  Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y0 = btkEigen::filtfilt_batch(b, a, x, 0);
+  TDDBenchmark_Report("filtfilt_batch, all threads" + suffix, timer.GetElapsed(), bytes);
+  
+  TS_ASSERT(y1.isApprox(ref, 1e-10));
+  TS_ASSERT(y0 == y1);
+};
+
+CXXTEST_SUITE(EigenFiltFiltBenchmark)
+{
+  CXXTEST_TEST(Butterworth2)
+  {
+    EigenFiltFiltBenchmark_Run(2, 0.02);
+  };
+  
+  CXXTEST_TEST(Butterworth6)
+  {
+    EigenFiltFiltBenchmark_Run(6, 0.1);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenFiltFiltBenchmark)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltBenchmark, Butterworth2)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltBenchmark, Butterworth6)
+#endif
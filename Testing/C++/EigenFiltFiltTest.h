@@ -123,13 +123,63 @@ CXXTEST_SUITE(EigenFiltFiltTest)
       TSM_ASSERT_DELTA("Row #" + btk::ToString(i), signal(i), ref(i), 5e-15); // 5e-15: Due to the differences in the computation of the initial state of the filter?
     }
   }
+  
+  CXXTEST_TEST(FiltFiltBatch_Butterworth)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> a,b;
+    btkEigen::butter(&b, &a, 4, 0.1);
+    // 4, 5 and 1 channels: one full group, one group and a partial one, a partial group only.
+    const int cols[3] = {4, 5, 1};
+    for (int k = 0 ; k < 3 ; ++k)
+    {
+      Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Random(300, cols[k]);
+      Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> ref = btkEigen::filtfilt(b, a, x);
+      Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y = btkEigen::filtfilt_batch(b, a, x);
+      TS_ASSERT_EQUALS(y.rows(), 300);
+      TS_ASSERT_EQUALS(y.cols(), cols[k]);
+      for (int j = 0 ; j < y.cols() ; ++j)
+        for (int i = 0 ; i < y.rows() ; ++i)
+          TSM_ASSERT_DELTA("Sample #" + btk::ToString(i) + " of the column #" + btk::ToString(j), y.coeff(i,j), ref.coeff(i,j), 1e-13);
+    }
+  };
+  
+  CXXTEST_TEST(FiltFiltBatch_Order2)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x(16,3);
+    x.col(0) << 1.0, 1.2, 1.4, 1.6, 1.8, 2.0, 2.2, 2.4, 2.6, 2.8, 3.0, 3.2, 3.4, 3.6, 3.8, 4.0;
+    x.col(1) = -x.col(0);
+    x.col(2).setConstant(5.0);
+    Eigen::Matrix<double, 2, 1> b; b << 1.0, -1.0;
+    Eigen::Matrix<double, 2, 1> a; a << 1.0, -0.995;
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> ref = btkEigen::filtfilt(b, a, x);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y = btkEigen::filtfilt_batch(b, a, x, 2);
+    for (int j = 0 ; j < 3 ; ++j)
+      for (int i = 0 ; i < 16 ; ++i)
+        TS_ASSERT_DELTA(y.coeff(i,j), ref.coeff(i,j), 1e-13);
+  };
+  
+  CXXTEST_TEST(FiltFiltBatch_Threads)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> a,b;
+    btkEigen::butter(&b, &a, 2, 0.25);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Random(1000, 70);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y1 = btkEigen::filtfilt_batch(b, a, x, 1);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y4 = btkEigen::filtfilt_batch(b, a, x, 4);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y0 = btkEigen::filtfilt_batch(b, a, x, 0);
+    TS_ASSERT(y1 == y4);
+    TS_ASSERT(y1 == y0);
+  };
 };
 
+
 CXXTEST_SUITE_REGISTRATION(EigenFiltFiltTest)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, Butterworth_LowPass_2_0Dot5)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, Butterworth_LowPass_7_0Dot4)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltWindowAverage_FixedSize)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltOrder2_FixedSize)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltECG_FixedSize)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltBatch_Butterworth)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltBatch_Order2)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltBatch_Threads)
 
 #endif // EigenFiltFiltTest_h
\ No newline at end of file
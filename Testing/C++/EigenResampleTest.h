@@ -0,0 +1,106 @@
+#ifndef EigenResampleTest_h
+#define EigenResampleTest_h
+
+#include <btkEigen/SignalProcessing/Resample.h>
+#include <btkConvert.h>
+
+inline Eigen::Matrix<double,Eigen::Dynamic,1> EigenResampleTest_Sine(int n, double rate, double frequency, double phase = 0.0)
+{
+  Eigen::Matrix<double,Eigen::Dynamic,1> x(n);
+  for (int i = 0 ; i < n ; ++i)
+    x.coeffRef(i) = std::sin(2.0 * M_PI * frequency * static_cast<double>(i) / rate + phase);
+  return x;
+};
+
+CXXTEST_SUITE(EigenResampleTest)
+{
+  CXXTEST_TEST(Firwin)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> h;
+    TS_ASSERT_EQUALS(btkEigen::firwin(&h, 41, 0.25), true);
+    TS_ASSERT_EQUALS(h.rows(), 41);
+    TS_ASSERT_DELTA(h.sum(), 1.0, 1e-15);
+    for (int i = 0 ; i < 20 ; ++i)
+      TSM_ASSERT_DELTA("Coefficient #" + btk::ToString(i), h.coeff(i), h.coeff(40-i), 1e-15);
+    TS_ASSERT_EQUALS(h.maxCoeff(), h.coeff(20));
+    TS_ASSERT_EQUALS(btkEigen::firwin(&h, 41, 0.0), false);
+    TS_ASSERT_EQUALS(btkEigen::firwin(&h, 41, 1.5), false);
+  };
+  
+  CXXTEST_TEST(OutputLength)
+  {
+    btkEigen::PolyphaseResampler r(120, 1000);
+    TS_ASSERT_EQUALS(r.GetUp(), 3);
+    TS_ASSERT_EQUALS(r.GetDown(), 25);
+    TS_ASSERT_EQUALS(r.GetOutputLength(1000), 120);
+    TS_ASSERT_EQUALS(r.GetOutputLength(1001), 121);
+    TS_ASSERT_EQUALS(r.GetOutputLength(0), 0);
+    TS_ASSERT_EQUALS(btkEigen::PolyphaseResampler(2,1).GetOutputLength(7), 14);
+  };
+  
+  CXXTEST_TEST(Identity)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = Eigen::Matrix<double,Eigen::Dynamic,1>::Random(50);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y = btkEigen::resample_poly(x, 4, 4);
+    TS_ASSERT_EQUALS(y.rows(), 50);
+    for (int i = 0 ; i < 50 ; ++i)
+      TSM_ASSERT_EQUALS("Sample #" + btk::ToString(i), y.coeff(i), x.coeff(i));
+  };
+  
+  CXXTEST_TEST(Constant)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = Eigen::Matrix<double,Eigen::Dynamic,1>::Constant(1000, 2.5);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y = btkEigen::resample_poly(x, 3, 25);
+    TS_ASSERT_EQUALS(y.rows(), 120);
+    for (int i = 0 ; i < y.rows() ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), 2.5, 2.5e-3);
+  };
+  
+  CXXTEST_TEST(LowFrequency_1000To120)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x(2000,2);
+    x.col(0) = EigenResampleTest_Sine(2000, 1000.0, 5.0);
+    x.col(1) = EigenResampleTest_Sine(2000, 1000.0, 12.0, 0.3);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y = btkEigen::resample_poly(x, 120, 1000);
+    TS_ASSERT_EQUALS(y.rows(), 240);
+    TS_ASSERT_EQUALS(y.cols(), 2);
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref0 = EigenResampleTest_Sine(240, 120.0, 5.0);
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref1 = EigenResampleTest_Sine(240, 120.0, 12.0, 0.3);
+    // The edges are affected by the extension of the signal.
+    for (int i = 20 ; i < 220 ; ++i)
+    {
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i,0), ref0.coeff(i), 5e-3);
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i,1), ref1.coeff(i), 5e-3);
+    }
+  };
+  
+  CXXTEST_TEST(AntiAliasing)
+  {
+    // 450 Hz would be folded at 30 Hz by a simple decimation.
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenResampleTest_Sine(4000, 1000.0, 450.0);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y = btkEigen::resample_poly(x, 1, 10);
+    TS_ASSERT_EQUALS(y.rows(), 400);
+    for (int i = 20 ; i < 380 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), 0.0, 1e-2);
+  };
+  
+  CXXTEST_TEST(Upsample)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenResampleTest_Sine(200, 100.0, 3.0);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> y = btkEigen::resample_poly(x, 5, 2);
+    TS_ASSERT_EQUALS(y.rows(), 500);
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref = EigenResampleTest_Sine(500, 250.0, 3.0);
+    for (int i = 50 ; i < 450 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), ref.coeff(i), 5e-3);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenResampleTest)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, Firwin)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, OutputLength)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, Identity)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, Constant)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, LowFrequency_1000To120)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, AntiAliasing)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, Upsample)
+#endif
@@ -0,0 +1,107 @@
+#ifndef LoggerTest_h
+#define LoggerTest_h
+
+#include <btkLogger.h>
+#include <btkConvert.h>
+
+#include <sstream>
+
+static int LoggerTest_MessageNumber = 0;
+
+inline std::string LoggerTest_Message()
+{
+  ++LoggerTest_MessageNumber;
+  return "Built message";
+};
+
+// Redirects the warnings into a string stream and restores the previous settings at the end.
+class LoggerTest_Capture
+{
+public:
+  LoggerTest_Capture(btk::Logger::VerboseMode mode)
+  {
+    this->m_Mode = btk::Logger::GetVerboseMode();
+    this->m_Stream = btk::Logger::GetWarningStream();
+    btk::Logger::SetVerboseMode(mode);
+    btk::Logger::SetWarningStream(&(this->m_Output));
+  };
+  ~LoggerTest_Capture()
+  {
+    btk::Logger::SetAsynchronous(false);
+    btk::Logger::SetWarningStream(this->m_Stream);
+    btk::Logger::SetVerboseMode(this->m_Mode);
+  };
+  std::string GetText() const {return this->m_Output.str();};
+private:
+  btk::Logger::VerboseMode m_Mode;
+  btk::Logger::Stream::Pointer m_Stream;
+  std::ostringstream m_Output;
+};
+
+CXXTEST_SUITE(LoggerTest)
+{
+  CXXTEST_TEST(QuietMacro)
+  {
+    LoggerTest_MessageNumber = 0;
+    {
+      LoggerTest_Capture capture(btk::Logger::Quiet);
+      btkWarningMacro(LoggerTest_Message());
+      btkWarningMacro("Foo.c3d", LoggerTest_Message());
+      TS_ASSERT_EQUALS(LoggerTest_MessageNumber, 0);
+      TS_ASSERT_EQUALS(capture.GetText(), "");
+    }
+    {
+      LoggerTest_Capture capture(btk::Logger::MessageOnly);
+      btkWarningMacro("/path/to/Foo.c3d", LoggerTest_Message());
+      TS_ASSERT_EQUALS(LoggerTest_MessageNumber, 1);
+      TS_ASSERT_EQUALS(capture.GetText(), "Foo.c3d - Built message\n");
+    }
+  };
+  
+  CXXTEST_TEST(ThreadTag)
+  {
+    LoggerTest_Capture capture(btk::Logger::Normal);
+    TS_ASSERT_EQUALS(btk::Logger::GetThreadTag(), "");
+    {
+      btk::Logger::ThreadTag tag("Foo.c3d");
+      btk::Logger::Warning("First");
+      {
+        btk::Logger::ThreadTag tag2("Bar.trc");
+        TS_ASSERT_EQUALS(btk::Logger::GetThreadTag(), "Bar.trc");
+        btk::Logger::Warning("Second");
+      }
+      TS_ASSERT_EQUALS(btk::Logger::GetThreadTag(), "Foo.c3d");
+    }
+    TS_ASSERT_EQUALS(btk::Logger::GetThreadTag(), "");
+    btk::Logger::Warning("Third");
+    TS_ASSERT_EQUALS(capture.GetText(), "[BTK WARNING] [Foo.c3d] First\n[BTK WARNING] [Bar.trc] Second\n[BTK WARNING] Third\n");
+  };
+  
+  CXXTEST_TEST(Asynchronous)
+  {
+    LoggerTest_Capture capture(btk::Logger::MessageOnly);
+    TS_ASSERT_EQUALS(btk::Logger::GetAsynchronous(), false);
+    btk::Logger::SetAsynchronous(true);
+    TS_ASSERT_EQUALS(btk::Logger::GetAsynchronous(), true);
+    std::ostringstream expected;
+    // More messages than the capacity of the ring buffer.
+    for (int i = 0 ; i < 5000 ; ++i)
+    {
+      btk::Logger::Warning(btk::ToString(i));
+      expected << i << "\n";
+    }
+    btk::Logger::Flush();
+    TS_ASSERT_EQUALS(capture.GetText(), expected.str());
+    btk::Logger::Warning("Last");
+    btk::Logger::SetAsynchronous(false);
+    TS_ASSERT_EQUALS(btk::Logger::GetAsynchronous(), false);
+    btk::Logger::Warning("Synchronous");
+    TS_ASSERT_EQUALS(capture.GetText(), expected.str() + "Last\nSynchronous\n");
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(LoggerTest)
+CXXTEST_TEST_REGISTRATION(LoggerTest, QuietMacro)
+CXXTEST_TEST_REGISTRATION(LoggerTest, ThreadTag)
+CXXTEST_TEST_REGISTRATION(LoggerTest, Asynchronous)
+#endif
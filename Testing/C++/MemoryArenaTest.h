@@ -0,0 +1,88 @@
+#ifndef MemoryArenaTest_h
+#define MemoryArenaTest_h
+
+#include <btkMemoryArena.h>
+#include <btkAcquisition.h>
+#include <btkMetaDataInfo.h>
+
+CXXTEST_SUITE(MemoryArenaTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New(1024);
+    TS_ASSERT_EQUALS(arena->GetBlockSize(), 1024u);
+    TS_ASSERT_EQUALS(arena->GetBlockNumber(), 0u);
+    TS_ASSERT_EQUALS(arena->GetReservedBytes(), 0u);
+    TS_ASSERT_EQUALS(arena->GetAllocatedBytes(), 0u);
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 0u);
+  };
+  
+  CXXTEST_TEST(Allocate)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New(1024);
+    char* ptr1 = static_cast<char*>(arena->Allocate(10));
+    char* ptr2 = static_cast<char*>(arena->Allocate(20));
+    TS_ASSERT_EQUALS(ptr2 - ptr1, 16);
+    TS_ASSERT_EQUALS(reinterpret_cast<size_t>(ptr2) % 16, 0u);
+    TS_ASSERT_EQUALS(arena->GetBlockNumber(), 1u);
+    TS_ASSERT_EQUALS(arena->GetAllocatedBytes(), 48u);
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 2u);
+    arena->Allocate(1000);
+    TS_ASSERT_EQUALS(arena->GetBlockNumber(), 2u);
+    arena->Allocate(4000);
+    TS_ASSERT_EQUALS(arena->GetBlockNumber(), 3u);
+    TS_ASSERT_EQUALS(arena->GetReservedBytes(), 2048u + 4000u);
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 4u);
+  };
+  
+  CXXTEST_TEST(Scope)
+  {
+    TS_ASSERT(btk::MemoryArena::GetCurrent() == 0);
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New();
+    {
+      btk::MemoryArena::Scope scope(arena);
+      TS_ASSERT_EQUALS(btk::MemoryArena::GetCurrent(), arena.get());
+      {
+        btk::MemoryArena::Pointer none;
+        btk::MemoryArena::Scope scope2(none);
+        TS_ASSERT(btk::MemoryArena::GetCurrent() == 0);
+      }
+      TS_ASSERT_EQUALS(btk::MemoryArena::GetCurrent(), arena.get());
+    }
+    TS_ASSERT(btk::MemoryArena::GetCurrent() == 0);
+  };
+  
+  CXXTEST_TEST(ObjectAllocation)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New();
+    btk::Acquisition::Pointer acq;
+    unsigned long heap = btk::MemoryArena::GetHeapAllocationNumber();
+    {
+      btk::MemoryArena::Scope scope(arena);
+      acq = btk::Acquisition::New();
+      acq->Init(10, 20, 5, 2);
+      acq->AppendEvent(btk::Event::New("FOO", 1.2));
+      acq->GetMetaData()->AppendChild(btk::MetaData::New("BAR", std::vector<std::string>(3, "test")));
+    }
+    TS_ASSERT_EQUALS(btk::MemoryArena::GetHeapAllocationNumber(), heap);
+    TS_ASSERT(arena->GetAllocationNumber() > 20u);
+    btk::Point::Pointer point = btk::Point::New(20);
+    TS_ASSERT_EQUALS(btk::MemoryArena::GetHeapAllocationNumber(), heap + 2);
+    // The objects allocated in the arena can outlive the acquisition and the arena's pointer.
+    btk::Analog::Pointer analog = acq->GetAnalog(2);
+    btk::MetaDataInfo::Pointer info = acq->GetMetaData()->GetChild("BAR")->GetInfo();
+    acq.reset();
+    arena.reset();
+    analog->SetLabel("Analog");
+    TS_ASSERT_EQUALS(analog->GetLabel(), "Analog");
+    TS_ASSERT_EQUALS(analog->GetFrameNumber(), 40);
+    TS_ASSERT_EQUALS(info->ToString(2), "test");
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MemoryArenaTest)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, Constructor)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, Allocate)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, Scope)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, ObjectAllocation)
+#endif
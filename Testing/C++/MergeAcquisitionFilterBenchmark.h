@@ -0,0 +1,65 @@
+#ifndef MergeAcquisitionFilterBenchmark_h
+#define MergeAcquisitionFilterBenchmark_h
+
+#include <btkMergeAcquisitionFilter.h>
+#include <btkConvert.h>
+
+// Synthetic acquisition with @a pointNumber points, @a analogNumber analog channels and @a eventNumber events.
+// The events use 100 labels and are spread over the frames and two contexts.
+static btk::Acquisition::Pointer MergeAcquisitionFilterBenchmark_Generate(int firstFrame, int frameNumber, int pointNumber, int analogNumber, int eventNumber)
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(pointNumber, frameNumber, analogNumber, 1);
+  acq->SetFirstFrame(firstFrame);
+  acq->SetPointFrequency(100.0);
+  int idx = 0;
+  for (btk::Acquisition::PointIterator it = acq->BeginPoint() ; it != acq->EndPoint() ; ++it)
+    (*it)->SetLabel("P" + btk::ToString(idx++));
+  idx = 0;
+  for (btk::Acquisition::AnalogIterator it = acq->BeginAnalog() ; it != acq->EndAnalog() ; ++it)
+    (*it)->SetLabel("A" + btk::ToString(idx++));
+  for (int i = 0 ; i < eventNumber ; ++i)
+  {
+    const int frame = firstFrame + i / 200;
+    acq->AppendEvent(btk::Event::New("E" + btk::ToString(i % 100), frame, ((i / 100) % 2) ? "Left" : "Right", btk::Event::Manual, "", "", i % 100));
+  }
+  return acq;
+};
+
+static void MergeAcquisitionFilterBenchmark_Run(const std::string& label, btk::Acquisition::Pointer acq1, btk::Acquisition::Pointer acq2, int pointNumber, int eventNumber)
+{
+  btk::MergeAcquisitionFilter::Pointer merger = btk::MergeAcquisitionFilter::New();
+  merger->SetInput(0, acq1);
+  merger->SetInput(1, acq2);
+  TDDBenchmark_Timer timer;
+  merger->Update();
+  TDDBenchmark_Report(label, timer.GetElapsed());
+  TS_ASSERT_EQUALS(merger->GetOutput()->GetPointNumber(), pointNumber);
+  TS_ASSERT_EQUALS(merger->GetOutput()->GetEventNumber(), eventNumber);
+};
+
+CXXTEST_SUITE(MergeAcquisitionFilterBenchmark)
+{
+  CXXTEST_TEST(Concat)
+  {
+    // Same labels and same frames: every point is renamed and half of the events are duplicates.
+    btk::Acquisition::Pointer acq1 = MergeAcquisitionFilterBenchmark_Generate(1, 250, 10000, 100, 50000);
+    btk::Acquisition::Pointer acq2 = MergeAcquisitionFilterBenchmark_Generate(1, 250, 10000, 100, 50000);
+    for (int i = 0 ; i < 25000 ; ++i)
+      acq2->GetEvent(i)->SetSubject("Other");
+    MergeAcquisitionFilterBenchmark_Run("Merge (concat, 10k points, 50k events)", acq1, acq2, 20000, 75000);
+  };
+  
+  CXXTEST_TEST(Merge)
+  {
+    // Consecutive frames with the same labels: the data are merged and no event is duplicated.
+    btk::Acquisition::Pointer acq1 = MergeAcquisitionFilterBenchmark_Generate(1, 250, 10000, 100, 50000);
+    btk::Acquisition::Pointer acq2 = MergeAcquisitionFilterBenchmark_Generate(251, 250, 10000, 100, 50000);
+    MergeAcquisitionFilterBenchmark_Run("Merge (merge, 10k points, 50k events)", acq1, acq2, 10000, 100000);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MergeAcquisitionFilterBenchmark)
+CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterBenchmark, Concat)
+CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterBenchmark, Merge)
+#endif
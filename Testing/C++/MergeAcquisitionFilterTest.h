@@ -191,6 +191,40 @@ CXXTEST_SUITE(MergeAcquisitionFilterTest)
     }
   };
   
+  CXXTEST_TEST(TwoInputsFromScratch_Events)
+  {
+    btk::Acquisition::Pointer i1 = btk::Acquisition::New();
+    i1->Init(2, 50);
+    i1->SetPointFrequency(100);
+    i1->AppendEvent(btk::Event::New("Foot Strike", 10, "Right", btk::Event::Manual, "Bob", "", 1));
+    i1->AppendEvent(btk::Event::New("Foot Off", 20, "Right", btk::Event::Manual, "Bob", "", 2));
+    
+    btk::Acquisition::Pointer i2 = btk::Acquisition::New();
+    i2->Init(2, 50);
+    i2->SetPointFrequency(100);
+    i2->AppendEvent(btk::Event::New("Foot Strike", 10, "Right", btk::Event::Manual, "Bob", "", 7)); // Duplicate
+    i2->AppendEvent(btk::Event::New("Foot Strike", 10, "Left", btk::Event::Manual, "Bob", "", 7));
+    i2->AppendEvent(btk::Event::New("Foot Off", 30, "Right", btk::Event::Manual, "Bob", "", 8));
+    i2->AppendEvent(btk::Event::New("General", 40, "General", btk::Event::Manual, "Bob", "", 9));
+    i2->AppendEvent(btk::Event::New("General", 45, "General", btk::Event::Manual, "Bob", "", 10));
+    i2->AppendEvent(btk::Event::New("General", 45, "General", btk::Event::Manual, "Bob", "", 11)); // Duplicate
+    
+    btk::MergeAcquisitionFilter::Pointer merger = btk::MergeAcquisitionFilter::New();
+    merger->SetInput(0, i1);
+    merger->SetInput(1, i2);
+    merger->Update();
+    btk::Acquisition::Pointer output = merger->GetOutput();
+    TS_ASSERT_EQUALS(output->GetEventNumber(), 6);
+    TS_ASSERT_EQUALS(output->GetEvent(2)->GetContext(), "Left");
+    TS_ASSERT_EQUALS(output->GetEvent(2)->GetId(), 1);
+    TS_ASSERT_EQUALS(output->GetEvent(3)->GetFrame(), 30);
+    TS_ASSERT_EQUALS(output->GetEvent(3)->GetId(), 2);
+    TS_ASSERT_EQUALS(output->GetEvent(4)->GetId(), 9);
+    TS_ASSERT_EQUALS(output->GetEvent(5)->GetFrame(), 45);
+    TS_ASSERT_EQUALS(output->GetEvent(5)->GetId(), 9);
+    TS_ASSERT_DELTA(output->GetEvent(5)->GetTime(), 0.44, 1e-15);
+  };
+  
   CXXTEST_TEST(TwinsFromFile_Concat)
   {
     btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
@@ -1879,6 +1913,7 @@ CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwoInputsFromScratch_First
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwoInputsFromScratch_FirstFrame2)
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwoInputsFromScratch_Merging1)
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwoInputsFromScratch_Merging2)
+CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwoInputsFromScratch_Events)
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwinsFromFile_Concat)
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwinsFromFile_Concat2)
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwinsFromFile_Merge)
@@ -601,6 +601,54 @@ CXXTEST_SUITE(MetaDataInfoTest)
 
   };
   
+  CXXTEST_TEST(ViewNumeric)
+  {
+    std::vector<uint8_t> dim = std::vector<uint8_t>(2, 3);
+    std::vector<int16_t> val = std::vector<int16_t>(9, 0);
+    for (int i = 0 ; i < 9 ; ++i)
+      val[i] = static_cast<int16_t>(i * 10);
+    btk::MetaDataInfo::Pointer test = btk::MetaDataInfo::New(dim, val);
+    btk::MetaDataInfo::View<int16_t> view = test->GetIntegerView();
+    TS_ASSERT_EQUALS(view.GetSize(), 9);
+    TS_ASSERT_EQUALS(test->GetValueNumber(), 9);
+    for (int i = 0 ; i < 9 ; ++i)
+      TS_ASSERT_EQUALS(view[i], i * 10);
+    TS_ASSERT_EQUALS(view.GetData(), static_cast<int16_t*>(test->GetValue(0)));
+    TS_ASSERT(test->GetByteView().IsEmpty());
+    TS_ASSERT(test->GetRealView().IsEmpty());
+    TS_ASSERT(test->GetCharView().IsEmpty());
+    test->SetDimension(1, 2);
+    view = test->GetIntegerView();
+    TS_ASSERT_EQUALS(view.GetSize(), 6);
+    for (int i = 0 ; i < 6 ; ++i)
+      TS_ASSERT_EQUALS(view[i], i * 10);
+  };
+  
+  CXXTEST_TEST(ViewChar)
+  {
+    std::vector<std::string> val(3);
+    val[0] = "A"; val[1] = "BCD"; val[2] = "EF";
+    btk::MetaDataInfo::Pointer test = btk::MetaDataInfo::New(val);
+    TS_ASSERT_EQUALS(test->GetCharWidth(), 3);
+    TS_ASSERT_EQUALS(test->GetValueNumber(), 3);
+    btk::MetaDataInfo::View<char> view = test->GetCharView();
+    TS_ASSERT_EQUALS(view.GetSize(), 9);
+    TS_ASSERT_EQUALS(std::string(view.Begin(), view.End()), "A  BCDEF ");
+    btk::MetaDataInfo::View<char> str = test->GetCharView(1);
+    TS_ASSERT_EQUALS(std::string(str.GetData(), str.GetSize()), "BCD");
+    TS_ASSERT(test->GetCharView(3).IsEmpty());
+    test->SetValue(0, std::string("GHIJ"));
+    TS_ASSERT_EQUALS(test->GetDimension(0), 4);
+    TS_ASSERT_EQUALS(test->GetCharWidth(), 4);
+    view = test->GetCharView();
+    TS_ASSERT_EQUALS(std::string(view.Begin(), view.End()), "GHIJBCD EF  ");
+    TS_ASSERT_EQUALS(*static_cast<std::string*>(test->GetValue(2)), "EF  ");
+    test->SetDimension(0, 2);
+    TS_ASSERT_EQUALS(test->ToString(0), "GH");
+    TS_ASSERT_EQUALS(test->ToString(1), "BC");
+    TS_ASSERT_EQUALS(test->ToString(2), "EF");
+  };
+  
   CXXTEST_TEST(Clone)
   {
     btk::MetaDataInfo::Pointer test = btk::MetaDataInfo::New((float)1.435);
@@ -912,6 +960,8 @@ CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, SetDimensionForFloat)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, ResizeDimensionsFrom0To1Byte)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, ResizeDimensionsFrom3To1Float)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, ResizeDimensionsFrom1To0Char)
+CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, ViewNumeric)
+CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, ViewChar)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, Clone)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, Equality)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, String2String)
@@ -2,6 +2,7 @@
 #define PointCollectionTest_h
 
 #include <btkPointCollection.h>
+#include <btkConvert.h>
 
 CXXTEST_SUITE(PointCollectionTest)
 {
@@ -37,6 +38,69 @@ CXXTEST_SUITE(PointCollectionTest)
     test->Clear();
     TS_ASSERT_EQUALS(test->GetTimestamp(), t1);
   };
+  
+  CXXTEST_TEST(GetItemOutOfRange)
+  {
+    btk::PointCollection::Pointer test = btk::PointCollection::New();
+    test->SetItemNumber(2);
+    TS_ASSERT_THROWS(test->GetItem(-1), btk::OutOfRangeException);
+    TS_ASSERT_THROWS(test->GetItem(2), btk::OutOfRangeException);
+  };
+  
+  CXXTEST_TEST(FindItem)
+  {
+    btk::PointCollection::Pointer test = btk::PointCollection::New();
+    for (int i = 0 ; i < 50 ; ++i)
+      test->InsertItem(test->End(), btk::Point::New("uname*" + btk::ToString(i + 1), 10));
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*1"), 0);
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*50"), 49);
+    TS_ASSERT_EQUALS(test->GetIndexOf("Foo"), -1);
+    TS_ASSERT(test->FindItem("Foo") == test->End());
+    TS_ASSERT_EQUALS((*test->FindItem("uname*25"))->GetLabel(), "uname*25");
+    // Appended item
+    test->InsertItem(test->End(), btk::Point::New("Foo", 10));
+    TS_ASSERT_EQUALS(test->GetIndexOf("Foo"), 50);
+    // Duplicated label: the first one is returned
+    test->InsertItem(test->End(), btk::Point::New("uname*2", 10));
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*2"), 1);
+    // Inserted item
+    test->InsertItem(0, btk::Point::New("Bar", 10));
+    TS_ASSERT_EQUALS(test->GetIndexOf("Bar"), 0);
+    TS_ASSERT_EQUALS(test->GetIndexOf("Foo"), 51);
+    // Removed item
+    test->RemoveItem(1);
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*1"), -1);
+    TS_ASSERT_EQUALS(test->GetIndexOf("Foo"), 50);
+    test->RemoveItem(test->FindItem("uname*2"));
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*2"), 50);
+    // Replaced item
+    test->SetItem(2, btk::Point::New("Toto", 10));
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*4"), -1);
+    TS_ASSERT_EQUALS(test->GetIndexOf("Toto"), 2);
+    // Renamed item
+    test->GetItem(10)->SetLabel("Titi");
+    TS_ASSERT_EQUALS(test->GetIndexOf("Titi"), 10);
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*12"), -1);
+    test->GetItem(10)->SetLabel("uname*12");
+    TS_ASSERT_EQUALS(test->GetIndexOf("Titi"), -1);
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*12"), 10);
+    // Item renamed in another collection
+    btk::PointCollection::Pointer other = btk::PointCollection::New();
+    other->InsertItem(btk::Point::New("Bar2", 10));
+    other->InsertItem(test->GetItem(20));
+    TS_ASSERT_EQUALS(other->GetIndexOf("uname*22"), 1);
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*22"), 20);
+    other->GetItem(1)->SetLabel("Tata");
+    TS_ASSERT_EQUALS(test->GetIndexOf("Tata"), 20);
+    TS_ASSERT_EQUALS(test->GetIndexOf("uname*22"), -1);
+    TS_ASSERT_EQUALS(other->GetIndexOf("Tata"), 1);
+    // Cleared collection
+    test->Clear();
+    TS_ASSERT_EQUALS(test->GetIndexOf("Foo"), -1);
+    test->SetItemNumber(3);
+    test->SetItem(1, btk::Point::New("Foo", 10));
+    TS_ASSERT_EQUALS(test->GetIndexOf("Foo"), 1);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(PointCollectionTest)
@@ -44,4 +108,6 @@ CXXTEST_TEST_REGISTRATION(PointCollectionTest, Constructor)
 CXXTEST_TEST_REGISTRATION(PointCollectionTest, InsertItem)
 CXXTEST_TEST_REGISTRATION(PointCollectionTest, ClearModified)
 CXXTEST_TEST_REGISTRATION(PointCollectionTest, ClearNotModified)
+CXXTEST_TEST_REGISTRATION(PointCollectionTest, GetItemOutOfRange)
+CXXTEST_TEST_REGISTRATION(PointCollectionTest, FindItem)
 #endif
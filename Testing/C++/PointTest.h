@@ -3,6 +3,29 @@
 
 #include <btkPoint.h>
 
+// Fills the point with the frame index and counts the number of loadings.
+class PointTestLoader : public btk::Point::Data::Loader
+{
+public:
+  PointTestLoader(int frameNumber, int* counter) : m_FrameNumber(frameNumber), mp_Counter(counter) {};
+  virtual int GetFrameNumber() const {return this->m_FrameNumber;};
+  virtual void Load(btk::MeasureData<btk::Point>* data)
+  {
+    btk::Point::Data* pointData = static_cast<btk::Point::Data*>(data);
+    pointData->GetValues().resize(this->m_FrameNumber, 3);
+    pointData->GetResiduals().resize(this->m_FrameNumber);
+    for (int i = 0 ; i < this->m_FrameNumber ; ++i)
+    {
+      pointData->GetValues().row(i).setConstant(static_cast<double>(i));
+      pointData->GetResiduals().coeffRef(i) = 0.5;
+    }
+    ++(*this->mp_Counter);
+  };
+private:
+  int m_FrameNumber;
+  int* mp_Counter;
+};
+
 CXXTEST_SUITE(PointTest)
 {
   CXXTEST_TEST(Constructor)
@@ -64,6 +87,106 @@ CXXTEST_SUITE(PointTest)
       TS_ASSERT_DELTA(cloned->GetValues().coeff(i),point->GetValues().coeff(i),1e-15);
   };
   
+  CXXTEST_TEST(DataCopyOnWrite)
+  {
+    btk::Point::Pointer point = btk::Point::New("HEEL_R", 5);
+    point->SetValues(Eigen::Matrix<double,Eigen::Dynamic,3>::Random(5,3));
+    point->SetResiduals(btk::Point::Residuals::Constant(5,0.5));
+    btk::Point::ConstPointer cloned = point->Clone();
+    TS_ASSERT(point->GetData()->IsShared());
+    TS_ASSERT_EQUALS(cloned->GetValues().data(), static_cast<btk::Point::ConstPointer>(point)->GetValues().data());
+    TS_ASSERT_EQUALS(cloned->GetResiduals().data(), static_cast<btk::Point::ConstPointer>(point)->GetResiduals().data());
+    const double x = cloned->GetValues().coeff(2,0);
+    // The first mutable access detaches the values (but not the residuals).
+    point->GetValues().coeffRef(2,0) = 1234.0;
+    TS_ASSERT(!point->GetData()->IsShared());
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(2,0), x);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(2,0), 1234.0);
+    TS_ASSERT_EQUALS(cloned->GetResiduals().data(), static_cast<btk::Point::ConstPointer>(point)->GetResiduals().data());
+    point->GetResiduals().coeffRef(1) = -1.0;
+    TS_ASSERT_EQUALS(cloned->GetResiduals().coeff(1), 0.5);
+    // Resizing a shared data
+    btk::Point::Pointer cloned2 = point->Clone();
+    cloned2->SetFrameNumber(3);
+    TS_ASSERT_EQUALS(point->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(cloned2->GetValues().coeff(2,0), 1234.0);
+    TS_ASSERT_EQUALS(cloned2->GetResiduals().coeff(1), -1.0);
+    cloned2->SetFrameNumber(10);
+    TS_ASSERT_EQUALS(cloned2->GetValues().coeff(2,0), 1234.0);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(2,0), 1234.0);
+    // Values set on a shared data
+    btk::Point::Pointer cloned3 = point->Clone();
+    point->SetValues(btk::Point::Values::Zero(5,3));
+    TS_ASSERT_EQUALS(cloned3->GetValues().coeff(2,0), 1234.0);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(2,0), 0.0);
+  };
+  
+  CXXTEST_TEST(DataReferenceKeptAfterClone)
+  {
+    btk::Point::Pointer point = btk::Point::New("HEEL_R", 5);
+    btk::Point::Values& values = point->GetValues();
+    btk::Point::Residuals& residuals = point->GetResiduals();
+    values.setConstant(1.0);
+    // The clone has its own values as the references could be used to modify the point.
+    btk::Point::ConstPointer cloned = point->Clone();
+    TS_ASSERT(!point->GetData()->IsShared());
+    values.coeffRef(2,0) = 1234.0;
+    residuals.coeffRef(2) = -1.0;
+    TS_ASSERT_EQUALS(point->GetValues().coeff(2,0), 1234.0);
+    TS_ASSERT_EQUALS(point->GetResiduals().coeff(2), -1.0);
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(2,0), 1.0);
+    TS_ASSERT_EQUALS(cloned->GetResiduals().coeff(2), 0.0);
+    // The values of the clone were never given by a mutable reference.
+    btk::Point::Pointer cloned2 = cloned->Clone();
+    TS_ASSERT(cloned->GetData()->IsShared());
+    // The values filled by a loader are shared too.
+    int counter = 0;
+    btk::Point::Data::Pointer data = btk::Point::Data::New(0);
+    data->SetLoader(btk::Point::Data::Loader::Pointer(new PointTestLoader(50, &counter)));
+    TS_ASSERT_EQUALS(static_cast<btk::Point::Data::ConstPointer>(data)->GetValues().coeff(49,2), 49.0);
+    btk::Point::Data::Pointer data2 = data->Clone();
+    TS_ASSERT(data->IsShared());
+    TS_ASSERT_EQUALS(static_cast<btk::Point::Data::ConstPointer>(data2)->GetResiduals().data(), static_cast<btk::Point::Data::ConstPointer>(data)->GetResiduals().data());
+  };
+  
+  CXXTEST_TEST(DataValuesPointer)
+  {
+    btk::Point::Pointer point = btk::Point::New("HEEL_R", 5);
+    point->GetValues().setConstant(1.0);
+    btkSharedPtr<btk::Point::Values> values = point->GetData()->GetValuesPointer();
+    btkSharedPtr<btk::Point::Residuals> residuals = point->GetData()->GetResidualsPointer();
+    // The pointers do not force a copy of the values.
+    TS_ASSERT(!point->GetData()->IsShared());
+    point->GetValues().coeffRef(2,0) = 2.0;
+    TS_ASSERT_EQUALS(values->coeff(2,0), 2.0);
+    values->coeffRef(3,1) = 3.0;
+    TS_ASSERT_EQUALS(point->GetValues().coeff(3,1), 3.0);
+    // A clone gets its own copy: the pointers still follow the original values.
+    btk::Point::Pointer cloned = point->Clone();
+    TS_ASSERT(!point->GetData()->IsShared());
+    point->GetValues().coeffRef(4,2) = 4.0;
+    point->GetResiduals().coeffRef(1) = 0.5;
+    TS_ASSERT_EQUALS(values->coeff(4,2), 4.0);
+    TS_ASSERT_EQUALS(residuals->coeff(1), 0.5);
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(4,2), 1.0);
+    TS_ASSERT_EQUALS(cloned->GetResiduals().coeff(1), 0.0);
+    // Values assigned in place.
+    point->SetValues(btk::Point::Values::Constant(5,3,6.0));
+    point->SetResiduals(btk::Point::Residuals::Constant(5,0.25));
+    TS_ASSERT_EQUALS(values->coeff(4,2), 6.0);
+    TS_ASSERT_EQUALS(residuals->coeff(1), 0.25);
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(4,2), 1.0);
+    point->GetValues().coeffRef(2,0) = 2.0;
+    point->GetValues().coeffRef(4,2) = 4.0;
+    // Replaced values: the pointer keeps the old ones.
+    point->SetFrameNumber(10);
+    point->GetValues().coeffRef(2,0) = 5.0;
+    TS_ASSERT_EQUALS(values->rows(), 5);
+    TS_ASSERT_EQUALS(values->coeff(2,0), 2.0);
+    point.reset();
+    TS_ASSERT_EQUALS(values->coeff(4,2), 4.0);
+  };
+  
   CXXTEST_TEST(EigenDataFromMap)
   {
     double data[12] = {1.0,2.0,3.0,4.0,5.0,6.0,7.0,8.0,9.0,10.0,11.0,12.0};
@@ -109,6 +232,30 @@ CXXTEST_SUITE(PointTest)
     TS_ASSERT_EQUALS(data[8], 0.0);
     TS_ASSERT_EQUALS(data[10], 0.0);
   };
+  
+  CXXTEST_TEST(LazyData)
+  {
+    int counter = 0;
+    btk::Point::Pointer test = btk::Point::New("HEEL_R");
+    btk::Point::Data::Pointer data = btk::Point::Data::New(0);
+    data->SetLoader(btk::Point::Data::Loader::Pointer(new PointTestLoader(50, &counter)));
+    test->SetData(data);
+    TS_ASSERT_EQUALS(test->GetFrameNumber(), 50);
+    TS_ASSERT(data->IsLazy());
+    btk::Point::Pointer clone = test->Clone();
+    TS_ASSERT(clone->GetData()->IsLazy());
+    TS_ASSERT_EQUALS(counter, 0);
+    TS_ASSERT_EQUALS(test->GetResiduals().coeff(49), 0.5);
+    TS_ASSERT_EQUALS(test->GetValues().coeff(49,2), 49.0);
+    TS_ASSERT(!data->IsLazy());
+    TS_ASSERT(clone->GetData()->IsLazy());
+    TS_ASSERT_EQUALS(counter, 1);
+    clone->SetFrameNumber(60);
+    TS_ASSERT_EQUALS(counter, 2);
+    TS_ASSERT_EQUALS(clone->GetValues().coeff(49,0), 49.0);
+    TS_ASSERT_EQUALS(clone->GetValues().coeff(59,0), 0.0);
+    TS_ASSERT_EQUALS(clone->GetResiduals().coeff(10), 0.5);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(PointTest)
@@ -117,8 +264,12 @@ CXXTEST_TEST_REGISTRATION(PointTest, FrameNumber)
 CXXTEST_TEST_REGISTRATION(PointTest, DataWithParent)
 CXXTEST_TEST_REGISTRATION(PointTest, DataWithoutParent)
 CXXTEST_TEST_REGISTRATION(PointTest, DataClone)  
+CXXTEST_TEST_REGISTRATION(PointTest, DataCopyOnWrite)
+CXXTEST_TEST_REGISTRATION(PointTest, DataReferenceKeptAfterClone)
+CXXTEST_TEST_REGISTRATION(PointTest, DataValuesPointer)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataFromMap)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataMapCopied)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataRowMajorFromMap)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataRowMajorFromMapSwap)
+CXXTEST_TEST_REGISTRATION(PointTest, LazyData)
 #endif
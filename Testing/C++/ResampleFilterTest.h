@@ -0,0 +1,268 @@
+#ifndef ResampleFilterTest_h
+#define ResampleFilterTest_h
+
+#include <btkResampleFilter.h>
+#include <btkMetaDataUtils.h>
+#include <btkConvert.h>
+
+inline void ResampleFilterTest_Sine(double* x, int n, double rate, double frequency, double amplitude = 1.0, double offset = 0.0)
+{
+  for (int i = 0 ; i < n ; ++i)
+    x[i] = offset + amplitude * std::sin(2.0 * M_PI * frequency * static_cast<double>(i) / rate);
+};
+
+CXXTEST_SUITE(ResampleFilterTest)
+{
+  CXXTEST_TEST(Default)
+  {
+    btk::ResampleFilter<btk::Analog>::Pointer rf = btk::ResampleFilter<btk::Analog>::New();
+    TS_ASSERT_EQUALS(rf->GetUpRatio(), 1);
+    TS_ASSERT_EQUALS(rf->GetDownRatio(), 1);
+    TS_ASSERT_EQUALS(rf->GetNumberOfThreads(), 1);
+    rf->SetUpDownRatio(0, 2);
+    TS_ASSERT_EQUALS(rf->GetUpRatio(), 1);
+    TS_ASSERT_EQUALS(rf->GetDownRatio(), 1);
+  };
+  
+  CXXTEST_TEST(Analog)
+  {
+    btk::Analog::Pointer a = btk::Analog::New("FZ1", 2000);
+    a->SetUnit("N");
+    a->SetScale(0.5);
+    ResampleFilterTest_Sine(a->GetValues().data(), 2000, 1000.0, 4.0, 100.0, 250.0);
+    btk::ResampleFilter<btk::Analog>::Pointer rf = btk::ResampleFilter<btk::Analog>::New();
+    rf->SetInput(a);
+    rf->SetUpDownRatio(120, 1000);
+    rf->Update();
+    btk::Analog::Pointer out = rf->GetOutput();
+    TS_ASSERT_EQUALS(out->GetLabel(), "FZ1");
+    TS_ASSERT_EQUALS(out->GetUnit(), "N");
+    TS_ASSERT_EQUALS(out->GetScale(), 0.5);
+    TS_ASSERT_EQUALS(out->GetFrameNumber(), 240);
+    std::vector<double> ref(240);
+    ResampleFilterTest_Sine(&(ref[0]), 240, 120.0, 4.0, 100.0, 250.0);
+    // The edges are affected by the extension of the signal.
+    for (int i = 20 ; i < 220 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), out->GetValues().coeff(i), ref[i], 0.5);
+    // The input is not modified.
+    TS_ASSERT_EQUALS(a->GetFrameNumber(), 2000);
+  };
+  
+  CXXTEST_TEST(Point)
+  {
+    btk::Point::Pointer p = btk::Point::New("RKNE", 100, btk::Point::Marker, "Right knee");
+    for (int i = 0 ; i < 3 ; ++i)
+      ResampleFilterTest_Sine(p->GetValues().col(i).data(), 100, 100.0, 1.0 + i, 10.0, 100.0 * i);
+    p->GetResiduals().setConstant(0.5);
+    p->GetResiduals().coeffRef(99) = -1.0;
+    btk::ResampleFilter<btk::Point>::Pointer rf = btk::ResampleFilter<btk::Point>::New();
+    rf->SetInput(p);
+    rf->SetUpDownRatio(2, 1);
+    rf->Update();
+    btk::Point::Pointer out = rf->GetOutput();
+    TS_ASSERT_EQUALS(out->GetLabel(), "RKNE");
+    TS_ASSERT_EQUALS(out->GetDescription(), "Right knee");
+    TS_ASSERT_EQUALS(out->GetFrameNumber(), 200);
+    std::vector<double> ref(200);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      ResampleFilterTest_Sine(&(ref[0]), 200, 200.0, 1.0 + i, 10.0, 100.0 * i);
+      for (int j = 20 ; j < 178 ; ++j)
+        TSM_ASSERT_DELTA("Sample #" + btk::ToString(j), out->GetValues().coeff(j,i), ref[j], 0.15);
+    }
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(0), 0.5);
+    // The output frames computed with the last input frame (occluded) are occluded.
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(177), 0.5);
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(178), -1.0);
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(199), -1.0);
+    TS_ASSERT_EQUALS(out->GetValues().row(178).isZero(), true);
+  };
+  
+  CXXTEST_TEST(PointWithGap)
+  {
+    btk::Point::Pointer p = btk::Point::New("LKNE", 100);
+    p->GetValues().setConstant(100.0);
+    p->GetResiduals().setConstant(0.5);
+    p->GetValues().block(40,0,10,3).setZero();
+    p->GetResiduals().segment(40,10).setConstant(-1.0);
+    btk::ResampleFilter<btk::Point>::Pointer rf = btk::ResampleFilter<btk::Point>::New();
+    rf->SetInput(p);
+    rf->SetUpDownRatio(2, 1);
+    rf->Update();
+    btk::Point::Pointer out = rf->GetOutput();
+    TS_ASSERT_EQUALS(out->GetFrameNumber(), 200);
+    // The gap is enlarged by the length of the filter.
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(59), 0.5);
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(60), -1.0);
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(119), -1.0);
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(120), 0.5);
+    // The values of the valid frames are not affected by the gap.
+    for (int k = 0 ; k < 200 ; ++k)
+    {
+      if (out->GetResiduals().coeff(k) < 0.0)
+      {
+        TSM_ASSERT_EQUALS("Sample #" + btk::ToString(k), out->GetValues().row(k).isZero(), true);
+      }
+      else
+      {
+        TSM_ASSERT_DELTA("Sample #" + btk::ToString(k), out->GetValues().coeff(k,1), 100.0, 0.5);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(WrenchCollection)
+  {
+    btk::WrenchCollection::Pointer wrenches = btk::WrenchCollection::New();
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::Wrench::Pointer w = btk::Wrench::New("FP" + btk::ToString(i+1), 1000);
+      w->GetPosition()->GetValues().setConstant(10.0 * i);
+      w->GetForce()->GetValues().setConstant(100.0);
+      ResampleFilterTest_Sine(w->GetForce()->GetValues().col(2).data(), 1000, 1000.0, 2.0, 500.0);
+      w->GetMoment()->GetValues().setZero();
+      wrenches->InsertItem(w);
+    }
+    btk::ResampleFilter<btk::WrenchCollection>::Pointer rf = btk::ResampleFilter<btk::WrenchCollection>::New();
+    rf->SetInput(wrenches);
+    rf->SetUpDownRatio(1, 5);
+    rf->Update();
+    btk::WrenchCollection::Pointer out = rf->GetOutput();
+    TS_ASSERT_EQUALS(out->GetItemNumber(), 2);
+    std::vector<double> ref(200);
+    ResampleFilterTest_Sine(&(ref[0]), 200, 200.0, 2.0, 500.0);
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::Wrench::Pointer w = out->GetItem(i);
+      TS_ASSERT_EQUALS(w->GetPosition()->GetLabel(), "FP" + btk::ToString(i+1));
+      TS_ASSERT_EQUALS(w->GetForce()->GetFrameNumber(), 200);
+      for (int j = 0 ; j < 200 ; ++j)
+      {
+        TS_ASSERT_DELTA(w->GetPosition()->GetValues().coeff(j,0), 10.0 * i, 1e-2);
+        TS_ASSERT_DELTA(w->GetForce()->GetValues().coeff(j,0), 100.0, 1e-1);
+        TS_ASSERT_DELTA(w->GetMoment()->GetValues().coeff(j,1), 0.0, 1e-15);
+        if ((j >= 20) && (j < 180))
+          TS_ASSERT_DELTA(w->GetForce()->GetValues().coeff(j,2), ref[j], 1.0);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(PointCollectionFrameNumberMismatch)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    points->InsertItem(btk::Point::New("LKNE", 100));
+    points->InsertItem(btk::Point::New("RKNE", 100));
+    btk::ResampleFilter<btk::PointCollection>::Pointer rf = btk::ResampleFilter<btk::PointCollection>::New();
+    rf->SetInput(points);
+    rf->SetUpDownRatio(2, 1);
+    rf->Update();
+    btk::PointCollection::Pointer out = rf->GetOutput();
+    TS_ASSERT_EQUALS(out->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(out->GetItem(1)->GetFrameNumber(), 200);
+    // The output is cleared instead of being partially resampled.
+    points->InsertItem(0, btk::Point::New("HEEL", 50));
+    rf->Update();
+    TS_ASSERT_EQUALS(out->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(Acquisition)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 300, 3, 20);
+    acq->SetPointFrequency(100.0);
+    acq->SetFirstFrame(11);
+    acq->GetPoint(0)->GetValues().setRandom();
+    for (int i = 0 ; i < 3 ; ++i)
+      ResampleFilterTest_Sine(acq->GetAnalog(i)->GetValues().data(), 6000, 2000.0, 3.0 * (i + 1), 1.0, i);
+    acq->GetAnalog(1)->SetUnit("Nmm");
+    acq->AppendEvent(btk::Event::New("Foot Strike", 0.5, "Right"));
+    btk::MetaData::Pointer analog = btk::MetaData::New("ANALOG");
+    acq->GetMetaData()->AppendChild(analog);
+    btk::MetaDataCreateChild(analog, "RATE", 2000.0f);
+    
+    btk::ResampleFilter<btk::Acquisition>::Pointer rf = btk::ResampleFilter<btk::Acquisition>::New();
+    rf->SetInput(acq);
+    rf->SetUpDownRatio(1, 10);
+    rf->SetNumberOfThreads(0);
+    rf->Update();
+    btk::Acquisition::Pointer out = rf->GetOutput();
+    TS_ASSERT_EQUALS(out->GetPointFrameNumber(), 300);
+    TS_ASSERT_EQUALS(out->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(out->GetFirstFrame(), 11);
+    TS_ASSERT_EQUALS(out->GetNumberAnalogSamplePerFrame(), 2);
+    TS_ASSERT_EQUALS(out->GetAnalogFrequency(), 200.0);
+    TS_ASSERT_EQUALS(out->GetAnalogFrameNumber(), 600);
+    TS_ASSERT_EQUALS(out->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(out->GetAnalogNumber(), 3);
+    TS_ASSERT_EQUALS(out->GetEventNumber(), 1);
+    TS_ASSERT_EQUALS(out->GetAnalog(1)->GetUnit(), "Nmm");
+    TS_ASSERT(out->GetPoint(0)->GetValues().isApprox(acq->GetPoint(0)->GetValues()));
+    std::vector<double> ref(600);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      TS_ASSERT_EQUALS(out->GetAnalog(i)->GetFrameNumber(), 600);
+      ResampleFilterTest_Sine(&(ref[0]), 600, 200.0, 3.0 * (i + 1), 1.0, i);
+      for (int j = 20 ; j < 580 ; ++j)
+        TSM_ASSERT_DELTA("Sample #" + btk::ToString(j), out->GetAnalog(i)->GetValues().coeff(j), ref[j], 1e-2);
+    }
+    btk::MetaData::ConstIterator itAnalog = out->GetMetaData()->FindChild("ANALOG");
+    TS_ASSERT(itAnalog != out->GetMetaData()->End());
+    TS_ASSERT_EQUALS((*itAnalog)->GetChild("RATE")->GetInfo()->ToDouble(0), 200.0);
+    // The input is not modified
+    TS_ASSERT_EQUALS(acq->GetNumberAnalogSamplePerFrame(), 20);
+    TS_ASSERT_EQUALS(acq->GetMetaData()->GetChild("ANALOG")->GetChild("RATE")->GetInfo()->ToDouble(0), 2000.0);
+  };
+  
+  CXXTEST_TEST(AcquisitionNotIntegerRatio)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 50, 2, 10);
+    acq->GetAnalog(0)->GetValues().setRandom();
+    btk::ResampleFilter<btk::Acquisition>::Pointer rf = btk::ResampleFilter<btk::Acquisition>::New();
+    rf->SetInput(acq);
+    rf->SetUpDownRatio(1, 3);
+    rf->Update();
+    btk::Acquisition::Pointer out = rf->GetOutput();
+    TS_ASSERT_EQUALS(out->GetNumberAnalogSamplePerFrame(), 10);
+    TS_ASSERT_EQUALS(out->GetAnalogFrameNumber(), 500);
+    TS_ASSERT(out->GetAnalog(0)->GetValues().isApprox(acq->GetAnalog(0)->GetValues()));
+  };
+  
+  CXXTEST_TEST(ParallelMatchesSerial)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 12 ; ++i)
+    {
+      btk::Analog::Pointer a = btk::Analog::New("Channel" + btk::ToString(i), 50000);
+      a->GetValues().setRandom();
+      analogs->InsertItem(a);
+    }
+    btk::ResampleFilter<btk::AnalogCollection>::Pointer serial = btk::ResampleFilter<btk::AnalogCollection>::New();
+    serial->SetInput(analogs);
+    serial->SetUpDownRatio(3, 25);
+    serial->Update();
+    btk::ResampleFilter<btk::AnalogCollection>::Pointer parallel = btk::ResampleFilter<btk::AnalogCollection>::New();
+    parallel->SetInput(analogs);
+    parallel->SetUpDownRatio(3, 25);
+    parallel->SetNumberOfThreads(4);
+    parallel->Update();
+    TS_ASSERT_EQUALS(parallel->GetOutput()->GetItemNumber(), 12);
+    for (int i = 0 ; i < 12 ; ++i)
+    {
+      TS_ASSERT_EQUALS(parallel->GetOutput()->GetItem(i)->GetLabel(), "Channel" + btk::ToString(i));
+      TS_ASSERT_EQUALS(parallel->GetOutput()->GetItem(i)->GetFrameNumber(), 6000);
+      TS_ASSERT(parallel->GetOutput()->GetItem(i)->GetValues() == serial->GetOutput()->GetItem(i)->GetValues());
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ResampleFilterTest)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, Default)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, Analog)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, Point)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, PointWithGap)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, WrenchCollection)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, PointCollectionFrameNumberMismatch)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, Acquisition)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AcquisitionNotIntegerRatio)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, ParallelMatchesSerial)
+#endif
@@ -3,6 +3,8 @@
 
 #include <btkSubAcquisitionFilter.h>
 
+#include "C3DFile_Util.h"
+
 CXXTEST_SUITE(SubAcquisitionFilterTest)
 {
   CXXTEST_TEST(TestAllNoEffect)
@@ -273,6 +275,109 @@ CXXTEST_SUITE(SubAcquisitionFilterTest)
     TS_ASSERT_EQUALS(output->GetEvent(0)->GetFrame(), 12);
     TS_ASSERT_EQUALS(output->GetEvent(1)->GetFrame(), 15);
   };
+  
+  CXXTEST_TEST(TestLazySubFrame)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(10,25,5,2);
+    acq->AppendEvent(btk::Event::New("", 17));
+    acq->AppendEvent(btk::Event::New("", 25));
+    acq->SetFirstFrame(10);
+    acq->SetPointFrequency(25.0);
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+      acq->GetPoint(i)->GetValues().col(0).setLinSpaced(25, 0.0, 24.0);
+      acq->GetPoint(i)->GetResiduals().setConstant(0.5);
+    }
+    for (int i = 0 ; i < 5 ; ++i)
+      acq->GetAnalog(i)->GetValues().setLinSpaced(50, 0.0, 49.0);
+    
+    btk::SubAcquisitionFilter::Pointer sub = btk::SubAcquisitionFilter::New();
+    TS_ASSERT_EQUALS(sub->GetLazyExtraction(), false);
+    sub->SetInput(acq);
+    sub->SetFramesIndex(5,14);
+    sub->SetLazyExtraction(true);
+    sub->Update();
+    
+    btk::Acquisition::Pointer output = sub->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 10);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 20);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), acq->GetPointNumber());
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), acq->GetAnalogNumber());
+    TS_ASSERT_EQUALS(output->GetEventNumber(), 1);
+    TS_ASSERT_EQUALS(output->GetEvent(0)->GetFrame(), 17);
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+      TS_ASSERT(output->GetPoint(i)->GetData()->IsLazy());
+      TS_ASSERT_EQUALS(output->GetPoint(i)->GetFrameNumber(), 10);
+    }
+    for (int i = 0 ; i < 5 ; ++i)
+      TS_ASSERT(output->GetAnalog(i)->GetData()->IsLazy());
+    // The input is modified after the extraction: the views keep the original values.
+    acq->GetPoint(0)->GetValues().coeffRef(5,0) = 1234.0;
+    // Only the accessed measures are copied.
+    TS_ASSERT_EQUALS(output->GetPoint(0)->GetValues().coeff(0,0), 5.0);
+    TS_ASSERT_EQUALS(output->GetPoint(0)->GetValues().coeff(9,0), 14.0);
+    TS_ASSERT_EQUALS(output->GetPoint(0)->GetResiduals().coeff(9), 0.5);
+    TS_ASSERT(!output->GetPoint(0)->GetData()->IsLazy());
+    TS_ASSERT(output->GetPoint(1)->GetData()->IsLazy());
+    TS_ASSERT_EQUALS(output->GetAnalog(2)->GetValues().coeff(0), 10.0);
+    TS_ASSERT_EQUALS(output->GetAnalog(2)->GetValues().coeff(19), 29.0);
+    TS_ASSERT(output->GetAnalog(1)->GetData()->IsLazy());
+    // Modifying the output does not modify the input.
+    output->GetPoint(1)->GetValues().coeffRef(0,0) = -1.0;
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues().coeff(5,0), 5.0);
+  };
+  
+  CXXTEST_TEST(TestLazySubFrameLazyInput)
+  {
+    const std::string filename = C3DFilePathOUT + "SubAcquisitionLazyInput.c3d";
+    C3DFileUtil_WriteAcquisition(filename, C3DFileUtil_GenerateAcquisition(1000, false), btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::Float);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetLazyLoading(true);
+    reader->SetFilename(filename);
+    reader->Update();
+    btk::Acquisition::ConstPointer acq = reader->GetOutput();
+    TS_ASSERT(acq->GetPoint(0)->GetData()->IsLazy());
+    // Several windows are cut from the same lazy input.
+    const int windows[3][2] = {{0, 99}, {250, 499}, {900, 999}};
+    std::vector<btk::Acquisition::Pointer> outputs;
+    for (int w = 0 ; w < 3 ; ++w)
+    {
+      btk::SubAcquisitionFilter::Pointer sub = btk::SubAcquisitionFilter::New();
+      sub->SetInput(reader->GetOutput());
+      sub->SetFramesIndex(windows[w][0], windows[w][1]);
+      sub->SetLazyExtraction(true);
+      sub->Update();
+      outputs.push_back(sub->GetOutput());
+      // The input is extracted by the first window and its values are shared with the next ones.
+      for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+      {
+        TS_ASSERT(!acq->GetPoint(i)->GetData()->IsLazy());
+        TS_ASSERT(acq->GetPoint(i)->GetData()->IsShared());
+      }
+      for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+      {
+        TS_ASSERT(!acq->GetAnalog(i)->GetData()->IsLazy());
+        TS_ASSERT(acq->GetAnalog(i)->GetData()->IsShared());
+      }
+    }
+    const int samples = acq->GetNumberAnalogSamplePerFrame();
+    for (int w = 0 ; w < 3 ; ++w)
+    {
+      const int numFrames = windows[w][1] - windows[w][0] + 1;
+      btk::Acquisition::ConstPointer output = outputs[w];
+      TS_ASSERT_EQUALS(output->GetPointFrameNumber(), numFrames);
+      for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+      {
+        TS_ASSERT(output->GetPoint(i)->GetData()->IsLazy());
+        TS_ASSERT(output->GetPoint(i)->GetValues() == acq->GetPoint(i)->GetValues().block(windows[w][0],0,numFrames,3));
+        TS_ASSERT(output->GetPoint(i)->GetResiduals() == acq->GetPoint(i)->GetResiduals().block(windows[w][0],0,numFrames,1));
+      }
+      for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+        TS_ASSERT(output->GetAnalog(i)->GetValues() == acq->GetAnalog(i)->GetValues().segment(windows[w][0]*samples,numFrames*samples));
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(SubAcquisitionFilterTest)
@@ -284,5 +389,7 @@ CXXTEST_TEST_REGISTRATION(SubAcquisitionFilterTest, TestOnlyFivePoints)
 CXXTEST_TEST_REGISTRATION(SubAcquisitionFilterTest, TestOnlyAnalogs)
 CXXTEST_TEST_REGISTRATION(SubAcquisitionFilterTest, TestOnlyTwoAnalogsSubFrame)
 CXXTEST_TEST_REGISTRATION(SubAcquisitionFilterTest, TestOnlyEventsSubFrame)
+CXXTEST_TEST_REGISTRATION(SubAcquisitionFilterTest, TestLazySubFrame)
+CXXTEST_TEST_REGISTRATION(SubAcquisitionFilterTest, TestLazySubFrameLazyInput)
 
 #endif // SubAcquisitionFilterTest_h
\ No newline at end of file
@@ -5,6 +5,53 @@
 #include <btkTRCFileIO.h>
 #include <btkConvert.h>
 
+#include "ASCIIFile_Util.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+// Appends the rows of a synthetic TRC file. The frame numbers jump after the frame @a gap (if positive).
+struct TRCFileReaderTest_LargeRow
+{
+  int pointNumber;
+  int gap;
+  int period;
+  void operator()(int f, std::string* content) const
+  {
+    char buffer[64];
+    const int frame = (this->period > 0) ? f % this->period : f;
+    sprintf(buffer, "%i\t%.3f", ((this->gap > 0) && (frame >= this->gap)) ? frame + 2 : frame + 1, 0.01 * frame);
+    content->append(buffer);
+    for (int p = 0 ; p < this->pointNumber ; ++p)
+    {
+      if ((f + p) % 11 == 0)
+        content->append("\t\t\t");
+      else
+      {
+        sprintf(buffer, "\t%.5f\t%.5f\t%.5f", 250.0 * sin(0.01 * f + p), 120.0 * cos(0.02 * f - p), 900.0 + 0.5 * f - 30.0 * p);
+        content->append(buffer);
+      }
+    }
+    content->append("\r\n");
+  };
+};
+
+// Generates a TRC file large enough to be parsed by several threads. The frame numbers jump after the frame @a gap (if positive)
+// and restart every @a period rows (if positive).
+inline std::string TRCFileReaderTest_WriteLarge(const std::string& name, int frameNumber, int gap, int period = 0)
+{
+  const TRCFileReaderTest_LargeRow row = {25, gap, period};
+  std::string header = "PathFileType\t4\t(X/Y/Z)\t" + name + "\r\n"
+                       "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\t\r\n"
+                       "100\t100\t" + btk::ToString(frameNumber) + "\t" + btk::ToString(row.pointNumber) + "\tmm\t100\t1\t" + btk::ToString(frameNumber) + "\t\r\n"
+                       "Frame#\tTime\t";
+  for (int p = 0 ; p < row.pointNumber ; ++p)
+    header += "P" + btk::ToString(p) + "\t\t\t";
+  header += "\r\n\t\t\r\n\r\n";
+  return ASCIIFileUtil_WriteLarge(TRCFilePathOUT + name, header, frameNumber, row);
+};
+
 CXXTEST_SUITE(TRCFileReaderTest)
 {
   CXXTEST_TEST(NoFile)
@@ -291,6 +338,166 @@ CXXTEST_SUITE(TRCFileReaderTest)
     TS_ASSERT_DELTA(acq->GetPoint(32)->GetValues()(1312,2), 951.17596, 1e-5);
     TS_ASSERT_DELTA(acq->GetPoint(32)->GetResiduals()(1312), 0.0, 1e-15);
   };
+  
+  CXXTEST_TEST(SyntheticOcclusion)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ASCIIFileUtil_WriteText(TRCFilePathOUT + "SyntheticOcclusion.trc",
+      "PathFileType\t4\t(X/Y/Z)\tSyntheticOcclusion.trc\r\n"
+      "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\t\r\n"
+      "100\t100\t3\t2\tmm\t100\t5\t3\t\r\n"
+      "Frame#\tTime\tA\t\t\tB\t\t\t\r\n"
+      "\t\tX1\tY1\tZ1\tX2\tY2\tZ2\t\r\n"
+      "\r\n"
+      "5\t0.000\t1.5\t-2.25\t3e2\t\t\t\t\r\n"
+      "6\t0.010\t\t\t\t4\t5\t6 \r\n"
+      "7\t0.020\t7.125\t8\t9"));
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    TS_ASSERT_EQUALS(acq->GetFirstFrame(), 5);
+    TS_ASSERT_EQUALS(acq->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), 3);
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "A");
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetLabel(), "B");
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(0,0), 1.5);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(0,1), -2.25);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(0,2), 300.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(0), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues().row(0).isZero(), true);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(0), -1.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues().row(1).isZero(), true);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(1), -1.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(1,0), 4.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(1,1), 5.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(1,2), 6.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(1), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(2,0), 7.125);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(2,1), 8.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(2,2), 9.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(2), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(2), -1.0);
+  };
+  
+  CXXTEST_TEST(SyntheticNonNumeric)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ASCIIFileUtil_WriteText(TRCFilePathOUT + "SyntheticNonNumeric.trc",
+      "PathFileType\t4\t(X/Y/Z)\tSyntheticNonNumeric.trc\r\n"
+      "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\t\r\n"
+      "100\t100\t2\t2\tmm\t100\t1\t2\t\r\n"
+      "Frame#\tTime\tA\t\t\tB\t\t\t\r\n"
+      "\t\tX1\tY1\tZ1\tX2\tY2\tZ2\t\r\n"
+      "\r\n"
+      "1\t0.000\t1.#QNAN\t1.#QNAN\t1.#QNAN\t4\t5\t6\r\n"
+      "2\t0.010\t1\t2\t3\t4\tfoo\t6\r\n"));
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), 2);
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), 2);
+    // The non numeric coordinates are read as occlusions.
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues().row(0).isZero(), true);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(0), -1.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(0,1), 5.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(0), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(1,2), 3.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(1), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues().row(1).isZero(), true);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(1), -1.0);
+  };
+  
+  CXXTEST_TEST(SyntheticUnlabeled)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ASCIIFileUtil_WriteText(TRCFilePathOUT + "SyntheticUnlabeled.trc",
+      "PathFileType\t4\t(X/Y/Z)\tSyntheticUnlabeled.trc\n"
+      "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\t\n"
+      "50\t50\t3\t0\tm\t50\t1\t3\t\n"
+      "Frame#\tTime\t\n"
+      "\t\t\n"
+      "\n"
+      "1\t0.00\t1\t2\t3\t\n"
+      "2\t0.02\t\n"
+      "3\t0.04\t4\t5\t6\t7\t8\t9\t\n"));
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    TS_ASSERT_EQUALS(acq->GetPointUnit(), "m");
+    TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), 3);
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "Unlabel#1");
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetLabel(), "Unlabel#2");
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(0,2), 3.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(0), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(0), -1.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(1), -1.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(1), -1.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(2,0), 4.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(2,0), 7.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(2,2), 9.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(2), 0.0);
+  };
+  
+  CXXTEST_TEST(SyntheticTruncated)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ASCIIFileUtil_WriteText(TRCFilePathOUT + "SyntheticTruncated.trc",
+      "PathFileType\t4\t(X/Y/Z)\tSyntheticTruncated.trc\n"
+      "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\t\n"
+      "100\t100\t4\t1\tmm\t100\t1\t4\t\n"
+      "Frame#\tTime\tA\t\t\t\n"
+      "\t\tX1\tY1\tZ1\t\n"
+      "\n"
+      "1\t0.00\t1\t2\t3\t\n"
+      "2\t0.01\t1\t2\t3\t\n"));
+    TS_ASSERT_THROWS_EQUALS(reader->Update(), const btk::TRCFileIOException &e, e.what(), std::string("Unexpected end of file."));
+  };
+  
+  CXXTEST_TEST(SyntheticThreads)
+  {
+    const std::string filename = TRCFileReaderTest_WriteLarge("SyntheticThreads.trc", 6000, 0);
+    btk::Acquisition::Pointer ref = ASCIIFileUtil_Read<btk::TRCFileIO>(filename, 1);
+    TS_ASSERT_EQUALS(ref->GetPointFrameNumber(), 6000);
+    TS_ASSERT_DELTA(ref->GetPoint(3)->GetValues()(5000,2), 900.0 + 2500.0 - 90.0, 1e-10);
+    TS_ASSERT_EQUALS(ref->GetPoint(3)->GetResiduals()(5000), 0.0);
+    TS_ASSERT_EQUALS(ref->GetPoint(5)->GetResiduals()(5000), -1.0);
+    ASCIIFileUtil_Compare(ASCIIFileUtil_Read<btk::TRCFileIO>(filename, 4), ref);
+    ASCIIFileUtil_Compare(ASCIIFileUtil_Read<btk::TRCFileIO>(filename, 0), ref);
+  };
+  
+  CXXTEST_TEST(SyntheticThreadsFrameGap)
+  {
+    // The frame numbers are not consecutive: the rows must be read in their order, like with one thread.
+    const std::string filename = TRCFileReaderTest_WriteLarge("SyntheticThreadsFrameGap.trc", 6000, 3500);
+    btk::Acquisition::Pointer ref = ASCIIFileUtil_Read<btk::TRCFileIO>(filename, 1);
+    TS_ASSERT_DELTA(ref->GetPoint(3)->GetValues()(5000,2), 900.0 + 2500.0 - 90.0, 1e-10);
+    ASCIIFileUtil_Compare(ASCIIFileUtil_Read<btk::TRCFileIO>(filename, 4), ref);
+  };
+  
+  CXXTEST_TEST(SyntheticThreadsRepeatedFrames)
+  {
+    // The frame numbers restart in the middle of the file: each thread must only store the rows of its own range.
+    const std::string filename = TRCFileReaderTest_WriteLarge("SyntheticThreadsRepeatedFrames.trc", 6000, 0, 2000);
+    btk::Acquisition::Pointer ref = ASCIIFileUtil_Read<btk::TRCFileIO>(filename, 1);
+    TS_ASSERT_EQUALS(ref->GetPointFrameNumber(), 6000);
+    for (int i = 0 ; i < 10 ; ++i)
+      ASCIIFileUtil_Compare(ASCIIFileUtil_Read<btk::TRCFileIO>(filename, 4), ref);
+  };
+  
+  CXXTEST_TEST(SyntheticThreadsTruncated)
+  {
+    const std::string filename = TRCFileReaderTest_WriteLarge("SyntheticThreadsTruncated.trc", 6000, 0);
+    const std::string truncated = TRCFilePathOUT + "SyntheticThreadsTruncated2.trc";
+    std::ifstream ifs(filename.c_str(), std::ios_base::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    ASCIIFileUtil_WriteText(TRCFilePathOUT + "SyntheticThreadsTruncated2.trc", content.substr(0, content.rfind("\r\n5990\t")));
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    btk::TRCFileIO::Pointer io = btk::TRCFileIO::New();
+    io->SetNumberOfThreads(4);
+    reader->SetAcquisitionIO(io);
+    reader->SetFilename(truncated);
+    TS_ASSERT_THROWS_EQUALS(reader->Update(), const btk::TRCFileIOException &e, e.what(), std::string("Unexpected end of file."));
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(TRCFileReaderTest)
@@ -302,4 +509,12 @@ CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, MOTEK_ballet)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, KneeWithOcclusion)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, Unamed1)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, Unamed2)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticOcclusion)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticNonNumeric)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticUnlabeled)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticTruncated)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticThreads)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticThreadsFrameGap)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticThreadsRepeatedFrames)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, SyntheticThreadsTruncated)
 #endif
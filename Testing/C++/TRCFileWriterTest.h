@@ -5,6 +5,28 @@
 #include <btkAcquisitionFileWriter.h>
 #include <btkTRCFileIO.h>
 
+#include <fstream>
+#include <sstream>
+
+inline std::string TRCFileWriterTest_Content(const std::string& filename)
+{
+  std::ifstream ifs(filename.c_str());
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+  return oss.str();
+};
+
+inline void TRCFileWriterTest_Write(const std::string& filename, btk::Acquisition::Pointer acq, int numberOfThreads)
+{
+  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+  btk::TRCFileIO::Pointer io = btk::TRCFileIO::New();
+  io->SetNumberOfThreads(numberOfThreads);
+  writer->SetAcquisitionIO(io);
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  writer->Update();
+};
+
 CXXTEST_SUITE(TRCFileWriterTest)
 {
   CXXTEST_TEST(NoFileNoInput)
@@ -183,6 +205,75 @@ CXXTEST_SUITE(TRCFileWriterTest)
       }
     }
   };
+
+  CXXTEST_TEST(SyntheticFormat)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 3);
+    acq->SetPointFrequency(60.0);
+    acq->GetPoint(0)->SetLabel("A");
+    acq->GetPoint(1)->SetLabel("B");
+    acq->GetPoint(0)->GetValues() << 1.0, -0.000005, 123.456789,
+                                     2.5, 0.125, -987.654321,
+                                     0.0, 1e-6, 1000000.0;
+    acq->GetPoint(1)->GetValues().setZero();
+    acq->GetPoint(1)->GetResiduals().setConstant(-1.0);
+    acq->GetPoint(1)->GetValues().row(2) << 3.0, 2.0, 1.0;
+    acq->GetPoint(1)->GetResiduals()(2) = 0.0;
+    const std::string filename = TRCFilePathOUT + "SyntheticFormat.trc";
+    TRCFileWriterTest_Write(filename, acq, 1);
+    const std::string content = TRCFileWriterTest_Content(filename);
+    const std::string data = "X1\tY1\tZ1\tX2\tY2\tZ2\t\n"
+                             "\n1\t0.000\t1.00000\t-0.00001\t123.45679\t\t\t "
+                             "\n2\t0.017\t2.50000\t0.12500\t-987.65432\t\t\t "
+                             "\n3\t0.033\t0.00000\t0.00000\t1000000.00000\t3.00000\t2.00000\t1.00000 \n";
+    TS_ASSERT(content.size() > data.size());
+    TS_ASSERT_EQUALS(content.substr(content.size() - data.size()), data);
+  };
+
+  CXXTEST_TEST(SyntheticThreads)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(40, 5000);
+    acq->SetPointFrequency(200.0);
+    for (int p = 0 ; p < 40 ; ++p)
+    {
+      btk::Point::Pointer point = acq->GetPoint(p);
+      for (int f = 0 ; f < 5000 ; ++f)
+      {
+        point->GetValues().coeffRef(f,0) = 250.0 * sin(0.01 * f + p);
+        point->GetValues().coeffRef(f,1) = 120.0 * cos(0.02 * f - p);
+        point->GetValues().coeffRef(f,2) = 900.0 + 0.5 * f - 30.0 * p;
+        if ((f + p) % 13 == 0)
+        {
+          point->GetValues().row(f).setZero();
+          point->GetResiduals().coeffRef(f) = -1.0;
+        }
+      }
+    }
+    TRCFileWriterTest_Write(TRCFilePathOUT + "SyntheticThreads1.trc", acq, 1);
+    TRCFileWriterTest_Write(TRCFilePathOUT + "SyntheticThreads4.trc", acq, 4);
+    // The first line contains the name of the file.
+    std::string content = TRCFileWriterTest_Content(TRCFilePathOUT + "SyntheticThreads1.trc");
+    std::string content4 = TRCFileWriterTest_Content(TRCFilePathOUT + "SyntheticThreads4.trc");
+    TS_ASSERT(content.size() > 4000000);
+    TS_ASSERT(content.substr(content.find('\n')) == content4.substr(content4.find('\n')));
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TRCFilePathOUT + "SyntheticThreads4.trc");
+    reader->Update();
+    btk::Acquisition::Pointer output = reader->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 5000);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 40);
+    for (int p = 0 ; p < 40 ; ++p)
+    {
+      for (int f = 0 ; f < 5000 ; f += 7)
+      {
+        TS_ASSERT_DELTA(output->GetPoint(p)->GetValues()(f,0), acq->GetPoint(p)->GetValues()(f,0), 1e-5);
+        TS_ASSERT_DELTA(output->GetPoint(p)->GetValues()(f,2), acq->GetPoint(p)->GetValues()(f,2), 1e-5);
+        TS_ASSERT_EQUALS(output->GetPoint(p)->GetResiduals()(f), acq->GetPoint(p)->GetResiduals()(f));
+      }
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(TRCFileWriterTest)
@@ -193,5 +284,7 @@ CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, MOTEK_T_rewrited)
 CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, Knee_rewrited)
 CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, Gait_from_c3d)
 CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, PlugInC3D)
+CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, SyntheticFormat)
+CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, SyntheticThreads)
   
 #endif
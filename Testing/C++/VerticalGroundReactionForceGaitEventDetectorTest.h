@@ -7,6 +7,28 @@
 #include <btkGroundReactionWrenchFilter.h>
 #include <btkDownsampleFilter.h>
 
+// Vertical force with three stances (the last one is not finished), a short contact and an oscillation around the threshold.
+inline btk::Wrench::Pointer VerticalGroundReactionForceGaitEventDetectorTest_Wrench()
+{
+  btk::Wrench::Pointer wrench = btk::Wrench::New(200);
+  btk::Point::Values& values = wrench->GetForce()->GetValues();
+  values.setZero();
+  values.block(10,2,30,1).setConstant(500.0);
+  values.block(60,2,2,1).setConstant(500.0);
+  values.block(80,2,5,1).setConstant(12.0);
+  values.block(85,2,36,1).setConstant(500.0);
+  values.block(190,2,10,1).setConstant(500.0);
+  return wrench;
+};
+
+inline void VerticalGroundReactionForceGaitEventDetectorTest_Check(btk::Event::Pointer ev, const std::string& label, int frame)
+{
+  TS_ASSERT_EQUALS(ev->GetLabel(), label);
+  TS_ASSERT_EQUALS(ev->GetFrame(), frame);
+  TS_ASSERT_EQUALS(ev->GetContext(), "Right");
+  TS_ASSERT_DELTA(ev->GetTime(), frame / 100.0, 1e-10);
+};
+
 CXXTEST_SUITE(VerticalGroundReactionForceGaitEventDetectorTest)
 {
   CXXTEST_TEST(NoWrench)
@@ -274,6 +296,88 @@ CXXTEST_SUITE(VerticalGroundReactionForceGaitEventDetectorTest)
     TS_ASSERT_EQUALS(ev->GetFrame(), 108);
     TS_ASSERT_EQUALS(ev->GetTime(), 108.0/60.0);
   };
+
+  CXXTEST_TEST(SyntheticSingleStance)
+  {
+    btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+    vgrfged->SetInput(VerticalGroundReactionForceGaitEventDetectorTest_Wrench());
+    vgrfged->SetForceplateContextMapping(std::vector<std::string>(1, "Right"));
+    vgrfged->SetAcquisitionInformation(1, 100.0, "");
+    TS_ASSERT_EQUALS(vgrfged->GetDetectionMode(), btk::VerticalGroundReactionForceGaitEventDetector::SingleStance);
+    btk::EventCollection::Pointer output = vgrfged->GetOutput();
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(0), "Foot Strike", 10);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(1), "Foot Off", 41);
+  };
+  
+  CXXTEST_TEST(SyntheticMultipleStances)
+  {
+    btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+    vgrfged->SetInput(VerticalGroundReactionForceGaitEventDetectorTest_Wrench());
+    vgrfged->SetForceplateContextMapping(std::vector<std::string>(1, "Right"));
+    vgrfged->SetAcquisitionInformation(1, 100.0, "");
+    vgrfged->SetDetectionMode(btk::VerticalGroundReactionForceGaitEventDetector::MultipleStances);
+    btk::EventCollection::Pointer output = vgrfged->GetOutput();
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 7);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(0), "Foot Strike", 10);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(1), "Foot Off", 41);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(2), "Foot Strike", 60);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(3), "Foot Off", 63);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(4), "Foot Strike", 80);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(5), "Foot Off", 122);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(6), "Foot Strike", 190);
+    
+    // Hysteresis and minimum duration: the short contact is discarded.
+    vgrfged->SetHysteresisValue(10.0);
+    vgrfged->SetMinimumStanceDuration(5);
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 5);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(0), "Foot Strike", 10);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(1), "Foot Off", 41);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(2), "Foot Strike", 80);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(3), "Foot Off", 122);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(4), "Foot Strike", 190);
+    
+    // Region of interest
+    vgrfged->SetRegionOfInterest(50, 150);
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(0), "Foot Strike", 80);
+    VerticalGroundReactionForceGaitEventDetectorTest_Check(output->GetItem(1), "Foot Off", 122);
+  };
+  
+  CXXTEST_TEST(StanceTrackerChunks)
+  {
+    btk::Wrench::Pointer wrench = VerticalGroundReactionForceGaitEventDetectorTest_Wrench();
+    const double* fz = wrench->GetForce()->GetValues().col(2).data();
+    btk::VerticalGroundReactionForceGaitEventDetector::StanceTracker tracker(10.0, 10.0, 5);
+    std::vector<int> fs, fo;
+    tracker.Process(fz, 200, &fs, &fo);
+    TS_ASSERT_EQUALS(tracker.GetProcessedFrameNumber(), 200);
+    TS_ASSERT_EQUALS(tracker.IsInStance(), true);
+    TS_ASSERT_EQUALS(fs.size(), 3u);
+    TS_ASSERT_EQUALS(fo.size(), 2u);
+    for (int chunk = 1 ; chunk <= 13 ; chunk += 3)
+    {
+      std::vector<int> fs2, fo2;
+      tracker.Reset();
+      for (int i = 0 ; i < 200 ; i += chunk)
+        tracker.Process(fz + i, std::min(chunk, 200 - i), &fs2, &fo2);
+      TS_ASSERT(fs2 == fs);
+      TS_ASSERT(fo2 == fo);
+    }
+    // The heel strike is given as soon as the stance lasted the minimum duration.
+    std::vector<int> fs3, fo3;
+    tracker.Reset();
+    tracker.Process(fz, 14, &fs3, &fo3);
+    TS_ASSERT_EQUALS(fs3.size(), 0u);
+    tracker.Process(fz + 14, 1, &fs3, &fo3);
+    TS_ASSERT_EQUALS(fs3.size(), 1u);
+    if (!fs3.empty())
+      TS_ASSERT_EQUALS(fs3[0], 9);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest)
@@ -283,5 +387,8 @@ CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, Gait
 CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, PluginC3D)
 CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, PluginC3D_Threshold50)
 CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, PluginC3D_ROI)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, SyntheticSingleStance)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, SyntheticMultipleStances)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, StanceTrackerChunks)
 
 #endif // VerticalGroundReactionForceGaitEventDetectorTest_h
\ No newline at end of file
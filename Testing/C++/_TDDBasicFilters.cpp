@@ -9,6 +9,7 @@
 #include "IMUsExtractorTest.h"
 #include "MeasureFrameExtractorTest.h"
 #include "MergeAcquisitionFilterTest.h"
+#include "ResampleFilterTest.h"
 #include "SeparateKnownVirtualMarkersFilterTest.h"
 #include "SpecializedPointsExtractorTest.h"
 #include "SubAcquisitionFilterTest.h"
@@ -0,0 +1,25 @@
+#include "_TDDConfigure.h"
+#include "_TDDBenchmark_Utils.h"
+
+#include <btkLogger.h>
+
+// BTK error messages are not displayed
+#define TDD_SILENT_CERR
+
+#include "ASCIIFileReaderBenchmark.h"
+#include "ASCIIFileWriterBenchmark.h"
+#include "BinaryFileStreamBenchmark.h"
+#include "C3DFileReaderBenchmark.h"
+#include "C3DFileWriterBenchmark.h"
+#include "EigenFiltFiltBenchmark.h"
+#include "MergeAcquisitionFilterBenchmark.h"
+
+int main()
+{
+#if defined(TDD_SILENT_CERR)
+  btk::Logger::SetVerboseMode(btk::Logger::Quiet);
+#endif
+  return CxxTest::ErrorPrinter().run();;
+};
+
+#include <cxxtest/Root.cpp>
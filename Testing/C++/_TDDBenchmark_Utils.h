@@ -0,0 +1,38 @@
+#ifndef _TDDBenchmark_Utils_h
+#define _TDDBenchmark_Utils_h
+
+#if defined(_WIN32)
+  #include <Utilities/timeval.h>
+#else
+  #include <sys/time.h>
+#endif
+
+#include <iostream>
+#include <string>
+
+// Wall clock timer (in seconds) used by the benchmarks.
+class TDDBenchmark_Timer
+{
+public:
+  TDDBenchmark_Timer() {this->Restart();};
+  void Restart() {gettimeofday(&this->m_Start, 0);};
+  double GetElapsed() const
+  {
+    struct timeval stop;
+    gettimeofday(&stop, 0);
+    return static_cast<double>(stop.tv_sec - this->m_Start.tv_sec) + static_cast<double>(stop.tv_usec - this->m_Start.tv_usec) * 1.0e-6;
+  };
+private:
+  struct timeval m_Start;
+};
+
+// Prints a line like: "<label>: 12.345 ms (123.4 MB/s)". The throughput is not printed if no size is given.
+inline void TDDBenchmark_Report(const std::string& label, double seconds, double bytes = 0.0)
+{
+  std::cout << std::endl << "  " << label << ": " << seconds * 1000.0 << " ms";
+  if ((bytes > 0.0) && (seconds > 0.0))
+    std::cout << " (" << bytes / seconds / 1048576.0 << " MB/s)";
+  std::cout << std::flush;
+};
+
+#endif // _TDDBenchmark_Utils_h
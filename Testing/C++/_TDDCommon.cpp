@@ -4,6 +4,8 @@
 #include "AnalogTest.h"
 #include "ForcePlatformTypesTest.h"
 #include "IMUTypesTest.h"
+#include "LoggerTest.h"
+#include "MemoryArenaTest.h"
 #include "NullPtrTest.h"
 #include "PointTest.h"
 #include "PointCollectionTest.h"
@@ -3,6 +3,7 @@
 #include "EigenFilterTest.h"
 #include "EigenFiltFiltTest.h"
 #include "EigenIIRFilterDesignTest.h"
+#include "EigenResampleTest.h"
 #include "GammalnTest.h"
 #include "CombTest.h"
 #include "CumtrapzTest.h"
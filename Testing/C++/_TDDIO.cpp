@@ -57,4 +57,9 @@
 #include "XMOVEFileIOTest.h"
 #include "XMOVEFileReaderTest.h"
 
+#include "ASCIIFileUtilsTest.h"
+#include "AcquisitionFileIOFactoryTest.h"
+#include "AcquisitionFileBatchConverterTest.h"
+#include "AcquisitionFileIOStressTest.h"
+
 #include "MultiSTLFileWriterTest.h"
\ No newline at end of file
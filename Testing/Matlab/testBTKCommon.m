@@ -144,6 +144,25 @@ assertEqual(res,res_);
 btkDeleteAcquisition(h);
 end
 
+function testGetPointsArray(d)
+np = 3;
+h = btkNewAcquisition(np,10);
+pv_ = rand(10,np*3);
+btkSetPointsValues(h, pv_);
+res_ = rand(10,np);
+btkSetPointsResiduals(h, res_);
+[values, res, labels] = btkGetPointsArray(h);
+assertEqual(size(values), [10 3 np]);
+assertEqual(reshape(values, 10, np*3), pv_);
+assertEqual(res, res_);
+assertEqual(length(labels), np);
+[values, res] = btkGetPointsArray(h, {labels{3}, labels{1}}, 0);
+assertEqual(values(:,:,1), pv_(:,7:9));
+assertEqual(values(:,:,2), pv_(:,1:3));
+assertEqual(res, res_(:,[3 1]));
+btkDeleteAcquisition(h);
+end
+
 function testCropAcquisition_first50(d)
 h = btkNewAcquisition(10,100,2,10);
 pv_ = rand(100,10*3);
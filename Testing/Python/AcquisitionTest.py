@@ -115,4 +115,19 @@ class AcquisitionTest(unittest.TestCase):
         test.SetFirstFrame(200, True)
         self.assertEqual(test.GetFirstFrame(), 200)
         self.assertEqual(test.GetEvent(0).GetFrame(), 240)
-        self.assertEqual(test.GetEvent(0).GetTime(), 2.39)
\ No newline at end of file
+        self.assertEqual(test.GetEvent(0).GetTime(), 2.39)
+    
+    def test_GetPointsArray(self):
+        test = btk.btkAcquisition()
+        test.Init(3, 5)
+        for p in range(0,3):
+          for f in range(0,5):
+            test.GetPoint(p).SetDataSlice(f, 100. * f + 10. * p, 100. * f + 10. * p + 1., 100. * f + 10. * p + 2.)
+        values = test.GetPointsArray()
+        self.assertEqual(values.shape, (5,3,3))
+        for p in range(0,3):
+          for f in range(0,5):
+            for c in range(0,3):
+              self.assertEqual(values[f,p,c], 100. * f + 10. * p + c)
+        values[0,0,0] = 42.
+        self.assertEqual(test.GetPoint(0).GetValue(0,0), 0.)
@@ -201,4 +201,14 @@ class AnalogTest(unittest.TestCase):
         t1 = a.GetTimestamp()
         t2 = d.GetTimestamp()
         self.assertEqual(a.GetData().GetValues()[4], 0.123)
-        self.assertEqual(t1 < t2, True)
\ No newline at end of file
+        self.assertEqual(t1 < t2, True)
+        
+    def test_GetValuesView(self):
+        a = btk.btkAnalog('F1X', 'Force platform 1, X-axis')
+        a.SetFrameNumber(20)
+        view = a.GetValuesView()
+        self.assertEqual(view.shape, (20,1))
+        view[7,0] = 1.5
+        self.assertEqual(a.GetValue(7), 1.5)
+        a.SetValue(19, -2.5)
+        self.assertEqual(view[19,0], -2.5)
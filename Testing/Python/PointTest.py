@@ -26,4 +26,50 @@ class PointTest(unittest.TestCase):
         for i in range(0,4):
           self.assertEqual(values_extracted[i,0], values[i,0])
           self.assertEqual(values_extracted[i,1], values[i,1])
-          self.assertEqual(values_extracted[i,2], values[i,2])
\ No newline at end of file
+          self.assertEqual(values_extracted[i,2], values[i,2])
+    
+    def test_GetValuesView(self):
+        p = btk.btkPoint("HEEL_R", 4)
+        p.SetValues(numpy.array([[1.,2.,3.],[4.,5.,6.],[7.,8.,9.],[10.,11.,12.]]))
+        view = p.GetValuesView()
+        self.assertEqual(view.shape, (4,3))
+        self.assertEqual(view[1,2], 6.)
+        self.assertEqual(view[3,0], 10.)
+        view[2,1] = 42.
+        self.assertEqual(p.GetValue(2,1), 42.)
+        p.SetValue(0,0,-1.)
+        self.assertEqual(view[0,0], -1.)
+        residuals = p.GetResidualsView()
+        self.assertEqual(residuals.shape, (4,1))
+        residuals[3,0] = -1.
+        self.assertEqual(p.GetResidual(3), -1.)
+        
+    def test_GetValuesViewOwnership(self):
+        view = btk.btkPoint("HEEL_R", 10).GetValuesView()
+        view[9,2] = 5.
+        self.assertEqual(view.shape, (10,3))
+        self.assertEqual(view[9,2], 5.)
+        
+    def test_GetValuesViewClone(self):
+        p = btk.btkPoint("HEEL_R", 4)
+        view = p.GetValuesView()
+        c = p.Clone()
+        p.SetValue(1,1,2.)
+        view[2,2] = 3.
+        self.assertEqual(view[1,1], 2.)
+        self.assertEqual(p.GetValue(2,2), 3.)
+        self.assertEqual(c.GetValue(1,1), 0.)
+        self.assertEqual(c.GetValue(2,2), 0.)
+        del c
+        view[3,0] = 4.
+        self.assertEqual(p.GetValue(3,0), 4.)
+        
+    def test_GetValuesViewReplaced(self):
+        p = btk.btkPoint("HEEL_R", 4)
+        view = p.GetValuesView()
+        view[1,1] = 2.
+        p.SetFrameNumber(10)
+        self.assertEqual(p.GetValue(1,1), 2.)
+        view[1,1] = 3.
+        self.assertEqual(view.shape, (4,3))
+        self.assertEqual(p.GetValue(1,1), 2.)
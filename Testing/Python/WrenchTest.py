@@ -77,4 +77,13 @@ class WrenchTest(unittest.TestCase):
       self.assertEqual(f.GetType(), btk.btkPoint.Force)
       self.assertEqual(f.GetValues().shape[0], 10)
       self.assertEqual(m.GetType(), btk.btkPoint.Moment)
-      self.assertEqual(m.GetValues().shape[0], 10)
\ No newline at end of file
+      self.assertEqual(m.GetValues().shape[0], 10)
+      
+    def test_GetComponentView(self):
+      test = btk.btkWrench("KneeJoint", 10)
+      self.assertEqual(test.GetPositionView().shape, (10,3))
+      force = test.GetForceView()
+      force[4,1] = 12.
+      self.assertEqual(test.GetForce().GetValue(4,1), 12.)
+      test.GetMomentView()[9,2] = -3.
+      self.assertEqual(test.GetMoment().GetValue(9,2), -3.)
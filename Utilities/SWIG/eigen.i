@@ -200,6 +200,65 @@
   template<> int NumPyType<double>() {return NPY_DOUBLE;};
 %}
 
+%fragment("Eigen_View_Fragments", "header",  fragment="Eigen_Fragments")
+%{
+  // Releases the copy of the owner stored in the base object of a NumPy view
+  template <class Owner>
+  void ReleaseNumPyViewOwner(PyObject* capsule)
+  {
+    delete static_cast<Owner*>(PyCapsule_GetPointer(capsule, NULL));
+  };
+
+  // Creates a 2D NumPy array sharing the memory of the given Eigen matrix (no copy).
+  // The strides follow the storage order of the Eigen matrix and a copy of the owner
+  // (a shared pointer) is kept in the base object of the array. The owner must own the
+  // memory of the matrix: the matrix itself or an object which never reallocates it.
+  // Then, the memory stays valid as long as the array exists.
+  template <class Derived, class Owner>
+  PyObject* CreateNumPyViewFromEigenMatrix(Eigen::PlainObjectBase<Derived>* in, const Owner& owner)
+  {
+    typedef typename Derived::Scalar Scalar;
+    npy_intp dims[2] = {in->rows(), in->cols()};
+    npy_intp strides[2];
+    if (Derived::IsRowMajor)
+    {
+      strides[0] = in->cols() * sizeof(Scalar);
+      strides[1] = sizeof(Scalar);
+    }
+    else
+    {
+      strides[0] = sizeof(Scalar);
+      strides[1] = in->rows() * sizeof(Scalar);
+    }
+#if NPY_API_VERSION < 0x00000007
+    int flags = NPY_WRITEABLE | NPY_ALIGNED;
+#else
+    int flags = NPY_ARRAY_WRITEABLE | NPY_ARRAY_ALIGNED;
+#endif
+    PyObject* out = PyArray_New(&PyArray_Type, 2, dims, NumPyType<Scalar>(), strides, in->data(), 0, flags, NULL);
+    if (out == NULL)
+      return NULL;
+    Owner* copy = new Owner(owner);
+    PyObject* base = PyCapsule_New(copy, NULL, &ReleaseNumPyViewOwner<Owner>);
+    if (base == NULL)
+    {
+      delete copy;
+      Py_DECREF(out);
+      return NULL;
+    }
+#if NPY_API_VERSION < 0x00000007
+    PyArray_BASE((PyArrayObject*)out) = base;
+#else
+    if (PyArray_SetBaseObject((PyArrayObject*)out, base) != 0)
+    {
+      Py_DECREF(out); // The reference to the base is stolen even in case of failure
+      return NULL;
+    }
+#endif
+    return out;
+  };
+%}
+
 // ----------------------------------------------------------------------------
 // Macro to create the typemap for Eigen classes
 // ----------------------------------------------------------------------------
@@ -40,6 +40,10 @@
 
 #include <Eigen/LU>
 
+#if defined(_OPENMP)
+  #include <omp.h>
+#endif
+
 #define BTKEIGEN_FILFILT_REVERSE_INPLACE(m) \
   { \
     Index dlen =  m.rows() * m.cols(); \
@@ -55,6 +59,36 @@ namespace btkEigen
 {
   using namespace Eigen;
   
+  /**
+   * Computes the initial state @a zi of the filter (@a bb, @a aa) for its step response (Gustafsson, 1996).
+   * The coefficients must be padded with zeros to have the same length.
+   */
+  template<typename VectorType>
+  void filtfilt_zi(VectorType* zi, const VectorType& bb, const VectorType& aa)
+  {
+    typedef typename VectorType::Scalar Scalar;
+    typedef typename VectorType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> FFMatrix;
+    
+    const Index order = bb.rows();
+    if (order == 2)
+    {
+      zi->resize(1,1);
+      zi->coeffRef(0) = (1.0 + aa.coeff(1)) / (bb.coeff(1) - bb.coeff(0)*aa.coeff(1));
+    }
+    else
+    {
+      FFMatrix temp(order-1,order-2);
+      temp.block(0,0,order-2,order-2) = -FFMatrix::Identity(order-2,order-2);
+      temp.block(order-2,0,1,order-2) = FFMatrix::Zero(1,order-2);
+      FFMatrix temp1(order-1,order-1);
+      temp1 << aa.block(1,0,order-1,1), temp;
+      temp1 += FFMatrix::Identity(order-1,order-1);
+      FFMatrix temp2 =  bb.block(1,0,order-1,1) - (bb.coeff(0) * aa.block(1,0,order-1,1));
+      *zi = temp1.lu().solve(temp2);
+    }
+  };
+  
   /**
    * A forward-backward digital filter without phase delay (zero phase distorsion). 
    * Compared to a simple forward filter, the order of this filter is twice of the original order and the cutoff frequency is reduced. 
@@ -72,7 +106,6 @@ namespace btkEigen
   {
     typedef typename MatrixType::Scalar Scalar;
     typedef typename MatrixType::Index Index;
-    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> FFMatrix;
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> FFVector;
   
     const Index slen = X.rows();
@@ -88,22 +121,7 @@ namespace btkEigen
     
     // Compute the initial state of the filter
     FFVector zi;
-    if (order == 2)
-    {
-      zi.resize(1,1);
-      zi.coeffRef(0) = (1.0 + aa.coeff(1)) / (bb.coeff(1) - bb.coeff(0)*aa.coeff(1));
-    }
-    else
-    {
-      FFMatrix temp(order-1,order-2);
-      temp.block(0,0,order-2,order-2) = -FFMatrix::Identity(order-2,order-2);
-      temp.block(order-2,0,1,order-2) = FFMatrix::Zero(1,order-2);
-      FFMatrix temp1(order-1,order-1);
-      temp1 << aa.block(1,0,order-1,1), temp;
-      temp1 += FFMatrix::Identity(order-1,order-1);
-      FFMatrix temp2 =  bb.block(1,0,order-1,1) - (bb.coeff(0) * aa.block(1,0,order-1,1));
-      zi = temp1.lu().solve(temp2);
-    }
+    filtfilt_zi(&zi, bb, aa);
     
     MatrixType Y = X;
     for (int i = 0 ; i < Y.cols() ; ++i)
@@ -133,5 +151,138 @@ namespace btkEigen
     
     return Y;
   };
+  
+  /**
+   * Number of channels filtered together by the function filtfilt_batch (one channel per SIMD lane).
+   */
+  enum {FiltFiltBatchSize = 4};
+  
+  /**
+   * Runs the forward-backward filtering on the padded signals stored in the workspace @a w (one channel per row, one sample per column).
+   * Each step of the recurrence updates all the channels with the same coefficients.
+   */
+  template<typename VectorType, typename WorkspaceType>
+  void filtfilt_batch_process(WorkspaceType& w, WorkspaceType& z, const VectorType& bb, const VectorType& aa, const VectorType& zi)
+  {
+    typedef typename VectorType::Index Index;
+    typedef typename VectorType::Scalar Scalar;
+    typedef Eigen::Array<Scalar, FiltFiltBatchSize, 1> Lanes;
+    
+    const Index lci = bb.rows()-1; // last index for the coefficients
+    const Index len = w.cols();
+    // Forward filter
+    for (Index k = 0 ; k < lci ; ++k)
+      z.col(k) = zi.coeff(k) * w.col(0);
+    for (Index t = 0 ; t < len ; ++t)
+    {
+      const Lanes x = w.col(t);
+      const Lanes y = z.col(0) + bb.coeff(0) * x;
+      for (Index k = 1 ; k < lci ; ++k)
+        z.col(k-1) = z.col(k) - aa.coeff(k) * y + bb.coeff(k) * x;
+      z.col(lci-1) = bb.coeff(lci) * x - aa.coeff(lci) * y;
+      w.col(t) = y;
+    }
+    // Backward filter (the workspace is read from the end instead of being reversed)
+    for (Index k = 0 ; k < lci ; ++k)
+      z.col(k) = zi.coeff(k) * w.col(len-1);
+    for (Index t = len-1 ; t >= 0 ; --t)
+    {
+      const Lanes x = w.col(t);
+      const Lanes y = z.col(0) + bb.coeff(0) * x;
+      for (Index k = 1 ; k < lci ; ++k)
+        z.col(k-1) = z.col(k) - aa.coeff(k) * y + bb.coeff(k) * x;
+      z.col(lci-1) = bb.coeff(lci) * x - aa.coeff(lci) * y;
+      w.col(t) = y;
+    }
+  };
+  
+  /**
+   * Same as the function filtfilt() but the columns of @a X are filtered by groups of FiltFiltBatchSize channels.
+   *
+   * The samples of a group are interleaved in one padded workspace (reused for every group) 
+   * and each step of the recurrence is computed for all the channels of the group at once.
+   * The reflections are written directly in the workspace and the backward pass reads it from the end. 
+   * Then, no vector is allocated or reversed for each column.
+   *
+   * When BTK is compiled with OpenMP (option BTK_USE_OPENMP), the groups are distributed between @a numberOfThreads threads
+   * (a value lower than 1 uses the default number of threads of OpenMP). Otherwise, this argument is ignored.
+   *
+   * The result is the same than the function filtfilt() up to the rounding errors.
+   */
+  template<typename NumeratorFilterCoeff, typename DenominatorFilterCoeff, typename MatrixType>
+  MatrixType filtfilt_batch(const NumeratorFilterCoeff& b, const DenominatorFilterCoeff& a, const MatrixType& X, int numberOfThreads = 1)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> FFVector;
+    typedef Eigen::Array<Scalar, FiltFiltBatchSize, Eigen::Dynamic> FFWorkspace;
+    
+    const Index slen = X.rows();
+    const Index order = std::max(b.rows(), a.rows());
+    const Index elen = 3 * (order - 1); // Number of element used in the reflections
+    
+    eigen_assert((order > 1) && "The order of the filter must be greater than 1.");
+    eigen_assert((slen > elen) && "The signal to filter must have a length 3 times greater than the order of the filter.");
+    
+    // Copy the coefficients and pad them with zeros 
+    BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,bb,b,order)
+    BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,aa,a,order)
+    
+    // Compute the initial state of the filter
+    FFVector zi;
+    filtfilt_zi(&zi, bb, aa);
+    
+    // Normalized coefficients used by the recurrence (see the function filter())
+    Scalar norm = aa.coeff(0);
+    if (norm == 0.0)
+    {
+      btkErrorMacro("Impossible to filter the signal, the first element of the denominator is equal to 0.");
+      return X;
+    }
+    else if (std::abs(norm - 1.0) > NumTraits<Scalar>::epsilon())
+    {
+      bb /= norm;
+      aa /= norm;
+    }
+    
+    MatrixType Y(X.rows(), X.cols());
+    const int groupNumber = static_cast<int>((X.cols() + FiltFiltBatchSize - 1) / FiltFiltBatchSize);
+#if defined(_OPENMP)
+    #pragma omp parallel num_threads((numberOfThreads < 1) ? omp_get_max_threads() : numberOfThreads)
+#else
+    (void)numberOfThreads;
+#endif
+    {
+      FFWorkspace w(static_cast<int>(FiltFiltBatchSize), slen + 2 * elen);
+      FFWorkspace z(static_cast<int>(FiltFiltBatchSize), order - 1);
+#if defined(_OPENMP)
+      #pragma omp for schedule(dynamic)
+#endif
+      for (int g = 0 ; g < groupNumber ; ++g)
+      {
+        const Index first = static_cast<Index>(g) * FiltFiltBatchSize;
+        const Index num = std::min(static_cast<Index>(FiltFiltBatchSize), X.cols() - first);
+        // The unused lanes of the last group are filled with its last channel.
+        Index c[FiltFiltBatchSize];
+        for (Index l = 0 ; l < FiltFiltBatchSize ; ++l)
+          c[l] = first + std::min(l, num - 1);
+        // The samples are interleaved sample by sample to read the columns of X sequentially.
+        for (Index i = 0 ; i < slen ; ++i)
+          for (Index l = 0 ; l < FiltFiltBatchSize ; ++l)
+            w.coeffRef(l, elen + i) = X.coeff(i, c[l]);
+        // Reflections at the beginning and at the end
+        for (Index i = 0 ; i < elen ; ++i)
+        {
+          w.col(i) = 2.0 * w.col(elen) - w.col(2 * elen - i);
+          w.col(elen + slen + i) = 2.0 * w.col(elen + slen - 1) - w.col(elen + slen - 2 - i);
+        }
+        filtfilt_batch_process(w, z, bb, aa, zi);
+        for (Index i = 0 ; i < slen ; ++i)
+          for (Index l = 0 ; l < num ; ++l)
+            Y.coeffRef(i, first + l) = w.coeff(l, elen + i);
+      }
+    }
+    return Y;
+  };
 };
 #endif // __btkEigenFiltFilt_h
\ No newline at end of file
@@ -0,0 +1,235 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenResample_h
+#define __btkEigenResample_h
+
+#include <Eigen/Core>
+#include <Eigen/Geometry> // M_PI
+
+#include <algorithm> // std::min, std::max
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Modified Bessel function of the first kind of order 0 (power series).
+   */
+  inline double besseli0(double x)
+  {
+    const double y = x * x / 4.0;
+    double sum = 1.0, term = 1.0;
+    for (int k = 1 ; k < 500 ; ++k)
+    {
+      term *= y / static_cast<double>(k * k);
+      sum += term;
+      if (term < sum * NumTraits<double>::epsilon())
+        break;
+    }
+    return sum;
+  };
+  
+  /**
+   * Kaiser window of @a n points with the shape parameter @a beta.
+   */
+  inline void kaiser(Eigen::Matrix<double, Eigen::Dynamic, 1>* w, int n, double beta)
+  {
+    w->resize(n);
+    if (n == 1)
+    {
+      w->coeffRef(0) = 1.0;
+      return;
+    }
+    const double norm = besseli0(beta);
+    for (int i = 0 ; i < n ; ++i)
+    {
+      const double r = 2.0 * static_cast<double>(i) / static_cast<double>(n - 1) - 1.0;
+      w->coeffRef(i) = besseli0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+    }
+  };
+  
+  /**
+   * Lowpass FIR filter of @a numtaps coefficients designed by the window method (Kaiser window).
+   * The cutoff frequency @a cutoff is normalized to the Nyquist frequency (i.e. 1.0 corresponds to the half of the sample rate).
+   * The coefficients are scaled to have a unit gain at the frequency 0.
+   *
+   * Inspired by the function firwin provided in SciPy.
+   */
+  inline bool firwin(Eigen::Matrix<double, Eigen::Dynamic, 1>* h, int numtaps, double cutoff, double beta = 5.0)
+  {
+    if ((numtaps < 1) || (cutoff <= 0.0) || (cutoff > 1.0))
+      return false;
+    kaiser(h, numtaps, beta);
+    const double alpha = 0.5 * static_cast<double>(numtaps - 1);
+    for (int i = 0 ; i < numtaps ; ++i)
+    {
+      const double m = M_PI * cutoff * (static_cast<double>(i) - alpha);
+      h->coeffRef(i) *= cutoff * ((m == 0.0) ? 1.0 : std::sin(m) / m);
+    }
+    *h /= h->sum();
+    return true;
+  };
+  
+  /**
+   * Greatest common divisor of two positive integers.
+   */
+  inline int gcd(int a, int b)
+  {
+    while (b != 0)
+    {
+      int r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
+  };
+  
+  /**
+   * Rational resampling (@a up / @a down) of 1D signals by a polyphase FIR filter.
+   *
+   * The signal is conceptually upsampled by inserting @a up - 1 zeros between each sample, lowpass filtered to
+   * remove the images and the aliasing, and then downsampled by keeping one sample every @a down samples.
+   * The polyphase decomposition computes only the kept samples and skips the multiplications by the inserted zeros.
+   * The delay of the filter is compensated: the output sample @c k corresponds to the time <tt>k * down / up</tt> of the input.
+   * The signal is extended with its first and last values to reduce the edge effects.
+   *
+   * By default, the filter is designed as in the function resample_poly provided in SciPy
+   * (Kaiser window, beta = 5, cutoff at the lowest Nyquist frequency, <tt>20 * max(up,down) + 1</tt> coefficients).
+   *
+   * The design is computed once in the constructor and the method Process() is const. 
+   * Then, one object can be shared to resample several channels, even from several threads.
+   */
+  class PolyphaseResampler
+  {
+  public:
+    PolyphaseResampler(int up, int down, int halfLength = 10, double beta = 5.0)
+    {
+      const int g = gcd(std::max(up,1), std::max(down,1));
+      this->m_Up = std::max(up,1) / g;
+      this->m_Down = std::max(down,1) / g;
+      const int maxRate = std::max(this->m_Up, this->m_Down);
+      Eigen::Matrix<double, Eigen::Dynamic, 1> h;
+      if ((maxRate == 1) || !firwin(&h, 2 * halfLength * maxRate + 1, 1.0 / static_cast<double>(maxRate), beta))
+        h.setOnes(1);
+      h *= static_cast<double>(this->m_Up);
+      this->m_Delay = static_cast<int>(h.rows() - 1) / 2;
+      // Phase p uses the coefficients h[p], h[p+up], h[p+2*up], ... (padded with zeros)
+      const int len = (static_cast<int>(h.rows()) + this->m_Up - 1) / this->m_Up;
+      this->m_Phases.setZero(len, this->m_Up);
+      for (int i = 0 ; i < h.rows() ; ++i)
+        this->m_Phases.coeffRef(i / this->m_Up, i % this->m_Up) = h.coeff(i);
+    };
+    
+    int GetUp() const {return this->m_Up;};
+    int GetDown() const {return this->m_Down;};
+    int GetPhaseLength() const {return static_cast<int>(this->m_Phases.rows());};
+    
+    /**
+     * Returns the number of samples obtained by resampling a signal of @a n samples (i.e. <tt>ceil(n * up / down)</tt>).
+     */
+    int GetOutputLength(int n) const
+    {
+      return static_cast<int>((static_cast<long long>(n) * this->m_Up + this->m_Down - 1) / this->m_Down);
+    };
+    
+    /**
+     * Sets in @a first and @a last the indices of the first and last input samples (among @a n) used to compute the output sample @a k.
+     */
+    void GetInputRange(int k, int n, int* first, int* last) const
+    {
+      const long long j = (static_cast<long long>(k) * this->m_Down + this->m_Delay) / this->m_Up;
+      const long long len = static_cast<long long>(this->m_Phases.rows());
+      *first = static_cast<int>(std::min(std::max(j - len + 1, 0LL), static_cast<long long>(n - 1)));
+      *last = static_cast<int>(std::min(std::max(j, 0LL), static_cast<long long>(n - 1)));
+    };
+    
+    /**
+     * Resamples the @a n samples of @a x and writes GetOutputLength(n) samples in @a y.
+     */
+    void Process(const double* x, int n, double* y) const
+    {
+      if (n <= 0)
+        return;
+      const int len = static_cast<int>(this->m_Phases.rows());
+      const int num = this->GetOutputLength(n);
+      for (int k = 0 ; k < num ; ++k)
+      {
+        const long long t = static_cast<long long>(k) * this->m_Down + this->m_Delay;
+        const int p = static_cast<int>(t % this->m_Up);
+        const long long j = t / this->m_Up;
+        const double* h = this->m_Phases.data() + p * len;
+        double s = 0.0;
+        if ((j - len + 1 >= 0) && (j < n))
+        {
+          const double* xj = x + j;
+          for (int i = 0 ; i < len ; ++i)
+            s += h[i] * xj[-i];
+        }
+        else
+        {
+          for (int i = 0 ; i < len ; ++i)
+            s += h[i] * x[static_cast<int>(std::min(std::max(j - i, 0LL), static_cast<long long>(n - 1)))];
+        }
+        y[k] = s;
+      }
+    };
+    
+  private:
+    int m_Up;
+    int m_Down;
+    int m_Delay;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> m_Phases; // One column per phase
+  };
+  
+  /**
+   * Convenient function to resample each column of @a X by the ratio @a up / @a down.
+   */
+  template <typename MatrixType>
+  Eigen::Matrix<typename MatrixType::Scalar, Eigen::Dynamic, Eigen::Dynamic> resample_poly(const MatrixType& X, int up, int down)
+  {
+    typedef Eigen::Matrix<typename MatrixType::Scalar, Eigen::Dynamic, Eigen::Dynamic> RMatrix;
+    PolyphaseResampler resampler(up, down);
+    const int n = static_cast<int>(X.rows());
+    RMatrix Y(resampler.GetOutputLength(n), X.cols());
+    for (int i = 0 ; i < X.cols() ; ++i)
+    {
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> x = X.col(i);
+      resampler.Process(x.data(), n, Y.col(i).data());
+    }
+    return Y;
+  };
+};
+#endif // __btkEigenResample_h
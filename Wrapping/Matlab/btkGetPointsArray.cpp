@@ -0,0 +1,200 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkMex.h"
+#include "btkMEXObjectHandle.h"
+
+#include <btkAcquisition.h>
+#include <btkThread_p.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <cstring>
+
+// Minimum number of bytes copied by each thread.
+static const size_t _btk_get_points_array_thread_minimum_size = 1048576;
+
+// Points [begin, end) copied by one thread into the preallocated outputs.
+struct btkGetPointsArrayChunk
+{
+  const double* const* values;
+  const double* const* residuals;
+  int begin;
+  int end;
+  int frameNumber;
+  double* outValues;
+  double* outResiduals;
+};
+
+// The values of a point (frames x 3, column major) have the same layout than the slice of
+// the output (frames x 3 x points), so each point is copied in one block.
+static void btkGetPointsArrayCopy(void* data)
+{
+  btkGetPointsArrayChunk* chunk = static_cast<btkGetPointsArrayChunk*>(data);
+  const size_t valuesSize = 3 * static_cast<size_t>(chunk->frameNumber);
+  const size_t residualsSize = static_cast<size_t>(chunk->frameNumber);
+  for (int i = chunk->begin ; i < chunk->end ; ++i)
+  {
+    memcpy(chunk->outValues + i * valuesSize, chunk->values[i], valuesSize * sizeof(double));
+    if (chunk->outResiduals != 0)
+      memcpy(chunk->outResiduals + i * residualsSize, chunk->residuals[i], residualsSize * sizeof(double));
+  }
+};
+
+static std::string btkGetPointsArrayLabel(const mxArray* label)
+{
+  if (!label || !mxIsChar(label))
+    mexErrMsgTxt("The labels must be given as a string or a cell array of strings.");
+  size_t strlen_ = (mxGetM(label) * mxGetN(label) * sizeof(mxChar)) + 1;
+  char* buffer = (char*)mxMalloc(strlen_);
+  mxGetString(label, buffer, strlen_);
+  std::string str = std::string(buffer);
+  mxFree(buffer);
+  return str;
+};
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  if ((nrhs < 1) || (nrhs > 3))
+    mexErrMsgTxt("One to three inputs required.");
+  if (nlhs > 3)
+    mexErrMsgTxt("Too many output arguments.");
+  if ((nrhs == 3) && (!mxIsNumeric(prhs[2]) || mxIsEmpty(prhs[2]) || mxIsComplex(prhs[2]) || (mxGetNumberOfElements(prhs[2]) != 1)))
+    mexErrMsgTxt("The number of threads must be set by a single integer.");
+
+  btk::Acquisition::Pointer acq = btk_MOH_get_object<btk::Acquisition>(prhs[0]);
+  const int numberOfFrames = acq->GetPointFrameNumber();
+
+  // Points to extract
+  std::vector<btk::Point::Pointer> points;
+  if ((nrhs < 2) || mxIsEmpty(prhs[1]))
+    points.assign(acq->BeginPoint(), acq->EndPoint());
+  else
+  {
+    std::vector<std::string> labels;
+    if (mxIsCell(prhs[1]))
+    {
+      labels.resize(mxGetNumberOfElements(prhs[1]));
+      for (size_t i = 0 ; i < labels.size() ; ++i)
+        labels[i] = btkGetPointsArrayLabel(mxGetCell(prhs[1], i));
+    }
+    else
+      labels.push_back(btkGetPointsArrayLabel(prhs[1]));
+    // Index built once to not search linearly each label (the first point with a given label is kept, like with FindPoint).
+    std::map<std::string, btk::Point::Pointer> index;
+    for (btk::Acquisition::PointConstIterator it = acq->BeginPoint() ; it != acq->EndPoint() ; ++it)
+      index.insert(std::make_pair((*it)->GetLabel(), *it));
+    points.resize(labels.size());
+    for (size_t i = 0 ; i < labels.size() ; ++i)
+    {
+      std::map<std::string, btk::Point::Pointer>::const_iterator it = index.find(labels[i]);
+      if (it == index.end())
+      {
+        std::string err = "No point with label: '" + labels[i] + "'.";
+        mexErrMsgTxt(err.c_str());
+      }
+      points[i] = it->second;
+    }
+  }
+  const int numberOfPoints = static_cast<int>(points.size());
+
+  // The data are loaded (if necessary) in this thread. The other threads only copy memory.
+  std::vector<const double*> values(numberOfPoints);
+  std::vector<const double*> residuals(numberOfPoints);
+  for (int i = 0 ; i < numberOfPoints ; ++i)
+  {
+    const btk::Point* point = points[i].get();
+    if (point->GetValues().rows() != numberOfFrames)
+    {
+      std::string err = "The point '" + point->GetLabel() + "' has not the same number of frames than the acquisition.";
+      mexErrMsgTxt(err.c_str());
+    }
+    values[i] = point->GetValues().data();
+    residuals[i] = point->GetResiduals().data();
+  }
+
+  mwSize dims[3] = {static_cast<mwSize>(numberOfFrames), 3, static_cast<mwSize>(numberOfPoints)};
+  plhs[0] = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+  btkGetPointsArrayChunk chunk;
+  chunk.values = 0;
+  chunk.residuals = 0;
+  chunk.begin = 0;
+  chunk.end = numberOfPoints;
+  chunk.frameNumber = numberOfFrames;
+  chunk.outValues = mxGetPr(plhs[0]);
+  chunk.outResiduals = 0;
+  if (nlhs > 1)
+  {
+    plhs[1] = mxCreateDoubleMatrix(numberOfFrames, numberOfPoints, mxREAL);
+    chunk.outResiduals = mxGetPr(plhs[1]);
+  }
+  if (nlhs > 2)
+  {
+    plhs[2] = mxCreateCellMatrix(1, numberOfPoints);
+    for (int i = 0 ; i < numberOfPoints ; ++i)
+      mxSetCell(plhs[2], i, mxCreateString(points[i]->GetLabel().c_str()));
+  }
+  if (numberOfPoints == 0)
+    return;
+
+  // Copy
+  chunk.values = &(values[0]);
+  chunk.residuals = &(residuals[0]);
+  int numberOfThreads = (nrhs == 3) ? static_cast<int>(mxGetScalar(prhs[2])) : 1;
+  if (numberOfThreads < 1)
+    numberOfThreads = btk::thread_p::GetNumberOfProcessors();
+  const size_t size = static_cast<size_t>(numberOfPoints) * numberOfFrames * ((chunk.outResiduals != 0) ? 4 : 3) * sizeof(double);
+  numberOfThreads = static_cast<int>(std::min(static_cast<size_t>(std::min(numberOfThreads, numberOfPoints)), std::max(size / _btk_get_points_array_thread_minimum_size, static_cast<size_t>(1))));
+  if (numberOfThreads == 1)
+  {
+    btkGetPointsArrayCopy(&chunk);
+    return;
+  }
+  std::vector<btkGetPointsArrayChunk> chunks(numberOfThreads, chunk);
+  for (int i = 0 ; i < numberOfThreads ; ++i)
+  {
+    chunks[i].begin = static_cast<int>(static_cast<size_t>(numberOfPoints) * i / numberOfThreads);
+    chunks[i].end = static_cast<int>(static_cast<size_t>(numberOfPoints) * (i + 1) / numberOfThreads);
+  }
+  // The last chunk is copied in the calling thread.
+  btk::thread_p* threads = new btk::thread_p[numberOfThreads - 1];
+  for (int i = 0 ; i < numberOfThreads - 1 ; ++i)
+    threads[i].Start(&btkGetPointsArrayCopy, &(chunks[i]));
+  btkGetPointsArrayCopy(&(chunks[numberOfThreads - 1]));
+  for (int i = 0 ; i < numberOfThreads - 1 ; ++i)
+    threads[i].Join();
+  delete[] threads;
+};
@@ -69,7 +69,7 @@ void btkMXCreateAnalysisStructure(btk::Acquisition::Pointer acq, int nlhs, mxArr
         size_t num = 0;
         if (it != (*itAnalysis)->End())
         {
-          num = ((numberOfParameters > (*it)->GetInfo()->GetValues().size()) ? (*it)->GetInfo()->GetValues().size() : numberOfParameters);
+          num = ((numberOfParameters > static_cast<size_t>((*it)->GetInfo()->GetValueNumber())) ? static_cast<size_t>((*it)->GetInfo()->GetValueNumber()) : numberOfParameters);
           for (size_t i = 0 ; i < num ; ++i)
             entryValues[inc][i] = btkTrimString((*it)->GetInfo()->ToString((int)i));
         }
@@ -76,7 +76,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     mexErrMsgTxt("No metadata's info.");
   
   size_t index = static_cast<size_t>(mxGetScalar(prhs[nrhs-2])) - 1;
-  if (index >= (*it)->GetInfo()->GetValues().size())
+  if (index >= static_cast<size_t>((*it)->GetInfo()->GetValueNumber()))
     mexErrMsgTxt("Invalid index to extract one metadata's value.");
     
   const mxArray* data = 0; 
@@ -70,4 +70,4 @@ public:
   BTK_SWIG_DECLARE_CLONE(MetaData);
   BTK_SWIG_DECLARE_POINTER_OPERATOR(MetaData);
 };
-BTK_SWIG_DECLARE_ITERATOR(MetaData,MetaData);
\ No newline at end of file
+BTK_SWIG_DECLARE_ITERATOR(MetaData,MetaData,btk::MetaData);
\ No newline at end of file
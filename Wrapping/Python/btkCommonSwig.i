@@ -40,6 +40,7 @@
 %include <std_string.i>
 %include <std_vector.i>
 %include <eigen.i>
+%fragment("Eigen_View_Fragments");
 
 #undef BTK_SWIG_HEADER_DECLARATION
 
@@ -92,6 +93,7 @@ protected:
 %include "Common/btkCommonSwig_Analog.h"
 
 BTK_SWIG_EXTEND_CLASS_GETSET_VECTOR(Analog, Value);
+BTK_SWIG_EXTEND_CLASS_GET_DATA_VIEW(Analog, Values);
 BTK_SWIG_DECLARE_IMPL_CLASS_DATA(Analog)
 {
 public:
@@ -136,6 +138,8 @@ protected:
 
 BTK_SWIG_EXTEND_CLASS_GETSET_MATRIX(Point, Value);
 BTK_SWIG_EXTEND_CLASS_GETSET_VECTOR(Point, Residual);
+BTK_SWIG_EXTEND_CLASS_GET_DATA_VIEW(Point, Values);
+BTK_SWIG_EXTEND_CLASS_GET_DATA_VIEW(Point, Residuals);
 BTK_SWIG_DECLARE_IMPL_CLASS_DATA(Point)
 {
 public:
@@ -180,6 +184,9 @@ protected:
 
 %include "Common/btkCommonSwig_ForcePlatform.h"
 
+BTK_SWIG_EXTEND_CLASS_GET_VIEW(ForcePlatform, Origin);
+BTK_SWIG_EXTEND_CLASS_GET_VIEW(ForcePlatform, Corners);
+BTK_SWIG_EXTEND_CLASS_GET_VIEW(ForcePlatform, CalMatrix);
 %extend btkForcePlatform
 { 
   %pythoncode
@@ -247,6 +254,14 @@ protected:
 
 %include "Common/btkCommonSwig_Wrench.h"
 
+%extend btkWrench
+{
+  // The views keep alive the point owning the values.
+  PyObject* GetPositionView() {btkSharedPtr<btk::Point::Values> v = (*$self)->GetPosition()->GetData()->GetValuesPointer(); return CreateNumPyViewFromEigenMatrix(v.get(), v);};
+  PyObject* GetForceView() {btkSharedPtr<btk::Point::Values> v = (*$self)->GetForce()->GetData()->GetValuesPointer(); return CreateNumPyViewFromEigenMatrix(v.get(), v);};
+  PyObject* GetMomentView() {btkSharedPtr<btk::Point::Values> v = (*$self)->GetMoment()->GetData()->GetValuesPointer(); return CreateNumPyViewFromEigenMatrix(v.get(), v);};
+}
+
 BTK_SWIG_DECLARE_IMPL_CLASS_DATA(Wrench)
 {
 public:
@@ -341,7 +356,7 @@ namespace std
   void SetDimension(int idx, int val) {(*$self)->SetDimension(idx, static_cast<uint8_t>(val));};
   const std::vector<int> GetDimensions() const {return btkSwigConvert<int>((*$self)->GetDimensions());};
   void SetDimensions(const std::vector<int>& dims) {(*$self)->SetDimensions(btkSwigConvert<uint8_t>(dims));};
-  int GetValueNumber() const {return (*$self)->GetValues().size();};
+  int GetValueNumber() const {return (*$self)->GetValueNumber();};
   void SetValue(int idx, const std::string& val) {(*$self)->SetValue(idx, val);};
   void SetValue(int idx, int val) {(*$self)->SetValue(idx, static_cast<int16_t>(val));};
   void SetValue(int idx, double val) {(*$self)->SetValue(idx, static_cast<float>(val));};
@@ -467,6 +482,35 @@ protected:
 
 %include "Common/btkCommonSwig_Acquisition.h"
 
+%extend btkAcquisition
+{
+  PyObject* GetPointsArray()
+  {
+    const btk::Acquisition& acq = *(*$self);
+    const int frameNumber = acq.GetPointFrameNumber();
+    const int pointNumber = acq.GetPointNumber();
+    for (btk::Acquisition::PointConstIterator it = acq.BeginPoint() ; it != acq.EndPoint() ; ++it)
+    {
+      if (static_cast<const btk::Point&>(**it).GetValues().rows() != frameNumber)
+        throw(btk::RuntimeError("The point '" + (*it)->GetLabel() + "' has not the same number of frames than the acquisition."));
+    }
+    npy_intp dims[3] = {frameNumber, pointNumber, 3};
+    PyObject* out = PyArray_SimpleNew(3, dims, NPY_DOUBLE);
+    if (out == NULL)
+      return NULL;
+    // Each point is copied in one pass into a strided map over its slice (frames x 3) of the C-ordered array.
+    typedef Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>, Eigen::Unaligned, Eigen::OuterStride<> > Slice;
+    double* data = static_cast<double*>(PyArray_DATA((PyArrayObject*)out));
+    int inc = 0;
+    for (btk::Acquisition::PointConstIterator it = acq.BeginPoint() ; it != acq.EndPoint() ; ++it)
+    {
+      Slice(data + 3 * inc, frameNumber, 3, Eigen::OuterStride<>(3 * pointNumber)) = static_cast<const btk::Point&>(**it).GetValues();
+      ++inc;
+    }
+    return out;
+  };
+}
+
 BTK_SWIG_DECLARE_IMPL_CLASS_DATA(Acquisition)
 {
 public:
@@ -135,6 +135,7 @@ BTK_SWIG_AUTODOC_IMPL(Analog, SetLabel, "SetLabel(self, string)");
 BTK_SWIG_AUTODOC_IMPL(Analog, SetDescription, "SetDescription(self, string)");
 BTK_SWIG_AUTODOC(Analog, SetValue, "SetValue(self, int, double)");
 BTK_SWIG_AUTODOC_IMPL(Analog, GetValues, "GetValues(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(Analog, GetValuesView, "GetValuesView(self) -> array (NumPy)");
 BTK_SWIG_AUTODOC_IMPL(Analog, SetValues, "SetValues(self, array)");
 BTK_SWIG_AUTODOC_IMPL(Analog, SetFrameNumber, "SetFrameNumber(self, int)");
 BTK_SWIG_AUTODOC_IMPL(Analog, SetUnit, "SetUnit(self, string)");
@@ -151,6 +152,7 @@ BTK_SWIG_DOCSTRING(Analog, GetValue, "Returns only one sample.");
 BTK_SWIG_DOCSTRING(Analog, SetValue, "Sets only one sample.");
 BTK_SWIG_DOCSTRING_IMPL(Analog, GetValues, "Returns the analog's samples.\nWARNING:You cannot set values using this method. Use the methods SetValues of SetValue for that.");
 BTK_SWIG_DOCSTRING_IMPL(Analog, SetValues, "Sets the analog's samples.");
+BTK_SWIG_DOCSTRING(Analog, GetValuesView, "Returns the analog's samples without copy.\nThe array owns the memory of the values: it stays valid even if the object is destroyed. Modifying the array modifies the object and vice versa, until the object replaces its values. The array keeps then the old values and is not linked to the object anymore. The values are replaced by SetValues (with another number of frames), SetFrameNumber (any new number of frames), SetData, and for the analog channel of an acquisition by its methods Init, Resize, ResizeFrameNumber and ResizeFrameNumberFromEnd. A clone created after the array receives its own copy of the values and is not modified by the array.");
 BTK_SWIG_DOCSTRING_IMPL(Analog, GetFrameNumber, "Returns the number of frames.");
 BTK_SWIG_DOCSTRING_IMPL(Analog, SetFrameNumber, "Sets the number of frames.");
 BTK_SWIG_DOCSTRING_IMPL(Analog, GetUnit, "Returns the analog's unit.");
@@ -213,9 +215,11 @@ BTK_SWIG_AUTODOC_IMPL(Point, SetLabel, "SetLabel(self, string)");
 BTK_SWIG_AUTODOC_IMPL(Point, SetDescription, "SetDescription(self, string)");
 BTK_SWIG_AUTODOC(Point, SetValue, "SetValue(self, int, int, double)");
 BTK_SWIG_AUTODOC_IMPL(Point, GetValues, "GetValues(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(Point, GetValuesView, "GetValuesView(self) -> array (NumPy)");
 BTK_SWIG_AUTODOC_IMPL(Point, SetValues, "SetValues(self, array)");
 BTK_SWIG_AUTODOC(Point, SetResidual, "SetResidual(self, int, double)");
 BTK_SWIG_AUTODOC_IMPL(Point, GetResiduals, "GetResiduals(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(Point, GetResidualsView, "GetResidualsView(self) -> array (NumPy)");
 BTK_SWIG_AUTODOC_IMPL(Point, SetResiduals, "SetResiduals(self, array)");
 BTK_SWIG_AUTODOC_IMPL(Point, SetFrameNumber, "SetFrameNumber(self, int)");
 BTK_SWIG_AUTODOC_IMPL(Point, SetType, "SetUnit(self, int)");
@@ -231,10 +235,12 @@ BTK_SWIG_DOCSTRING(Point, GetValue, "Returns only one value for the given compon
 BTK_SWIG_DOCSTRING(Point, SetValue, "Sets only one value for the given component and frame.");
 BTK_SWIG_DOCSTRING_IMPL(Point, GetValues, "Returns the point's values.\nWARNING:You cannot set values using this method. Use the methods SetValues of SetValue for that.");
 BTK_SWIG_DOCSTRING_IMPL(Point, SetValues, "Sets the point's values.");
+BTK_SWIG_DOCSTRING(Point, GetValuesView, "Returns the point's values without copy.\nThe array owns the memory of the values: it stays valid even if the object is destroyed. Modifying the array modifies the object and vice versa, until the object replaces its values. The array keeps then the old values and is not linked to the object anymore. The values are replaced by SetValues (with another number of frames), SetFrameNumber (any new number of frames), SetData, and for the point of an acquisition by its methods Init, Resize, ResizeFrameNumber, ResizeFrameNumberFromEnd, and with the contiguous storage of the points by ResizePointNumber, SetPointStorage, GetPointValuesBlock and GetPointResidualsBlock. A clone created after the array receives its own copy of the values and is not modified by the array.");
 BTK_SWIG_DOCSTRING(Point, GetResidual, "Returns only one residual for the given frame.");
 BTK_SWIG_DOCSTRING(Point, SetResidual, "Sets only one residual for the given frame.");
 BTK_SWIG_DOCSTRING_IMPL(Point, GetResiduals, "Returns the point's residuals.");
 BTK_SWIG_DOCSTRING_IMPL(Point, SetResiduals, "Sets the point's residuals.");
+BTK_SWIG_DOCSTRING(Point, GetResidualsView, "Returns the point's residuals without copy.\nThe array owns the memory of the values: it stays valid even if the object is destroyed. Modifying the array modifies the object and vice versa, until the object replaces its values. The array keeps then the old values and is not linked to the object anymore. The values are replaced by SetResiduals (with another number of frames), SetFrameNumber (any new number of frames), SetData, and for the point of an acquisition by its methods Init, Resize, ResizeFrameNumber, ResizeFrameNumberFromEnd, and with the contiguous storage of the points by ResizePointNumber, SetPointStorage, GetPointValuesBlock and GetPointResidualsBlock. A clone created after the array receives its own copy of the values and is not modified by the array.");
 BTK_SWIG_DOCSTRING_IMPL(Point, GetFrameNumber, "Returns the number of frames.");
 BTK_SWIG_DOCSTRING_IMPL(Point, SetFrameNumber, "Sets the number of frames.");
 BTK_SWIG_DOCSTRING_IMPL(Point, GetType, "Returns the point's type.");
@@ -289,6 +295,7 @@ BTK_SWIG_AUTODOC_IMPL(ForcePlatform, End, "End(self) -> btkAnalogIterator");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, GetChannel, "GetChannel(self, int) -> btkAnalog)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, SetChannel, "SetChannel(self, int , btkAnalog)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, GetOrigin, "GetOrigin(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(ForcePlatform, GetOriginView, "GetOriginView(self) -> array (NumPy)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, SetOrigin(double , double , double ), "_set_origin_2(self, double, double, double)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, SetOrigin(const btk::ForcePlatform::Origin& ), "_set_origin_1(self, array)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, GetCorner, "GetCorner(self, int) -> array (NumPy)");
@@ -298,6 +305,8 @@ BTK_SWIG_AUTODOC_IMPL(ForcePlatform, SetCorner(int, const btk::ForcePlatform::Co
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, GetCorners, "GetCorners(self) -> array (NumPy)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, SetCorners, "SetCorners(self, array)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, GetCalMatrix, "GetCalMatrix(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(ForcePlatform, GetCornersView, "GetCornersView(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(ForcePlatform, GetCalMatrixView, "GetCalMatrixView(self) -> array (NumPy)");
 BTK_SWIG_AUTODOC_IMPL(ForcePlatform, SetCalMatrix, "SetCalMatrix(self, array)");
 
 BTK_SWIG_DOCSTRING(ForcePlatform, Clone, "Deep copy of the object.");
@@ -314,6 +323,9 @@ BTK_SWIG_DOCSTRING_IMPL(ForcePlatform, SetCorner, "Internal method. Sets the cor
 BTK_SWIG_DOCSTRING_IMPL(ForcePlatform, GetCorners, "Returns corners' coordinates.");
 BTK_SWIG_DOCSTRING_IMPL(ForcePlatform, SetCorners, "Sets corners' coordinates.");
 BTK_SWIG_DOCSTRING_IMPL(ForcePlatform, GetCalMatrix, "Returns the calibration matrix.");
+BTK_SWIG_DOCSTRING(ForcePlatform, GetOriginView, "Returns the origin of the force platform without copy. Modifying the array modifies the force platform.");
+BTK_SWIG_DOCSTRING(ForcePlatform, GetCornersView, "Returns corners' coordinates without copy. Modifying the array modifies the force platform.");
+BTK_SWIG_DOCSTRING(ForcePlatform, GetCalMatrixView, "Returns the calibration matrix without copy. Modifying the array modifies the force platform and the array keeps the force platform alive. Setting a calibration matrix with other dimensions (SetCalMatrix) releases the memory used by the array which must not be used anymore.");
 BTK_SWIG_DOCSTRING_IMPL(ForcePlatform, SetCalMatrix, "Sets the calibration matrix.");
 BTK_SWIG_DOCSTRING_IMPL(ForcePlatform, GetType, "Returns the type of the force platform.");
 
@@ -388,6 +400,9 @@ BTK_SWIG_AUTODOC_IMPL(Wrench, SetForce, "SetForce(self, btkPoint)");
 BTK_SWIG_AUTODOC_IMPL(Wrench, SetMoment, "SetMoment(self, btkPoint)");
 BTK_SWIG_AUTODOC_IMPL(Wrench, GetComponent, "GetComponent(self, int) -> btkPoint)");
 BTK_SWIG_AUTODOC_IMPL(Wrench, SetFrameNumber, "SetFrameNumber(self, int)");
+BTK_SWIG_AUTODOC(Wrench, GetPositionView, "GetPositionView(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(Wrench, GetForceView, "GetForceView(self) -> array (NumPy)");
+BTK_SWIG_AUTODOC(Wrench, GetMomentView, "GetMomentView(self) -> array (NumPy)");
 
 BTK_SWIG_DOCSTRING_IMPL(Wrench, GetPosition, "Returns the wrench's position.");
 BTK_SWIG_DOCSTRING_IMPL(Wrench, SetPosition, "Sets the wrench's position.");
@@ -397,6 +412,9 @@ BTK_SWIG_DOCSTRING_IMPL(Wrench, GetMoment, "Returns the wrench's moment.");
 BTK_SWIG_DOCSTRING_IMPL(Wrench, SetForce, "Sets the wrench's moment.");
 BTK_SWIG_DOCSTRING_IMPL(Wrench, GetComponent, "Returns the component with the given index. The possible value for the index are: 0: Returns the position, 1: Returns the force, 2: Returns the moment. Any other value will trigger an exception.");
 BTK_SWIG_DOCSTRING_IMPL(Wrench, SetFrameNumber, "Set the number of frames in the wrenches. The given number of frames must be greater than 0.");
+BTK_SWIG_DOCSTRING(Wrench, GetPositionView, "Returns the values of the wrench's position without copy (see btkPoint::GetValuesView).");
+BTK_SWIG_DOCSTRING(Wrench, GetForceView, "Returns the values of the wrench's force without copy (see btkPoint::GetValuesView).");
+BTK_SWIG_DOCSTRING(Wrench, GetMomentView, "Returns the values of the wrench's moment without copy (see btkPoint::GetValuesView).");
 BTK_SWIG_DOCSTRING(btkWrench, Clone, "Deep copy of the object.");
 
 // ------------------------------------------------------------------------- //
@@ -863,6 +881,8 @@ BTK_SWIG_DOCSTRING_IMPL(Acquisition, EndPoint, "Returns an iterator just past th
 BTK_SWIG_DOCSTRING_IMPL(Acquisition, GetPoint, "Gets the point at the given index or label. If no Point exists, then an exception is thrown.");
 BTK_SWIG_DOCSTRING_IMPL(Acquisition, SetPoint, "Sets the content of a point at the given index.");
 BTK_SWIG_DOCSTRING_IMPL(Acquisition, GetPoints, "Returns the collection of points.");
+BTK_SWIG_AUTODOC(Acquisition, GetPointsArray, "GetPointsArray(self) -> array (NumPy)");
+BTK_SWIG_DOCSTRING(Acquisition, GetPointsArray, "Returns the values of all the points in one array of size frames x points x 3. The values are copied.");
 BTK_SWIG_DOCSTRING_IMPL(Acquisition, SetPoints, "Sets points for this acquisition.");
 BTK_SWIG_DOCSTRING_IMPL(Acquisition, IsEmptyPoint, "Checks if the points' list is empty.");
 BTK_SWIG_DOCSTRING_IMPL(Acquisition, GetPointNumber, "Returns the number of points.");
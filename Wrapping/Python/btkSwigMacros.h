@@ -178,25 +178,47 @@
     }; \
   }
   
+// Returns a NumPy array sharing the memory of the Eigen matrix (see the fragment Eigen_View_Fragments).
+#define BTK_SWIG_EXTEND_CLASS_GET_VIEW(classname, method) \
+  %extend btk##classname \
+  { \
+    PyObject* Get##method##View() \
+    { \
+      return CreateNumPyViewFromEigenMatrix(&((*$self)->Get##method()), static_cast<const btk##classname##_shared&>(*$self)); \
+    }; \
+  }
+
+// Returns a NumPy array sharing the memory of the measure's data (see the fragment Eigen_View_Fragments).
+// The array owns the matrix and not the measure, as the matrix is replaced in some cases (copy-on-write, resizing, ...).
+#define BTK_SWIG_EXTEND_CLASS_GET_DATA_VIEW(classname, method) \
+  %extend btk##classname \
+  { \
+    PyObject* Get##method##View() \
+    { \
+      btkSharedPtr<btk::classname::method> m = (*$self)->GetData()->Get##method##Pointer(); \
+      return CreateNumPyViewFromEigenMatrix(m.get(), m); \
+    }; \
+  }
+  
 // ------------------------------------------------------------------------- //
 //                      Macros for btk<class>Iterator                        //
 // ------------------------------------------------------------------------- //
   
 #ifdef BTK_SWIG_HEADER_DECLARATION
-  #define BTK_SWIG_DECLARE_ITERATOR(classname, elt) \
-    class btk##classname##Iterator : public std::list<btk##elt##_shared>::iterator \
+  #define BTK_SWIG_DECLARE_ITERATOR(classname, elt, container) \
+    class btk##classname##Iterator : public container::Iterator \
     { \
     public: \
-      btk##classname##Iterator() : std::list<btk##elt##_shared>::iterator() {}; \
-      btk##classname##Iterator(const std::list<btk##elt##_shared>::iterator& toCopy) : std::list<btk##elt##_shared>::iterator(toCopy) {}; \
+      btk##classname##Iterator() : container::Iterator() {}; \
+      btk##classname##Iterator(const container::Iterator& toCopy) : container::Iterator(toCopy) {}; \
       void incr() {this->operator++();}; \
       void decr() {this->operator--();}; \
       btk##elt value() {return this->operator*();}; \
-      bool operator==(const btk##classname##Iterator& rhs) {return static_cast<const std::list<btk##elt##_shared>::iterator&>(*this) == static_cast<const std::list<btk##elt##_shared>::iterator&>(rhs);}; \
+      bool operator==(const btk##classname##Iterator& rhs) {return static_cast<const container::Iterator&>(*this) == static_cast<const container::Iterator&>(rhs);}; \
       bool operator!=(const btk##classname##Iterator& rhs) {return !(*this == rhs);}; \
     };
 #else
-  #define BTK_SWIG_DECLARE_ITERATOR(classname, elt) \
+  #define BTK_SWIG_DECLARE_ITERATOR(classname, elt, container) \
     class btk##classname##Iterator \
     { \
     public: \
@@ -214,7 +236,7 @@
 // ------------------------------------------------------------------------- //
 
 #define BTK_SWIG_DECLARE_COLLECTION(elt) \
-  BTK_SWIG_DECLARE_ITERATOR(elt##Collection,elt) \
+  BTK_SWIG_DECLARE_ITERATOR(elt##Collection,elt,btk::Collection<btk::elt>) \
   BTK_SWIG_DECLARE_CLASS(elt##Collection) \
   { \
   public: \